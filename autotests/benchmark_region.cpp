@@ -0,0 +1,307 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QRandomGenerator>
+#include <QTest>
+
+#include "core/region.h"
+#include "core/region_p.h"
+
+#include <optional>
+
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(memory_sanitizer)
+#define KWIN_BENCHMARK_SANITIZED
+#endif
+#elif defined(__SANITIZE_ADDRESS__)
+#define KWIN_BENCHMARK_SANITIZED
+#endif
+
+#if defined(__GLIBC__) && !defined(KWIN_BENCHMARK_SANITIZED)
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+/*
+ * Counts the heap allocations made by the thread it is read on, so growing a QList while a
+ * region is built shows up as well, not only moving the rectangles out of the inline storage.
+ */
+static thread_local quint64 s_allocationCount = 0;
+
+extern "C" void *malloc(size_t size)
+{
+    ++s_allocationCount;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    ++s_allocationCount;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    ++s_allocationCount;
+    return __libc_realloc(ptr, size);
+}
+
+static std::optional<quint64> allocationCount()
+{
+    return s_allocationCount;
+}
+#else
+static std::optional<quint64> allocationCount()
+{
+    return std::nullopt;
+}
+#endif
+
+using namespace KWin;
+
+/*
+ * The shapes below mimic regions that show up in the compositor when the desktop is busy, e.g.
+ * damage produced by a terminal or a web browser (lots of glyph sized rectangles that share bands),
+ * or the opaque region of a stack of overlapping windows. The generators are seeded so that every
+ * run operates on the same data.
+ */
+static Region glyphDamage(quint32 seed, int lineCount, int glyphsPerLine)
+{
+    QRandomGenerator generator(seed);
+
+    QList<Rect> rects;
+    rects.reserve(lineCount * glyphsPerLine);
+
+    for (int line = 0; line < lineCount; ++line) {
+        const int y = 40 + line * 24;
+        int x = generator.bounded(0, 64);
+        for (int glyph = 0; glyph < glyphsPerLine; ++glyph) {
+            const int width = generator.bounded(6, 14);
+            rects.append(Rect(x, y, width, 20));
+            x += width + generator.bounded(2, 12);
+        }
+    }
+
+    return Region::fromRectsSortedByY(rects);
+}
+
+static Region scatteredDamage(quint32 seed, int count)
+{
+    QRandomGenerator generator(seed);
+
+    QList<Rect> rects;
+    rects.reserve(count);
+
+    for (int i = 0; i < count; ++i) {
+        const int width = generator.bounded(4, 96);
+        const int height = generator.bounded(4, 48);
+        rects.append(Rect(generator.bounded(0, 3840 - width), generator.bounded(0, 2160 - height), width, height));
+    }
+
+    return Region::fromUnsortedRects(rects);
+}
+
+static Region windowStack(quint32 seed, int count)
+{
+    QRandomGenerator generator(seed);
+
+    Region region;
+    for (int i = 0; i < count; ++i) {
+        const int width = generator.bounded(300, 1600);
+        const int height = generator.bounded(200, 1000);
+        const Rect frame(generator.bounded(0, 3840 - width), generator.bounded(0, 2160 - height), width, height);
+
+        // Rounded corners are not part of the opaque region.
+        Region opaque(frame);
+        opaque -= Rect(frame.left(), frame.top(), 8, 8);
+        opaque -= Rect(frame.right() - 8, frame.top(), 8, 8);
+        opaque -= Rect(frame.left(), frame.bottom() - 8, 8, 8);
+        opaque -= Rect(frame.right() - 8, frame.bottom() - 8, 8, 8);
+
+        region += opaque;
+    }
+
+    return region;
+}
+
+class BenchmarkRegion : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void cleanup();
+
+    void united_data();
+    void united();
+    void subtracted_data();
+    void subtracted();
+    void intersected_data();
+    void intersected();
+    void xored_data();
+    void xored();
+    void frameAllocations_data();
+    void frameAllocations();
+};
+
+static void addShapes()
+{
+    QTest::addColumn<int>("isa");
+    QTest::addColumn<Region>("left");
+    QTest::addColumn<Region>("right");
+
+    const struct
+    {
+        const char *name;
+        Region left;
+        Region right;
+    } shapes[] = {
+        {"glyphs", glyphDamage(1, 40, 120), glyphDamage(2, 40, 120)},
+        {"scattered", scatteredDamage(3, 400), scatteredDamage(4, 400)},
+        {"windows", windowStack(5, 60), windowStack(6, 60)},
+        {"glyphs vs windows", glyphDamage(7, 60, 160), windowStack(8, 40)},
+    };
+
+    const struct
+    {
+        const char *name;
+        RegionIsa isa;
+    } isas[] = {
+        {"scalar", RegionIsa::Scalar},
+        {"sse4.1", RegionIsa::Sse41},
+        {"avx2", RegionIsa::Avx2},
+    };
+
+    for (const auto &shape : shapes) {
+        for (const auto &isa : isas) {
+            if (isa.isa > bestRegionIsa()) {
+                continue;
+            }
+            QTest::addRow("%s - %s", shape.name, isa.name) << int(isa.isa) << shape.left << shape.right;
+        }
+    }
+}
+
+template<typename Operation>
+static void runBenchmark(Operation operation)
+{
+    QFETCH(int, isa);
+    QFETCH(Region, left);
+    QFETCH(Region, right);
+
+    setRegionIsa(RegionIsa::Scalar);
+    const Region expected = operation(left, right);
+
+    setRegionIsa(RegionIsa(isa));
+    QCOMPARE(operation(left, right), expected);
+
+    QBENCHMARK {
+        operation(left, right);
+    }
+}
+
+void BenchmarkRegion::cleanup()
+{
+    setRegionIsa(bestRegionIsa());
+}
+
+void BenchmarkRegion::united_data()
+{
+    addShapes();
+}
+
+void BenchmarkRegion::united()
+{
+    runBenchmark([](const Region &left, const Region &right) {
+        return left.united(right);
+    });
+}
+
+void BenchmarkRegion::subtracted_data()
+{
+    addShapes();
+}
+
+void BenchmarkRegion::subtracted()
+{
+    runBenchmark([](const Region &left, const Region &right) {
+        return left.subtracted(right);
+    });
+}
+
+void BenchmarkRegion::intersected_data()
+{
+    addShapes();
+}
+
+void BenchmarkRegion::intersected()
+{
+    runBenchmark([](const Region &left, const Region &right) {
+        return left.intersected(right);
+    });
+}
+
+void BenchmarkRegion::xored_data()
+{
+    addShapes();
+}
+
+void BenchmarkRegion::xored()
+{
+    runBenchmark([](const Region &left, const Region &right) {
+        return left.xored(right);
+    });
+}
+
+void BenchmarkRegion::frameAllocations_data()
+{
+    QTest::addColumn<QList<Rect>>("repaints");
+    QTest::addColumn<quint64>("maximumAllocations");
+
+    QTest::addRow("cursor") << QList<Rect>{Rect(100, 100, 24, 24), Rect(104, 102, 24, 24)} << quint64(0);
+    QTest::addRow("blinking caret") << QList<Rect>{Rect(400, 300, 2, 18)} << quint64(0);
+    QTest::addRow("two surfaces") << QList<Rect>{Rect(0, 0, 800, 600), Rect(1000, 0, 800, 600)} << quint64(0);
+    QTest::addRow("panel and window") << QList<Rect>{Rect(0, 0, 1920, 44), Rect(200, 200, 800, 600), Rect(1800, 1000, 32, 32)} << quint64(0);
+
+    // The glyphs don't touch, so every union adds one rectangle. The first four rectangles are
+    // stored inline, every following union must allocate exactly once, and so can combining the
+    // damage with the output and with the previous frame.
+    const Region fragmented = glyphDamage(9, 4, 32);
+    const QList<Rect> glyphs(fragmented.rects().begin(), fragmented.rects().end());
+    QTest::addRow("fragmented") << glyphs << quint64(glyphs.size() - 4 + 2);
+}
+
+void BenchmarkRegion::frameAllocations()
+{
+    // This mimics how repaints flow through the scene during a frame: every item schedules a
+    // repaint, the repaints are accumulated per view, and then the damage is intersected with
+    // the output and combined with the damage from previous frames.
+    QFETCH(QList<Rect>, repaints);
+    QFETCH(quint64, maximumAllocations);
+
+    const Rect output(0, 0, 3840, 2160);
+    const Region previousFrame(Rect(2000, 1500, 64, 64));
+
+    if (!allocationCount()) {
+        QSKIP("Heap allocations can't be counted in this build");
+    }
+    const quint64 before = *allocationCount();
+
+    Region deviceRepaints;
+    for (const Rect &repaint : std::as_const(repaints)) {
+        deviceRepaints += Region(repaint);
+    }
+    const Region damage = deviceRepaints & output;
+    const Region repaint = damage | previousFrame;
+    Q_UNUSED(repaint)
+
+    const quint64 allocations = *allocationCount() - before;
+    QVERIFY2(allocations <= maximumAllocations, qPrintable(QStringLiteral("%1 allocations").arg(allocations)));
+    QTest::setBenchmarkResult(allocations, QTest::Events);
+}
+
+QTEST_MAIN(BenchmarkRegion)
+
+#include "benchmark_region.moc"
@@ -0,0 +1,178 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QRandomGenerator>
+#include <QTest>
+
+#include "utils/stackinggrid.h"
+
+using namespace KWin;
+
+struct FakeWindow
+{
+    RectF geometry;
+    bool minimized = false;
+};
+
+/*
+ * A stack of windows scattered over two 4K outputs placed side by side, every tenth window is
+ * minimized, which is checked by the hit test predicate like in InputRedirection::findToplevel().
+ */
+static QList<FakeWindow> windowStack(int count)
+{
+    QRandomGenerator generator(count);
+
+    QList<FakeWindow> windows;
+    windows.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const int width = generator.bounded(200, 1600);
+        const int height = generator.bounded(150, 1000);
+        windows.append(FakeWindow{
+            .geometry = RectF(generator.bounded(0, 7680 - width), generator.bounded(0, 2160 - height), width, height),
+            .minimized = (i % 10) == 0,
+        });
+    }
+
+    return windows;
+}
+
+/*
+ * Pointer motion events as produced by a high polling rate mouse, i.e. lots of events with small
+ * deltas.
+ */
+static QList<QPointF> pointerMotion(int count)
+{
+    QRandomGenerator generator(42);
+
+    QList<QPointF> positions;
+    positions.reserve(count);
+
+    QPointF position(3840, 1080);
+    for (int i = 0; i < count; ++i) {
+        position += QPointF(generator.bounded(-8.0, 8.0), generator.bounded(-8.0, 8.0));
+        position.setX(std::clamp(position.x(), 0.0, 7679.0));
+        position.setY(std::clamp(position.y(), 0.0, 2159.0));
+        positions.append(position);
+    }
+
+    return positions;
+}
+
+static int linearTopmostAt(const QList<FakeWindow> &windows, const QPointF &point)
+{
+    for (int i = windows.size() - 1; i >= 0; --i) {
+        if (!windows[i].minimized && windows[i].geometry.contains(point)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static StackingGrid buildGrid(const QList<FakeWindow> &windows)
+{
+    QList<std::optional<RectF>> bounds;
+    bounds.reserve(windows.size());
+    for (const FakeWindow &window : windows) {
+        bounds.append(window.geometry);
+    }
+
+    StackingGrid grid;
+    grid.reset(bounds);
+    return grid;
+}
+
+class BenchmarkStackingGrid : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void topmostAt_data();
+    void topmostAt();
+    void move_data();
+    void move();
+};
+
+void BenchmarkStackingGrid::topmostAt_data()
+{
+    QTest::addColumn<int>("windowCount");
+    QTest::addColumn<bool>("linear");
+
+    for (int windowCount : {10, 100, 500, 2000}) {
+        QTest::addRow("%d windows - linear", windowCount) << windowCount << true;
+        QTest::addRow("%d windows - grid", windowCount) << windowCount << false;
+    }
+}
+
+void BenchmarkStackingGrid::topmostAt()
+{
+    QFETCH(int, windowCount);
+    QFETCH(bool, linear);
+
+    const QList<FakeWindow> windows = windowStack(windowCount);
+    const QList<QPointF> positions = pointerMotion(1000);
+    const StackingGrid grid = buildGrid(windows);
+
+    const auto accept = [&windows](int index) {
+        return !windows[index].minimized;
+    };
+
+    for (const QPointF &position : positions) {
+        QCOMPARE(grid.topmostAt(position, accept), linearTopmostAt(windows, position));
+    }
+
+    if (linear) {
+        QBENCHMARK {
+            for (const QPointF &position : positions) {
+                linearTopmostAt(windows, position);
+            }
+        }
+    } else {
+        QBENCHMARK {
+            for (const QPointF &position : positions) {
+                grid.topmostAt(position, accept);
+            }
+        }
+    }
+}
+
+void BenchmarkStackingGrid::move_data()
+{
+    QTest::addColumn<int>("windowCount");
+
+    QTest::addRow("100 windows") << 100;
+    QTest::addRow("2000 windows") << 2000;
+}
+
+void BenchmarkStackingGrid::move()
+{
+    // This mimics an interactively moved window, which updates the grid on every pointer motion.
+    QFETCH(int, windowCount);
+
+    QList<FakeWindow> windows = windowStack(windowCount);
+    const QList<QPointF> positions = pointerMotion(1000);
+    StackingGrid grid = buildGrid(windows);
+
+    const int movedIndex = windows.size() - 1;
+    const QSizeF movedSize = windows[movedIndex].geometry.size();
+
+    QBENCHMARK {
+        for (const QPointF &position : positions) {
+            windows[movedIndex].geometry = RectF(position, movedSize);
+            grid.update(movedIndex, windows[movedIndex].geometry);
+        }
+    }
+
+    const auto accept = [&windows](int index) {
+        return !windows[index].minimized;
+    };
+    for (const QPointF &position : positions) {
+        QCOMPARE(grid.topmostAt(position, accept), linearTopmostAt(windows, position));
+    }
+}
+
+QTEST_MAIN(BenchmarkStackingGrid)
+
+#include "benchmark_stackinggrid.moc"
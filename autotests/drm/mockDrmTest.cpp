@@ -17,6 +17,10 @@
 #include "core/outputlayer.h"
 #include "core/session.h"
 #include "drm_backend.h"
+#include "drm_blob.h"
+#include "drm_buffer.h"
+#include "drm_commit.h"
+#include "drm_commit_thread.h"
 #include "drm_connector.h"
 #include "drm_crtc.h"
 #include "drm_egl_backend.h"
@@ -30,10 +34,12 @@
 #include "wayland/drmlease_v1.h"
 #include "wayland/drmlease_v1_p.h"
 
+#include <array>
 #include <drm_fourcc.h>
 #include <fcntl.h>
 #include <sys/socket.h>
 #include <sys/utsname.h>
+#include <unistd.h>
 
 using namespace KWin;
 
@@ -85,6 +91,11 @@ private Q_SLOTS:
     void testModeset_data();
     void testModeset();
     void testVrrChange();
+    void testCrtcAssignmentTestCommits_data();
+    void testCrtcAssignmentTestCommits();
+    void testCommitThreadWaitsForFences();
+    void testUnchangedPropertiesAreSkipped();
+    void testBlobDeduplication();
     void testLeaseDisconnectReconnect();
     void testLeaseAvailableAfterMasterToggleAndClientExit();
     void testLeaseAvailableWhenClientExitsBeforeQueuedReoffer();
@@ -501,6 +512,215 @@ void DrmTest::testVrrChange()
     QVERIFY(output->capabilities() & BackendOutput::Capability::Vrr);
 }
 
+void DrmTest::testCrtcAssignmentTestCommits_data()
+{
+    QTest::addColumn<int>("outputCount");
+    QTest::addColumn<bool>("repeated");
+
+    for (int outputCount : {4, 6, 8}) {
+        QTest::addRow("%d outputs", outputCount) << outputCount << false;
+        QTest::addRow("%d outputs, repeated", outputCount) << outputCount << true;
+    }
+}
+
+void DrmTest::testCrtcAssignmentTestCommits()
+{
+    // reports the number of test commits needed to find a working crtc assignment
+    QFETCH(int, outputCount);
+    QFETCH(bool, repeated);
+
+    const auto mockGpu = findPrimaryDevice(outputCount);
+    mockGpu->deviceCaps[MOCKDRM_DEVICE_CAP_ATOMIC] = 1;
+    for (int i = 0; i < outputCount; i++) {
+        mockGpu->connectors.push_back(std::make_shared<MockConnector>(mockGpu.get()));
+    }
+    // the last connector only works with the crtc in the middle, which
+    // the search has to find by trying different assignments
+    const uint32_t workingCrtc = mockGpu->crtcs[outputCount / 2]->id;
+    for (const auto &crtc : std::as_const(mockGpu->crtcs)) {
+        if (crtc->id != workingCrtc) {
+            mockGpu->connectors.back()->rejectedCrtcs.push_back(crtc->id);
+        }
+    }
+
+    const auto session = Session::create(Session::Type::Noop);
+    const auto backend = std::make_unique<DrmBackend>(session.get());
+    auto gpu = std::make_unique<DrmGpu>(backend.get(), mockGpu->fd, DrmDevice::open(mockGpu->devNode));
+    const auto renderBackend = backend->createOpenGLBackend(gpu->renderDevice());
+
+    QVERIFY(gpu->updateOutputs());
+    QCOMPARE(gpu->drmOutputs().size(), outputCount);
+    for (DrmOutput *output : gpu->drmOutputs()) {
+        output->pipeline()->setMode(output->connector()->modes().front());
+        output->pipeline()->setEnable(true);
+        output->pipeline()->setActive(true);
+    }
+
+    if (repeated) {
+        QCOMPARE(gpu->testPendingConfiguration(), DrmPipeline::Error::None);
+    }
+    const uint32_t testCommits = mockGpu->atomicTestCommits.load();
+    QCOMPARE(gpu->testPendingConfiguration(), DrmPipeline::Error::None);
+    const uint32_t neededTestCommits = mockGpu->atomicTestCommits.load() - testCommits;
+    const auto outputs = gpu->drmOutputs();
+    const auto lastOutput = std::ranges::find_if(outputs, [&mockGpu](DrmOutput *output) {
+        return output->connector()->id() == mockGpu->connectors.back()->id;
+    });
+    QCOMPARE((*lastOutput)->pipeline()->crtc()->id(), workingCrtc);
+    if (repeated) {
+        // the last working assignment is tried first
+        QCOMPARE(neededTestCommits, 1u);
+    }
+    QTest::setBenchmarkResult(neededTestCommits, QTest::Events);
+
+    gpu.reset();
+    verifyCleanup(mockGpu.get());
+}
+
+void DrmTest::testCommitThreadWaitsForFences()
+{
+    const auto mockGpu = findPrimaryDevice(1);
+    mockGpu->deviceCaps[MOCKDRM_DEVICE_CAP_ATOMIC] = 1;
+    mockGpu->connectors.push_back(std::make_shared<MockConnector>(mockGpu.get()));
+
+    const auto session = Session::create(Session::Type::Noop);
+    const auto backend = std::make_unique<DrmBackend>(session.get());
+    auto gpu = std::make_unique<DrmGpu>(backend.get(), mockGpu->fd, DrmDevice::open(mockGpu->devNode));
+    const auto renderBackend = backend->createOpenGLBackend(gpu->renderDevice());
+
+    QVERIFY(gpu->updateOutputs());
+    const auto output = gpu->drmOutputs().front();
+    DrmPipeline *pipeline = output->pipeline();
+    pipeline->setMode(output->connector()->modes().front());
+    pipeline->setEnable(true);
+    pipeline->setActive(true);
+    QCOMPARE(gpu->testPendingConfiguration(), DrmPipeline::Error::None);
+    DrmCommitThread *thread = pipeline->commitThread();
+    thread->setModeInfo(60'000, std::chrono::nanoseconds::zero());
+
+    // with vrr, commits are submitted as soon as their buffers are readable
+    auto vrrCommit = std::make_unique<DrmAtomicCommit>(gpu.get());
+    vrrCommit->setVrr(pipeline->crtc(), true);
+    const uint32_t commits = mockGpu->atomicCommits.load();
+    thread->addCommit(std::move(vrrCommit));
+    QTRY_COMPARE(mockGpu->atomicCommits.load(), commits + 1);
+    thread->pageFlipped(std::chrono::steady_clock::now().time_since_epoch());
+
+    // a pipe works as a synthetic fence, it becomes readable when something is written to it
+    int fence[2];
+    QCOMPARE(pipe2(fence, O_CLOEXEC), 0);
+    FileDescriptor readEnd{fence[0]};
+    const FileDescriptor writeEnd{fence[1]};
+    uint32_t framebufferId = 0;
+    QCOMPARE(drmModeAddFB(mockGpu->fd, 1920, 1080, 24, 32, 1920 * 4, 0, &framebufferId), 0);
+    auto buffer = std::make_shared<DrmFramebuffer>(std::make_shared<DrmFramebufferData>(gpu.get(), framebufferId, nullptr), nullptr, std::move(readEnd));
+
+    auto commit = std::make_unique<DrmAtomicCommit>(gpu.get());
+    commit->addBuffer(pipeline->crtc()->primaryPlane(), buffer, nullptr);
+    thread->addCommit(std::move(commit));
+
+    // the commit must not be submitted before the fence is signaled, and the thread has to
+    // sleep until then instead of polling the fence
+    const uint64_t iterations = thread->iterations();
+    QTest::qWait(100);
+    QCOMPARE(mockGpu->atomicCommits.load(), commits + 1);
+    QCOMPARE_LE(thread->iterations() - iterations, 3u);
+
+    const char signal = 1;
+    QCOMPARE(write(writeEnd.get(), &signal, sizeof(signal)), 1);
+    QTRY_COMPARE(mockGpu->atomicCommits.load(), commits + 2);
+    thread->pageFlipped(std::chrono::steady_clock::now().time_since_epoch());
+
+    buffer.reset();
+    gpu.reset();
+    verifyCleanup(mockGpu.get());
+}
+
+void DrmTest::testUnchangedPropertiesAreSkipped()
+{
+    const auto mockGpu = findPrimaryDevice(1);
+    mockGpu->deviceCaps[MOCKDRM_DEVICE_CAP_ATOMIC] = 1;
+    mockGpu->connectors.push_back(std::make_shared<MockConnector>(mockGpu.get()));
+
+    const auto session = Session::create(Session::Type::Noop);
+    const auto backend = std::make_unique<DrmBackend>(session.get());
+    auto gpu = std::make_unique<DrmGpu>(backend.get(), mockGpu->fd, DrmDevice::open(mockGpu->devNode));
+    QVERIFY(gpu->updateOutputs());
+    DrmPlane *plane = gpu->drmOutputs().front()->pipeline()->crtc()->primaryPlane();
+
+    const auto commitPosition = [&gpu, plane](uint64_t x, uint64_t y) {
+        DrmAtomicCommit commit(gpu.get());
+        commit.addProperty(plane->crtcX, x);
+        commit.addProperty(plane->crtcY, y);
+        return commit.commit();
+    };
+    QVERIFY(commitPosition(10, 20));
+    QCOMPARE(mockGpu->lastAtomicCommitProperties.load(), 2u);
+
+    // nothing changed, so nothing needs to be sent
+    QVERIFY(commitPosition(10, 20));
+    QCOMPARE(mockGpu->lastAtomicCommitProperties.load(), 0u);
+
+    QVERIFY(commitPosition(30, 20));
+    QCOMPARE(mockGpu->lastAtomicCommitProperties.load(), 1u);
+
+    // tests always contain the full state
+    const uint32_t testCommits = mockGpu->atomicTestCommits.load();
+    DrmAtomicCommit test(gpu.get());
+    test.addProperty(plane->crtcX, 30);
+    test.addProperty(plane->crtcY, 20);
+    QVERIFY(test.test());
+    QCOMPARE(mockGpu->atomicTestCommits.load(), testCommits + 1);
+
+    // the kernel state is unknown after another DRM master was active
+    gpu->setActive(false);
+    gpu->setActive(true);
+    QVERIFY(commitPosition(30, 20));
+    QCOMPARE(mockGpu->lastAtomicCommitProperties.load(), 2u);
+
+    gpu.reset();
+    verifyCleanup(mockGpu.get());
+}
+
+void DrmTest::testBlobDeduplication()
+{
+    const auto mockGpu = findPrimaryDevice(0);
+    mockGpu->deviceCaps[MOCKDRM_DEVICE_CAP_ATOMIC] = 1;
+
+    const auto session = Session::create(Session::Type::Noop);
+    const auto backend = std::make_unique<DrmBackend>(session.get());
+    auto gpu = std::make_unique<DrmGpu>(backend.get(), mockGpu->fd, DrmDevice::open(mockGpu->devNode));
+
+    const std::array<uint32_t, 4> data{1, 2, 3, 4};
+    const std::array<uint32_t, 4> otherData{4, 3, 2, 1};
+    auto blob = DrmBlob::create(gpu.get(), data.data(), sizeof(data));
+    QVERIFY(blob);
+    const size_t blobCount = mockGpu->propertyBlobs.size();
+
+    // the same content results in the same blob
+    auto sameBlob = DrmBlob::create(gpu.get(), data.data(), sizeof(data));
+    QCOMPARE(sameBlob, blob);
+    QCOMPARE(mockGpu->propertyBlobs.size(), blobCount);
+
+    auto otherBlob = DrmBlob::create(gpu.get(), otherData.data(), sizeof(otherData));
+    QVERIFY(otherBlob);
+    QCOMPARE_NE(otherBlob->blobId(), blob->blobId());
+    QCOMPARE(mockGpu->propertyBlobs.size(), blobCount + 1);
+
+    // once all users are gone, the blob is destroyed and a new one gets created
+    blob.reset();
+    sameBlob.reset();
+    QCOMPARE(mockGpu->propertyBlobs.size(), blobCount);
+    blob = DrmBlob::create(gpu.get(), data.data(), sizeof(data));
+    QVERIFY(blob);
+    QCOMPARE(mockGpu->propertyBlobs.size(), blobCount + 1);
+
+    blob.reset();
+    otherBlob.reset();
+    gpu.reset();
+    verifyCleanup(mockGpu.get());
+}
+
 void DrmTest::testLeaseDisconnectReconnect()
 {
     const auto mockGpu = findPrimaryDevice(1);
@@ -995,6 +995,13 @@ int drmModeAtomicCommit(int fd, drmModeAtomicReqPtr req, uint32_t flags, void *u
         return -(errno = EINVAL);
     }
 
+    if (flags & DRM_MODE_ATOMIC_TEST_ONLY) {
+        gpu->atomicTestCommits++;
+    } else {
+        gpu->atomicCommits++;
+        gpu->lastAtomicCommitProperties = req->props.count();
+    }
+
     QList<MockConnector> connCopies;
     for (const auto &conn : std::as_const(gpu->connectors)) {
         connCopies << *conn;
@@ -1150,6 +1157,10 @@ int drmModeAtomicCommit(int fd, drmModeAtomicReqPtr req, uint32_t flags, void *u
                     qWarning("mode on crtc %u is incompatible with connector %u", p.crtc->id, conn->id);
                     return -(errno = EINVAL);
                 }
+                if (conn->rejectedCrtcs.contains(p.crtc->id)) {
+                    qWarning("crtc %u can't drive connector %u", p.crtc->id, conn->id);
+                    return -(errno = EINVAL);
+                }
             }
         }
     }
@@ -14,6 +14,7 @@
 #include <QList>
 #include <QMap>
 #include <QRect>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -81,6 +82,9 @@ public:
     uint32_t type;
     std::shared_ptr<MockEncoder> encoder;
     QList<drmModeModeInfo> modes;
+    // crtcs that are advertised as possible, but fail the atomic test,
+    // like with hardware that shares resources between crtcs
+    QList<uint32_t> rejectedCrtcs;
 };
 
 class MockEncoder : public MockObject
@@ -206,5 +210,12 @@ public:
     QList<drmModeObjectPropertiesPtr> drmObjectProperties;
     QList<drmModePlaneResPtr> drmPlaneRes;
     QList<MockLease> leases;
+
+    // the number of atomic commits with and without DRM_MODE_ATOMIC_TEST_ONLY
+    std::atomic<uint32_t> atomicTestCommits = 0;
+    std::atomic<uint32_t> atomicCommits = 0;
+    // the number of properties in the last atomic commit without DRM_MODE_ATOMIC_TEST_ONLY
+    std::atomic<uint32_t> lastAtomicCommitProperties = 0;
+
     std::mutex m_mutex;
 };
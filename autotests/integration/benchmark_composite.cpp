@@ -0,0 +1,334 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "kwin_wayland_test.h"
+
+#include "compositor.h"
+#include "core/backendoutput.h"
+#include "core/framestatistics.h"
+#include "core/output.h"
+#include "core/renderbackend.h"
+#include "core/renderloop.h"
+#include "effect/effecthandler.h"
+#include "wayland_server.h"
+#include "workspace.h"
+
+#include <KWayland/Client/surface.h>
+
+#include <QRandomGenerator>
+#include <QSignalSpy>
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <time.h>
+
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(memory_sanitizer)
+#define KWIN_BENCHMARK_SANITIZED
+#endif
+#elif defined(__SANITIZE_ADDRESS__)
+#define KWIN_BENCHMARK_SANITIZED
+#endif
+
+#if defined(__GLIBC__) && !defined(KWIN_BENCHMARK_SANITIZED)
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+/*
+ * Counts the heap allocations made by the thread it is read on. Both the compositor and the
+ * synthetic clients run on the main thread, so the client side of the commits is included too,
+ * but it stays the same for a given damage pattern.
+ */
+static thread_local quint64 s_allocationCount = 0;
+
+extern "C" void *malloc(size_t size)
+{
+    ++s_allocationCount;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    ++s_allocationCount;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    ++s_allocationCount;
+    return __libc_realloc(ptr, size);
+}
+
+static std::optional<quint64> allocationCount()
+{
+    return s_allocationCount;
+}
+#else
+static std::optional<quint64> allocationCount()
+{
+    return std::nullopt;
+}
+#endif
+
+using namespace std::chrono_literals;
+
+namespace KWin
+{
+
+enum class DamagePattern {
+    /**
+     * Only the topmost window updates a caret sized area, e.g. typing in a terminal.
+     */
+    Caret,
+    /**
+     * Every window damages a few scattered rectangles, e.g. busy web pages.
+     */
+    Scattered,
+    /**
+     * Every window damages its whole surface, e.g. videos.
+     */
+    Full,
+};
+
+static std::chrono::nanoseconds threadCpuTime()
+{
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+static double toMilliseconds(std::chrono::nanoseconds duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+static std::chrono::nanoseconds percentile(QList<std::chrono::nanoseconds> durations, double percentile)
+{
+    if (durations.isEmpty()) {
+        return 0ns;
+    }
+    std::ranges::sort(durations);
+    return durations[std::min<qsizetype>(std::ceil(percentile * durations.size()), durations.size()) - 1];
+}
+
+class CompositeBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void composite_data();
+    void composite();
+};
+
+void CompositeBenchmark::initTestCase()
+{
+    qRegisterMetaType<Window *>();
+
+    // Rendering in software makes the results comparable between machines, and allows
+    // to catch regressions in the hot paths without a GPU.
+    if (!qEnvironmentVariableIsSet("LIBGL_ALWAYS_SOFTWARE")) {
+        qputenv("LIBGL_ALWAYS_SOFTWARE", QByteArrayLiteral("1"));
+    }
+
+    QVERIFY(waylandServer()->init(qAppName()));
+    kwinApp()->start();
+    Test::setOutputConfig({
+        Rect(0, 0, 1920, 1080),
+    });
+    QVERIFY(Compositor::self());
+    // KWIN_COMPOSE=Q benchmarks the software renderer, so it can be compared with llvmpipe,
+    // KWIN_COMPOSE=V benchmarks the Vulkan renderer.
+    const QByteArray compose = qgetenv("KWIN_COMPOSE");
+    if (compose.startsWith('Q')) {
+        QCOMPARE(Compositor::self()->backend()->compositingType(), KWin::QPainterCompositing);
+    } else if (compose.startsWith('V')) {
+        QCOMPARE(Compositor::self()->backend()->compositingType(), KWin::VulkanCompositing);
+    } else {
+        QCOMPARE(Compositor::self()->backend()->compositingType(), KWin::OpenGLCompositing);
+    }
+
+    effects->unloadAllEffects();
+}
+
+void CompositeBenchmark::init()
+{
+    QVERIFY(Test::setupWaylandConnection());
+}
+
+void CompositeBenchmark::cleanup()
+{
+    effects->unloadAllEffects();
+    Test::destroyWaylandConnection();
+}
+
+void CompositeBenchmark::composite_data()
+{
+    QTest::addColumn<int>("windowCount");
+    QTest::addColumn<QSize>("windowSize");
+    QTest::addColumn<int>("damage");
+    QTest::addColumn<QStringList>("effectNames");
+
+    const struct
+    {
+        const char *name;
+        DamagePattern pattern;
+    } patterns[] = {
+        {"caret", DamagePattern::Caret},
+        {"scattered", DamagePattern::Scattered},
+        {"full", DamagePattern::Full},
+    };
+
+    for (int windowCount : {1, 10, 40}) {
+        for (const auto &pattern : patterns) {
+            QTest::addRow("%d windows - %s", windowCount, pattern.name) << windowCount << QSize(640, 480) << int(pattern.pattern) << QStringList();
+        }
+    }
+
+    // A single large shared memory canvas, e.g. a software rendered browser or image editor.
+    // Whether it's sampled directly through udmabuf or how it's uploaded matters most here,
+    // KWIN_DISABLE_UDMABUF_IMPORT=1 and KWIN_PBO_UPLOADS=0 can be used to compare the paths.
+    for (const QSize &canvasSize : {QSize(1920, 1080), QSize(3840, 2160)}) {
+        for (const auto &pattern : patterns) {
+            QTest::addRow("%dx%d canvas - %s", canvasSize.width(), canvasSize.height(), pattern.name) << 1 << canvasSize << int(pattern.pattern) << QStringList();
+        }
+    }
+
+    // Inactive windows are painted with modulated colors.
+    QTest::addRow("10 windows - scattered - diminactive") << 10 << QSize(640, 480) << int(DamagePattern::Scattered) << QStringList{QStringLiteral("diminactive")};
+    QTest::addRow("10 windows - full - diminactive") << 10 << QSize(640, 480) << int(DamagePattern::Full) << QStringList{QStringLiteral("diminactive")};
+}
+
+void CompositeBenchmark::composite()
+{
+    QFETCH(int, windowCount);
+    QFETCH(QSize, windowSize);
+    QFETCH(int, damage);
+    QFETCH(QStringList, effectNames);
+
+    for (const QString &effectName : std::as_const(effectNames)) {
+        QVERIFY(effects->loadEffect(effectName));
+    }
+
+    std::vector<std::unique_ptr<Test::XdgToplevelWindow>> windows;
+    for (int i = 0; i < windowCount; ++i) {
+        auto window = std::make_unique<Test::XdgToplevelWindow>();
+        QVERIFY(window->show(windowSize, QColor::fromHsv((i * 37) % 360, 200, 200)));
+        windows.push_back(std::move(window));
+    }
+
+    const QImage images[] = {
+        [&]() {
+            QImage image(windowSize, QImage::Format_ARGB32_Premultiplied);
+            image.fill(Qt::red);
+            return image;
+        }(),
+        [&]() {
+            QImage image(windowSize, QImage::Format_ARGB32_Premultiplied);
+            image.fill(Qt::blue);
+            return image;
+        }(),
+    };
+
+    QRandomGenerator generator(windowCount);
+    const auto update = [&](int frame) {
+        const QImage &image = images[frame % 2];
+        switch (DamagePattern(damage)) {
+        case DamagePattern::Caret: {
+            auto &window = windows.back();
+            window->m_surface->attachBuffer(Test::waylandShmPool()->createBuffer(image));
+            window->m_surface->damage(QRect(16 + (frame % 40) * 8, 16, 8, 16));
+            window->m_surface->commit(KWayland::Client::Surface::CommitFlag::None);
+            break;
+        }
+        case DamagePattern::Scattered:
+            for (auto &window : windows) {
+                window->m_surface->attachBuffer(Test::waylandShmPool()->createBuffer(image));
+                for (int i = 0; i < 8; ++i) {
+                    const QSize size(generator.bounded(8, 128), generator.bounded(8, 64));
+                    window->m_surface->damage(QRect(QPoint(generator.bounded(windowSize.width() - size.width()), generator.bounded(windowSize.height() - size.height())), size));
+                }
+                window->m_surface->commit(KWayland::Client::Surface::CommitFlag::None);
+            }
+            break;
+        case DamagePattern::Full:
+            for (auto &window : windows) {
+                window->m_surface->attachBuffer(Test::waylandShmPool()->createBuffer(image));
+                window->m_surface->damage(QRect(QPoint(0, 0), windowSize));
+                window->m_surface->commit(KWayland::Client::Surface::CommitFlag::None);
+            }
+            break;
+        }
+    };
+
+    BackendOutput *output = workspace()->outputs().front()->backendOutput();
+    RenderLoop *renderLoop = output->renderLoop();
+    QSignalSpy framePresented(renderLoop, &RenderLoop::framePresented);
+
+    // Let the swapchain, the shader caches and the textures settle down first.
+    const int warmupFrameCount = 30;
+    for (int frame = 0; frame < warmupFrameCount; ++frame) {
+        update(frame);
+        QVERIFY(framePresented.wait());
+    }
+
+    const int frameCount = 120;
+    const quint64 firstSequence = renderLoop->frameStatistics()->lastSequence();
+    const std::optional<quint64> allocationsBefore = allocationCount();
+    const std::chrono::nanoseconds cpuTimeBefore = threadCpuTime();
+
+    for (int frame = 0; frame < frameCount; ++frame) {
+        update(warmupFrameCount + frame);
+        QVERIFY(framePresented.wait());
+    }
+
+    const std::chrono::nanoseconds cpuTime = threadCpuTime() - cpuTimeBefore;
+    const std::optional<quint64> allocationsAfter = allocationCount();
+
+    QList<std::chrono::nanoseconds> frameTimes;
+    QList<std::chrono::nanoseconds> prepareTimes;
+    QList<std::chrono::nanoseconds> renderTimes;
+    int droppedFrames = 0;
+    const QList<FrameStatistics> frames = renderLoop->frameStatistics()->snapshot(firstSequence);
+    for (const FrameStatistics &statistics : frames) {
+        if (statistics.status == FrameStatistics::Status::Dropped) {
+            droppedFrames++;
+            continue;
+        }
+        prepareTimes.append(statistics.prepareEnd - statistics.prepareStart);
+        renderTimes.append(statistics.renderEnd - statistics.renderStart);
+        frameTimes.append(std::max(statistics.renderEnd, statistics.prepareEnd) - statistics.prepareStart);
+    }
+    QVERIFY(!frameTimes.isEmpty());
+
+    qInfo("frame time: p50 %.3fms, p95 %.3fms, p99 %.3fms, max %.3fms",
+          toMilliseconds(percentile(frameTimes, 0.5)),
+          toMilliseconds(percentile(frameTimes, 0.95)),
+          toMilliseconds(percentile(frameTimes, 0.99)),
+          toMilliseconds(percentile(frameTimes, 1.0)));
+    qInfo("prepare: p50 %.3fms, p95 %.3fms; render: p50 %.3fms, p95 %.3fms",
+          toMilliseconds(percentile(prepareTimes, 0.5)),
+          toMilliseconds(percentile(prepareTimes, 0.95)),
+          toMilliseconds(percentile(renderTimes, 0.5)),
+          toMilliseconds(percentile(renderTimes, 0.95)));
+    qInfo("main thread cpu time per frame: %.3fms, presented frames: %lld, dropped frames: %d",
+          toMilliseconds(cpuTime / frameCount), qint64(frameTimes.size()), droppedFrames);
+    if (allocationsBefore && allocationsAfter) {
+        qInfo("main thread allocations per frame: %.1f", double(*allocationsAfter - *allocationsBefore) / frameCount);
+    }
+
+    QTest::setBenchmarkResult(toMilliseconds(percentile(frameTimes, 0.5)), QTest::WalltimeMilliseconds);
+}
+
+}
+
+WAYLANDTEST_MAIN(KWin::CompositeBenchmark)
+#include "benchmark_composite.moc"
@@ -0,0 +1,162 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "kwin_wayland_test.h"
+
+#include "backends/virtual/virtual_qpainter_backend.h"
+#include "compositor.h"
+#include "core/output.h"
+#include "cursor.h"
+#include "effect/effecthandler.h"
+#include "scene/windowitem.h"
+#include "wayland/surface.h"
+#include "wayland_server.h"
+#include "window.h"
+#include "workspace.h"
+
+#include <KWayland/Client/compositor.h>
+#include <KWayland/Client/region.h>
+#include <KWayland/Client/surface.h>
+
+namespace KWin
+{
+
+class OcclusionCacheTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void testOtherWindowCommit();
+    void testOpaqueRegionChange();
+    void testMove();
+    void testOpacityChange();
+    void testAlphaChannelChange();
+};
+
+void OcclusionCacheTest::initTestCase()
+{
+    qRegisterMetaType<Window *>();
+
+    // The software renderer is used so the contents of the output can be inspected
+    qputenv("KWIN_COMPOSE", QByteArrayLiteral("Q"));
+    QVERIFY(waylandServer()->init(qAppName()));
+    kwinApp()->start();
+    QCOMPARE(Compositor::self()->backend()->compositingType(), QPainterCompositing);
+    Test::setOutputConfig({
+        Rect(0, 0, 1280, 1024),
+    });
+
+    // make sure open/close effects don't make the windows translucent
+    effects->unloadAllEffects();
+}
+
+void OcclusionCacheTest::init()
+{
+    QVERIFY(Test::setupWaylandConnection(Test::AdditionalWaylandInterface::PresentationTime));
+    Cursors::self()->hideCursor();
+}
+
+void OcclusionCacheTest::cleanup()
+{
+    Test::destroyWaylandConnection();
+}
+
+void OcclusionCacheTest::testOtherWindowCommit()
+{
+    // this test verifies that a commit of one window doesn't invalidate the cached opaque region of another
+    Test::XdgToplevelWindow first;
+    QVERIFY(first.show(QSize(100, 50), Qt::red));
+    Test::XdgToplevelWindow second;
+    QVERIFY(second.show(QSize(100, 50), Qt::blue));
+
+    const quint64 generation = first.m_window->windowItem()->occlusionGeneration();
+
+    QSignalSpy committedSpy(second.m_window->surface(), &SurfaceInterface::committed);
+    Test::render(second.m_surface.get(), QSize(100, 50), Qt::green);
+    QVERIFY(committedSpy.wait());
+
+    QCOMPARE(first.m_window->windowItem()->occlusionGeneration(), generation);
+}
+
+void OcclusionCacheTest::testOpaqueRegionChange()
+{
+    // this test verifies that changing the opaque region of a surface invalidates the cached opaque region
+    Test::XdgToplevelWindow window;
+    QVERIFY(window.show(QSize(100, 50), Qt::red));
+
+    const quint64 generation = window.m_window->windowItem()->occlusionGeneration();
+
+    QSignalSpy opaqueChangedSpy(window.m_window->surface(), &SurfaceInterface::opaqueChanged);
+    std::unique_ptr<KWayland::Client::Region> region(Test::waylandCompositor()->createRegion(QRegion(0, 0, 100, 50)));
+    window.m_surface->setOpaqueRegion(region.get());
+    window.m_surface->commit(KWayland::Client::Surface::CommitFlag::None);
+    QVERIFY(opaqueChangedSpy.wait());
+
+    QVERIFY(window.m_window->windowItem()->occlusionGeneration() != generation);
+}
+
+void OcclusionCacheTest::testMove()
+{
+    // this test verifies that moving a window invalidates its cached opaque region
+    Test::XdgToplevelWindow window;
+    QVERIFY(window.show(QSize(100, 50), Qt::red));
+
+    const quint64 generation = window.m_window->windowItem()->occlusionGeneration();
+    window.m_window->move(QPointF(10, 20));
+    QVERIFY(window.m_window->windowItem()->occlusionGeneration() != generation);
+}
+
+void OcclusionCacheTest::testOpacityChange()
+{
+    // this test verifies that changing the opacity of a window invalidates its cached opaque region
+    Test::XdgToplevelWindow window;
+    QVERIFY(window.show(QSize(100, 50), Qt::red));
+
+    const quint64 generation = window.m_window->windowItem()->occlusionGeneration();
+    window.m_window->windowItem()->setOpacity(0.5);
+    QVERIFY(window.m_window->windowItem()->occlusionGeneration() != generation);
+}
+
+}
+
+void OcclusionCacheTest::testAlphaChannelChange()
+{
+    // this test verifies that a window below a surface is painted again when the surface switches
+    // from a buffer without an alpha channel to a buffer of the same size with an alpha channel
+    LogicalOutput *output = workspace()->outputs().front();
+    const auto layer = static_cast<VirtualQPainterLayer *>(Compositor::self()->backend()->compatibleOutputLayers(output->backendOutput()).front());
+
+    Test::XdgToplevelWindow below;
+    QVERIFY(below.show(QSize(100, 50), Qt::red));
+    below.m_window->move(QPointF(100, 100));
+
+    QImage opaqueImage(QSize(100, 50), QImage::Format_RGB32);
+    opaqueImage.fill(Qt::blue);
+    Test::XdgToplevelWindow above;
+    QVERIFY(above.show(opaqueImage));
+    above.m_window->move(QPointF(100, 100));
+
+    // render a few frames, to make sure every buffer of the swapchain is up to date
+    for (int i = 0; i < 3; i++) {
+        QVERIFY(above.presentWait());
+    }
+    QCOMPARE(layer->image()->pixel(150, 125), qRgb(0, 0, 255));
+
+    QImage transparentImage(QSize(100, 50), QImage::Format_ARGB32_Premultiplied);
+    transparentImage.fill(Qt::transparent);
+    Test::render(above.m_surface.get(), transparentImage);
+    for (int i = 0; i < 3; i++) {
+        QVERIFY(above.presentWait());
+    }
+    QCOMPARE(layer->image()->pixel(150, 125), qRgb(255, 0, 0));
+}
+
+WAYLANDTEST_MAIN(KWin::OcclusionCacheTest)
+#include "occlusion_cache_test.moc"
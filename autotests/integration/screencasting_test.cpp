@@ -9,7 +9,10 @@
 #include "compositor.h"
 #include "core/output.h"
 #include "generic_scene_opengl_test.h"
+#include "main.h"
 #include "opengl/glplatform.h"
+#include "plugin.h"
+#include "pluginmanager.h"
 #include "pointer_input.h"
 #include "scene/workspacescene.h"
 #include "wayland_server.h"
@@ -20,8 +23,13 @@
 #include <KWayland/Client/subsurface.h>
 #include <KWayland/Client/surface.h>
 #include <PipeWireSourceStream>
+#include <QElapsedTimer>
 #include <QPainter>
 #include <QScreen>
+#include <QSocketNotifier>
+
+#include <pipewire/pipewire.h>
+#include <spa/param/video/format-utils.h>
 
 #define QCOMPAREIMG(actual, expected, id)                                                        \
     {                                                                                            \
@@ -38,6 +46,107 @@
 namespace KWin
 {
 
+/**
+ * The SizedPipeWireStream class consumes a stream at a size picked by the consumer, which
+ * PipeWireSourceStream can't ask for. No modifiers are offered, so the frames arrive in memfds.
+ */
+class SizedPipeWireStream : public QObject
+{
+    Q_OBJECT
+
+public:
+    SizedPipeWireStream(quint64 serial, const QSize &size)
+    {
+        pw_init(nullptr, nullptr);
+        m_loop = pw_loop_new(nullptr);
+        pw_loop_enter(m_loop);
+        m_notifier = std::make_unique<QSocketNotifier>(pw_loop_get_fd(m_loop), QSocketNotifier::Read);
+        connect(m_notifier.get(), &QSocketNotifier::activated, this, [this]() {
+            pw_loop_iterate(m_loop, 0);
+        });
+        m_context = pw_context_new(m_loop, nullptr, 0);
+        m_core = pw_context_connect(m_context, nullptr, 0);
+
+        m_stream = pw_stream_new(m_core, "kwin-test-sized-stream",
+                                 pw_properties_new(PW_KEY_MEDIA_TYPE, "Video",
+                                                   PW_KEY_MEDIA_CATEGORY, "Capture",
+                                                   PW_KEY_MEDIA_ROLE, "Screen",
+                                                   PW_KEY_TARGET_OBJECT, QByteArray::number(serial).constData(),
+                                                   nullptr));
+        m_events.version = PW_VERSION_STREAM_EVENTS;
+        m_events.param_changed = [](void *data, uint32_t id, const spa_pod *param) {
+            static_cast<SizedPipeWireStream *>(data)->handleParamChanged(id, param);
+        };
+        m_events.process = [](void *data) {
+            static_cast<SizedPipeWireStream *>(data)->handleProcess();
+        };
+        pw_stream_add_listener(m_stream, &m_listener, &m_events, this);
+
+        uint8_t buffer[1024];
+        spa_pod_builder builder = SPA_POD_BUILDER_INIT(buffer, sizeof(buffer));
+        const spa_rectangle streamSize = SPA_RECTANGLE(uint32_t(size.width()), uint32_t(size.height()));
+        const spa_fraction framerate = SPA_FRACTION(0, 1);
+        const spa_pod *params[] = {
+            static_cast<const spa_pod *>(spa_pod_builder_add_object(&builder,
+                                                                    SPA_TYPE_OBJECT_Format, SPA_PARAM_EnumFormat,
+                                                                    SPA_FORMAT_mediaType, SPA_POD_Id(SPA_MEDIA_TYPE_video),
+                                                                    SPA_FORMAT_mediaSubtype, SPA_POD_Id(SPA_MEDIA_SUBTYPE_raw),
+                                                                    SPA_FORMAT_VIDEO_format, SPA_POD_CHOICE_ENUM_Id(3, SPA_VIDEO_FORMAT_BGRA, SPA_VIDEO_FORMAT_BGRA, SPA_VIDEO_FORMAT_BGRx),
+                                                                    SPA_FORMAT_VIDEO_size, SPA_POD_Rectangle(&streamSize),
+                                                                    SPA_FORMAT_VIDEO_framerate, SPA_POD_Fraction(&framerate))),
+        };
+        pw_stream_connect(m_stream, PW_DIRECTION_INPUT, PW_ID_ANY, pw_stream_flags(PW_STREAM_FLAG_AUTOCONNECT | PW_STREAM_FLAG_MAP_BUFFERS), params, 1);
+    }
+
+    ~SizedPipeWireStream() override
+    {
+        pw_stream_destroy(m_stream);
+        pw_core_disconnect(m_core);
+        pw_context_destroy(m_context);
+        m_notifier.reset();
+        pw_loop_leave(m_loop);
+        pw_loop_destroy(m_loop);
+        pw_deinit();
+    }
+
+Q_SIGNALS:
+    void frameReceived(const QImage &image);
+
+private:
+    void handleParamChanged(uint32_t id, const spa_pod *param)
+    {
+        if (!param || id != SPA_PARAM_Format) {
+            return;
+        }
+        spa_video_info_raw format;
+        spa_format_video_raw_parse(param, &format);
+        m_size = QSize(format.size.width, format.size.height);
+    }
+
+    void handleProcess()
+    {
+        pw_buffer *buffer = pw_stream_dequeue_buffer(m_stream);
+        if (!buffer) {
+            return;
+        }
+        const spa_data &data = buffer->buffer->datas[0];
+        if (data.data && data.chunk->size && !(data.chunk->flags & SPA_CHUNK_FLAG_CORRUPTED)) {
+            const QImage image(static_cast<const uchar *>(data.data) + data.chunk->offset, m_size.width(), m_size.height(), data.chunk->stride, QImage::Format_ARGB32_Premultiplied);
+            Q_EMIT frameReceived(image.copy());
+        }
+        pw_stream_queue_buffer(m_stream, buffer);
+    }
+
+    pw_loop *m_loop = nullptr;
+    pw_context *m_context = nullptr;
+    pw_core *m_core = nullptr;
+    pw_stream *m_stream = nullptr;
+    pw_stream_events m_events = {};
+    spa_hook m_listener = {};
+    std::unique_ptr<QSocketNotifier> m_notifier;
+    QSize m_size;
+};
+
 class ScreencastingTest : public GenericSceneOpenGLTest
 {
     Q_OBJECT
@@ -81,6 +190,10 @@ private Q_SLOTS:
     void testWindowWithPopup();
     void testWindowWithPopupDynamic();
     void testOutputCasting();
+    void testOutputCastingRendersOnce_data();
+    void testOutputCastingRendersOnce();
+    void testOutputCastingKeepAlive();
+    void testOutputCastingSmallStream();
 
 private:
     std::optional<QImage> oneFrameAndClose(Test::ScreencastingStreamV1 *stream);
@@ -128,6 +241,25 @@ std::optional<QImage> ScreencastingTest::oneFrameAndClose(Test::ScreencastingStr
     return img;
 }
 
+/**
+ * Returns the pacing statistics of the stream of the @p output, the stream class lives in the
+ * screencast plugin so they are read through its debug property.
+ */
+static QVariantMap outputStreamStatistics(LogicalOutput *output)
+{
+    Plugin *plugin = kwinApp()->pluginManager()->plugin(QStringLiteral("screencast"));
+    if (!plugin) {
+        return QVariantMap{};
+    }
+    const auto children = plugin->findChildren<QObject *>(output->name(), Qt::FindDirectChildrenOnly);
+    for (QObject *child : children) {
+        if (child->inherits("KWin::ScreenCastStream")) {
+            return child->property("debugStatistics").toMap();
+        }
+    }
+    return QVariantMap{};
+}
+
 void ScreencastingTest::testWindowCasting()
 {
     QImage sourceImage(QSize(30, 10), QImage::Format_RGBA8888_Premultiplied);
@@ -266,5 +398,256 @@ void ScreencastingTest::testOutputCasting()
 
 }
 
+void ScreencastingTest::testOutputCastingRendersOnce_data()
+{
+    QTest::addColumn<int>("streamCount");
+
+    QTest::addRow("1 stream") << 1;
+    QTest::addRow("2 streams") << 2;
+    QTest::addRow("3 streams") << 3;
+}
+
+void ScreencastingTest::testOutputCastingRendersOnce()
+{
+    // This test verifies that concurrent streams of the same output share one paint per frame
+    QFETCH(int, streamCount);
+
+    auto theOutput = KWin::Test::waylandOutputs().constFirst();
+    LogicalOutput *output = workspace()->outputs().constFirst();
+
+    Test::XdgToplevelWindow window{[theOutput](Test::XdgToplevel *toplevel) {
+        toplevel->set_fullscreen(theOutput->output());
+    }};
+
+    QImage sourceImage(theOutput->pixelSize(), QImage::Format_RGBA8888_Premultiplied);
+    sourceImage.fill(Qt::green);
+    {
+        QPainter p(&sourceImage);
+        p.drawRect(100, 100, 100, 100);
+    }
+
+    QVERIFY(window.show(sourceImage));
+    QVERIFY(window.m_window->isFullScreen());
+    QVERIFY(window.presentWait());
+
+    // Every scene view renders the output once per frame
+    const auto sceneViewCount = [output]() {
+        const auto views = kwinApp()->scene()->views();
+        return std::count_if(views.cbegin(), views.cend(), [output](RenderView *view) {
+            return qobject_cast<SceneView *>(view) && view->logicalOutput() == output;
+        });
+    };
+    const auto initialSceneViewCount = sceneViewCount();
+
+    std::vector<std::unique_ptr<Test::ScreencastingStreamV1>> streams;
+    std::vector<std::unique_ptr<PipeWireSourceStream>> pwStreams;
+    std::vector<std::optional<QImage>> images(streamCount);
+    int receivedCount = 0;
+    for (int i = 0; i < streamCount; ++i) {
+        std::unique_ptr<Test::ScreencastingStreamV1> stream(KWin::Test::screencasting()->createOutputStream(theOutput->output(), QtWayland::zkde_screencast_unstable_v1::pointer_hidden));
+        auto pwStream = std::make_unique<PipeWireSourceStream>();
+        connect(stream.get(), &Test::ScreencastingStreamV1::created, qGuiApp, [pwStream = pwStream.get()](quint64 serial) {
+            pwStream->createStream(serial, 0);
+        });
+        connect(pwStream.get(), &PipeWireSourceStream::frameReceived, qGuiApp, [&images, &receivedCount, i](const PipeWireFrame &frame) {
+            if (frame.dataFrame) {
+                if (!images[i]) {
+                    ++receivedCount;
+                }
+                images[i] = frame.dataFrame->toImage();
+            }
+        });
+        streams.push_back(std::move(stream));
+        pwStreams.push_back(std::move(pwStream));
+    }
+
+    QTRY_COMPARE(receivedCount, streamCount);
+    QCOMPARE(sceneViewCount(), initialSceneViewCount + 1);
+
+    for (std::optional<QImage> &image : images) {
+        QVERIFY(image);
+        image->convertTo(sourceImage.format());
+        QCOMPAREIMG(*image, sourceImage, QLatin1StringView("output_cast_shared"));
+    }
+
+    // Every change of the output is expected to be painted once, no matter how many streams show it
+    const auto paintCount = [output]() {
+        quint64 count = 0;
+        Plugin *plugin = kwinApp()->pluginManager()->plugin(QStringLiteral("screencast"));
+        QMetaObject::invokeMethod(plugin, "debugOutputPaintCount", Qt::DirectConnection, Q_RETURN_ARG(quint64, count), Q_ARG(QString, output->name()));
+        return count;
+    };
+    const QPoint center(sourceImage.width() / 2, sourceImage.height() / 2);
+    const QList<QColor> colors{Qt::red, Qt::blue, Qt::yellow};
+    const quint64 initialPaintCount = paintCount();
+    for (const QColor &color : colors) {
+        Test::render(window.m_surface.get(), sourceImage.size(), color);
+        QTRY_VERIFY(std::all_of(images.cbegin(), images.cend(), [center, color](const std::optional<QImage> &image) {
+            return image->pixelColor(center) == color;
+        }));
+    }
+    // A single stream renders the output directly into its buffers, so a keep-alive frame is painted too
+    QCOMPARE_GE(paintCount() - initialPaintCount, quint64(colors.size()));
+    QCOMPARE_LE(paintCount() - initialPaintCount, quint64(colors.size() + 1));
+
+    for (const auto &pwStream : pwStreams) {
+        pwStream->stopStreaming();
+    }
+
+    // The shared render goes away together with the last stream
+    streams.clear();
+    Test::flushWaylandConnection();
+    QTRY_COMPARE(sceneViewCount(), initialSceneViewCount);
+}
+
+void ScreencastingTest::testOutputCastingKeepAlive()
+{
+    // This test verifies that frames are still sent while the output doesn't change, that
+    // repaints which change nothing are not sent, that small changes are coalesced and that
+    // motion is not held back by the coalescing
+    auto theOutput = KWin::Test::waylandOutputs().constFirst();
+    LogicalOutput *output = workspace()->outputs().constFirst();
+
+    Test::XdgToplevelWindow window{[theOutput](Test::XdgToplevel *toplevel) {
+        toplevel->set_fullscreen(theOutput->output());
+    }};
+
+    QImage sourceImage(theOutput->pixelSize(), QImage::Format_RGBA8888_Premultiplied);
+    sourceImage.fill(Qt::green);
+    QVERIFY(window.show(sourceImage));
+    QVERIFY(window.presentWait());
+
+    std::unique_ptr<Test::ScreencastingStreamV1> stream(KWin::Test::screencasting()->createOutputStream(theOutput->output(), QtWayland::zkde_screencast_unstable_v1::pointer_hidden));
+    PipeWireSourceStream pwStream;
+    connect(stream.get(), &Test::ScreencastingStreamV1::created, qGuiApp, [&pwStream](quint64 serial) {
+        pwStream.createStream(serial, 0);
+    });
+
+    std::vector<QImage> images;
+    connect(&pwStream, &PipeWireSourceStream::frameReceived, qGuiApp, [&images](const PipeWireFrame &frame) {
+        if (frame.dataFrame) {
+            images.push_back(frame.dataFrame->toImage());
+        }
+    });
+
+    QTRY_VERIFY_WITH_TIMEOUT(images.size() >= 1, 5000);
+
+    // Request a frame callback with every commit, so the output keeps getting repainted but nothing
+    // in it changes. Only the keep-alive frames, one per second, are expected to be sent.
+    QElapsedTimer timer;
+    timer.start();
+    size_t frameCount = images.size();
+    QVariantMap statistics = outputStreamStatistics(output);
+    QVERIFY(!statistics.isEmpty());
+    while (timer.elapsed() < 2500) {
+        QSignalSpy frameRenderedSpy(window.m_surface.get(), &KWayland::Client::Surface::frameRendered);
+        window.m_surface->commit(KWayland::Client::Surface::CommitFlag::FrameCallback);
+        frameRenderedSpy.wait(100);
+    }
+    QCOMPARE_GE(images.size() - frameCount, 2u);
+    QCOMPARE_LE(images.size() - frameCount, 3u);
+
+    QVariantMap newStatistics = outputStreamStatistics(output);
+    QCOMPARE_GE(newStatistics[QStringLiteral("keepAliveFrames")].toULongLong() - statistics[QStringLiteral("keepAliveFrames")].toULongLong(), 2u);
+    QCOMPARE_GE(newStatistics[QStringLiteral("producedFrames")].toULongLong() - statistics[QStringLiteral("producedFrames")].toULongLong(), images.size() - frameCount);
+    QCOMPARE_GT(newStatistics[QStringLiteral("skippedFrames")].toULongLong(), statistics[QStringLiteral("skippedFrames")].toULongLong());
+
+    for (QImage &image : images) {
+        image.convertTo(sourceImage.format());
+        QCOMPAREIMG(image, sourceImage, QLatin1StringView("output_cast_keep_alive"));
+    }
+
+    // Change a small part of the output with every frame, the changes are expected to be
+    // coalesced into one frame per 100ms
+    std::unique_ptr<KWayland::Client::Surface> patchSurface = Test::createSurface();
+    std::unique_ptr<KWayland::Client::SubSurface> patchSubSurface = Test::createSubSurface(patchSurface.get(), window.m_surface.get());
+    patchSubSurface->setMode(KWayland::Client::SubSurface::Mode::Desynchronized);
+    Test::render(patchSurface.get(), QSize(10, 10), Qt::red);
+    window.m_surface->commit(KWayland::Client::Surface::CommitFlag::None);
+    QTRY_VERIFY_WITH_TIMEOUT(images.size() > frameCount, 5000);
+
+    timer.restart();
+    frameCount = images.size();
+    statistics = outputStreamStatistics(output);
+    for (int i = 0; timer.elapsed() < 1000; ++i) {
+        QSignalSpy frameRenderedSpy(patchSurface.get(), &KWayland::Client::Surface::frameRendered);
+        QImage patch(QSize(10, 10), QImage::Format_ARGB32_Premultiplied);
+        patch.fill(i % 2 ? Qt::red : Qt::blue);
+        patchSurface->attachBuffer(Test::waylandShmPool()->createBuffer(patch));
+        patchSurface->damage(patch.rect());
+        patchSurface->commit(KWayland::Client::Surface::CommitFlag::FrameCallback);
+        frameRenderedSpy.wait(100);
+    }
+    QCOMPARE_GE(images.size() - frameCount, 5u);
+    QCOMPARE_LE(images.size() - frameCount, 12u);
+
+    newStatistics = outputStreamStatistics(output);
+    QCOMPARE_GT(newStatistics[QStringLiteral("coalescedRequests")].toULongLong(), statistics[QStringLiteral("coalescedRequests")].toULongLong());
+
+    // A frame with a small change starts a coalescing interval. If the whole window changes while
+    // another small change is held back, the frame is expected to be sent without waiting for the
+    // end of the interval.
+    QTest::qWait(200);
+    frameCount = images.size();
+    Test::render(patchSurface.get(), QSize(10, 10), Qt::red);
+    QTRY_VERIFY_WITH_TIMEOUT(images.size() > frameCount, 5000);
+
+    const QPoint center(sourceImage.width() / 2, sourceImage.height() / 2);
+    std::optional<qint64> motionLatency;
+    connect(&pwStream, &PipeWireSourceStream::frameReceived, qGuiApp, [&timer, &motionLatency, center](const PipeWireFrame &frame) {
+        if (frame.dataFrame && !motionLatency) {
+            const QImage image = frame.dataFrame->toImage().convertToFormat(QImage::Format_RGBA8888_Premultiplied);
+            if (image.pixelColor(center) == QColor(Qt::blue)) {
+                motionLatency = timer.elapsed();
+            }
+        }
+    });
+    Test::render(patchSurface.get(), QSize(10, 10), Qt::green);
+    timer.restart();
+    Test::render(window.m_surface.get(), sourceImage.size(), Qt::blue);
+    QTRY_VERIFY_WITH_TIMEOUT(motionLatency.has_value(), 5000);
+    QCOMPARE_LT(*motionLatency, 75);
+
+    pwStream.stopStreaming();
+}
+
+void ScreencastingTest::testOutputCastingSmallStream()
+{
+    // This test verifies that a stream smaller than the output shows the whole output with its
+    // aspect ratio preserved, and that the unused part of the stream is blank
+    auto theOutput = KWin::Test::waylandOutputs().constFirst();
+
+    Test::XdgToplevelWindow window{[theOutput](Test::XdgToplevel *toplevel) {
+        toplevel->set_fullscreen(theOutput->output());
+    }};
+
+    const QSize outputSize = theOutput->pixelSize();
+    QImage sourceImage(outputSize, QImage::Format_RGBA8888_Premultiplied);
+    sourceImage.fill(Qt::green);
+    QVERIFY(window.show(sourceImage));
+    QVERIFY(window.presentWait());
+
+    // The stream is wider than the output, the output is scaled down to fit its height
+    const QSize streamSize(outputSize.width() / 2, outputSize.height() / 4);
+    std::unique_ptr<Test::ScreencastingStreamV1> stream(KWin::Test::screencasting()->createOutputStream(theOutput->output(), QtWayland::zkde_screencast_unstable_v1::pointer_hidden));
+    std::unique_ptr<SizedPipeWireStream> pwStream;
+    connect(stream.get(), &Test::ScreencastingStreamV1::created, qGuiApp, [&pwStream, streamSize](quint64 serial) {
+        pwStream = std::make_unique<SizedPipeWireStream>(serial, streamSize);
+    });
+    QTRY_VERIFY(pwStream);
+
+    QSignalSpy frameReceivedSpy(pwStream.get(), &SizedPipeWireStream::frameReceived);
+    QVERIFY(frameReceivedSpy.wait());
+    QImage image = frameReceivedSpy.last().at(0).value<QImage>();
+    QCOMPARE(image.size(), streamSize);
+
+    QImage expectedImage(streamSize, QImage::Format_ARGB32_Premultiplied);
+    expectedImage.fill(Qt::transparent);
+    QPainter painter(&expectedImage);
+    painter.fillRect(QRect(0, 0, outputSize.width() / 4, outputSize.height() / 4), Qt::green);
+    painter.end();
+    QCOMPAREIMG(image, expectedImage, QLatin1StringView("output_cast_small"));
+}
+
 WAYLANDTEST_MAIN(KWin::ScreencastingTest)
 #include "screencasting_test.moc"
@@ -0,0 +1,90 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "kwin_wayland_test.h"
+
+#include "backends/virtual/virtual_vulkan_backend.h"
+#include "compositor.h"
+#include "cursor.h"
+#include "effect/effecthandler.h"
+#include "vulkan/vulkan_texture.h"
+#include "wayland_server.h"
+#include "workspace.h"
+
+namespace KWin
+{
+
+class VulkanRendererTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanup();
+
+    void testWindow();
+};
+
+void VulkanRendererTest::initTestCase()
+{
+    qRegisterMetaType<Window *>();
+    qputenv("KWIN_COMPOSE", QByteArrayLiteral("V"));
+
+    QVERIFY(waylandServer()->init(qAppName()));
+    kwinApp()->start();
+
+    // The compositor falls back to OpenGL if there is no usable Vulkan device.
+    if (Compositor::self()->backend()->compositingType() != VulkanCompositing) {
+        QSKIP("Vulkan compositing is not supported on this device");
+    }
+
+    Test::setOutputConfig({
+        Rect(0, 0, 1280, 1024),
+    });
+
+    // make sure open/close effects don't get in the way
+    // of image comparisons
+    effects->unloadAllEffects();
+}
+
+void VulkanRendererTest::cleanup()
+{
+    Test::destroyWaylandConnection();
+}
+
+void VulkanRendererTest::testWindow()
+{
+    // this test verifies that a window is rendered with the vulkan renderer
+    QVERIFY(Test::setupWaylandConnection(Test::AdditionalWaylandInterface::PresentationTime));
+
+    LogicalOutput *output = workspace()->outputs().front();
+    Test::XdgToplevelWindow window;
+    QVERIFY(window.show(QSize(100, 50), Qt::red));
+    window.m_window->move(QPoint(10, 20));
+
+    Cursors::self()->hideCursor();
+
+    // render a few frames, to make sure every buffer of the swapchain is up to date
+    for (int i = 0; i < 3; i++) {
+        QVERIFY(window.presentWait());
+    }
+
+    const auto layer = static_cast<VirtualVulkanLayer *>(Compositor::self()->backend()->compatibleOutputLayers(output->backendOutput()).front());
+
+    QImage expected(QSize(1280, 1024), QImage::Format_RGB32);
+    expected.fill(Qt::black);
+    for (int y = 20; y < 70; y++) {
+        for (int x = 10; x < 110; x++) {
+            expected.setPixel(x, y, qRgb(255, 0, 0));
+        }
+    }
+    QCOMPARE(layer->texture()->download().convertToFormat(QImage::Format_RGB32), expected);
+}
+
+}
+
+WAYLANDTEST_MAIN(KWin::VulkanRendererTest)
+#include "vulkan_renderer_test.moc"
@@ -0,0 +1,199 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include "utils/damagejournal.h"
+
+using namespace KWin;
+
+class TestDamageJournal : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void empty();
+    void accumulate_data();
+    void accumulate();
+    void wrapAround();
+    void changingBufferAge();
+    void setCapacity();
+    void clear();
+    void deepQueryExpires();
+};
+
+/**
+ * Returns the damage region that is added to the journal for the given @a frame. Every frame
+ * damages a different area so missing or duplicate regions can be detected.
+ */
+static Region frameDamage(int frame)
+{
+    return Region(Rect(frame * 10, (frame % 3) * 10, 5, 5));
+}
+
+/**
+ * Returns the damage accumulated for the given @a bufferAge by re-uniting the damage regions
+ * of the last frames, i.e. the way the journal used to compute it.
+ */
+static Region expectedDamage(int lastFrame, int bufferAge)
+{
+    Region region;
+    for (int i = 0; i < bufferAge - 1; ++i) {
+        region += frameDamage(lastFrame - i);
+    }
+    return region;
+}
+
+void TestDamageJournal::empty()
+{
+    DamageJournal journal;
+    QCOMPARE(journal.accumulate(0, Region::infinite()), Region::infinite());
+    QCOMPARE(journal.accumulate(1, Region::infinite()), Region::infinite());
+    QCOMPARE(journal.accumulate(2, Region::infinite()), Region::infinite());
+}
+
+void TestDamageJournal::accumulate_data()
+{
+    QTest::addColumn<int>("bufferAge");
+
+    QTest::addRow("1") << 1;
+    QTest::addRow("2") << 2;
+    QTest::addRow("3") << 3;
+    QTest::addRow("4") << 4;
+}
+
+void TestDamageJournal::accumulate()
+{
+    QFETCH(int, bufferAge);
+
+    DamageJournal journal;
+    for (int frame = 0; frame < 30; ++frame) {
+        if (bufferAge <= frame) {
+            QCOMPARE(journal.accumulate(bufferAge, Region::infinite()), expectedDamage(frame - 1, bufferAge));
+        } else {
+            QCOMPARE(journal.accumulate(bufferAge, Region::infinite()), Region::infinite());
+        }
+
+        journal.add(frameDamage(frame));
+        QCOMPARE(journal.lastDamage(), frameDamage(frame));
+    }
+}
+
+void TestDamageJournal::wrapAround()
+{
+    DamageJournal journal;
+    journal.setCapacity(4);
+
+    for (int frame = 0; frame < 10; ++frame) {
+        journal.add(frameDamage(frame));
+    }
+
+    QCOMPARE(journal.accumulate(1), Region());
+    QCOMPARE(journal.accumulate(2), expectedDamage(9, 2));
+    QCOMPARE(journal.accumulate(3), expectedDamage(9, 3));
+    QCOMPARE(journal.accumulate(4), expectedDamage(9, 4));
+    QCOMPARE(journal.accumulate(5, Region::infinite()), Region::infinite());
+}
+
+void TestDamageJournal::changingBufferAge()
+{
+    // The buffer age can change from frame to frame, e.g. if the swapchain is reallocated or the
+    // compositor switches between direct scanout and composition.
+    const int bufferAges[] = {3, 3, 1, 4, 2, 4, 4, 0, 3, 5, 2, 3, 4, 4, 4};
+
+    DamageJournal journal;
+    journal.setCapacity(4);
+
+    int frame = 0;
+    for (; frame < 4; ++frame) {
+        journal.add(frameDamage(frame));
+    }
+
+    for (int bufferAge : bufferAges) {
+        const int lastFrame = frame - 1;
+        if (bufferAge > 0 && bufferAge <= 4) {
+            QCOMPARE(journal.accumulate(bufferAge, Region::infinite()), expectedDamage(lastFrame, bufferAge));
+        } else {
+            QCOMPARE(journal.accumulate(bufferAge, Region::infinite()), Region::infinite());
+        }
+
+        journal.add(frameDamage(frame));
+        ++frame;
+    }
+}
+
+void TestDamageJournal::setCapacity()
+{
+    DamageJournal journal;
+    journal.setCapacity(6);
+
+    for (int frame = 0; frame < 8; ++frame) {
+        journal.add(frameDamage(frame));
+    }
+    QCOMPARE(journal.accumulate(5), expectedDamage(7, 5));
+
+    journal.setCapacity(3);
+    QCOMPARE(journal.capacity(), 3);
+    QCOMPARE(journal.lastDamage(), frameDamage(7));
+    QCOMPARE(journal.accumulate(3), expectedDamage(7, 3));
+    QCOMPARE(journal.accumulate(4, Region::infinite()), Region::infinite());
+
+    journal.add(frameDamage(8));
+    QCOMPARE(journal.accumulate(3), expectedDamage(8, 3));
+
+    journal.setCapacity(5);
+    QCOMPARE(journal.accumulate(3), expectedDamage(8, 3));
+    QCOMPARE(journal.accumulate(4, Region::infinite()), Region::infinite());
+
+    journal.add(frameDamage(9));
+    journal.add(frameDamage(10));
+    QCOMPARE(journal.accumulate(5), expectedDamage(10, 5));
+}
+
+void TestDamageJournal::clear()
+{
+    DamageJournal journal;
+    for (int frame = 0; frame < 5; ++frame) {
+        journal.add(frameDamage(frame));
+    }
+    QCOMPARE(journal.accumulate(3), expectedDamage(4, 3));
+
+    journal.clear();
+    QCOMPARE(journal.accumulate(3, Region::infinite()), Region::infinite());
+
+    journal.add(frameDamage(5));
+    journal.add(frameDamage(6));
+    QCOMPARE(journal.accumulate(2), expectedDamage(6, 2));
+    QCOMPARE(journal.accumulate(3), expectedDamage(6, 3));
+}
+
+void TestDamageJournal::deepQueryExpires()
+{
+    // The accumulated damage of a one-off deep query is dropped after a while, but it can still
+    // be queried again afterwards.
+    DamageJournal journal;
+    journal.setCapacity(32);
+
+    int frame = 0;
+    for (; frame < 32; ++frame) {
+        journal.add(frameDamage(frame));
+    }
+    QCOMPARE(journal.accumulate(32), expectedDamage(frame - 1, 32));
+
+    for (int i = 0; i < 40; ++i, ++frame) {
+        journal.add(frameDamage(frame));
+        QCOMPARE(journal.accumulate(3), expectedDamage(frame, 3));
+    }
+
+    QCOMPARE(journal.accumulate(32), expectedDamage(frame - 1, 32));
+    journal.add(frameDamage(frame));
+    QCOMPARE(journal.accumulate(32), expectedDamage(frame, 32));
+    QCOMPARE(journal.accumulate(2), expectedDamage(frame, 2));
+}
+
+QTEST_MAIN(TestDamageJournal)
+
+#include "test_damagejournal.moc"
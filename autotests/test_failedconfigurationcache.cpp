@@ -0,0 +1,87 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include "utils/failedconfigurationcache.h"
+
+using namespace KWin;
+using namespace std::chrono_literals;
+
+class TestFailedConfigurationCache : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void notTestedAgain();
+    void retried();
+    void capped();
+    void cleared();
+};
+
+using Cache = FailedConfigurationCache<QString>;
+
+void TestFailedConfigurationCache::notTestedAgain()
+{
+    // this test verifies that a failed configuration is remembered, but other ones aren't
+    Cache cache;
+    const auto now = Cache::Clock::now();
+    QVERIFY(!cache.contains(QStringLiteral("overlay"), now));
+
+    cache.insert(QStringLiteral("overlay"), now);
+    QVERIFY(cache.contains(QStringLiteral("overlay"), now));
+    QVERIFY(cache.contains(QStringLiteral("overlay"), now + 1s));
+    QVERIFY(!cache.contains(QStringLiteral("underlay"), now));
+}
+
+void TestFailedConfigurationCache::retried()
+{
+    // this test verifies that a failed configuration is forgotten after the retry interval
+    Cache cache;
+    const auto now = Cache::Clock::now();
+    cache.insert(QStringLiteral("overlay"), now);
+
+    QVERIFY(cache.contains(QStringLiteral("overlay"), now + Cache::s_retryInterval - 1ms));
+    QVERIFY(!cache.contains(QStringLiteral("overlay"), now + Cache::s_retryInterval));
+    QCOMPARE(cache.size(), 0);
+
+    // a configuration that fails again is remembered again
+    cache.insert(QStringLiteral("overlay"), now + Cache::s_retryInterval);
+    QVERIFY(cache.contains(QStringLiteral("overlay"), now + Cache::s_retryInterval));
+}
+
+void TestFailedConfigurationCache::capped()
+{
+    // this test verifies that only the most recent failures are kept
+    Cache cache;
+    const auto now = Cache::Clock::now();
+    for (int i = 0; i < Cache::s_capacity + 1; ++i) {
+        cache.insert(QString::number(i), now);
+    }
+    QCOMPARE(cache.size(), Cache::s_capacity);
+    QVERIFY(!cache.contains(QString::number(0), now));
+    for (int i = 1; i < Cache::s_capacity + 1; ++i) {
+        QVERIFY(cache.contains(QString::number(i), now));
+    }
+}
+
+void TestFailedConfigurationCache::cleared()
+{
+    // this test verifies that the failures are forgotten when the outputs change
+    Cache cache;
+    const auto now = Cache::Clock::now();
+    cache.insert(QStringLiteral("overlay"), now);
+    cache.insert(QStringLiteral("underlay"), now);
+
+    cache.clear();
+    QCOMPARE(cache.size(), 0);
+    QVERIFY(!cache.contains(QStringLiteral("overlay"), now));
+    QVERIFY(!cache.contains(QStringLiteral("underlay"), now));
+}
+
+QTEST_GUILESS_MAIN(TestFailedConfigurationCache)
+
+#include "test_failedconfigurationcache.moc"
@@ -0,0 +1,156 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include "core/framestatistics.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace KWin;
+using namespace std::chrono_literals;
+
+class TestFrameStatistics : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void empty();
+    void add();
+    void since();
+    void wrapAround();
+    void concurrentReader();
+};
+
+/**
+ * Returns the statistics of the given @a frame. All timestamps are derived from the frame
+ * number so a torn record can be detected.
+ */
+static FrameStatistics frameStatistics(quint64 frame)
+{
+    const std::chrono::nanoseconds base = frame * 16'666'666ns;
+    return FrameStatistics{
+        .status = frame % 7 ? FrameStatistics::Status::Presented : FrameStatistics::Status::Dropped,
+        .presentationMode = frame % 2 ? PresentationMode::VSync : PresentationMode::AdaptiveSync,
+        .refreshDuration = 16'666'666ns,
+        .predictedRenderTime = 3ms,
+        .targetPresentationTimestamp = base + 16'666'666ns,
+        .prepareStart = base + 1ms,
+        .prepareEnd = base + 2ms,
+        .renderStart = base + 2ms,
+        .renderEnd = base + 5ms,
+        .commitTimestamp = base + 13ms,
+        .presentationTimestamp = base + 16'666'666ns,
+    };
+}
+
+static bool isConsistent(const FrameStatistics &statistics)
+{
+    const FrameStatistics expected = frameStatistics(statistics.sequence);
+    return statistics.status == expected.status
+        && statistics.presentationMode == expected.presentationMode
+        && statistics.refreshDuration == expected.refreshDuration
+        && statistics.predictedRenderTime == expected.predictedRenderTime
+        && statistics.targetPresentationTimestamp == expected.targetPresentationTimestamp
+        && statistics.prepareStart == expected.prepareStart
+        && statistics.prepareEnd == expected.prepareEnd
+        && statistics.renderStart == expected.renderStart
+        && statistics.renderEnd == expected.renderEnd
+        && statistics.commitTimestamp == expected.commitTimestamp
+        && statistics.presentationTimestamp == expected.presentationTimestamp;
+}
+
+void TestFrameStatistics::empty()
+{
+    FrameStatisticsRing ring;
+    QCOMPARE(ring.lastSequence(), quint64(0));
+    QVERIFY(ring.snapshot().isEmpty());
+}
+
+void TestFrameStatistics::add()
+{
+    FrameStatisticsRing ring(8);
+    for (quint64 frame = 1; frame <= 5; ++frame) {
+        QCOMPARE(ring.add(frameStatistics(frame)), frame);
+    }
+    QCOMPARE(ring.lastSequence(), quint64(5));
+
+    const QList<FrameStatistics> frames = ring.snapshot();
+    QCOMPARE(frames.size(), 5);
+    for (int i = 0; i < frames.size(); ++i) {
+        QCOMPARE(frames[i].sequence, quint64(i + 1));
+        QVERIFY(isConsistent(frames[i]));
+    }
+}
+
+void TestFrameStatistics::since()
+{
+    FrameStatisticsRing ring(8);
+    for (quint64 frame = 1; frame <= 5; ++frame) {
+        ring.add(frameStatistics(frame));
+    }
+
+    const QList<FrameStatistics> frames = ring.snapshot(3);
+    QCOMPARE(frames.size(), 2);
+    QCOMPARE(frames[0].sequence, quint64(4));
+    QCOMPARE(frames[1].sequence, quint64(5));
+
+    QVERIFY(ring.snapshot(5).isEmpty());
+    QVERIFY(ring.snapshot(10).isEmpty());
+}
+
+void TestFrameStatistics::wrapAround()
+{
+    FrameStatisticsRing ring(4);
+    for (quint64 frame = 1; frame <= 10; ++frame) {
+        ring.add(frameStatistics(frame));
+    }
+
+    const QList<FrameStatistics> frames = ring.snapshot();
+    QCOMPARE(frames.size(), 4);
+    for (int i = 0; i < frames.size(); ++i) {
+        QCOMPARE(frames[i].sequence, quint64(7 + i));
+        QVERIFY(isConsistent(frames[i]));
+    }
+
+    // Frames that have been overwritten are not returned.
+    QCOMPARE(ring.snapshot(2).size(), 4);
+}
+
+void TestFrameStatistics::concurrentReader()
+{
+    FrameStatisticsRing ring(16);
+    std::atomic<bool> done = false;
+
+    std::thread writer([&ring, &done]() {
+        for (quint64 frame = 1; frame <= 200'000; ++frame) {
+            ring.add(frameStatistics(frame));
+        }
+        done = true;
+    });
+
+    quint64 lastSeen = 0;
+    bool consistent = true;
+    bool ordered = true;
+    while (!done) {
+        const QList<FrameStatistics> frames = ring.snapshot(lastSeen);
+        for (const FrameStatistics &statistics : frames) {
+            consistent &= isConsistent(statistics);
+            ordered &= statistics.sequence > lastSeen;
+            lastSeen = statistics.sequence;
+        }
+    }
+    writer.join();
+
+    QVERIFY(consistent);
+    QVERIFY(ordered);
+    QCOMPARE(ring.lastSequence(), quint64(200'000));
+}
+
+QTEST_MAIN(TestFrameStatistics)
+
+#include "test_framestatistics.moc"
@@ -0,0 +1,226 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QRandomGenerator>
+#include <QTest>
+
+#include "scene/software/pixelkernels.h"
+
+using namespace KWin;
+
+Q_DECLARE_METATYPE(KWin::PixelKernelIsa)
+
+static quint32 randomPremultipliedPixel(QRandomGenerator &generator)
+{
+    const int alpha = generator.bounded(256);
+    return qRgba(generator.bounded(alpha + 1), generator.bounded(alpha + 1), generator.bounded(alpha + 1), alpha);
+}
+
+static QList<quint32> randomRow(QRandomGenerator &generator, int count)
+{
+    QList<quint32> row(count);
+    for (quint32 &pixel : row) {
+        pixel = randomPremultipliedPixel(generator);
+    }
+    return row;
+}
+
+class TestPixelKernels : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void cleanup();
+
+    void blendPixel_data();
+    void blendPixel();
+    void modulation_data();
+    void modulation();
+    void blendRow_data();
+    void blendRow();
+    void scaleRow_data();
+    void scaleRow();
+    void sampleBilinear();
+};
+
+void TestPixelKernels::cleanup()
+{
+    setPixelKernelIsa(bestPixelKernelIsa());
+}
+
+void TestPixelKernels::blendPixel_data()
+{
+    QTest::addColumn<quint32>("dst");
+    QTest::addColumn<quint32>("src");
+    QTest::addColumn<quint32>("expected");
+
+    QTest::addRow("transparent over white") << 0xffffffffu << 0x00000000u << 0xffffffffu;
+    QTest::addRow("opaque over white") << 0xffffffffu << 0xff102030u << 0xff102030u;
+    QTest::addRow("translucent over white") << 0xffffffffu << 0x80402010u << 0xffbf9f8fu;
+    QTest::addRow("translucent over transparent") << 0x00000000u << 0x80402010u << 0x80402010u;
+    QTest::addRow("translucent over translucent") << 0x80808080u << 0x80808080u << 0xc0c0c0c0u;
+}
+
+void TestPixelKernels::blendPixel()
+{
+    QFETCH(quint32, dst);
+    QFETCH(quint32, src);
+
+    blendRow(&dst, &src, 1, false, PixelModulation{});
+    QTEST(dst, "expected");
+}
+
+void TestPixelKernels::modulation_data()
+{
+    QTest::addColumn<qreal>("opacity");
+    QTest::addColumn<qreal>("brightness");
+    QTest::addColumn<int>("color");
+    QTest::addColumn<int>("alpha");
+
+    QTest::addRow("identity") << 1.0 << 1.0 << 256 << 256;
+    QTest::addRow("half opacity") << 0.5 << 1.0 << 128 << 128;
+    QTest::addRow("half brightness") << 1.0 << 0.5 << 128 << 256;
+    QTest::addRow("transparent") << 0.0 << 1.0 << 0 << 0;
+    QTest::addRow("brightened") << 1.0 << 2.0 << 256 << 256;
+}
+
+void TestPixelKernels::modulation()
+{
+    QFETCH(qreal, opacity);
+    QFETCH(qreal, brightness);
+
+    const PixelModulation modulation = PixelModulation::fromOpacity(opacity, brightness);
+    QTEST(modulation.color, "color");
+    QTEST(modulation.alpha, "alpha");
+}
+
+void TestPixelKernels::blendRow_data()
+{
+    QTest::addColumn<PixelKernelIsa>("isa");
+    QTest::addColumn<bool>("opaque");
+    QTest::addColumn<qreal>("opacity");
+
+    const struct
+    {
+        const char *name;
+        PixelKernelIsa isa;
+    } isas[] = {
+        {"sse2", PixelKernelIsa::Sse2},
+        {"avx2", PixelKernelIsa::Avx2},
+    };
+
+    for (const auto &isa : isas) {
+        QTest::addRow("%s - translucent", isa.name) << isa.isa << false << 1.0;
+        QTest::addRow("%s - opaque", isa.name) << isa.isa << true << 1.0;
+        QTest::addRow("%s - translucent - modulated", isa.name) << isa.isa << false << 0.7;
+        QTest::addRow("%s - opaque - modulated", isa.name) << isa.isa << true << 0.3;
+    }
+}
+
+void TestPixelKernels::blendRow()
+{
+    QFETCH(PixelKernelIsa, isa);
+    QFETCH(bool, opaque);
+    QFETCH(qreal, opacity);
+
+    setPixelKernelIsa(isa);
+    if (pixelKernelIsa() != isa) {
+        QSKIP("The instruction set is not supported by the CPU");
+    }
+
+    const PixelModulation modulation = PixelModulation::fromOpacity(opacity, 0.9);
+    QRandomGenerator generator(42);
+
+    // Odd sizes exercise the scalar tails of the vectorized kernels.
+    for (int count : {1, 3, 7, 8, 15, 16, 33, 1023}) {
+        const QList<quint32> src = randomRow(generator, count);
+        const QList<quint32> dst = randomRow(generator, count);
+
+        QList<quint32> expected = dst;
+        setPixelKernelIsa(PixelKernelIsa::Scalar);
+        KWin::blendRow(expected.data(), src.constData(), count, opaque, modulation);
+
+        QList<quint32> actual = dst;
+        setPixelKernelIsa(isa);
+        KWin::blendRow(actual.data(), src.constData(), count, opaque, modulation);
+
+        QCOMPARE(actual, expected);
+    }
+}
+
+void TestPixelKernels::scaleRow_data()
+{
+    QTest::addColumn<PixelKernelIsa>("isa");
+    QTest::addColumn<qint32>("u");
+    QTest::addColumn<qint32>("du");
+
+    const struct
+    {
+        const char *name;
+        PixelKernelIsa isa;
+    } isas[] = {
+        {"sse2", PixelKernelIsa::Sse2},
+        {"avx2", PixelKernelIsa::Avx2},
+    };
+
+    for (const auto &isa : isas) {
+        QTest::addRow("%s - upscale", isa.name) << isa.isa << qint32(-32768) << qint32(65536 * 2 / 3);
+        QTest::addRow("%s - downscale", isa.name) << isa.isa << qint32(16384) << qint32(65536 * 3 / 2);
+        QTest::addRow("%s - out of bounds", isa.name) << isa.isa << qint32(-65536 * 4) << qint32(65536 * 5 / 4);
+    }
+}
+
+void TestPixelKernels::scaleRow()
+{
+    QFETCH(PixelKernelIsa, isa);
+    QFETCH(qint32, u);
+    QFETCH(qint32, du);
+
+    setPixelKernelIsa(isa);
+    if (pixelKernelIsa() != isa) {
+        QSKIP("The instruction set is not supported by the CPU");
+    }
+
+    QRandomGenerator generator(7);
+    const int width = 64;
+    const QList<quint32> top = randomRow(generator, width);
+    const QList<quint32> bottom = randomRow(generator, width);
+
+    for (int count : {1, 5, 8, 13, 64}) {
+        for (int weight : {0, 100, 256}) {
+            QList<quint32> expected(count);
+            setPixelKernelIsa(PixelKernelIsa::Scalar);
+            KWin::scaleRow(expected.data(), count, top.constData(), bottom.constData(), weight, u, du, 0, width - 1);
+
+            QList<quint32> actual(count);
+            setPixelKernelIsa(isa);
+            KWin::scaleRow(actual.data(), count, top.constData(), bottom.constData(), weight, u, du, 0, width - 1);
+
+            QCOMPARE(actual, expected);
+        }
+    }
+}
+
+void TestPixelKernels::sampleBilinear()
+{
+    const quint32 pixels[] = {
+        0xff000000, 0xffffffff,
+        0xffffffff, 0xff000000};
+    const auto bits = reinterpret_cast<const uchar *>(pixels);
+    const qsizetype stride = 2 * sizeof(quint32);
+
+    QCOMPARE(KWin::sampleBilinear(bits, stride, 0, 0, 0, 0, 1, 1), 0xff000000u);
+    QCOMPARE(KWin::sampleBilinear(bits, stride, 1, 0, 0, 0, 1, 1), 0xffffffffu);
+    QCOMPARE(KWin::sampleBilinear(bits, stride, 0.5, 0.5, 0, 0, 1, 1), 0xff7f7f7fu);
+
+    // The texel coordinates are clamped to the edges.
+    QCOMPARE(KWin::sampleBilinear(bits, stride, -3, -3, 0, 0, 1, 1), 0xff000000u);
+    QCOMPARE(KWin::sampleBilinear(bits, stride, 10, 0, 0, 0, 1, 1), 0xffffffffu);
+}
+
+QTEST_MAIN(TestPixelKernels)
+
+#include "test_pixelkernels.moc"
@@ -4,9 +4,11 @@
     SPDX-License-Identifier: LGPL-2.0-or-later
 */
 
+#include <QRandomGenerator>
 #include <QTest>
 
 #include "core/region.h"
+#include "core/region_p.h"
 
 using namespace KWin;
 
@@ -174,6 +176,31 @@ static QSize testGridSize()
     return QSize(text.left(x).toInt(), text.mid(x + 1).toInt());
 }
 
+/**
+ * Returns a region with lines of fractional glyph sized rectangles, so the bands are long enough
+ * for the vectorized band kernels to process several rectangles at a time.
+ */
+static RegionF randomRegion(quint32 seed)
+{
+    QRandomGenerator generator(seed);
+
+    QList<RectF> rects;
+    const int lineCount = generator.bounded(1, 8);
+    for (int line = 0; line < lineCount; ++line) {
+        const qreal y = line * 12.5 + generator.bounded(4) * 0.25;
+        const qreal height = 8 + generator.bounded(8) * 0.5;
+        qreal x = generator.bounded(16) * 0.75;
+        const int glyphCount = generator.bounded(1, 24);
+        for (int glyph = 0; glyph < glyphCount; ++glyph) {
+            const qreal width = 1 + generator.bounded(12) * 0.5;
+            rects.append(RectF(x, y, width, height));
+            x += width + generator.bounded(1, 8) * 0.25;
+        }
+    }
+
+    return RegionF::fromUnsortedRects(rects);
+}
+
 class TestRegionF : public QObject
 {
     Q_OBJECT
@@ -216,6 +243,8 @@ private Q_SLOTS:
     void roundedOut();
     void grownBy_data();
     void grownBy();
+    void simdMatchesScalar_data();
+    void simdMatchesScalar();
 
 private:
     const QSize gridSize = testGridSize();
@@ -723,6 +752,67 @@ void TestRegionF::grownBy()
     QTEST(region.grownBy(margins), "expected");
 }
 
+void TestRegionF::simdMatchesScalar_data()
+{
+    QTest::addColumn<int>("isa");
+
+    QTest::addRow("sse4.1") << int(RegionIsa::Sse41);
+    QTest::addRow("avx2") << int(RegionIsa::Avx2);
+}
+
+void TestRegionF::simdMatchesScalar()
+{
+    QFETCH(int, isa);
+    if (RegionIsa(isa) > bestRegionIsa()) {
+        QSKIP("The instruction set is not supported by the CPU");
+    }
+
+    struct Result
+    {
+        RegionF united;
+        RegionF subtracted;
+        RegionF intersected;
+        RegionF xored;
+        bool intersects;
+        QList<bool> contains;
+    };
+
+    const auto compute = [](const RegionF &left, const RegionF &right) {
+        Result result{
+            .united = left | right,
+            .subtracted = left - right,
+            .intersected = left & right,
+            .xored = left ^ right,
+            .intersects = left.intersects(right),
+        };
+        for (qreal y = 0; y < 100; y += 3.3) {
+            for (qreal x = 0; x < 100; x += 1.7) {
+                result.contains.append(left.contains(QPointF(x, y)));
+            }
+        }
+        return result;
+    };
+
+    for (quint32 seed = 0; seed < 64; ++seed) {
+        const RegionF left = randomRegion(seed * 2);
+        const RegionF right = randomRegion(seed * 2 + 1).translated(QPointF(seed * 0.25, seed * 0.5));
+
+        setRegionIsa(RegionIsa::Scalar);
+        const Result expected = compute(left, right);
+
+        setRegionIsa(RegionIsa(isa));
+        const Result actual = compute(left, right);
+        setRegionIsa(bestRegionIsa());
+
+        QCOMPARE(actual.united, expected.united);
+        QCOMPARE(actual.subtracted, expected.subtracted);
+        QCOMPARE(actual.intersected, expected.intersected);
+        QCOMPARE(actual.xored, expected.xored);
+        QCOMPARE(actual.intersects, expected.intersects);
+        QCOMPARE(actual.contains, expected.contains);
+    }
+}
+
 QTEST_MAIN(TestRegionF)
 
 #include "test_regionf.moc"
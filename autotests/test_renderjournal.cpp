@@ -0,0 +1,218 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QRandomGenerator>
+#include <QTest>
+
+#include "core/renderjournal.h"
+
+using namespace KWin;
+using namespace std::chrono_literals;
+
+class TestRenderJournal : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void percentile_data();
+    void percentile();
+    void overflow();
+    void slidingWindow();
+    void expiredSamples();
+    void traces_data();
+    void traces();
+};
+
+enum class Trace {
+    Steady,
+    Blur,
+    FrequentBlur,
+    Ramp,
+    Spikes,
+};
+
+static std::chrono::nanoseconds jitter(QRandomGenerator &generator, std::chrono::nanoseconds amount)
+{
+    return std::chrono::nanoseconds(generator.bounded(qint64(amount.count() * 2))) - amount;
+}
+
+/**
+ * Returns render times shaped after the ones recorded with KWIN_LOG_PERFORMANCE_DATA on a
+ * 60Hz output. The generators are seeded so that every run operates on the same data.
+ */
+static QList<std::chrono::nanoseconds> renderTimes(Trace trace)
+{
+    QRandomGenerator generator(42);
+
+    QList<std::chrono::nanoseconds> times;
+    for (int frame = 0; frame < 3000; ++frame) {
+        switch (trace) {
+        case Trace::Steady:
+            // a terminal or a text editor
+            times.append(3ms + jitter(generator, 300us));
+            break;
+        case Trace::Blur:
+            // cheap frames with an occasional blur heavy frame, e.g. a translucent popup
+            times.append((generator.bounded(100) < 4 ? 11ms : 3ms) + jitter(generator, 300us));
+            break;
+        case Trace::FrequentBlur:
+            times.append((generator.bounded(100) < 20 ? 11ms : 3ms) + jitter(generator, 300us));
+            break;
+        case Trace::Ramp:
+            // a window that gradually covers more and more of the screen
+            times.append(2ms + 6ms * frame / 3000 + jitter(generator, 300us));
+            break;
+        case Trace::Spikes:
+            // rare stalls, e.g. shader compilation or texture uploads
+            times.append((generator.bounded(1000) < 3 ? 60ms : 4ms) + jitter(generator, 500us));
+            break;
+        }
+    }
+    return times;
+}
+
+void TestRenderJournal::percentile_data()
+{
+    QTest::addColumn<double>("percentile");
+    QTest::addColumn<std::chrono::nanoseconds>("expected");
+
+    QTest::addRow("p50") << 0.5 << std::chrono::nanoseconds(5ms);
+    QTest::addRow("p90") << 0.9 << std::chrono::nanoseconds(9ms);
+    QTest::addRow("p95") << 0.95 << std::chrono::nanoseconds(10ms);
+    QTest::addRow("p100") << 1.0 << std::chrono::nanoseconds(10ms);
+}
+
+void TestRenderJournal::percentile()
+{
+    QFETCH(double, percentile);
+    QFETCH(std::chrono::nanoseconds, expected);
+
+    RenderJournal journal(RenderJournal::Predictor::Percentile, percentile, 10);
+    QCOMPARE(journal.result(), 0ns);
+
+    // The render times are in the middle of the histogram buckets, so the prediction is
+    // rounded up to the end of the bucket.
+    for (int i = 1; i <= 10; ++i) {
+        journal.add(i * 1ms - 50us, i * 16ms);
+    }
+    QCOMPARE(journal.result(), expected);
+}
+
+void TestRenderJournal::overflow()
+{
+    RenderJournal journal(RenderJournal::Predictor::Percentile, 0.9, 10);
+    for (int i = 0; i < 8; ++i) {
+        journal.add(2ms, i * 16ms);
+    }
+    journal.add(70ms, 8 * 16ms);
+    journal.add(80ms, 9 * 16ms);
+
+    // Render times that don't fit in the histogram are reported as is.
+    QCOMPARE(journal.result(), std::chrono::nanoseconds(70ms));
+}
+
+void TestRenderJournal::slidingWindow()
+{
+    RenderJournal journal(RenderJournal::Predictor::Percentile, 1.0, 10);
+    journal.add(20ms - 50us, 0ms);
+    for (int i = 1; i < 10; ++i) {
+        journal.add(2ms - 50us, i * 16ms);
+    }
+    QCOMPARE(journal.result(), std::chrono::nanoseconds(20ms));
+
+    // Once the expensive frame leaves the window, it shouldn't affect the prediction anymore.
+    journal.add(2ms - 50us, 10 * 16ms);
+    QCOMPARE(journal.result(), std::chrono::nanoseconds(2ms));
+}
+
+void TestRenderJournal::expiredSamples()
+{
+    RenderJournal journal(RenderJournal::Predictor::Percentile, 1.0, 120);
+    for (int i = 0; i < 60; ++i) {
+        journal.add(20ms - 50us, i * 16ms);
+    }
+    QCOMPARE(journal.result(), std::chrono::nanoseconds(20ms));
+
+    // After an idle period, the frames from before it shouldn't affect the prediction even
+    // though the window isn't full.
+    journal.add(2ms - 50us, 5s);
+    QCOMPARE(journal.result(), std::chrono::nanoseconds(2ms));
+
+    // Without an idle period, old frames drop out after a while too.
+    for (int i = 1; i < 60; ++i) {
+        journal.add(20ms - 50us, 5s + i * 16ms);
+    }
+    QCOMPARE(journal.result(), std::chrono::nanoseconds(20ms));
+    for (int i = 0; i < 60; ++i) {
+        journal.add(2ms - 50us, 6s + i * 50ms);
+    }
+    QCOMPARE(journal.result(), std::chrono::nanoseconds(2ms));
+}
+
+void TestRenderJournal::traces_data()
+{
+    QTest::addColumn<int>("trace");
+    QTest::addColumn<int>("predictor");
+    QTest::addColumn<double>("percentile");
+    QTest::addColumn<double>("maximumMissRate");
+
+    const struct
+    {
+        const char *name;
+        Trace trace;
+    } traces[] = {
+        {"steady", Trace::Steady},
+        {"blur", Trace::Blur},
+        {"frequent blur", Trace::FrequentBlur},
+        {"ramp", Trace::Ramp},
+        {"spikes", Trace::Spikes},
+    };
+
+    for (const auto &trace : traces) {
+        QTest::addRow("%s - smoothed", trace.name) << int(trace.trace) << int(RenderJournal::Predictor::Smoothed) << 0.0 << 1.0;
+        QTest::addRow("%s - p95", trace.name) << int(trace.trace) << int(RenderJournal::Predictor::Percentile) << 0.95 << 0.08;
+        QTest::addRow("%s - p99", trace.name) << int(trace.trace) << int(RenderJournal::Predictor::Percentile) << 0.99 << 0.04;
+    }
+}
+
+void TestRenderJournal::traces()
+{
+    QFETCH(int, trace);
+    QFETCH(int, predictor);
+    QFETCH(double, percentile);
+    QFETCH(double, maximumMissRate);
+
+    const QList<std::chrono::nanoseconds> times = renderTimes(Trace(trace));
+    RenderJournal journal(RenderJournal::Predictor(predictor), percentile);
+
+    // The first frames only warm up the journal.
+    const int warmup = 200;
+    int misses = 0;
+    std::chrono::nanoseconds slack = 0ns;
+    for (int frame = 0; frame < times.size(); ++frame) {
+        const auto predicted = journal.result();
+        const auto actual = times[frame];
+        if (frame >= warmup) {
+            if (actual > predicted) {
+                misses++;
+            } else {
+                slack += predicted - actual;
+            }
+        }
+        journal.add(actual, frame * 16'666'667ns);
+    }
+
+    const int measured = times.size() - warmup;
+    const double missRate = misses / double(measured);
+    const double averageSlack = std::chrono::duration<double, std::milli>(slack).count() / (measured - misses);
+    qInfo("miss rate: %.2f%%, average slack: %.2fms", missRate * 100, averageSlack);
+
+    QVERIFY(missRate <= maximumMissRate);
+}
+
+QTEST_MAIN(TestRenderJournal)
+
+#include "test_renderjournal.moc"
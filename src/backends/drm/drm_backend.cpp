@@ -20,6 +20,7 @@
 #include "drm_logging.h"
 #include "drm_output.h"
 #include "drm_pipeline.h"
+#include "drm_qpainter_backend.h"
 #include "drm_render_backend.h"
 #include "drm_virtual_output.h"
 #include "utils/envvar.h"
@@ -264,9 +265,14 @@ std::unique_ptr<EglBackend> DrmBackend::createOpenGLBackend(RenderDevice *device
     return std::make_unique<EglGbmBackend>(this, device);
 }
 
+std::unique_ptr<QPainterBackend> DrmBackend::createQPainterBackend()
+{
+    return std::make_unique<DrmQPainterBackend>(this);
+}
+
 QList<CompositingType> DrmBackend::supportedCompositors() const
 {
-    return QList<CompositingType>{OpenGLCompositing};
+    return QList<CompositingType>{OpenGLCompositing, QPainterCompositing};
 }
 
 QString DrmBackend::supportInformation() const
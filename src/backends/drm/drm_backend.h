@@ -40,6 +40,7 @@ public:
 
     std::unique_ptr<InputBackend> createInputBackend() override;
     std::unique_ptr<EglBackend> createOpenGLBackend(RenderDevice *device) override;
+    std::unique_ptr<QPainterBackend> createQPainterBackend() override;
 
     bool initialize() override;
 
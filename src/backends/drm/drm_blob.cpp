@@ -32,9 +32,17 @@ uint32_t DrmBlob::blobId() const
 
 std::shared_ptr<DrmBlob> DrmBlob::create(DrmGpu *gpu, const void *data, uint32_t dataSize)
 {
+    // reusing blobs with the same content keeps the blob id of the property the same,
+    // so that the property doesn't have to be part of the next commit
+    const QByteArray content(static_cast<const char *>(data), dataSize);
+    if (auto blob = gpu->findBlob(content)) {
+        return blob;
+    }
     uint32_t id = 0;
     if (drmModeCreatePropertyBlob(gpu->fd(), data, dataSize, &id) == 0) {
-        return std::make_shared<DrmBlob>(gpu, id);
+        auto blob = std::make_shared<DrmBlob>(gpu, id);
+        gpu->addBlob(content, blob);
+        return blob;
     } else {
         return nullptr;
     }
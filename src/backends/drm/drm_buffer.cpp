@@ -90,6 +90,22 @@ const FileDescriptor &DrmFramebuffer::syncFd() const
     return m_syncFd;
 }
 
+std::vector<int> DrmFramebuffer::readFences() const
+{
+    if (m_syncFd.isValid()) {
+        return {m_syncFd.get()};
+    }
+    std::vector<int> ret;
+    if (m_bufferRef && m_bufferRef->dmabufAttributes()) {
+        for (const auto &fd : m_bufferRef->dmabufAttributes()->fd) {
+            if (fd.isValid()) {
+                ret.push_back(fd.get());
+            }
+        }
+    }
+    return ret;
+}
+
 bool DrmFramebuffer::isReadable()
 {
     if (m_readable) {
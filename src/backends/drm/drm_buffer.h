@@ -14,6 +14,7 @@
 
 #include <QPointer>
 #include <chrono>
+#include <vector>
 
 namespace KWin
 {
@@ -47,6 +48,10 @@ public:
     bool isReadable();
 
     const FileDescriptor &syncFd() const;
+    /**
+     * @returns the file descriptors that become readable once the buffer is readable
+     */
+    std::vector<int> readFences() const;
     void setDeadline(std::chrono::steady_clock::time_point deadline);
 
     std::shared_ptr<DrmFramebufferData> data() const;
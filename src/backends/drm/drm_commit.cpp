@@ -14,6 +14,7 @@
 #include "drm_crtc.h"
 #include "drm_gpu.h"
 #include "drm_object.h"
+#include "drm_plane.h"
 #include "drm_property.h"
 
 #include <QCoreApplication>
@@ -58,7 +59,7 @@ void DrmAtomicCommit::addProperty(const DrmProperty &prop, uint64_t value)
         return;
     }
     prop.checkValueInRange(value);
-    m_properties[prop.drmObject()->id()][prop.propId()] = value;
+    m_properties[prop.drmObject()->id()][&prop] = value;
 }
 
 void DrmAtomicCommit::addBlob(const DrmProperty &prop, const std::shared_ptr<DrmBlob> &blob)
@@ -130,24 +131,29 @@ bool DrmAtomicCommit::commitModeset()
 
 bool DrmAtomicCommit::doCommit(uint32_t flags)
 {
+    // Presentation commits only need to contain what changed since the last commit. Tests
+    // can run while other commits are still in flight and modesets replace the whole state,
+    // so those always contain all properties
+    const bool onlyChanges = !(flags & (DRM_MODE_ATOMIC_TEST_ONLY | DRM_MODE_ATOMIC_ALLOW_MODESET));
     std::vector<uint32_t> objects;
     std::vector<uint32_t> propertyCounts;
     std::vector<uint32_t> propertyIds;
     std::vector<uint64_t> values;
     objects.reserve(m_properties.size());
     propertyCounts.reserve(m_properties.size());
-    uint64_t totalPropertiesCount = 0;
-    for (const auto &[object, properties] : m_properties) {
-        objects.push_back(object);
-        propertyCounts.push_back(properties.size());
-        totalPropertiesCount += properties.size();
-    }
-    propertyIds.reserve(totalPropertiesCount);
-    values.reserve(totalPropertiesCount);
     for (const auto &[object, properties] : m_properties) {
+        uint32_t count = 0;
         for (const auto &[property, value] : properties) {
-            propertyIds.push_back(property);
+            if (onlyChanges && property->committedValue() == value && !isPerCommitProperty(object, property)) {
+                continue;
+            }
+            propertyIds.push_back(property->propId());
             values.push_back(value);
+            count++;
+        }
+        if (count > 0) {
+            objects.push_back(object);
+            propertyCounts.push_back(count);
         }
     }
     drm_mode_atomic commitData{
@@ -165,12 +171,39 @@ bool DrmAtomicCommit::doCommit(uint32_t flags)
         lock = m_gpu->lockPendingCommits();
     }
     const bool success = drmIoctl(m_gpu->fd(), DRM_IOCTL_MODE_ATOMIC, &commitData) == 0;
+    if (success && !(flags & DRM_MODE_ATOMIC_TEST_ONLY)) {
+        for (const auto &[object, properties] : m_properties) {
+            for (const auto &[property, value] : properties) {
+                property->setCommittedValue(value);
+            }
+        }
+    }
     if (success && (flags & DRM_MODE_PAGE_FLIP_EVENT)) {
+        // the pageflip event can't be processed while the lock is held,
+        // so the frames are guaranteed to be alive here
+        const auto commitTime = std::chrono::steady_clock::now();
+        for (const auto &[plane, frame] : m_frames) {
+            if (frame) {
+                frame->setCommitTime(commitTime);
+            }
+        }
         m_gpu->registerPendingCommit(lock, *m_crtc, this);
     }
     return success;
 }
 
+bool DrmAtomicCommit::isPerCommitProperty(uint32_t object, const DrmProperty *property) const
+{
+    if (m_crtc == object) {
+        // the crtc has to be in the commit for the pageflip event
+        return true;
+    }
+    // these apply to the commit they're in, not to the state of the plane
+    return std::ranges::any_of(m_planes, [property](const DrmPlane *plane) {
+        return property == &plane->fbId || property == &plane->inFenceFd || property == &plane->fbDamage;
+    });
+}
+
 void DrmAtomicCommit::pageFlipped(std::chrono::nanoseconds timestamp)
 {
     Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
@@ -208,6 +241,17 @@ bool DrmAtomicCommit::areBuffersReadable() const
     });
 }
 
+std::vector<int> DrmAtomicCommit::unreadableBufferFences() const
+{
+    std::vector<int> ret;
+    for (const auto &[plane, buffer] : m_buffers) {
+        if (buffer && !buffer->isReadable()) {
+            std::ranges::copy(buffer->readFences(), std::back_inserter(ret));
+        }
+    }
+    return ret;
+}
+
 void DrmAtomicCommit::setDeadline(std::chrono::steady_clock::time_point deadline)
 {
     for (const auto &[plane, buffer] : m_buffers) {
@@ -322,6 +366,9 @@ bool DrmLegacyCommit::doPageflip(PresentationMode mode)
     auto lock = gpu()->lockPendingCommits();
     const bool success = drmModePageFlip(gpu()->fd(), m_crtc->id(), m_buffer->framebufferId(), flags, gpu()) == 0;
     if (success) {
+        if (m_frame) {
+            m_frame->setCommitTime(std::chrono::steady_clock::now());
+        }
         gpu()->registerPendingCommit(lock, m_crtc->id(), this);
     }
     return success;
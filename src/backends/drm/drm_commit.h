@@ -15,6 +15,7 @@
 #include <chrono>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "core/renderloop.h"
 #include "drm_pointer.h"
@@ -75,6 +76,10 @@ public:
     void pageFlipped(std::chrono::nanoseconds timestamp) override;
 
     bool areBuffersReadable() const;
+    /**
+     * @returns the file descriptors to wait on until the buffers that aren't readable yet are
+     */
+    std::vector<int> unreadableBufferFences() const;
     void setDeadline(std::chrono::steady_clock::time_point deadline);
     std::optional<bool> isVrr() const;
     const std::unordered_set<DrmPlane *> &modifiedPlanes() const;
@@ -96,6 +101,7 @@ public:
 
 private:
     bool doCommit(uint32_t flags);
+    bool isPerCommitProperty(uint32_t object, const DrmProperty *property) const;
 
     const QList<DrmPipeline *> m_pipelines;
     std::optional<std::chrono::steady_clock::time_point> m_targetPageflipTime;
@@ -105,7 +111,7 @@ private:
     std::unordered_map<DrmPlane *, std::shared_ptr<OutputFrame>> m_frames;
     std::unordered_set<DrmPlane *> m_planes;
     std::optional<bool> m_vrr;
-    std::unordered_map<uint32_t /* object */, std::unordered_map<uint32_t /* property */, uint64_t /* value */>> m_properties;
+    std::unordered_map<uint32_t /* object */, std::unordered_map<const DrmProperty *, uint64_t /* value */>> m_properties;
     bool m_modeset = false;
     std::optional<uint32_t> m_crtc;
     PresentationMode m_mode = PresentationMode::VSync;
@@ -13,15 +13,30 @@
 #include "utils/envvar.h"
 #include "utils/realtime.h"
 
+#include <array>
 #include <ranges>
 #include <span>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
 #include <thread>
+#include <unistd.h>
 
 using namespace std::chrono_literals;
 
 namespace KWin
 {
 
+/**
+ * How long the thread waits for buffer fences at most without a deadline, so that fences
+ * that never signal, e.g. because of a GPU hang, don't stall the thread.
+ */
+static constexpr std::chrono::milliseconds s_maxFenceWait = 100ms;
+/**
+ * How often fences that can't be added to the epoll set are polled instead.
+ */
+static constexpr std::chrono::milliseconds s_fencePollInterval = 1ms;
+
 DrmCommitThread::DrmCommitThread(DrmGpu *gpu, const QString &name)
     : m_gpu(gpu)
     , m_targetPageflipTime(std::chrono::steady_clock::now())
@@ -30,6 +45,22 @@ DrmCommitThread::DrmCommitThread(DrmGpu *gpu, const QString &name)
         return;
     }
 
+    m_epollFd = FileDescriptor{epoll_create1(EPOLL_CLOEXEC)};
+    m_wakeupFd = FileDescriptor{eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)};
+    m_timerFd = FileDescriptor{timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK)};
+    if (!m_epollFd.isValid() || !m_wakeupFd.isValid() || !m_timerFd.isValid()) {
+        qFatal("Failed to create the commit thread file descriptors: %s", strerror(errno));
+    }
+    for (const FileDescriptor *fd : {&m_wakeupFd, &m_timerFd}) {
+        epoll_event event{
+            .events = EPOLLIN,
+            .data = {.fd = fd->get()},
+        };
+        if (epoll_ctl(m_epollFd.get(), EPOLL_CTL_ADD, fd->get(), &event) != 0) {
+            qFatal("Failed to set up the commit thread epoll set: %s", strerror(errno));
+        }
+    }
+
     m_thread.reset(QThread::create([this]() {
         const auto thread = QThread::currentThread();
         gainRealTime();
@@ -37,6 +68,7 @@ DrmCommitThread::DrmCommitThread(DrmGpu *gpu, const QString &name)
             if (thread->isInterruptionRequested()) {
                 return;
             }
+            m_iterations++;
             std::unique_lock lock(m_mutex);
             bool timeout = false;
             if (m_committed) {
@@ -89,7 +121,12 @@ DrmCommitThread::DrmCommitThread(DrmGpu *gpu, const QString &name)
             if (!m_commits.front()->isReadyFor(m_targetPageflipTime)) {
                 // no commit is ready yet, reschedule
                 if (m_vrr || m_tearing) {
-                    m_targetPageflipTime += 50us;
+                    if (m_commits.front()->areBuffersReadable()) {
+                        // the commit targets a later pageflip, there's nothing to do until then
+                        m_targetPageflipTime = std::max(m_targetPageflipTime, *m_commits.front()->targetPageflipTime());
+                    } else if (waitForBuffers(lock, std::chrono::steady_clock::now() + s_maxFenceWait) == WaitResult::BuffersReadable) {
+                        m_targetPageflipTime = std::max(m_targetPageflipTime, std::chrono::steady_clock::now() + m_safetyMargin);
+                    }
                 } else {
                     m_targetPageflipTime += m_minVblankInterval;
                 }
@@ -113,16 +150,16 @@ DrmCommitThread::DrmCommitThread(DrmGpu *gpu, const QString &name)
                         continue;
                     }
                 } else {
-                    // TODO replace this with polling for the buffers to be ready instead
-                    bool timeout = true;
-                    while (std::chrono::steady_clock::now() < delayedTarget && timeout && m_commits.front()->allowedVrrDelay().has_value()) {
-                        timeout = m_commitPending.wait_for(lock, 50us) == std::cv_status::timeout;
+                    // wait until the buffers of a commit without delay are ready
+                    WaitResult result = WaitResult::BuffersReadable;
+                    while (result == WaitResult::BuffersReadable && m_commits.front()->allowedVrrDelay().has_value()) {
+                        result = waitForBuffers(lock, delayedTarget);
                         if (m_commits.empty()) {
                             break;
                         }
                         optimizeCommits(delayedTarget);
                     }
-                    if (!timeout) {
+                    if (result == WaitResult::Wakeup) {
                         // some new commit was added, process that
                         continue;
                     }
@@ -201,6 +238,109 @@ void DrmCommitThread::submit()
     QMetaObject::invokeMethod(this, &DrmCommitThread::clearDroppedCommits, Qt::ConnectionType::QueuedConnection);
 }
 
+DrmCommitThread::WaitResult DrmCommitThread::waitForBuffers(std::unique_lock<std::mutex> &lock, TimePoint deadline)
+{
+    // the mutex is held, so all previous wakeups have already been taken into account
+    uint64_t count;
+    const auto drained = read(m_wakeupFd.get(), &count, sizeof(count));
+    Q_UNUSED(drained);
+
+    std::vector<int> fences;
+    for (const auto &commit : m_commits) {
+        std::ranges::copy(commit->unreadableBufferFences(), std::back_inserter(fences));
+    }
+    std::ranges::sort(fences);
+    const auto duplicates = std::ranges::unique(fences);
+    fences.erase(duplicates.begin(), duplicates.end());
+
+    std::vector<int> watchedFences;
+    bool pollFences = false;
+    for (int fence : fences) {
+        epoll_event event{
+            .events = EPOLLIN,
+            .data = {.fd = fence},
+        };
+        if (epoll_ctl(m_epollFd.get(), EPOLL_CTL_ADD, fence, &event) == 0) {
+            watchedFences.push_back(fence);
+        } else {
+            // e.g. a file type that doesn't support polling. Fall back to checking the
+            // buffers periodically, the caller re-checks them after every wakeup
+            qCWarning(KWIN_DRM, "Failed to wait for a buffer fence with epoll: %s", strerror(errno));
+            pollFences = true;
+        }
+    }
+    const TimePoint wakeupTime = pollFences ? std::min(deadline, std::chrono::steady_clock::now() + s_fencePollInterval) : deadline;
+    const auto time = wakeupTime.time_since_epoch();
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(time);
+    itimerspec spec = {};
+    spec.it_value.tv_sec = seconds.count();
+    spec.it_value.tv_nsec = std::chrono::nanoseconds(time - seconds).count();
+    if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+        // a zero value would disarm the timer
+        spec.it_value.tv_nsec = 1;
+    }
+    if (timerfd_settime(m_timerFd.get(), TFD_TIMER_ABSTIME, &spec, nullptr) != 0) {
+        qCWarning(KWIN_DRM, "Failed to arm the commit thread timer: %s", strerror(errno));
+        for (int fence : watchedFences) {
+            epoll_ctl(m_epollFd.get(), EPOLL_CTL_DEL, fence, nullptr);
+        }
+        return WaitResult::Timeout;
+    }
+
+    lock.unlock();
+    std::array<epoll_event, 16> events;
+    int eventCount;
+    do {
+        eventCount = epoll_wait(m_epollFd.get(), events.data(), events.size(), -1);
+    } while (eventCount < 0 && errno == EINTR);
+    lock.lock();
+
+    for (int fence : watchedFences) {
+        // the commit and with it the fence may have been dropped in the meantime, which
+        // already removes the fence from the epoll set
+        if (epoll_ctl(m_epollFd.get(), EPOLL_CTL_DEL, fence, nullptr) != 0 && errno != EBADF && errno != ENOENT) {
+            qCWarning(KWIN_DRM, "Failed to remove a buffer fence from the epoll set: %s", strerror(errno));
+        }
+    }
+    const itimerspec disarm = {};
+    timerfd_settime(m_timerFd.get(), 0, &disarm, nullptr);
+    const auto expirations = read(m_timerFd.get(), &count, sizeof(count));
+    Q_UNUSED(expirations);
+
+    if (eventCount < 0) {
+        qCWarning(KWIN_DRM, "Waiting for buffer fences failed: %s", strerror(errno));
+        return WaitResult::Timeout;
+    }
+    const auto signaled = std::span(events.data(), eventCount);
+    if (std::ranges::any_of(signaled, [this](const epoll_event &event) {
+            return event.data.fd == m_wakeupFd.get();
+        })) {
+        return WaitResult::Wakeup;
+    }
+    if (std::ranges::any_of(signaled, [this](const epoll_event &event) {
+            return event.data.fd != m_timerFd.get();
+        })) {
+        return WaitResult::BuffersReadable;
+    }
+    if (pollFences && wakeupTime < deadline) {
+        // the buffers have to be checked again by the caller
+        return WaitResult::BuffersReadable;
+    }
+    return WaitResult::Timeout;
+}
+
+uint64_t DrmCommitThread::iterations() const
+{
+    return m_iterations;
+}
+
+void DrmCommitThread::wakeUp()
+{
+    const uint64_t value = 1;
+    const auto written = write(m_wakeupFd.get(), &value, sizeof(value));
+    Q_UNUSED(written);
+}
+
 void DrmCommitThread::optimizeCommits(TimePoint pageflipTarget)
 {
     if (m_commits.size() <= 1) {
@@ -317,6 +457,7 @@ DrmCommitThread::~DrmCommitThread()
             std::unique_lock lock(m_mutex);
             m_thread->requestInterruption();
             m_commitPending.notify_all();
+            wakeUp();
             m_ping = true;
             m_pong.notify_all();
         }
@@ -344,6 +485,7 @@ void DrmCommitThread::addCommit(std::unique_ptr<DrmAtomicCommit> &&commit)
     m_targetPageflipTime = std::max(m_targetPageflipTime, newTarget);
     m_commits.back()->setDeadline(m_targetPageflipTime - m_safetyMargin);
     m_commitPending.notify_all();
+    wakeUp();
 }
 
 void DrmCommitThread::setPendingCommit(std::unique_ptr<DrmLegacyCommit> &&commit)
@@ -383,6 +525,7 @@ void DrmCommitThread::pageFlipped(std::chrono::nanoseconds timestamp)
     if (!m_commits.empty()) {
         m_targetPageflipTime = estimateNextVblank(std::chrono::steady_clock::now());
         m_commitPending.notify_all();
+        wakeUp();
     }
 }
 
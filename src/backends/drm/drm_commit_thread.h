@@ -8,10 +8,14 @@
 */
 #pragma once
 
+#include "utils/filedescriptor.h"
+
 #include <QObject>
 #include <QThread>
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
+#include <optional>
 #include <vector>
 
 namespace KWin
@@ -43,6 +47,11 @@ public:
      *         in order to get presented at that timestamp
      */
     std::chrono::nanoseconds safetyMargin() const;
+    /**
+     * @return how often the thread went through its main loop, the tests use this to
+     *         verify that the thread sleeps while it waits for something
+     */
+    uint64_t iterations() const;
 
 private:
     void clearDroppedCommits();
@@ -51,6 +60,19 @@ private:
     void submit();
     void handlePing();
 
+    enum class WaitResult {
+        Timeout,
+        Wakeup,
+        BuffersReadable,
+    };
+    /**
+     * Unlocks the mutex until a buffer of a pending commit becomes readable, wakeUp() is called
+     * or the deadline is reached, whichever happens first. If a fence can't be waited for, the
+     * function returns BuffersReadable periodically so that the caller checks the buffers again.
+     */
+    WaitResult waitForBuffers(std::unique_lock<std::mutex> &lock, TimePoint deadline);
+    void wakeUp();
+
     DrmGpu *const m_gpu;
     std::unique_ptr<DrmCommit> m_committed;
     std::vector<std::unique_ptr<DrmAtomicCommit>> m_commits;
@@ -70,6 +92,10 @@ private:
     std::chrono::nanoseconds m_additionalSafetyMargin = std::chrono::milliseconds(1);
     bool m_ping = false;
     bool m_pageflipTimeoutDetected = false;
+    FileDescriptor m_epollFd;
+    FileDescriptor m_wakeupFd;
+    FileDescriptor m_timerFd;
+    std::atomic<uint64_t> m_iterations = 0;
 };
 
 }
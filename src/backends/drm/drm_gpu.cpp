@@ -14,6 +14,7 @@
 #include "core/gpumanager.h"
 #include "core/session.h"
 #include "drm_backend.h"
+#include "drm_blob.h"
 #include "drm_buffer.h"
 #include "drm_commit.h"
 #include "drm_commit_thread.h"
@@ -34,6 +35,7 @@
 #include <drm_fourcc.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <functional>
 #include <gbm.h>
 #include <libdrm/drm_mode.h>
 #include <poll.h>
@@ -366,7 +368,47 @@ void DrmGpu::removeOutputs()
     }
 }
 
-DrmPipeline::Error DrmGpu::checkCrtcAssignment(QList<DrmConnector *> connectors, const QList<DrmCrtc *> &crtcs, std::chrono::steady_clock::time_point deadline)
+bool DrmGpu::needsCrtc(DrmConnector *connector) const
+{
+    const auto it = m_pipelineMap.find(connector);
+    return it != m_pipelineMap.end() && it->second->enabled() && connector->isConnected();
+}
+
+/**
+ * Checks whether every connector can get a crtc of its own from the list, only taking the
+ * possible crtcs of the connectors into account. Anything else needs a test commit.
+ */
+static bool canAssignCrtcs(const QList<DrmConnector *> &connectors, const QList<DrmCrtc *> &crtcs)
+{
+    if (connectors.size() > crtcs.size()) {
+        return false;
+    }
+    // a simple augmenting path search for a bipartite matching, the lists are tiny
+    std::vector<qsizetype> crtcOwners(crtcs.size(), -1);
+    std::vector<bool> visited;
+    const std::function<bool(qsizetype)> assign = [&](qsizetype connector) {
+        for (qsizetype i = 0; i < crtcs.size(); i++) {
+            if (visited[i] || !connectors[connector]->isCrtcSupported(crtcs[i])) {
+                continue;
+            }
+            visited[i] = true;
+            if (crtcOwners[i] == -1 || assign(crtcOwners[i])) {
+                crtcOwners[i] = connector;
+                return true;
+            }
+        }
+        return false;
+    };
+    for (qsizetype connector = 0; connector < connectors.size(); connector++) {
+        visited.assign(crtcs.size(), false);
+        if (!assign(connector)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DrmPipeline::Error DrmGpu::checkCrtcAssignment(QList<DrmConnector *> connectors, const QList<DrmCrtc *> &crtcs, const QHash<uint32_t, uint32_t> &preferredCrtcs, std::chrono::steady_clock::time_point deadline)
 {
     if (std::chrono::steady_clock::now() > deadline) {
         return DrmPipeline::Error::Timeout;
@@ -379,45 +421,53 @@ DrmPipeline::Error DrmGpu::checkCrtcAssignment(QList<DrmConnector *> connectors,
     auto pipelineIt = m_pipelineMap.find(connector);
     if (pipelineIt == m_pipelineMap.end()) {
         // this connector doesn't even have a connected output
-        return checkCrtcAssignment(connectors, crtcs, deadline);
+        return checkCrtcAssignment(connectors, crtcs, preferredCrtcs, deadline);
     }
     auto pipeline = pipelineIt->second.get();
     if (!pipeline->enabled() || !connector->isConnected()) {
         // disabled pipelines don't need CRTCs
         pipeline->setCrtc(nullptr);
-        return checkCrtcAssignment(connectors, crtcs, deadline);
+        return checkCrtcAssignment(connectors, crtcs, preferredCrtcs, deadline);
     }
     if (crtcs.isEmpty()) {
         // we have no crtc left to drive this connector
         return DrmPipeline::Error::NotEnoughCrtcs;
     }
-    DrmCrtc *currentCrtc = nullptr;
-    if (m_atomicModeSetting) {
-        // try the crtc that this connector is already connected to first
-        const uint32_t id = connector->crtcId.value();
-        auto it = std::ranges::find_if(crtcs, [id](const DrmCrtc *crtc) {
-            return id == crtc->id();
+
+    // try the crtc of the last configuration that worked with this set of connectors first,
+    // then the crtc that this connector is already connected to
+    QList<DrmCrtc *> candidates = crtcs | std::views::filter([connector](DrmCrtc *crtc) {
+        return connector->isCrtcSupported(crtc);
+    }) | std::ranges::to<QList>();
+    const auto moveToFront = [&candidates](uint32_t id) {
+        const auto it = std::ranges::find_if(candidates, [id](const DrmCrtc *crtc) {
+            return crtc->id() == id;
         });
-        if (it != crtcs.end()) {
-            currentCrtc = *it;
-            auto crtcsLeft = crtcs;
-            crtcsLeft.removeOne(currentCrtc);
-            pipeline->setCrtc(currentCrtc);
-            DrmPipeline::Error err = checkCrtcAssignment(connectors, crtcsLeft, deadline);
-            if (err == DrmPipeline::Error::None || err == DrmPipeline::Error::NoPermission || err == DrmPipeline::Error::FramePending || err == DrmPipeline::Error::Timeout) {
-                return err;
-            }
+        if (it != candidates.end()) {
+            std::rotate(candidates.begin(), it, it + 1);
         }
+    };
+    if (m_atomicModeSetting) {
+        moveToFront(connector->crtcId.value());
     }
-    for (DrmCrtc *crtc : std::as_const(crtcs)) {
-        if (connector->isCrtcSupported(crtc) && crtc != currentCrtc) {
-            auto crtcsLeft = crtcs;
-            crtcsLeft.removeOne(crtc);
-            pipeline->setCrtc(crtc);
-            DrmPipeline::Error err = checkCrtcAssignment(connectors, crtcsLeft, deadline);
-            if (err == DrmPipeline::Error::None || err == DrmPipeline::Error::NoPermission || err == DrmPipeline::Error::FramePending || err == DrmPipeline::Error::Timeout) {
-                return err;
-            }
+    if (const auto it = preferredCrtcs.constFind(connector->id()); it != preferredCrtcs.constEnd()) {
+        moveToFront(*it);
+    }
+
+    const QList<DrmConnector *> remaining = connectors | std::views::filter([this](DrmConnector *other) {
+        return needsCrtc(other);
+    }) | std::ranges::to<QList>();
+    for (DrmCrtc *crtc : std::as_const(candidates)) {
+        auto crtcsLeft = crtcs;
+        crtcsLeft.removeOne(crtc);
+        if (!canAssignCrtcs(remaining, crtcsLeft)) {
+            // no need to test anything if the other connectors can't be driven anymore
+            continue;
+        }
+        pipeline->setCrtc(crtc);
+        DrmPipeline::Error err = checkCrtcAssignment(connectors, crtcsLeft, preferredCrtcs, deadline);
+        if (err == DrmPipeline::Error::None || err == DrmPipeline::Error::NoPermission || err == DrmPipeline::Error::FramePending || err == DrmPipeline::Error::Timeout) {
+            return err;
         }
     }
     return DrmPipeline::Error::InvalidArguments;
@@ -454,8 +504,25 @@ DrmPipeline::Error DrmGpu::testPendingConfiguration()
             return c1->crtcId.value() > c2->crtcId.value();
         });
     }
+
+    const QList<DrmConnector *> enabledConnectors = connectors | std::views::filter([this](DrmConnector *connector) {
+        return needsCrtc(connector);
+    }) | std::ranges::to<QList>();
+    if (!canAssignCrtcs(enabledConnectors, crtcs)) {
+        // lowering the bandwidth doesn't help with this
+        return DrmPipeline::Error::NotEnoughCrtcs;
+    }
+    QList<uint32_t> connectorSet = enabledConnectors | std::views::transform([](DrmConnector *connector) {
+        return connector->id();
+    }) | std::ranges::to<QList>();
+    std::ranges::sort(connectorSet);
+    const QHash<uint32_t, uint32_t> preferredCrtcs = m_crtcAssignments.value(connectorSet);
+
     m_forceLowBandwidthMode = false;
-    auto err = checkCrtcAssignment(connectors, crtcs, std::chrono::steady_clock::now() + s_checkCrtcTimeout);
+    auto err = checkCrtcAssignment(connectors, crtcs, preferredCrtcs, std::chrono::steady_clock::now() + s_checkCrtcTimeout);
+    if (err == DrmPipeline::Error::None) {
+        rememberCrtcAssignment(connectorSet, enabledConnectors);
+    }
     if (err == DrmPipeline::Error::None || err == DrmPipeline::Error::NoPermission || err == DrmPipeline::Error::FramePending) {
         return err;
     }
@@ -466,11 +533,29 @@ DrmPipeline::Error DrmGpu::testPendingConfiguration()
         // We currently don't have any information about why the output config
         // got rejected; one possibility is missing memory bandwidth.
         m_forceLowBandwidthMode = true;
-        err = checkCrtcAssignment(connectors, crtcs, std::chrono::steady_clock::now() + s_checkCrtcTimeout);
+        err = checkCrtcAssignment(connectors, crtcs, preferredCrtcs, std::chrono::steady_clock::now() + s_checkCrtcTimeout);
+        if (err == DrmPipeline::Error::None) {
+            rememberCrtcAssignment(connectorSet, enabledConnectors);
+        }
     }
     return err;
 }
 
+void DrmGpu::rememberCrtcAssignment(const QList<uint32_t> &connectorSet, const QList<DrmConnector *> &connectors)
+{
+    // the number of connector sets is small in practice, this only guards against pathological hotplugging
+    if (m_crtcAssignments.size() >= 32 && !m_crtcAssignments.contains(connectorSet)) {
+        m_crtcAssignments.clear();
+    }
+    QHash<uint32_t, uint32_t> &assignment = m_crtcAssignments[connectorSet];
+    assignment.clear();
+    for (DrmConnector *connector : connectors) {
+        if (const DrmCrtc *crtc = m_pipelineMap.at(connector)->crtc()) {
+            assignment.insert(connector->id(), crtc->id());
+        }
+    }
+}
+
 void DrmGpu::releaseUnusedBuffers()
 {
     const auto isLayerUsed = [this](DrmPipelineLayer *layer) {
@@ -629,6 +714,33 @@ std::unique_lock<std::mutex> DrmGpu::lockPendingCommits()
     return std::unique_lock(m_pendingCommitsMutex);
 }
 
+uint64_t DrmGpu::committedStateGeneration() const
+{
+    return m_committedStateGeneration;
+}
+
+void DrmGpu::invalidateCommittedState()
+{
+    m_committedStateGeneration++;
+}
+
+std::shared_ptr<DrmBlob> DrmGpu::findBlob(const QByteArray &data)
+{
+    const auto it = m_blobs.constFind(data);
+    if (it == m_blobs.constEnd()) {
+        return nullptr;
+    }
+    return it->lock();
+}
+
+void DrmGpu::addBlob(const QByteArray &data, const std::shared_ptr<DrmBlob> &blob)
+{
+    m_blobs.removeIf([](const auto &it) {
+        return it.value().expired();
+    });
+    m_blobs[data] = blob;
+}
+
 void DrmGpu::registerPendingCommit(std::unique_lock<std::mutex> &lock, uint32_t crtcId, DrmCommit *commit)
 {
     Q_ASSERT(lock.owns_lock() && lock.mutex() == &m_pendingCommitsMutex);
@@ -770,6 +882,8 @@ void DrmGpu::setActive(bool active)
     if (m_isActive != active) {
         m_isActive = active;
         if (active) {
+            // another DRM master may have changed anything in the meantime
+            invalidateCommittedState();
             for (const DrmOutput *output : std::as_const(m_drmOutputs)) {
                 output->renderLoop()->uninhibit();
             }
@@ -15,12 +15,15 @@
 #include "utils/filedescriptor.h"
 #include "utils/version.h"
 
+#include <QByteArray>
+#include <QHash>
 #include <QList>
 #include <QPointer>
 #include <QSize>
 #include <QSocketNotifier>
 #include <QTimer>
 
+#include <atomic>
 #include <chrono>
 #include <epoxy/egl.h>
 #include <mutex>
@@ -44,6 +47,7 @@ class GraphicsBuffer;
 class GraphicsBufferAllocator;
 class OutputFrame;
 class DrmCommit;
+class DrmBlob;
 class RenderDevice;
 
 class DrmLease : public QObject
@@ -130,6 +134,19 @@ public:
     void addDefunctCommit(std::unique_ptr<DrmCommit> &&commit);
 
     std::unique_lock<std::mutex> lockPendingCommits();
+
+    /**
+     * The committed values of DrmProperty are only valid for the generation they were
+     * committed in. It changes whenever the kernel state might have been changed by
+     * someone else, like while another DRM master was active.
+     */
+    uint64_t committedStateGeneration() const;
+    void invalidateCommittedState();
+    /**
+     * @returns a blob with the same content that is still alive, if there is one
+     */
+    std::shared_ptr<DrmBlob> findBlob(const QByteArray &data);
+    void addBlob(const QByteArray &data, const std::shared_ptr<DrmBlob> &blob);
     void registerPendingCommit(std::unique_lock<std::mutex> &lock, uint32_t crtcId, DrmCommit *commit);
 
 Q_SIGNALS:
@@ -147,7 +164,9 @@ private:
     void setRenderDevice(RenderDevice *device);
     void updateRenderDevice();
 
-    DrmPipeline::Error checkCrtcAssignment(QList<DrmConnector *> connectors, const QList<DrmCrtc *> &crtcs, std::chrono::steady_clock::time_point deadline);
+    DrmPipeline::Error checkCrtcAssignment(QList<DrmConnector *> connectors, const QList<DrmCrtc *> &crtcs, const QHash<uint32_t, uint32_t> &preferredCrtcs, std::chrono::steady_clock::time_point deadline);
+    bool needsCrtc(DrmConnector *connector) const;
+    void rememberCrtcAssignment(const QList<uint32_t> &connectorSet, const QList<DrmConnector *> &connectors);
     DrmPipeline::Error testPipelines();
     QList<DrmObject *> unusedModesetObjects() const;
     void assignOutputLayers();
@@ -186,6 +205,11 @@ private:
     std::unordered_map<DrmCrtc *, std::unique_ptr<DrmPipelineLayer>> m_legacyCursorLayerMap;
     QList<DrmObject *> m_allObjects;
     QList<DrmPipeline *> m_pipelines;
+    // the crtc ids of the last configuration that passed the test, by the sorted ids of the enabled connectors
+    QHash<QList<uint32_t>, QHash<uint32_t, uint32_t>> m_crtcAssignments;
+
+    std::atomic<uint64_t> m_committedStateGeneration = 1;
+    QHash<QByteArray, std::weak_ptr<DrmBlob>> m_blobs;
 
     QList<DrmOutput *> m_drmOutputs;
 
@@ -33,6 +33,7 @@ bool DrmProperty::setPropertyLegacy(uint64_t value)
     const int ret = drmModeObjectSetProperty(m_obj->gpu()->fd(), m_obj->id(), m_obj->type(), m_propId, value);
     if (ret == 0) {
         m_current = value;
+        m_committedGeneration = 0;
         return true;
     }
 
@@ -40,12 +41,27 @@ bool DrmProperty::setPropertyLegacy(uint64_t value)
     return false;
 }
 
+std::optional<uint64_t> DrmProperty::committedValue() const
+{
+    if (m_committedGeneration != m_obj->gpu()->committedStateGeneration()) {
+        return std::nullopt;
+    }
+    return m_committedValue.load();
+}
+
+void DrmProperty::setCommittedValue(uint64_t value) const
+{
+    m_committedValue = value;
+    m_committedGeneration = m_obj->gpu()->committedStateGeneration();
+}
+
 void DrmProperty::update(DrmPropertyList &propertyList)
 {
     if (const auto opt = propertyList.takeProperty(m_propName)) {
         const auto &[prop, value] = *opt;
         m_propId = prop->prop_id;
         m_current = value;
+        m_committedGeneration = 0;
         m_flags = prop->flags;
         if ((prop->flags & DRM_MODE_PROP_RANGE) || (prop->flags & DRM_MODE_PROP_SIGNED_RANGE)) {
             Q_ASSERT(prop->count_values > 1);
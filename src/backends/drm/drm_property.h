@@ -16,6 +16,8 @@
 #include <QList>
 #include <QMap>
 
+#include <atomic>
+#include <optional>
 #include <xf86drmMode.h>
 
 namespace KWin
@@ -50,6 +52,12 @@ public:
     void update(DrmPropertyList &propertyList);
     bool setPropertyLegacy(uint64_t value);
 
+    /**
+     * @returns the value that was committed last, if it's known to still be the current state
+     */
+    std::optional<uint64_t> committedValue() const;
+    void setCommittedValue(uint64_t value) const;
+
     QList<uint64_t> possibleEnumValues() const;
 
 protected:
@@ -60,6 +68,10 @@ protected:
     uint32_t m_propId = 0;
     // the last known value from the kernel
     uint64_t m_current = 0;
+    // the last value committed by KWin, only valid as long as the generation
+    // matches DrmGpu::committedStateGeneration()
+    mutable std::atomic<uint64_t> m_committedValue = 0;
+    mutable std::atomic<uint64_t> m_committedGeneration = 0;
     DrmUniquePtr<drmModePropertyBlobRes> m_immutableBlob;
 
     uint64_t m_minValue = -1;
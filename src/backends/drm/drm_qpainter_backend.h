@@ -0,0 +1,48 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+#include "drm_render_backend.h"
+#include "qpainter/qpainterbackend.h"
+
+namespace KWin
+{
+
+class DrmBackend;
+class GraphicsBufferAllocator;
+
+/**
+ * @brief QPainter backend that renders on the CPU into dumb buffers.
+ *
+ * It's meant for GPUs without usable 3D acceleration, where llvmpipe would be the alternative.
+ */
+class DrmQPainterBackend : public QPainterBackend, public DrmRenderBackend
+{
+    Q_OBJECT
+
+public:
+    explicit DrmQPainterBackend(DrmBackend *drmBackend);
+    ~DrmQPainterBackend() override;
+
+    QList<OutputLayer *> compatibleOutputLayers(BackendOutput *output) override;
+
+    std::unique_ptr<DrmPipelineLayer> createDrmPlaneLayer(DrmPlane *plane) override;
+    std::unique_ptr<DrmPipelineLayer> createDrmPlaneLayer(DrmGpu *gpu, DrmPlane::TypeIndex type) override;
+    std::unique_ptr<DrmOutputLayer> createLayer(DrmVirtualOutput *output) override;
+
+    /**
+     * Returns the allocator for the buffers of virtual outputs, which are never scanned out.
+     */
+    GraphicsBufferAllocator *graphicsBufferAllocator() const;
+
+private:
+    DrmBackend *m_backend;
+    std::unique_ptr<GraphicsBufferAllocator> m_allocator;
+};
+
+}
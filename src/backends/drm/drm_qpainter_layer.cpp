@@ -0,0 +1,178 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "drm_qpainter_layer.h"
+#include "core/drmdevice.h"
+#include "core/graphicsbufferview.h"
+#include "core/renderbackend.h"
+#include "drm_buffer.h"
+#include "drm_gpu.h"
+#include "drm_logging.h"
+#include "drm_output.h"
+#include "drm_pipeline.h"
+#include "qpainter/qpainterswapchain.h"
+
+#include <QPainter>
+#include <cerrno>
+#include <cstring>
+#include <drm_fourcc.h>
+
+namespace KWin
+{
+
+static const bool s_bufferAgeEnabled = qEnvironmentVariable("KWIN_USE_BUFFER_AGE") != QStringLiteral("0");
+
+DrmQPainterLayer::DrmQPainterLayer(DrmPlane *plane)
+    : DrmPipelineLayer(plane)
+{
+}
+
+DrmQPainterLayer::DrmQPainterLayer(DrmPlane::TypeIndex type)
+    : DrmPipelineLayer(type)
+{
+}
+
+DrmQPainterLayer::~DrmQPainterLayer()
+{
+    releaseBuffers();
+}
+
+uint32_t DrmQPainterLayer::selectFormat() const
+{
+    // dumb buffers are always linear, with 32 bits per pixel
+    const FormatModifierMap formats = supportedDrmFormats();
+    const auto supportsLinear = [&formats](uint32_t format) {
+        return formats.containsFormat(format, DRM_FORMAT_MOD_LINEAR) || formats.containsFormat(format, DRM_FORMAT_MOD_INVALID);
+    };
+    if (m_type == OutputLayerType::Primary && m_requiredAlphaBits == 0 && supportsLinear(DRM_FORMAT_XRGB8888)) {
+        return DRM_FORMAT_XRGB8888;
+    } else if (supportsLinear(DRM_FORMAT_ARGB8888)) {
+        return DRM_FORMAT_ARGB8888;
+    } else {
+        return DRM_FORMAT_INVALID;
+    }
+}
+
+bool DrmQPainterLayer::ensureSwapchain()
+{
+    const QSize size = targetRect().size();
+    const uint32_t format = selectFormat();
+    if (format == DRM_FORMAT_INVALID) {
+        return false;
+    }
+    if (!m_swapchain || m_swapchain->size() != size || m_swapchain->format() != format) {
+        m_swapchain = std::make_unique<QPainterSwapchain>(gpu()->drmDevice()->allocator(), size, format, true);
+        m_damageJournal.clear();
+        m_shadowImage = QImage();
+    }
+    return true;
+}
+
+std::optional<OutputLayerBeginFrameInfo> DrmQPainterLayer::beginFrame(OutputFrame *frame)
+{
+    if (!ensureSwapchain()) {
+        return std::nullopt;
+    }
+    m_currentSlot = m_swapchain->acquire();
+    if (!m_currentSlot) {
+        return std::nullopt;
+    }
+
+    m_query = std::make_unique<CpuRenderTimeQuery>();
+
+    QImage *image = m_currentSlot->view()->image();
+    const OutputTransform transform = drmOutput()->transform();
+    if (transform.kind() == OutputTransform::Kind::Normal) {
+        m_shadowImage = QImage();
+        return OutputLayerBeginFrameInfo{
+            .renderTarget = RenderTarget(image),
+            .repaint = s_bufferAgeEnabled ? m_damageJournal.accumulate(m_currentSlot->age(), Region::infinite()) : Region::infinite(),
+        };
+    }
+
+    // the shadow image keeps the previous frame, only the dumb buffer needs to catch up in endFrame()
+    const QSize orientedSize = transform.map(image->size());
+    Region repaint = s_bufferAgeEnabled ? Region() : Region::infinite();
+    if (m_shadowImage.size() != orientedSize || m_shadowImage.format() != image->format()) {
+        m_shadowImage = QImage(orientedSize, image->format());
+        repaint = Region::infinite();
+    }
+    return OutputLayerBeginFrameInfo{
+        .renderTarget = RenderTarget(&m_shadowImage),
+        .repaint = repaint,
+    };
+}
+
+bool DrmQPainterLayer::endFrame(const Region &renderedDeviceRegion, const Region &damagedDeviceRegion, OutputFrame *frame)
+{
+    if (!m_shadowImage.isNull()) {
+        const OutputTransform transform = drmOutput()->transform();
+        const QSize orientedSize = m_shadowImage.size();
+        const Region deviceDamage = s_bufferAgeEnabled ? m_damageJournal.accumulate(m_currentSlot->age(), Region::infinite()) | damagedDeviceRegion : Region::infinite();
+        const Region bufferDamage = transform.map(deviceDamage & Rect(QPoint(0, 0), orientedSize), orientedSize);
+
+        QImage *image = m_currentSlot->view()->image();
+        const QPointF origin = transform.map(QPointF(0, 0), orientedSize);
+        const QPointF xAxis = transform.map(QPointF(1, 0), orientedSize) - origin;
+        const QPointF yAxis = transform.map(QPointF(0, 1), orientedSize) - origin;
+
+        QPainter painter(image);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.setClipRegion(QRegion(bufferDamage));
+        painter.setTransform(QTransform(xAxis.x(), xAxis.y(), yAxis.x(), yAxis.y(), origin.x(), origin.y()));
+        painter.drawImage(QPoint(0, 0), m_shadowImage);
+    }
+
+    m_query->end();
+    if (frame) {
+        frame->addRenderTimeQuery(std::move(m_query));
+    }
+
+    m_currentFramebuffer = gpu()->importBuffer(m_currentSlot->buffer(), FileDescriptor{});
+    m_swapchain->release(m_currentSlot);
+    m_currentSlot.reset();
+    if (!m_currentFramebuffer) {
+        qCWarning(KWIN_DRM, "Failed to create a framebuffer: %s", strerror(errno));
+        m_damageJournal.clear();
+        return false;
+    }
+    m_damageJournal.add(damagedDeviceRegion);
+    return true;
+}
+
+bool DrmQPainterLayer::preparePresentationTest()
+{
+    if (m_type != OutputLayerType::Primary && drmOutput()->shouldDisableNonPrimaryPlanes()) {
+        return false;
+    }
+    if (!ensureSwapchain()) {
+        return false;
+    }
+    // the contents don't matter for a test commit, so the slot doesn't need to be released
+    const auto slot = m_swapchain->acquire();
+    if (!slot) {
+        return false;
+    }
+    m_currentFramebuffer = gpu()->importBuffer(slot->buffer(), FileDescriptor{});
+    return m_currentFramebuffer != nullptr;
+}
+
+std::shared_ptr<DrmFramebuffer> DrmQPainterLayer::currentBuffer() const
+{
+    return m_currentFramebuffer;
+}
+
+void DrmQPainterLayer::releaseBuffers()
+{
+    m_currentFramebuffer.reset();
+    m_currentSlot.reset();
+    m_swapchain.reset();
+    m_shadowImage = QImage();
+}
+
+}
@@ -0,0 +1,51 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+#include "drm_layer.h"
+#include "utils/damagejournal.h"
+
+#include <QImage>
+
+namespace KWin
+{
+
+class CpuRenderTimeQuery;
+class QPainterSwapchain;
+class QPainterSwapchainSlot;
+
+class DrmQPainterLayer : public DrmPipelineLayer
+{
+public:
+    explicit DrmQPainterLayer(DrmPlane *plane);
+    explicit DrmQPainterLayer(DrmPlane::TypeIndex type);
+    ~DrmQPainterLayer() override;
+
+    std::optional<OutputLayerBeginFrameInfo> beginFrame(OutputFrame *frame) override;
+    bool endFrame(const Region &renderedDeviceRegion, const Region &damagedDeviceRegion, OutputFrame *frame) override;
+    bool preparePresentationTest() override;
+    std::shared_ptr<DrmFramebuffer> currentBuffer() const override;
+    void releaseBuffers() override;
+
+private:
+    bool ensureSwapchain();
+    uint32_t selectFormat() const;
+
+    std::unique_ptr<QPainterSwapchain> m_swapchain;
+    std::shared_ptr<QPainterSwapchainSlot> m_currentSlot;
+    std::shared_ptr<DrmFramebuffer> m_currentFramebuffer;
+    std::unique_ptr<CpuRenderTimeQuery> m_query;
+    DamageJournal m_damageJournal;
+    /**
+     * QImage render targets have no transform, so rotated outputs are rendered into this
+     * image in the output orientation and then copied into the dumb buffer.
+     */
+    QImage m_shadowImage;
+};
+
+}
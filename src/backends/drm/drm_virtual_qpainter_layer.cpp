@@ -0,0 +1,76 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "drm_virtual_qpainter_layer.h"
+#include "core/graphicsbufferview.h"
+#include "core/renderbackend.h"
+#include "drm_qpainter_backend.h"
+#include "drm_virtual_output.h"
+#include "qpainter/qpainterswapchain.h"
+
+#include <drm_fourcc.h>
+
+namespace KWin
+{
+
+DrmVirtualQPainterLayer::DrmVirtualQPainterLayer(DrmQPainterBackend *backend, DrmVirtualOutput *output)
+    : DrmOutputLayer(output, OutputLayerType::Primary)
+    , m_backend(backend)
+{
+}
+
+DrmVirtualQPainterLayer::~DrmVirtualQPainterLayer()
+{
+    releaseBuffers();
+}
+
+std::optional<OutputLayerBeginFrameInfo> DrmVirtualQPainterLayer::beginFrame(OutputFrame *frame)
+{
+    const QSize size = m_output->modeSize();
+    if (!m_swapchain || m_swapchain->size() != size) {
+        m_swapchain = std::make_unique<QPainterSwapchain>(m_backend->graphicsBufferAllocator(), size, DRM_FORMAT_XRGB8888, false);
+        m_damageJournal.clear();
+    }
+
+    m_currentSlot = m_swapchain->acquire();
+    if (!m_currentSlot) {
+        return std::nullopt;
+    }
+
+    m_query = std::make_unique<CpuRenderTimeQuery>();
+
+    return OutputLayerBeginFrameInfo{
+        .renderTarget = RenderTarget(m_currentSlot->view()->image()),
+        .repaint = m_damageJournal.accumulate(m_currentSlot->age(), Region::infinite()),
+    };
+}
+
+bool DrmVirtualQPainterLayer::endFrame(const Region &renderedDeviceRegion, const Region &damagedDeviceRegion, OutputFrame *frame)
+{
+    m_query->end();
+    if (frame) {
+        frame->addRenderTimeQuery(std::move(m_query));
+    }
+    m_swapchain->release(m_currentSlot);
+    m_currentSlot.reset();
+    m_damageJournal.add(damagedDeviceRegion);
+    return true;
+}
+
+void DrmVirtualQPainterLayer::releaseBuffers()
+{
+    m_currentSlot.reset();
+    m_swapchain.reset();
+}
+
+FormatModifierMap DrmVirtualQPainterLayer::supportedDrmFormats() const
+{
+    return {{DRM_FORMAT_XRGB8888, {DRM_FORMAT_MOD_LINEAR}}};
+}
+
+}
@@ -0,0 +1,41 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+#include "drm_layer.h"
+#include "utils/damagejournal.h"
+
+namespace KWin
+{
+
+class CpuRenderTimeQuery;
+class DrmQPainterBackend;
+class DrmVirtualOutput;
+class QPainterSwapchain;
+class QPainterSwapchainSlot;
+
+class DrmVirtualQPainterLayer : public DrmOutputLayer
+{
+public:
+    DrmVirtualQPainterLayer(DrmQPainterBackend *backend, DrmVirtualOutput *output);
+    ~DrmVirtualQPainterLayer() override;
+
+    std::optional<OutputLayerBeginFrameInfo> beginFrame(OutputFrame *frame) override;
+    bool endFrame(const Region &renderedDeviceRegion, const Region &damagedDeviceRegion, OutputFrame *frame) override;
+    void releaseBuffers() override;
+    FormatModifierMap supportedDrmFormats() const override;
+
+private:
+    DrmQPainterBackend *const m_backend;
+    std::unique_ptr<QPainterSwapchain> m_swapchain;
+    std::shared_ptr<QPainterSwapchainSlot> m_currentSlot;
+    std::unique_ptr<CpuRenderTimeQuery> m_query;
+    DamageJournal m_damageJournal;
+};
+
+}
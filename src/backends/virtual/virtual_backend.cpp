@@ -7,9 +7,14 @@
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 #include "virtual_backend.h"
+#include "config-kwin.h"
 
 #include "virtual_egl_backend.h"
 #include "virtual_output.h"
+#include "virtual_qpainter_backend.h"
+#if KWIN_BUILD_VULKAN
+#include "virtual_vulkan_backend.h"
+#endif
 
 #include <fcntl.h>
 #include <gbm.h>
@@ -38,7 +43,11 @@ bool VirtualBackend::initialize()
 
 QList<CompositingType> VirtualBackend::supportedCompositors() const
 {
-    return {OpenGLCompositing};
+#if KWIN_BUILD_VULKAN
+    return {OpenGLCompositing, QPainterCompositing, VulkanCompositing};
+#else
+    return {OpenGLCompositing, QPainterCompositing};
+#endif
 }
 
 std::unique_ptr<EglBackend> VirtualBackend::createOpenGLBackend(RenderDevice *renderDevice)
@@ -46,6 +55,20 @@ std::unique_ptr<EglBackend> VirtualBackend::createOpenGLBackend(RenderDevice *re
     return std::make_unique<VirtualEglBackend>(this, renderDevice);
 }
 
+std::unique_ptr<QPainterBackend> VirtualBackend::createQPainterBackend()
+{
+    return std::make_unique<VirtualQPainterBackend>(this);
+}
+
+std::unique_ptr<VulkanBackend> VirtualBackend::createVulkanBackend(RenderDevice *device)
+{
+#if KWIN_BUILD_VULKAN
+    return std::make_unique<VirtualVulkanBackend>(this, device);
+#else
+    return nullptr;
+#endif
+}
+
 BackendOutput *VirtualBackend::createVirtualOutput(const QString &name, const QString &description, const QSize &size, qreal scale)
 {
     return addOutput(OutputInfo{
@@ -30,6 +30,8 @@ public:
     bool initialize() override;
 
     std::unique_ptr<EglBackend> createOpenGLBackend(RenderDevice *renderDevice) override;
+    std::unique_ptr<QPainterBackend> createQPainterBackend() override;
+    std::unique_ptr<VulkanBackend> createVulkanBackend(RenderDevice *device) override;
 
     BackendOutput *createVirtualOutput(const QString &name, const QString &description, const QSize &size, qreal scale) override;
     void removeVirtualOutput(BackendOutput *output) override;
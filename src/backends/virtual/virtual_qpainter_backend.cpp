@@ -0,0 +1,117 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "virtual_qpainter_backend.h"
+#include "core/graphicsbufferview.h"
+#include "core/renderbackend.h"
+#include "core/shmgraphicsbufferallocator.h"
+#include "qpainter/qpainterswapchain.h"
+#include "virtual_backend.h"
+#include "virtual_output.h"
+
+#include <drm_fourcc.h>
+
+namespace KWin
+{
+
+static const bool s_bufferAgeEnabled = qEnvironmentVariable("KWIN_USE_BUFFER_AGE") != QStringLiteral("0");
+
+VirtualQPainterLayer::VirtualQPainterLayer(BackendOutput *output, VirtualQPainterBackend *backend)
+    : OutputLayer(output, OutputLayerType::Primary)
+    , m_backend(backend)
+{
+}
+
+VirtualQPainterLayer::~VirtualQPainterLayer()
+{
+}
+
+std::optional<OutputLayerBeginFrameInfo> VirtualQPainterLayer::beginFrame(OutputFrame *frame)
+{
+    const QSize nativeSize = m_output->modeSize();
+    if (!m_swapchain || m_swapchain->size() != nativeSize) {
+        m_swapchain = std::make_unique<QPainterSwapchain>(m_backend->graphicsBufferAllocator(), nativeSize, DRM_FORMAT_XRGB8888, false);
+        m_damageJournal.clear();
+    }
+
+    m_current = m_swapchain->acquire();
+    if (!m_current) {
+        return std::nullopt;
+    }
+
+    m_query = std::make_unique<CpuRenderTimeQuery>();
+
+    return OutputLayerBeginFrameInfo{
+        .renderTarget = RenderTarget(m_current->view()->image()),
+        .repaint = s_bufferAgeEnabled ? m_damageJournal.accumulate(m_current->age(), Region::infinite()) : Region::infinite(),
+    };
+}
+
+bool VirtualQPainterLayer::endFrame(const Region &renderedDeviceRegion, const Region &damagedDeviceRegion, OutputFrame *frame)
+{
+    m_query->end();
+    if (frame) {
+        frame->addRenderTimeQuery(std::move(m_query));
+    }
+    m_swapchain->release(m_current);
+    m_damageJournal.add(damagedDeviceRegion);
+    return true;
+}
+
+FormatModifierMap VirtualQPainterLayer::supportedDrmFormats() const
+{
+    return {{DRM_FORMAT_XRGB8888, {DRM_FORMAT_MOD_LINEAR}}};
+}
+
+void VirtualQPainterLayer::releaseBuffers()
+{
+    m_current.reset();
+    m_swapchain.reset();
+}
+
+QImage *VirtualQPainterLayer::image() const
+{
+    return m_current ? m_current->view()->image() : nullptr;
+}
+
+VirtualQPainterBackend::VirtualQPainterBackend(VirtualBackend *backend)
+    : m_backend(backend)
+    , m_allocator(std::make_unique<ShmGraphicsBufferAllocator>())
+{
+    const auto outputs = m_backend->outputs();
+    for (BackendOutput *output : outputs) {
+        addOutput(output);
+    }
+
+    connect(m_backend, &VirtualBackend::outputAdded, this, &VirtualQPainterBackend::addOutput);
+}
+
+VirtualQPainterBackend::~VirtualQPainterBackend()
+{
+    const auto outputs = m_backend->outputs();
+    for (BackendOutput *output : outputs) {
+        static_cast<VirtualOutput *>(output)->setOutputLayer(nullptr);
+    }
+}
+
+GraphicsBufferAllocator *VirtualQPainterBackend::graphicsBufferAllocator() const
+{
+    return m_allocator.get();
+}
+
+void VirtualQPainterBackend::addOutput(BackendOutput *output)
+{
+    static_cast<VirtualOutput *>(output)->setOutputLayer(std::make_unique<VirtualQPainterLayer>(output, this));
+}
+
+QList<OutputLayer *> VirtualQPainterBackend::compatibleOutputLayers(BackendOutput *output)
+{
+    return {static_cast<VirtualOutput *>(output)->outputLayer()};
+}
+
+} // namespace KWin
+
+#include "moc_virtual_qpainter_backend.cpp"
@@ -0,0 +1,70 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "core/outputlayer.h"
+#include "qpainter/qpainterbackend.h"
+#include "utils/damagejournal.h"
+
+#include <memory>
+
+namespace KWin
+{
+
+class CpuRenderTimeQuery;
+class GraphicsBufferAllocator;
+class QPainterSwapchain;
+class QPainterSwapchainSlot;
+class VirtualBackend;
+class VirtualQPainterBackend;
+
+class KWIN_EXPORT VirtualQPainterLayer : public OutputLayer
+{
+public:
+    VirtualQPainterLayer(BackendOutput *output, VirtualQPainterBackend *backend);
+    ~VirtualQPainterLayer() override;
+
+    std::optional<OutputLayerBeginFrameInfo> beginFrame(OutputFrame *frame) override;
+    bool endFrame(const Region &renderedDeviceRegion, const Region &damagedDeviceRegion, OutputFrame *frame) override;
+
+    FormatModifierMap supportedDrmFormats() const override;
+    void releaseBuffers() override;
+
+    QImage *image() const;
+
+private:
+    VirtualQPainterBackend *const m_backend;
+    std::unique_ptr<QPainterSwapchain> m_swapchain;
+    std::shared_ptr<QPainterSwapchainSlot> m_current;
+    std::unique_ptr<CpuRenderTimeQuery> m_query;
+    DamageJournal m_damageJournal;
+};
+
+/**
+ * The VirtualQPainterBackend class renders the virtual outputs into shared memory buffers on
+ * the CPU. It's mainly useful for comparing the software renderer with llvmpipe.
+ */
+class VirtualQPainterBackend : public QPainterBackend
+{
+    Q_OBJECT
+
+public:
+    explicit VirtualQPainterBackend(VirtualBackend *backend);
+    ~VirtualQPainterBackend() override;
+
+    QList<OutputLayer *> compatibleOutputLayers(BackendOutput *output) override;
+
+    GraphicsBufferAllocator *graphicsBufferAllocator() const;
+
+private:
+    void addOutput(BackendOutput *output);
+
+    VirtualBackend *m_backend;
+    std::unique_ptr<GraphicsBufferAllocator> m_allocator;
+};
+
+} // namespace KWin
@@ -0,0 +1,134 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "virtual_vulkan_backend.h"
+#include "core/renderdevice.h"
+#include "core/syncobjtimeline.h"
+#include "virtual_backend.h"
+#include "virtual_output.h"
+#include "vulkan/vulkan_device.h"
+#include "vulkan/vulkan_swapchain.h"
+
+#include <drm_fourcc.h>
+
+namespace KWin
+{
+
+static const bool s_bufferAgeEnabled = qEnvironmentVariable("KWIN_USE_BUFFER_AGE") != QStringLiteral("0");
+
+VirtualVulkanLayer::VirtualVulkanLayer(BackendOutput *output, VirtualVulkanBackend *backend)
+    : OutputLayer(output, OutputLayerType::Primary)
+    , m_backend(backend)
+{
+}
+
+VirtualVulkanLayer::~VirtualVulkanLayer()
+{
+}
+
+std::optional<OutputLayerBeginFrameInfo> VirtualVulkanLayer::beginFrame(OutputFrame *frame)
+{
+    const QSize nativeSize = m_output->modeSize();
+    if (!m_swapchain || m_swapchain->size() != nativeSize) {
+        const auto modifiers = m_backend->vulkanDevice()->renderFormats().value(DRM_FORMAT_XRGB8888);
+        if (modifiers.isEmpty()) {
+            return std::nullopt;
+        }
+        const GraphicsBufferOptions options{
+            .size = nativeSize,
+            .format = DRM_FORMAT_XRGB8888,
+            .modifiers = modifiers,
+        };
+        m_swapchain = VulkanSwapchain::create(m_backend->vulkanDevice(), m_backend->renderDevice()->allocator(), options,
+                                              VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+        if (!m_swapchain) {
+            return std::nullopt;
+        }
+        m_damageJournal.clear();
+    }
+
+    m_current = m_swapchain->acquire();
+    if (!m_current) {
+        return std::nullopt;
+    }
+
+    m_renderReleasePoint = std::make_shared<GraphicsBufferReleasePoint>();
+    m_query = std::make_unique<CpuRenderTimeQuery>();
+
+    return OutputLayerBeginFrameInfo{
+        .renderTarget = RenderTarget(m_current->texture(), m_renderReleasePoint),
+        .repaint = s_bufferAgeEnabled ? m_damageJournal.accumulate(m_current->age(), Region::infinite()) : Region::infinite(),
+    };
+}
+
+bool VirtualVulkanLayer::endFrame(const Region &renderedDeviceRegion, const Region &damagedDeviceRegion, OutputFrame *frame)
+{
+    m_query->end();
+    if (frame) {
+        frame->addRenderTimeQuery(std::move(m_query));
+    }
+    m_swapchain->release(m_current.get(), m_renderReleasePoint->releaseFd().duplicate());
+    m_renderReleasePoint.reset();
+    m_damageJournal.add(damagedDeviceRegion);
+    return true;
+}
+
+FormatModifierMap VirtualVulkanLayer::supportedDrmFormats() const
+{
+    return m_backend->vulkanDevice()->renderFormats();
+}
+
+void VirtualVulkanLayer::releaseBuffers()
+{
+    m_current.reset();
+    m_swapchain.reset();
+}
+
+VulkanTexture *VirtualVulkanLayer::texture() const
+{
+    return m_current ? m_current->texture() : nullptr;
+}
+
+VirtualVulkanBackend::VirtualVulkanBackend(VirtualBackend *backend, RenderDevice *renderDevice)
+    : VulkanBackend(renderDevice)
+    , m_backend(backend)
+{
+}
+
+VirtualVulkanBackend::~VirtualVulkanBackend()
+{
+    const auto outputs = m_backend->outputs();
+    for (BackendOutput *output : outputs) {
+        static_cast<VirtualOutput *>(output)->setOutputLayer(nullptr);
+    }
+}
+
+bool VirtualVulkanBackend::init()
+{
+    initWayland();
+
+    const auto outputs = m_backend->outputs();
+    for (BackendOutput *output : outputs) {
+        addOutput(output);
+    }
+
+    connect(m_backend, &VirtualBackend::outputAdded, this, &VirtualVulkanBackend::addOutput);
+    return true;
+}
+
+void VirtualVulkanBackend::addOutput(BackendOutput *output)
+{
+    static_cast<VirtualOutput *>(output)->setOutputLayer(std::make_unique<VirtualVulkanLayer>(output, this));
+}
+
+QList<OutputLayer *> VirtualVulkanBackend::compatibleOutputLayers(BackendOutput *output)
+{
+    return {static_cast<VirtualOutput *>(output)->outputLayer()};
+}
+
+} // namespace KWin
+
+#include "moc_virtual_vulkan_backend.cpp"
@@ -0,0 +1,69 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "core/outputlayer.h"
+#include "utils/damagejournal.h"
+#include "vulkan/vulkan_backend.h"
+
+#include <memory>
+
+namespace KWin
+{
+
+class CpuRenderTimeQuery;
+class GraphicsBufferReleasePoint;
+class VirtualBackend;
+class VirtualVulkanBackend;
+class VulkanSwapchain;
+class VulkanSwapchainSlot;
+class VulkanTexture;
+
+class KWIN_EXPORT VirtualVulkanLayer : public OutputLayer
+{
+public:
+    VirtualVulkanLayer(BackendOutput *output, VirtualVulkanBackend *backend);
+    ~VirtualVulkanLayer() override;
+
+    std::optional<OutputLayerBeginFrameInfo> beginFrame(OutputFrame *frame) override;
+    bool endFrame(const Region &renderedDeviceRegion, const Region &damagedDeviceRegion, OutputFrame *frame) override;
+
+    FormatModifierMap supportedDrmFormats() const override;
+    void releaseBuffers() override;
+
+    VulkanTexture *texture() const;
+
+private:
+    VirtualVulkanBackend *const m_backend;
+    std::unique_ptr<VulkanSwapchain> m_swapchain;
+    std::shared_ptr<VulkanSwapchainSlot> m_current;
+    std::shared_ptr<GraphicsBufferReleasePoint> m_renderReleasePoint;
+    std::unique_ptr<CpuRenderTimeQuery> m_query;
+    DamageJournal m_damageJournal;
+};
+
+/**
+ * The VirtualVulkanBackend class renders the virtual outputs into dmabufs with Vulkan.
+ */
+class VirtualVulkanBackend : public VulkanBackend
+{
+    Q_OBJECT
+
+public:
+    VirtualVulkanBackend(VirtualBackend *backend, RenderDevice *renderDevice);
+    ~VirtualVulkanBackend() override;
+
+    bool init() override;
+    QList<OutputLayer *> compatibleOutputLayers(BackendOutput *output) override;
+
+private:
+    void addOutput(BackendOutput *output);
+
+    VirtualBackend *m_backend;
+};
+
+} // namespace KWin
@@ -16,6 +16,7 @@
 #include "core/drmdevice.h"
 #include "core/gpumanager.h"
 #include "core/graphicsbufferview.h"
+#include "core/output.h"
 #include "core/outputbackend.h"
 #include "core/outputlayer.h"
 #include "core/renderbackend.h"
@@ -25,17 +26,26 @@
 #include "cursorsource.h"
 #include "dbusinterface.h"
 #include "effect/effecthandler.h"
+#include "framestatisticsdbusinterface.h"
 #include "ftrace.h"
 #include "opengl/eglbackend.h"
 #include "opengl/glplatform.h"
+#include "opengl/glshadermanager.h"
+#include "qpainter/qpainterbackend.h"
 #include "renderloopdrivenqanimationdriver.h"
 #include "scene/cursoritem.h"
 #include "scene/itemrenderer_opengl.h"
+#include "scene/itemrenderer_software.h"
+#if KWIN_BUILD_VULKAN
+#include "scene/itemrenderer_vulkan.h"
+#endif
 #include "scene/surfaceitem.h"
 #include "scene/surfaceitem_wayland.h"
 #include "scene/workspacescene.h"
 #include "utils/common.h"
 #include "utils/envvar.h"
+#include "vulkan/vulkan_backend.h"
+#include "vulkan/vulkan_device.h"
 #include "wayland/surface.h"
 #include "wayland_server.h"
 #include "window.h"
@@ -71,6 +81,7 @@ Compositor::Compositor(QObject *workspace)
 {
     // register DBus
     new CompositorDBusInterface(this);
+    new FrameStatisticsDBusInterface(this);
 
     m_renderLoopDrivenAnimationDriver->install();
     connect(m_renderLoopDrivenAnimationDriver, &RenderLoopDrivenQAnimationDriver::started, this, [this]() {
@@ -289,6 +300,51 @@ bool Compositor::attemptOpenGLCompositing()
     return true;
 }
 
+bool Compositor::attemptVulkanCompositing()
+{
+#if !KWIN_BUILD_VULKAN
+    qCWarning(KWIN_CORE) << "KWin has been built without Vulkan compositing support";
+    return false;
+#else
+    if (!m_primaryDevice) {
+        m_primaryDevice = selectRenderDevice();
+        if (!m_primaryDevice) {
+            qCWarning(KWIN_CORE, "Found no render device!");
+            return false;
+        }
+        qCDebug(KWIN_CORE, "Chose %s as the primary GPU", qPrintable(m_primaryDevice->path()));
+    }
+    VulkanDevice *vulkanDevice = m_primaryDevice->vulkanDevice();
+    if (!vulkanDevice) {
+        qCDebug(KWIN_CORE) << "Vulkan is not supported by the primary GPU";
+        return false;
+    }
+    if (!vulkanDevice->supportsDynamicRendering()) {
+        qCDebug(KWIN_CORE) << "Vulkan dynamic rendering is not supported by the primary GPU";
+        return false;
+    }
+
+    std::unique_ptr<VulkanBackend> backend = kwinApp()->outputBackend()->createVulkanBackend(m_primaryDevice);
+    if (!backend || !backend->init()) {
+        return false;
+    }
+    m_backend = std::move(backend);
+    qCDebug(KWIN_CORE) << "Vulkan compositing has been successfully initialized";
+    return true;
+#endif
+}
+
+bool Compositor::attemptQPainterCompositing()
+{
+    std::unique_ptr<QPainterBackend> backend = kwinApp()->outputBackend()->createQPainterBackend();
+    if (!backend) {
+        return false;
+    }
+    m_backend = std::move(backend);
+    qCDebug(KWIN_CORE) << "QPainter compositing has been successfully initialized";
+    return true;
+}
+
 void Compositor::createRenderer()
 {
     // If compositing has been restarted, try to use the last used compositing type.
@@ -317,7 +373,12 @@ void Compositor::createRenderer()
             stop = attemptOpenGLCompositing();
             break;
         case QPainterCompositing:
-            stop = true;
+            qCDebug(KWIN_CORE) << "Attempting to load the QPainter scene";
+            stop = attemptQPainterCompositing();
+            break;
+        case VulkanCompositing:
+            qCDebug(KWIN_CORE) << "Attempting to load the Vulkan scene";
+            stop = attemptVulkanCompositing();
             break;
         case NoCompositing:
             qCDebug(KWIN_CORE) << "Starting without compositing...";
@@ -327,6 +388,10 @@ void Compositor::createRenderer()
 
         if (stop) {
             break;
+        } else if (type == VulkanCompositing) {
+            // Vulkan compositing is opt-in and needs features that not every driver has, so fall
+            // back to the other compositors even if it was forced with KWIN_COMPOSE.
+            qCWarning(KWIN_CORE) << "Vulkan compositing is not available, falling back to the next compositor";
         } else if (qEnvironmentVariableIsSet("KWIN_COMPOSE")) {
             qCCritical(KWIN_CORE) << "Could not fulfill the requested compositing mode in KWIN_COMPOSE:" << type << ". Exiting.";
             qApp->quit();
@@ -371,11 +436,23 @@ void Compositor::start()
         case QPainterCompositing:
             QQuickWindow::setGraphicsApi(QSGRendererInterface::Software);
             break;
+        case VulkanCompositing:
+            // Qt Quick would need its own Vulkan instance and device, the software renderer output
+            // is uploaded like any other image instead.
+            qCInfo(KWIN_CORE) << "Qt Quick scenes are rendered with the software renderer when compositing with Vulkan";
+            QQuickWindow::setGraphicsApi(QSGRendererInterface::Software);
+            break;
         }
     }
 
     if (const auto eglBackend = qobject_cast<EglBackend *>(m_backend.get())) {
         kwinApp()->scene()->attachRenderer(std::make_unique<ItemRendererOpenGL>(eglBackend->eglDisplayObject()));
+    } else if (qobject_cast<QPainterBackend *>(m_backend.get())) {
+        kwinApp()->scene()->attachRenderer(std::make_unique<ItemRendererSoftware>());
+#if KWIN_BUILD_VULKAN
+    } else if (const auto vulkanBackend = qobject_cast<VulkanBackend *>(m_backend.get())) {
+        kwinApp()->scene()->attachRenderer(std::make_unique<ItemRendererVulkan>(vulkanBackend->vulkanDevice()));
+#endif
     }
 
     handleOutputsChanged();
@@ -411,6 +488,9 @@ void Compositor::stop()
     if (m_backend->compositingType() == OpenGLCompositing) {
         // some layers need a context current for destruction
         (void)static_cast<EglBackend *>(m_backend.get())->openglContext()->makeCurrent();
+    } else if (m_backend->compositingType() == VulkanCompositing) {
+        // the layers can only be destroyed after the GPU is done with their buffers
+        static_cast<VulkanBackend *>(m_backend.get())->vulkanDevice()->waitIdle();
     }
 
     const auto loops = m_primaryViews | std::views::transform([](const auto &pair) {
@@ -744,7 +824,96 @@ std::pair<QList<Compositor::LayerData>, bool> Compositor::setupLayers(SceneView
             return std::make_pair(layers, false);
         }
     }
-    return std::make_pair(layers, backendOutput->testPresentation(frame));
+
+    const QList<OutputLayerState> configuration = layerConfiguration(layers);
+    if (isFailedLayerConfiguration(backendOutput->renderLoop(), configuration, frame->presentationMode())) {
+        return std::make_pair(layers, false);
+    }
+    const bool result = backendOutput->testPresentation(frame);
+    if (!result) {
+        addFailedLayerConfiguration(backendOutput->renderLoop(), configuration, frame->presentationMode());
+    }
+    return std::make_pair(layers, result);
+}
+
+bool Compositor::OutputLayerState::operator==(const OutputLayerState &other) const
+{
+    const bool sameColor = colorDescription.get() == other.colorDescription.get()
+        || (colorDescription && other.colorDescription && *colorDescription == *other.colorDescription);
+    return layer == other.layer
+        && zpos == other.zpos
+        && sourceRect == other.sourceRect
+        && targetRect == other.targetRect
+        && bufferTransform == other.bufferTransform
+        && offloadTransform == other.offloadTransform
+        && sameColor
+        && renderIntent == other.renderIntent
+        && format == other.format
+        && modifier == other.modifier
+        && requiredAlphaBits == other.requiredAlphaBits;
+}
+
+QList<Compositor::OutputLayerState> Compositor::layerConfiguration(const QList<LayerData> &layers) const
+{
+    // the primary layer on its own is the last fallback, it must always be tested
+    const bool onlyPrimary = std::ranges::all_of(layers, [](const LayerData &layer) {
+        return !layer.view->layer()->isEnabled() || layer.view->layer()->type() == OutputLayerType::Primary;
+    });
+    if (onlyPrimary) {
+        return {};
+    }
+
+    QList<OutputLayerState> configuration;
+    for (const LayerData &layer : layers) {
+        OutputLayer *outputLayer = layer.view->layer();
+        if (!outputLayer->isEnabled()) {
+            continue;
+        }
+        OutputLayerState state{
+            .layer = outputLayer,
+            .zpos = outputLayer->zpos(),
+            .sourceRect = outputLayer->sourceRect(),
+            .targetRect = outputLayer->targetRect(),
+            .bufferTransform = outputLayer->bufferTransform(),
+            .offloadTransform = outputLayer->offloadTransform(),
+            .colorDescription = outputLayer->colorDescription(),
+            .renderIntent = outputLayer->renderIntent(),
+            .requiredAlphaBits = layer.requiredAlphaBits,
+        };
+        if (layer.directScanout) {
+            const auto attrs = layer.view->scanoutCandidate()->buffer()->dmabufAttributes();
+            state.format = attrs->format;
+            state.modifier = attrs->modifier;
+        }
+        configuration.push_back(state);
+    }
+    return configuration;
+}
+
+bool Compositor::isFailedLayerConfiguration(RenderLoop *renderLoop, const QList<OutputLayerState> &configuration, PresentationMode presentationMode)
+{
+    if (configuration.isEmpty()) {
+        return false;
+    }
+    const auto it = m_failedLayerConfigurations.find(renderLoop);
+    if (it == m_failedLayerConfigurations.end()) {
+        return false;
+    }
+    return it->second.contains(FailedLayerConfiguration{
+        .layers = configuration,
+        .presentationMode = presentationMode,
+    });
+}
+
+void Compositor::addFailedLayerConfiguration(RenderLoop *renderLoop, const QList<OutputLayerState> &configuration, PresentationMode presentationMode)
+{
+    if (configuration.isEmpty()) {
+        return;
+    }
+    m_failedLayerConfigurations[renderLoop].insert(FailedLayerConfiguration{
+        .layers = configuration,
+        .presentationMode = presentationMode,
+    });
 }
 
 void Compositor::composite(RenderLoop *renderLoop)
@@ -769,6 +938,7 @@ void Compositor::composite(RenderLoop *renderLoop)
         m_renderLoopDrivenAnimationDriver->advanceToNextFrame(renderLoop->nextPresentationTimestamp());
     }
 
+    const auto prepareStart = std::chrono::steady_clock::now();
     auto totalTimeQuery = std::make_unique<CpuRenderTimeQuery>();
     auto frame = std::make_shared<OutputFrame>(renderLoop, std::chrono::nanoseconds(1'000'000'000'000 / output->refreshRate()));
     std::optional<double> desiredArtificalHdrHeadroom;
@@ -909,6 +1079,11 @@ void Compositor::composite(RenderLoop *renderLoop)
         }
     };
 
+    frame->setPrepareTime(RenderTimeSpan{
+        .start = prepareStart,
+        .end = std::chrono::steady_clock::now(),
+    });
+
     // now actually render the layers that need rendering
     if (result) {
         // before rendering, enable and disable all the views that need it,
@@ -934,6 +1109,7 @@ void Compositor::composite(RenderLoop *renderLoop)
         // and even with atomic modesetting, drivers are buggy and atomic tests
         // sometimes have false positives
         result = false;
+        addFailedLayerConfiguration(renderLoop, layerConfiguration(layers), frame->presentationMode());
 
         // same fallbacks as above:
         // first, fall back to composited primary + hardware cursor, if that's not already done
@@ -1006,12 +1182,33 @@ void Compositor::handleOutputsChanged()
     }
     m_overlayViews.clear();
     m_primaryViews.clear();
+    // the layers and the bandwidth available to them may have changed
+    m_failedLayerConfigurations.clear();
     const auto outputs = kwinApp()->outputBackend()->outputs();
     for (BackendOutput *output : outputs) {
         if (LogicalOutput *logicalOutput = workspace()->findOutput(output)) {
             addOutput(logicalOutput, output);
         }
     }
+
+    prewarmShaders();
+}
+
+void Compositor::prewarmShaders()
+{
+    const auto eglBackend = qobject_cast<EglBackend *>(m_backend.get());
+    if (!eglBackend || !eglBackend->openglContext()->makeCurrent()) {
+        return;
+    }
+
+    const auto outputs = workspace()->outputs();
+    const bool transformColorspace = std::ranges::any_of(outputs, [](LogicalOutput *output) {
+        return output->blendingColor() != ColorDescription::sRGB;
+    });
+
+    // Compile the shaders in the background before the first frame that needs them, otherwise
+    // the first frame with e.g. rounded corners or a faded window would be late.
+    eglBackend->openglContext()->shaderManager()->prewarm(ItemRendererOpenGL::commonShaderTraits(transformColorspace));
 }
 
 void Compositor::addOutput(LogicalOutput *logicalOutput, BackendOutput *backendOutput)
@@ -1032,6 +1229,7 @@ void Compositor::removeOutput(BackendOutput *output)
     m_overlayViews.erase(output->renderLoop());
     m_primaryViews.erase(output->renderLoop());
     m_brokenCursors.erase(output->renderLoop());
+    m_failedLayerConfigurations.erase(output->renderLoop());
 }
 
 void Compositor::assignOutputLayers(LogicalOutput *logicalOutput, BackendOutput *backendOutput)
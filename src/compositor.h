@@ -11,11 +11,15 @@
 
 #include "effect/globals.h"
 #include "kwin_export.h"
+#include "core/colorspace.h"
+#include "core/output.h"
 #include "core/region.h"
+#include "utils/failedconfigurationcache.h"
 
 #include <QHash>
 #include <QObject>
 
+#include <chrono>
 #include <memory>
 
 namespace KWin
@@ -98,7 +102,10 @@ protected:
     BackendOutput *findOutput(RenderLoop *loop) const;
 
     bool attemptOpenGLCompositing();
+    bool attemptQPainterCompositing();
+    bool attemptVulkanCompositing();
     void handleOutputsChanged();
+    void prewarmShaders();
     void addOutput(LogicalOutput *logicalOutput, BackendOutput *backendOutput);
     void removeOutput(BackendOutput *output);
     void assignOutputLayers(LogicalOutput *logicalOutput, BackendOutput *backendOutput);
@@ -119,6 +126,44 @@ protected:
                                                   const std::shared_ptr<OutputFrame> &frame,
                                                   std::unordered_set<OutputLayer *> &toUpdate);
 
+    /**
+     * The OutputLayerState type describes an enabled output layer as far as a presentation
+     * test is concerned.
+     */
+    struct OutputLayerState
+    {
+        OutputLayer *layer;
+        int zpos;
+        RectF sourceRect;
+        Rect targetRect;
+        OutputTransform bufferTransform;
+        OutputTransform offloadTransform;
+        std::shared_ptr<ColorDescription> colorDescription;
+        RenderingIntent renderIntent;
+        uint32_t format = 0;
+        uint64_t modifier = 0;
+        uint32_t requiredAlphaBits = 0;
+
+        bool operator==(const OutputLayerState &other) const;
+    };
+
+    /**
+     * A layer configuration that failed the presentation test. It's not tested again for a
+     * while, so frames with an unchanged scene don't keep issuing test commits that are known
+     * to fail.
+     */
+    struct FailedLayerConfiguration
+    {
+        QList<OutputLayerState> layers;
+        PresentationMode presentationMode;
+
+        bool operator==(const FailedLayerConfiguration &other) const = default;
+    };
+
+    QList<OutputLayerState> layerConfiguration(const QList<LayerData> &layers) const;
+    bool isFailedLayerConfiguration(RenderLoop *renderLoop, const QList<OutputLayerState> &configuration, PresentationMode presentationMode);
+    void addFailedLayerConfiguration(RenderLoop *renderLoop, const QList<OutputLayerState> &configuration, PresentationMode presentationMode);
+
     CompositingType m_selectedCompositor = NoCompositing;
 
     State m_state = State::Off;
@@ -126,6 +171,7 @@ protected:
     std::unordered_map<RenderLoop *, std::unique_ptr<SceneView>> m_primaryViews;
     std::unordered_map<RenderLoop *, std::unordered_map<OutputLayer *, std::unique_ptr<ItemView>>> m_overlayViews;
     std::unordered_set<RenderLoop *> m_brokenCursors;
+    std::unordered_map<RenderLoop *, FailedConfigurationCache<FailedLayerConfiguration>> m_failedLayerConfigurations;
     std::optional<bool> m_allowOverlaysEnv;
     RenderLoopDrivenQAnimationDriver *m_renderLoopDrivenAnimationDriver;
     RenderDevice *m_primaryDevice = nullptr;
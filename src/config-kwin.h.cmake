@@ -15,6 +15,7 @@
 #cmakedefine01 KWIN_BUILD_GLOBALSHORTCUTS
 #cmakedefine01 KWIN_BUILD_X11
 #cmakedefine01 KWIN_BUILD_QACCESSIBILITYCLIENT
+#cmakedefine01 KWIN_BUILD_VULKAN
 constexpr QLatin1StringView KWIN_CONFIG("kwinrc");
 constexpr QLatin1StringView KWIN_VERSION_STRING("${PROJECT_VERSION}");
 constexpr QLatin1StringView XCB_VERSION_STRING("${XCB_VERSION}");
@@ -0,0 +1,137 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "core/framestatistics.h"
+
+#include <algorithm>
+#include <array>
+
+namespace KWin
+{
+
+enum FrameStatisticsField {
+    StatusField,
+    PresentationModeField,
+    RefreshDurationField,
+    PredictedRenderTimeField,
+    TargetPresentationTimestampField,
+    PrepareStartField,
+    PrepareEndField,
+    RenderStartField,
+    RenderEndField,
+    CommitTimestampField,
+    PresentationTimestampField,
+    FieldCount,
+};
+
+struct FrameStatisticsRing::Slot
+{
+    /**
+     * The sequence number of the stored frame shifted by one bit. The lowest bit is set
+     * while the slot is being written.
+     */
+    std::atomic<quint64> version = 0;
+    std::array<std::atomic<qint64>, FieldCount> fields{};
+};
+
+FrameStatisticsRing::FrameStatisticsRing(int capacity)
+    : m_slots(std::make_unique<Slot[]>(capacity))
+    , m_capacity(capacity)
+{
+}
+
+FrameStatisticsRing::~FrameStatisticsRing() = default;
+
+int FrameStatisticsRing::capacity() const
+{
+    return m_capacity;
+}
+
+quint64 FrameStatisticsRing::lastSequence() const
+{
+    return m_lastSequence.load(std::memory_order_acquire);
+}
+
+quint64 FrameStatisticsRing::add(FrameStatistics statistics)
+{
+    const quint64 sequence = m_lastSequence.load(std::memory_order_relaxed) + 1;
+    Slot &slot = m_slots[sequence % m_capacity];
+
+    slot.version.store((sequence << 1) | 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const qint64 fields[FieldCount] = {
+        qint64(statistics.status),
+        qint64(statistics.presentationMode),
+        statistics.refreshDuration.count(),
+        statistics.predictedRenderTime.count(),
+        statistics.targetPresentationTimestamp.count(),
+        statistics.prepareStart.count(),
+        statistics.prepareEnd.count(),
+        statistics.renderStart.count(),
+        statistics.renderEnd.count(),
+        statistics.commitTimestamp.count(),
+        statistics.presentationTimestamp.count(),
+    };
+    for (int i = 0; i < FieldCount; ++i) {
+        slot.fields[i].store(fields[i], std::memory_order_relaxed);
+    }
+
+    slot.version.store(sequence << 1, std::memory_order_release);
+    m_lastSequence.store(sequence, std::memory_order_release);
+    return sequence;
+}
+
+QList<FrameStatistics> FrameStatisticsRing::snapshot(quint64 since) const
+{
+    const quint64 last = m_lastSequence.load(std::memory_order_acquire);
+    if (since >= last) {
+        return {};
+    }
+
+    const quint64 first = std::max<quint64>(since, last > quint64(m_capacity) ? last - m_capacity : 0) + 1;
+
+    QList<FrameStatistics> frames;
+    frames.reserve(last - first + 1);
+    for (quint64 sequence = first; sequence <= last; ++sequence) {
+        const Slot &slot = m_slots[sequence % m_capacity];
+
+        const quint64 version = slot.version.load(std::memory_order_acquire);
+        if (version != sequence << 1) {
+            // The slot is being rewritten with a newer frame.
+            continue;
+        }
+
+        qint64 fields[FieldCount];
+        for (int i = 0; i < FieldCount; ++i) {
+            fields[i] = slot.fields[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.version.load(std::memory_order_relaxed) != version) {
+            continue;
+        }
+
+        frames.append(FrameStatistics{
+            .sequence = sequence,
+            .status = FrameStatistics::Status(fields[StatusField]),
+            .presentationMode = PresentationMode(fields[PresentationModeField]),
+            .refreshDuration = std::chrono::nanoseconds(fields[RefreshDurationField]),
+            .predictedRenderTime = std::chrono::nanoseconds(fields[PredictedRenderTimeField]),
+            .targetPresentationTimestamp = std::chrono::nanoseconds(fields[TargetPresentationTimestampField]),
+            .prepareStart = std::chrono::nanoseconds(fields[PrepareStartField]),
+            .prepareEnd = std::chrono::nanoseconds(fields[PrepareEndField]),
+            .renderStart = std::chrono::nanoseconds(fields[RenderStartField]),
+            .renderEnd = std::chrono::nanoseconds(fields[RenderEndField]),
+            .commitTimestamp = std::chrono::nanoseconds(fields[CommitTimestampField]),
+            .presentationTimestamp = std::chrono::nanoseconds(fields[PresentationTimestampField]),
+        });
+    }
+
+    return frames;
+}
+
+} // namespace KWin
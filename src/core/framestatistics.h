@@ -0,0 +1,104 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "effect/globals.h"
+
+#include <QList>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+namespace KWin
+{
+
+/**
+ * The FrameStatistics struct describes the life of a single frame on an output.
+ *
+ * All timestamps are sourced from the monotonic clock. A zero timestamp means that the
+ * corresponding stage has not been reached or is unknown, e.g. the commit time is only
+ * known with the drm backend.
+ */
+struct FrameStatistics
+{
+    enum class Status {
+        Presented,
+        Dropped,
+    };
+
+    /**
+     * Monotonically increasing number of the frame, starting at 1.
+     */
+    quint64 sequence = 0;
+    Status status = Status::Presented;
+    PresentationMode presentationMode = PresentationMode::VSync;
+    std::chrono::nanoseconds refreshDuration{0};
+    std::chrono::nanoseconds predictedRenderTime{0};
+    std::chrono::nanoseconds targetPresentationTimestamp{0};
+    /**
+     * The time span during which the compositor updated animations, collected damage
+     * and assigned the output layers.
+     */
+    std::chrono::nanoseconds prepareStart{0};
+    std::chrono::nanoseconds prepareEnd{0};
+    /**
+     * The time span covered by the render time queries, i.e. from the start of painting until
+     * the GPU has finished rendering if the render backend supports timer queries.
+     */
+    std::chrono::nanoseconds renderStart{0};
+    std::chrono::nanoseconds renderEnd{0};
+    std::chrono::nanoseconds commitTimestamp{0};
+    std::chrono::nanoseconds presentationTimestamp{0};
+};
+
+/**
+ * The FrameStatisticsRing class keeps the statistics of the last N frames.
+ *
+ * The ring has a single writer, the thread that calls add(), but the statistics can be read
+ * from any thread without locking. Every slot is guarded by a sequence counter that is odd
+ * while the slot is being written, so readers can detect and skip torn records instead of
+ * blocking the compositor.
+ */
+class KWIN_EXPORT FrameStatisticsRing
+{
+public:
+    explicit FrameStatisticsRing(int capacity = 256);
+    ~FrameStatisticsRing();
+
+    /**
+     * Returns the maximum number of frames that can be stored in the ring.
+     */
+    int capacity() const;
+
+    /**
+     * Returns the sequence number of the most recently added frame, or @c 0 if no frame
+     * has been added yet.
+     */
+    quint64 lastSequence() const;
+
+    /**
+     * Adds the specified @a statistics to the ring, overwriting the oldest record if the ring
+     * is full. The sequence number is assigned by the ring and returned.
+     */
+    quint64 add(FrameStatistics statistics);
+
+    /**
+     * Returns the frames with a sequence number greater than @a since that are still
+     * in the ring, sorted from the oldest to the newest frame.
+     */
+    QList<FrameStatistics> snapshot(quint64 since = 0) const;
+
+private:
+    struct Slot;
+
+    std::unique_ptr<Slot[]> m_slots;
+    const int m_capacity;
+    std::atomic<quint64> m_lastSequence = 0;
+};
+
+} // namespace KWin
@@ -14,6 +14,8 @@
 #include "opengl/egldisplay.h"
 #include "output.h"
 #include "outputconfiguration.h"
+#include "qpainter/qpainterbackend.h"
+#include "vulkan/vulkan_backend.h"
 
 namespace KWin
 {
@@ -37,6 +39,16 @@ std::unique_ptr<EglBackend> OutputBackend::createOpenGLBackend(RenderDevice *dev
     return nullptr;
 }
 
+std::unique_ptr<QPainterBackend> OutputBackend::createQPainterBackend()
+{
+    return nullptr;
+}
+
+std::unique_ptr<VulkanBackend> OutputBackend::createVulkanBackend(RenderDevice *device)
+{
+    return nullptr;
+}
+
 OutputConfigurationError OutputBackend::applyOutputChanges(const OutputConfiguration &config)
 {
     const auto availableOutputs = outputs();
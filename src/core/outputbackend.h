@@ -24,6 +24,8 @@ namespace KWin
 class LogicalOutput;
 class InputBackend;
 class EglBackend;
+class QPainterBackend;
+class VulkanBackend;
 class OutputConfiguration;
 class EglDisplay;
 class Session;
@@ -41,6 +43,8 @@ public:
     virtual bool initialize() = 0;
     virtual std::unique_ptr<InputBackend> createInputBackend();
     virtual std::unique_ptr<EglBackend> createOpenGLBackend(RenderDevice *device);
+    virtual std::unique_ptr<QPainterBackend> createQPainterBackend();
+    virtual std::unique_ptr<VulkanBackend> createVulkanBackend(RenderDevice *device);
 
     /**
      * The CompositingTypes supported by the Platform.
@@ -82,6 +82,7 @@ void OutputLayer::scheduleRepaint(Item *item)
     if (m_renderLoop) {
         m_renderLoop->scheduleRepaint(item, this);
     }
+    Q_EMIT itemRepaintScheduled(item);
     Q_EMIT repaintScheduled();
 }
 
@@ -156,6 +156,11 @@ public:
 
 Q_SIGNALS:
     void repaintScheduled();
+    /**
+     * This signal is emitted when the @p item has scheduled a repaint on this layer, its
+     * pending damage is available from Item::deviceRepaints().
+     */
+    void itemRepaintScheduled(Item *item);
 
 protected:
     const OutputLayerType m_type;
@@ -5,12 +5,267 @@
 */
 
 #include "core/region.h"
+#include "core/region_p.h"
 
 #include <QDebug>
 
+#include <bit>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define KWIN_REGION_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
 namespace KWin
 {
 
+static_assert(sizeof(Rect) == 4 * sizeof(int), "The SIMD band kernels expect Rect to be laid out as {left, top, right, bottom}");
+static_assert(sizeof(RectF) == 4 * sizeof(qreal), "The SIMD band kernels expect RectF to be laid out as {left, top, right, bottom}");
+
+/*!
+ * \internal
+ *
+ * Returns \c true if the rectangles in two bands with \a count rectangles each have the same
+ * horizontal extents.
+ */
+template<typename R>
+static bool bandsEqualScalar(const R *previous, const R *current, qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        if (previous[i].left() != current[i].left() || previous[i].right() != current[i].right()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \internal
+ *
+ * Returns the index of the first rectangle in the given band whose right edge is past \a x. The
+ * right edges in a band are strictly increasing, so all rectangles before the returned index lie
+ * completely to the left of \a x.
+ */
+template<typename R, typename T>
+static qsizetype skipBandScalar(const R *rects, qsizetype count, T x)
+{
+    qsizetype index = 0;
+    while (index < count && rects[index].right() <= x) {
+        ++index;
+    }
+    return index;
+}
+
+#if KWIN_REGION_SIMD_X86
+static_assert(std::is_same_v<qreal, double>);
+
+__attribute__((target("sse4.1"))) static bool bandsEqualSse41(const Rect *previous, const Rect *current, qsizetype count)
+{
+    const __m128i mask = _mm_setr_epi32(-1, 0, -1, 0);
+    for (qsizetype i = 0; i < count; ++i) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(previous + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(current + i));
+        if (!_mm_testz_si128(_mm_xor_si128(a, b), mask)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+__attribute__((target("avx2"))) static bool bandsEqualAvx2(const Rect *previous, const Rect *current, qsizetype count)
+{
+    const __m256i mask = _mm256_setr_epi32(-1, 0, -1, 0, -1, 0, -1, 0);
+    qsizetype i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(previous + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(current + i));
+        if (!_mm256_testz_si256(_mm256_xor_si256(a, b), mask)) {
+            return false;
+        }
+    }
+    return bandsEqualScalar(previous + i, current + i, count - i);
+}
+
+__attribute__((target("sse4.1"))) static qsizetype skipBandSse41(const Rect *rects, qsizetype count, int x)
+{
+    const __m128i threshold = _mm_set1_epi32(x);
+    qsizetype i = 0;
+    for (; i + 4 <= count; i += 4) {
+        uint32_t mask = 0;
+        for (int j = 0; j < 4; ++j) {
+            const __m128i rect = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rects + i + j));
+            mask |= uint32_t(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(rect, threshold)))) << (4 * j);
+        }
+        // Only the right edges are of interest, they are stored in the third lane.
+        mask &= 0x4444;
+        if (mask) {
+            return i + std::countr_zero(mask) / 4;
+        }
+    }
+    return i + skipBandScalar(rects + i, count - i, x);
+}
+
+__attribute__((target("avx2"))) static qsizetype skipBandAvx2(const Rect *rects, qsizetype count, int x)
+{
+    const __m256i threshold = _mm256_set1_epi32(x);
+    qsizetype i = 0;
+    for (; i + 8 <= count; i += 8) {
+        uint32_t mask = 0;
+        for (int j = 0; j < 4; ++j) {
+            const __m256i pair = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rects + i + 2 * j));
+            mask |= uint32_t(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(pair, threshold)))) << (8 * j);
+        }
+        mask &= 0x44444444;
+        if (mask) {
+            return i + std::countr_zero(mask) / 4;
+        }
+    }
+    return i + skipBandSse41(rects + i, count - i, x);
+}
+
+__attribute__((target("sse4.1"))) static bool bandsEqualSse41(const RectF *previous, const RectF *current, qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        const double *a = reinterpret_cast<const double *>(previous + i);
+        const double *b = reinterpret_cast<const double *>(current + i);
+        const __m128d aHorizontal = _mm_unpacklo_pd(_mm_loadu_pd(a), _mm_loadu_pd(a + 2));
+        const __m128d bHorizontal = _mm_unpacklo_pd(_mm_loadu_pd(b), _mm_loadu_pd(b + 2));
+        if (_mm_movemask_pd(_mm_cmpeq_pd(aHorizontal, bHorizontal)) != 0x3) {
+            return false;
+        }
+    }
+    return true;
+}
+
+__attribute__((target("avx2"))) static bool bandsEqualAvx2(const RectF *previous, const RectF *current, qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        const __m256d a = _mm256_loadu_pd(reinterpret_cast<const double *>(previous + i));
+        const __m256d b = _mm256_loadu_pd(reinterpret_cast<const double *>(current + i));
+        if ((_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)) & 0x5) != 0x5) {
+            return false;
+        }
+    }
+    return true;
+}
+
+__attribute__((target("sse4.1"))) static qsizetype skipBandSse41(const RectF *rects, qsizetype count, qreal x)
+{
+    const __m128d threshold = _mm_set1_pd(x);
+    qsizetype i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const double *a = reinterpret_cast<const double *>(rects + i);
+        const double *b = reinterpret_cast<const double *>(rects + i + 1);
+        const __m128d rights = _mm_unpacklo_pd(_mm_loadu_pd(a + 2), _mm_loadu_pd(b + 2));
+        const int mask = _mm_movemask_pd(_mm_cmpgt_pd(rights, threshold));
+        if (mask) {
+            return i + std::countr_zero(uint32_t(mask));
+        }
+    }
+    return i + skipBandScalar(rects + i, count - i, x);
+}
+
+__attribute__((target("avx2"))) static qsizetype skipBandAvx2(const RectF *rects, qsizetype count, qreal x)
+{
+    const __m256d threshold = _mm256_set1_pd(x);
+    qsizetype i = 0;
+    for (; i + 4 <= count; i += 4) {
+        uint32_t mask = 0;
+        for (int j = 0; j < 4; ++j) {
+            const __m256d rect = _mm256_loadu_pd(reinterpret_cast<const double *>(rects + i + j));
+            mask |= uint32_t(_mm256_movemask_pd(_mm256_cmp_pd(rect, threshold, _CMP_GT_OQ))) << (4 * j);
+        }
+        mask &= 0x4444;
+        if (mask) {
+            return i + std::countr_zero(mask) / 4;
+        }
+    }
+    return i + skipBandSse41(rects + i, count - i, x);
+}
+#endif
+
+struct RegionKernels
+{
+    RegionIsa isa;
+    bool (*bandsEqual)(const Rect *previous, const Rect *current, qsizetype count);
+    qsizetype (*skipBand)(const Rect *rects, qsizetype count, int x);
+    bool (*bandsEqualF)(const RectF *previous, const RectF *current, qsizetype count);
+    qsizetype (*skipBandF)(const RectF *rects, qsizetype count, qreal x);
+};
+
+static RegionKernels selectRegionKernels(RegionIsa isa)
+{
+    switch (isa) {
+#if KWIN_REGION_SIMD_X86
+    case RegionIsa::Avx2:
+        return RegionKernels{
+            .isa = RegionIsa::Avx2,
+            .bandsEqual = bandsEqualAvx2,
+            .skipBand = skipBandAvx2,
+            .bandsEqualF = bandsEqualAvx2,
+            .skipBandF = skipBandAvx2,
+        };
+    case RegionIsa::Sse41:
+        return RegionKernels{
+            .isa = RegionIsa::Sse41,
+            .bandsEqual = bandsEqualSse41,
+            .skipBand = skipBandSse41,
+            .bandsEqualF = bandsEqualSse41,
+            .skipBandF = skipBandSse41,
+        };
+#endif
+    default:
+        return RegionKernels{
+            .isa = RegionIsa::Scalar,
+            .bandsEqual = bandsEqualScalar<Rect>,
+            .skipBand = skipBandScalar<Rect, int>,
+            .bandsEqualF = bandsEqualScalar<RectF>,
+            .skipBandF = skipBandScalar<RectF, qreal>,
+        };
+    }
+}
+
+static RegionKernels &regionKernels()
+{
+    static RegionKernels kernels = selectRegionKernels(bestRegionIsa());
+    return kernels;
+}
+
+RegionIsa bestRegionIsa()
+{
+#if KWIN_REGION_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return RegionIsa::Avx2;
+    } else if (__builtin_cpu_supports("sse4.1")) {
+        return RegionIsa::Sse41;
+    }
+#endif
+    return RegionIsa::Scalar;
+}
+
+RegionIsa regionIsa()
+{
+    return regionKernels().isa;
+}
+
+void setRegionIsa(RegionIsa isa)
+{
+    regionKernels() = selectRegionKernels(std::min(isa, bestRegionIsa()));
+}
+
+template<typename T, qsizetype Prealloc>
+void RegionStorage<T, Prealloc>::spill(qsizetype capacity)
+{
+    m_list.reserve(std::max(capacity, m_inlineSize));
+    m_list.resizeForOverwrite(m_inlineSize);
+    std::copy(m_inline, m_inline + m_inlineSize, m_list.data());
+
+    m_inlineSize = 0;
+    m_capacityHint = 0;
+    m_spilled = true;
+}
+
 Region::Region(const QRegion &region)
 {
     const QSpan<const QRect> rects = region.rects();
@@ -199,7 +454,7 @@ QSpan<const Rect> Region::rects() const
     if (m_rects.isEmpty()) {
         return QSpan(&m_bounds, 1);
     } else {
-        return QSpan(m_rects);
+        return QSpan<const Rect>(m_rects.constData(), m_rects.size());
     }
 }
 
@@ -240,7 +495,7 @@ Region::BandRef Region::sliceBand(QSpan<const Rect> rects, int top, int bottom,
 
 Region::BandRef Region::mergeBands(QSpan<const Rect> left, QSpan<const Rect> right, int top, int bottom, const BandRef &previousBand)
 {
-    Rect *previousRect = nullptr;
+    qsizetype previousRect = -1;
     qsizetype leftIndex = 0;
     qsizetype rightIndex = 0;
 
@@ -249,22 +504,24 @@ Region::BandRef Region::mergeBands(QSpan<const Rect> left, QSpan<const Rect> rig
         const Rect &rightRect = right[rightIndex];
 
         if (leftRect.left() < rightRect.left()) {
-            if (previousRect && leftRect.left() <= previousRect->right()) {
-                if (previousRect->right() < leftRect.right()) {
-                    previousRect->setRight(leftRect.right());
+            if (previousRect != -1 && leftRect.left() <= m_rects[previousRect].right()) {
+                if (m_rects[previousRect].right() < leftRect.right()) {
+                    m_rects[previousRect].setRight(leftRect.right());
                 }
             } else {
-                previousRect = &m_rects.emplaceBack(slicedRect(leftRect, top, bottom));
+                previousRect = m_rects.size();
+                m_rects.emplaceBack(slicedRect(leftRect, top, bottom));
             }
 
             ++leftIndex;
         } else {
-            if (previousRect && rightRect.left() <= previousRect->right()) {
-                if (previousRect->right() < rightRect.right()) {
-                    previousRect->setRight(rightRect.right());
+            if (previousRect != -1 && rightRect.left() <= m_rects[previousRect].right()) {
+                if (m_rects[previousRect].right() < rightRect.right()) {
+                    m_rects[previousRect].setRight(rightRect.right());
                 }
             } else {
-                previousRect = &m_rects.emplaceBack(slicedRect(rightRect, top, bottom));
+                previousRect = m_rects.size();
+                m_rects.emplaceBack(slicedRect(rightRect, top, bottom));
             }
 
             ++rightIndex;
@@ -274,12 +531,13 @@ Region::BandRef Region::mergeBands(QSpan<const Rect> left, QSpan<const Rect> rig
     while (leftIndex != left.size()) {
         const Rect &leftRect = left[leftIndex];
 
-        if (leftRect.left() <= previousRect->right()) {
-            if (previousRect->right() < leftRect.right()) {
-                previousRect->setRight(leftRect.right());
+        if (leftRect.left() <= m_rects[previousRect].right()) {
+            if (m_rects[previousRect].right() < leftRect.right()) {
+                m_rects[previousRect].setRight(leftRect.right());
             }
         } else {
-            previousRect = &m_rects.emplaceBack(slicedRect(leftRect, top, bottom));
+            previousRect = m_rects.size();
+            m_rects.emplaceBack(slicedRect(leftRect, top, bottom));
         }
 
         ++leftIndex;
@@ -288,12 +546,13 @@ Region::BandRef Region::mergeBands(QSpan<const Rect> left, QSpan<const Rect> rig
     while (rightIndex != right.size()) {
         const Rect &rightRect = right[rightIndex];
 
-        if (rightRect.left() <= previousRect->right()) {
-            if (previousRect->right() < rightRect.right()) {
-                previousRect->setRight(rightRect.right());
+        if (rightRect.left() <= m_rects[previousRect].right()) {
+            if (m_rects[previousRect].right() < rightRect.right()) {
+                m_rects[previousRect].setRight(rightRect.right());
             }
         } else {
-            previousRect = &m_rects.emplaceBack(slicedRect(rightRect, top, bottom));
+            previousRect = m_rects.size();
+            m_rects.emplaceBack(slicedRect(rightRect, top, bottom));
         }
 
         ++rightIndex;
@@ -304,14 +563,15 @@ Region::BandRef Region::mergeBands(QSpan<const Rect> left, QSpan<const Rect> rig
 
 Region::BandRef Region::organizeBand(QSpan<const Rect> rects, int top, int bottom, const BandRef &previousBand)
 {
-    Rect *previousRect = nullptr;
+    qsizetype previousRect = -1;
     for (const Rect &rect : rects) {
-        if (previousRect && rect.left() <= previousRect->right()) {
-            if (previousRect->right() < rect.right()) {
-                previousRect->setRight(rect.right());
+        if (previousRect != -1 && rect.left() <= m_rects[previousRect].right()) {
+            if (m_rects[previousRect].right() < rect.right()) {
+                m_rects[previousRect].setRight(rect.right());
             }
         } else {
-            previousRect = &m_rects.emplaceBack(slicedRect(rect, top, bottom));
+            previousRect = m_rects.size();
+            m_rects.emplaceBack(slicedRect(rect, top, bottom));
         }
     }
 
@@ -325,6 +585,14 @@ Region::BandRef Region::subtractBands(QSpan<const Rect> left, QSpan<const Rect>
 
     int scanline = std::min(left[0].left(), right[0].left());
     while (leftIndex != left.size() && rightIndex != right.size()) {
+        // Rectangles in the right band that end before the current left rectangle starts
+        // do not cut anything out, skip them in bulk.
+        if (right[rightIndex].right() <= left[leftIndex].left()) {
+            rightIndex += regionKernels().skipBand(right.data() + rightIndex, right.size() - rightIndex, left[leftIndex].left());
+            scanline = right[rightIndex - 1].right();
+            continue;
+        }
+
         const Rect &leftRect = left[leftIndex];
         const Rect &rightRect = right[rightIndex];
 
@@ -363,7 +631,7 @@ Region::BandRef Region::subtractBands(QSpan<const Rect> left, QSpan<const Rect>
 
 Region::BandRef Region::xorBands(QSpan<const Rect> left, QSpan<const Rect> right, int top, int bottom, const BandRef &previousBand)
 {
-    Rect *previousRect = nullptr;
+    qsizetype previousRect = -1;
     qsizetype leftIndex = 0;
     qsizetype rightIndex = 0;
 
@@ -376,10 +644,11 @@ Region::BandRef Region::xorBands(QSpan<const Rect> left, QSpan<const Rect> right
             const int x = std::max(leftRect.left(), scanline);
             if (x < rightRect.left()) {
                 scanline = std::min(leftRect.right(), rightRect.left());
-                if (previousRect && previousRect->right() == x) {
-                    previousRect->setRight(scanline);
+                if (previousRect != -1 && m_rects[previousRect].right() == x) {
+                    m_rects[previousRect].setRight(scanline);
                 } else {
-                    previousRect = &m_rects.emplaceBack(Rect(QPoint(x, top), QPoint(scanline, bottom)));
+                    previousRect = m_rects.size();
+                    m_rects.emplaceBack(Rect(QPoint(x, top), QPoint(scanline, bottom)));
                 }
             } else {
                 scanline = std::min(leftRect.right(), rightRect.right());
@@ -388,10 +657,11 @@ Region::BandRef Region::xorBands(QSpan<const Rect> left, QSpan<const Rect> right
             const int x = std::max(rightRect.left(), scanline);
             if (x < leftRect.left()) {
                 scanline = std::min(leftRect.left(), rightRect.right());
-                if (previousRect && previousRect->right() == x) {
-                    previousRect->setRight(scanline);
+                if (previousRect != -1 && m_rects[previousRect].right() == x) {
+                    m_rects[previousRect].setRight(scanline);
                 } else {
-                    previousRect = &m_rects.emplaceBack(Rect(QPoint(x, top), QPoint(scanline, bottom)));
+                    previousRect = m_rects.size();
+                    m_rects.emplaceBack(Rect(QPoint(x, top), QPoint(scanline, bottom)));
                 }
             } else {
                 scanline = std::min(leftRect.right(), rightRect.right());
@@ -408,8 +678,8 @@ Region::BandRef Region::xorBands(QSpan<const Rect> left, QSpan<const Rect> right
 
     if (leftIndex != left.size()) {
         const int y = std::max(left[leftIndex].left(), scanline);
-        if (previousRect && previousRect->right() == y) {
-            previousRect->setRight(left[leftIndex].right());
+        if (previousRect != -1 && m_rects[previousRect].right() == y) {
+            m_rects[previousRect].setRight(left[leftIndex].right());
         } else {
             m_rects.emplaceBack(Rect(QPoint(y, top), QPoint(left[leftIndex].right(), bottom)));
         }
@@ -424,8 +694,8 @@ Region::BandRef Region::xorBands(QSpan<const Rect> left, QSpan<const Rect> right
 
     if (rightIndex != right.size()) {
         const int y = std::max(right[rightIndex].left(), scanline);
-        if (previousRect && previousRect->right() == y) {
-            previousRect->setRight(right[rightIndex].right());
+        if (previousRect != -1 && m_rects[previousRect].right() == y) {
+            m_rects[previousRect].setRight(right[rightIndex].right());
         } else {
             m_rects.emplaceBack(Rect(QPoint(y, top), QPoint(right[rightIndex].right(), bottom)));
         }
@@ -447,6 +717,16 @@ Region::BandRef Region::intersectBands(QSpan<const Rect> left, QSpan<const Rect>
     qsizetype rightIndex = 0;
 
     while (leftIndex != left.size() && rightIndex != right.size()) {
+        // Rectangles that end before the current rectangle in the other band starts do not
+        // contribute anything to the intersection, skip them in bulk.
+        if (left[leftIndex].right() <= right[rightIndex].left()) {
+            leftIndex += regionKernels().skipBand(left.data() + leftIndex, left.size() - leftIndex, right[rightIndex].left());
+            continue;
+        } else if (right[rightIndex].right() <= left[leftIndex].left()) {
+            rightIndex += regionKernels().skipBand(right.data() + rightIndex, right.size() - rightIndex, left[leftIndex].left());
+            continue;
+        }
+
         const int x1 = std::max(left[leftIndex].left(), right[rightIndex].left());
         const int x2 = std::min(left[leftIndex].right(), right[rightIndex].right());
         if (x1 < x2) {
@@ -478,12 +758,8 @@ Region::BandRef Region::coalesceBands(const BandRef &previous, const BandRef &cu
         return current;
     }
 
-    for (qsizetype i = 0; i < currentCount; ++i) {
-        const Rect &a = m_rects[previous.start + i];
-        const Rect &b = m_rects[current.start + i];
-        if (a.left() != b.left() || a.right() != b.right()) {
-            return current;
-        }
+    if (!regionKernels().bandsEqual(m_rects.constData() + previous.start, m_rects.constData() + current.start, currentCount)) {
+        return current;
     }
 
     const int currentBottom = m_rects[current.start].bottom();
@@ -1517,7 +1793,7 @@ QSpan<const RectF> RegionF::rects() const
     if (m_rects.isEmpty()) {
         return QSpan(&m_bounds, 1);
     } else {
-        return QSpan(m_rects);
+        return QSpan<const RectF>(m_rects.constData(), m_rects.size());
     }
 }
 
@@ -1558,7 +1834,7 @@ RegionF::BandRef RegionF::sliceBand(QSpan<const RectF> rects, qreal top, qreal b
 
 RegionF::BandRef RegionF::mergeBands(QSpan<const RectF> left, QSpan<const RectF> right, qreal top, qreal bottom, const BandRef &previousBand)
 {
-    RectF *previousRect = nullptr;
+    qsizetype previousRect = -1;
     qsizetype leftIndex = 0;
     qsizetype rightIndex = 0;
 
@@ -1567,22 +1843,24 @@ RegionF::BandRef RegionF::mergeBands(QSpan<const RectF> left, QSpan<const RectF>
         const RectF &rightRect = right[rightIndex];
 
         if (leftRect.left() < rightRect.left()) {
-            if (previousRect && leftRect.left() <= previousRect->right()) {
-                if (previousRect->right() < leftRect.right()) {
-                    previousRect->setRight(leftRect.right());
+            if (previousRect != -1 && leftRect.left() <= m_rects[previousRect].right()) {
+                if (m_rects[previousRect].right() < leftRect.right()) {
+                    m_rects[previousRect].setRight(leftRect.right());
                 }
             } else {
-                previousRect = &m_rects.emplaceBack(slicedRect(leftRect, top, bottom));
+                previousRect = m_rects.size();
+                m_rects.emplaceBack(slicedRect(leftRect, top, bottom));
             }
 
             ++leftIndex;
         } else {
-            if (previousRect && rightRect.left() <= previousRect->right()) {
-                if (previousRect->right() < rightRect.right()) {
-                    previousRect->setRight(rightRect.right());
+            if (previousRect != -1 && rightRect.left() <= m_rects[previousRect].right()) {
+                if (m_rects[previousRect].right() < rightRect.right()) {
+                    m_rects[previousRect].setRight(rightRect.right());
                 }
             } else {
-                previousRect = &m_rects.emplaceBack(slicedRect(rightRect, top, bottom));
+                previousRect = m_rects.size();
+                m_rects.emplaceBack(slicedRect(rightRect, top, bottom));
             }
 
             ++rightIndex;
@@ -1592,12 +1870,13 @@ RegionF::BandRef RegionF::mergeBands(QSpan<const RectF> left, QSpan<const RectF>
     while (leftIndex != left.size()) {
         const RectF &leftRect = left[leftIndex];
 
-        if (leftRect.left() <= previousRect->right()) {
-            if (previousRect->right() < leftRect.right()) {
-                previousRect->setRight(leftRect.right());
+        if (leftRect.left() <= m_rects[previousRect].right()) {
+            if (m_rects[previousRect].right() < leftRect.right()) {
+                m_rects[previousRect].setRight(leftRect.right());
             }
         } else {
-            previousRect = &m_rects.emplaceBack(slicedRect(leftRect, top, bottom));
+            previousRect = m_rects.size();
+            m_rects.emplaceBack(slicedRect(leftRect, top, bottom));
         }
 
         ++leftIndex;
@@ -1606,12 +1885,13 @@ RegionF::BandRef RegionF::mergeBands(QSpan<const RectF> left, QSpan<const RectF>
     while (rightIndex != right.size()) {
         const RectF &rightRect = right[rightIndex];
 
-        if (rightRect.left() <= previousRect->right()) {
-            if (previousRect->right() < rightRect.right()) {
-                previousRect->setRight(rightRect.right());
+        if (rightRect.left() <= m_rects[previousRect].right()) {
+            if (m_rects[previousRect].right() < rightRect.right()) {
+                m_rects[previousRect].setRight(rightRect.right());
             }
         } else {
-            previousRect = &m_rects.emplaceBack(slicedRect(rightRect, top, bottom));
+            previousRect = m_rects.size();
+            m_rects.emplaceBack(slicedRect(rightRect, top, bottom));
         }
 
         ++rightIndex;
@@ -1622,14 +1902,15 @@ RegionF::BandRef RegionF::mergeBands(QSpan<const RectF> left, QSpan<const RectF>
 
 RegionF::BandRef RegionF::organizeBand(QSpan<const RectF> rects, qreal top, qreal bottom, const BandRef &previousBand)
 {
-    RectF *previousRect = nullptr;
+    qsizetype previousRect = -1;
     for (const RectF &rect : rects) {
-        if (previousRect && rect.left() <= previousRect->right()) {
-            if (previousRect->right() < rect.right()) {
-                previousRect->setRight(rect.right());
+        if (previousRect != -1 && rect.left() <= m_rects[previousRect].right()) {
+            if (m_rects[previousRect].right() < rect.right()) {
+                m_rects[previousRect].setRight(rect.right());
             }
         } else {
-            previousRect = &m_rects.emplaceBack(slicedRect(rect, top, bottom));
+            previousRect = m_rects.size();
+            m_rects.emplaceBack(slicedRect(rect, top, bottom));
         }
     }
 
@@ -1643,6 +1924,14 @@ RegionF::BandRef RegionF::subtractBands(QSpan<const RectF> left, QSpan<const Rec
 
     qreal scanline = std::min(left[0].left(), right[0].left());
     while (leftIndex != left.size() && rightIndex != right.size()) {
+        // Rectangles in the right band that end before the current left rectangle starts
+        // do not cut anything out, skip them in bulk.
+        if (right[rightIndex].right() <= left[leftIndex].left()) {
+            rightIndex += regionKernels().skipBandF(right.data() + rightIndex, right.size() - rightIndex, left[leftIndex].left());
+            scanline = right[rightIndex - 1].right();
+            continue;
+        }
+
         const RectF &leftRect = left[leftIndex];
         const RectF &rightRect = right[rightIndex];
 
@@ -1681,7 +1970,7 @@ RegionF::BandRef RegionF::subtractBands(QSpan<const RectF> left, QSpan<const Rec
 
 RegionF::BandRef RegionF::xorBands(QSpan<const RectF> left, QSpan<const RectF> right, qreal top, qreal bottom, const BandRef &previousBand)
 {
-    RectF *previousRect = nullptr;
+    qsizetype previousRect = -1;
     qsizetype leftIndex = 0;
     qsizetype rightIndex = 0;
 
@@ -1694,10 +1983,11 @@ RegionF::BandRef RegionF::xorBands(QSpan<const RectF> left, QSpan<const RectF> r
             const qreal x = std::max(leftRect.left(), scanline);
             if (x < rightRect.left()) {
                 scanline = std::min(leftRect.right(), rightRect.left());
-                if (previousRect && previousRect->right() == x) {
-                    previousRect->setRight(scanline);
+                if (previousRect != -1 && m_rects[previousRect].right() == x) {
+                    m_rects[previousRect].setRight(scanline);
                 } else {
-                    previousRect = &m_rects.emplaceBack(RectF(QPointF(x, top), QPointF(scanline, bottom)));
+                    previousRect = m_rects.size();
+                    m_rects.emplaceBack(RectF(QPointF(x, top), QPointF(scanline, bottom)));
                 }
             } else {
                 scanline = std::min(leftRect.right(), rightRect.right());
@@ -1706,10 +1996,11 @@ RegionF::BandRef RegionF::xorBands(QSpan<const RectF> left, QSpan<const RectF> r
             const qreal x = std::max(rightRect.left(), scanline);
             if (x < leftRect.left()) {
                 scanline = std::min(leftRect.left(), rightRect.right());
-                if (previousRect && previousRect->right() == x) {
-                    previousRect->setRight(scanline);
+                if (previousRect != -1 && m_rects[previousRect].right() == x) {
+                    m_rects[previousRect].setRight(scanline);
                 } else {
-                    previousRect = &m_rects.emplaceBack(RectF(QPointF(x, top), QPointF(scanline, bottom)));
+                    previousRect = m_rects.size();
+                    m_rects.emplaceBack(RectF(QPointF(x, top), QPointF(scanline, bottom)));
                 }
             } else {
                 scanline = std::min(leftRect.right(), rightRect.right());
@@ -1726,8 +2017,8 @@ RegionF::BandRef RegionF::xorBands(QSpan<const RectF> left, QSpan<const RectF> r
 
     if (leftIndex != left.size()) {
         const qreal y = std::max(left[leftIndex].left(), scanline);
-        if (previousRect && previousRect->right() == y) {
-            previousRect->setRight(left[leftIndex].right());
+        if (previousRect != -1 && m_rects[previousRect].right() == y) {
+            m_rects[previousRect].setRight(left[leftIndex].right());
         } else {
             m_rects.emplaceBack(RectF(QPointF(y, top), QPointF(left[leftIndex].right(), bottom)));
         }
@@ -1742,8 +2033,8 @@ RegionF::BandRef RegionF::xorBands(QSpan<const RectF> left, QSpan<const RectF> r
 
     if (rightIndex != right.size()) {
         const qreal y = std::max(right[rightIndex].left(), scanline);
-        if (previousRect && previousRect->right() == y) {
-            previousRect->setRight(right[rightIndex].right());
+        if (previousRect != -1 && m_rects[previousRect].right() == y) {
+            m_rects[previousRect].setRight(right[rightIndex].right());
         } else {
             m_rects.emplaceBack(RectF(QPointF(y, top), QPointF(right[rightIndex].right(), bottom)));
         }
@@ -1765,6 +2056,16 @@ RegionF::BandRef RegionF::intersectBands(QSpan<const RectF> left, QSpan<const Re
     qsizetype rightIndex = 0;
 
     while (leftIndex != left.size() && rightIndex != right.size()) {
+        // Rectangles that end before the current rectangle in the other band starts do not
+        // contribute anything to the intersection, skip them in bulk.
+        if (left[leftIndex].right() <= right[rightIndex].left()) {
+            leftIndex += regionKernels().skipBandF(left.data() + leftIndex, left.size() - leftIndex, right[rightIndex].left());
+            continue;
+        } else if (right[rightIndex].right() <= left[leftIndex].left()) {
+            rightIndex += regionKernels().skipBandF(right.data() + rightIndex, right.size() - rightIndex, left[leftIndex].left());
+            continue;
+        }
+
         const qreal x1 = std::max(left[leftIndex].left(), right[rightIndex].left());
         const qreal x2 = std::min(left[leftIndex].right(), right[rightIndex].right());
         if (x1 < x2) {
@@ -1796,12 +2097,8 @@ RegionF::BandRef RegionF::coalesceBands(const BandRef &previous, const BandRef &
         return current;
     }
 
-    for (qsizetype i = 0; i < currentCount; ++i) {
-        const RectF &a = m_rects[previous.start + i];
-        const RectF &b = m_rects[current.start + i];
-        if (a.left() != b.left() || a.right() != b.right()) {
-            return current;
-        }
+    if (!regionKernels().bandsEqualF(m_rects.constData() + previous.start, m_rects.constData() + current.start, currentCount)) {
+        return current;
     }
 
     const qreal currentBottom = m_rects[current.start].bottom();
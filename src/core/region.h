@@ -12,13 +12,230 @@
 #include <QRegion>
 #include <QSpan>
 
+#include <algorithm>
 #include <limits>
+#include <type_traits>
+#include <utility>
 
 namespace KWin
 {
 
 class RegionF;
 
+/*!
+ * \internal
+ *
+ * The RegionStorage type stores the rectangles of a Region or a RegionF. Up to \c Prealloc
+ * rectangles are stored inline, in the region object itself, so the most common regions with
+ * a handful of rectangles never allocate any memory. Once the storage grows past that, the
+ * rectangles are moved to an implicitly shared QList.
+ *
+ * Unlike QList, reserve() does not allocate memory as long as the rectangles fit in the inline
+ * storage, so references to the stored rectangles must not be kept while appending new ones.
+ *
+ * The inline storage is part of the object, so it makes Region and RegionF noticeably bigger
+ * than a QRegion, and changing \c Prealloc changes the size of every type that embeds them.
+ * A moved-from storage is always left empty and inline.
+ */
+template<typename T, qsizetype Prealloc>
+class RegionStorage
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+    RegionStorage() = default;
+    RegionStorage(const RegionStorage &other) = default;
+    RegionStorage(RegionStorage &&other);
+
+    bool isEmpty() const;
+    qsizetype size() const;
+
+    T *data();
+    const T *data() const;
+    const T *constData() const;
+    const T &constFirst() const;
+
+    T *begin();
+    T *end();
+    const T *begin() const;
+    const T *end() const;
+
+    T &operator[](qsizetype index);
+    const T &operator[](qsizetype index) const;
+
+    void reserve(qsizetype size);
+    void resizeForOverwrite(qsizetype size);
+    void emplaceBack(const T &value);
+    void append(const T &value);
+    void remove(qsizetype index, qsizetype count);
+
+    bool operator==(const RegionStorage &other) const;
+    RegionStorage &operator=(const RegionStorage &other) = default;
+    RegionStorage &operator=(RegionStorage &&other);
+
+private:
+    void spill(qsizetype capacity);
+
+    T m_inline[Prealloc];
+    qsizetype m_inlineSize = 0;
+    qsizetype m_capacityHint = 0;
+    QList<T> m_list;
+    bool m_spilled = false;
+};
+
+template<typename T, qsizetype Prealloc>
+inline RegionStorage<T, Prealloc>::RegionStorage(RegionStorage &&other)
+    : m_inlineSize(std::exchange(other.m_inlineSize, 0))
+    , m_capacityHint(std::exchange(other.m_capacityHint, 0))
+    , m_list(std::exchange(other.m_list, {}))
+    , m_spilled(std::exchange(other.m_spilled, false))
+{
+    std::copy(other.m_inline, other.m_inline + m_inlineSize, m_inline);
+}
+
+template<typename T, qsizetype Prealloc>
+inline bool RegionStorage<T, Prealloc>::isEmpty() const
+{
+    return size() == 0;
+}
+
+template<typename T, qsizetype Prealloc>
+inline qsizetype RegionStorage<T, Prealloc>::size() const
+{
+    return m_spilled ? m_list.size() : m_inlineSize;
+}
+
+template<typename T, qsizetype Prealloc>
+inline T *RegionStorage<T, Prealloc>::data()
+{
+    return m_spilled ? m_list.data() : m_inline;
+}
+
+template<typename T, qsizetype Prealloc>
+inline const T *RegionStorage<T, Prealloc>::data() const
+{
+    return constData();
+}
+
+template<typename T, qsizetype Prealloc>
+inline const T *RegionStorage<T, Prealloc>::constData() const
+{
+    return m_spilled ? m_list.constData() : m_inline;
+}
+
+template<typename T, qsizetype Prealloc>
+inline const T &RegionStorage<T, Prealloc>::constFirst() const
+{
+    return constData()[0];
+}
+
+template<typename T, qsizetype Prealloc>
+inline T *RegionStorage<T, Prealloc>::begin()
+{
+    return data();
+}
+
+template<typename T, qsizetype Prealloc>
+inline T *RegionStorage<T, Prealloc>::end()
+{
+    return data() + size();
+}
+
+template<typename T, qsizetype Prealloc>
+inline const T *RegionStorage<T, Prealloc>::begin() const
+{
+    return constData();
+}
+
+template<typename T, qsizetype Prealloc>
+inline const T *RegionStorage<T, Prealloc>::end() const
+{
+    return constData() + size();
+}
+
+template<typename T, qsizetype Prealloc>
+inline T &RegionStorage<T, Prealloc>::operator[](qsizetype index)
+{
+    return data()[index];
+}
+
+template<typename T, qsizetype Prealloc>
+inline const T &RegionStorage<T, Prealloc>::operator[](qsizetype index) const
+{
+    return constData()[index];
+}
+
+template<typename T, qsizetype Prealloc>
+inline void RegionStorage<T, Prealloc>::reserve(qsizetype size)
+{
+    if (m_spilled) {
+        m_list.reserve(size);
+    } else {
+        m_capacityHint = std::max(m_capacityHint, size);
+    }
+}
+
+template<typename T, qsizetype Prealloc>
+inline void RegionStorage<T, Prealloc>::resizeForOverwrite(qsizetype size)
+{
+    if (!m_spilled && size > Prealloc) {
+        spill(size);
+    }
+
+    if (m_spilled) {
+        m_list.resizeForOverwrite(size);
+    } else {
+        m_inlineSize = size;
+    }
+}
+
+template<typename T, qsizetype Prealloc>
+inline void RegionStorage<T, Prealloc>::emplaceBack(const T &value)
+{
+    if (!m_spilled) {
+        if (m_inlineSize < Prealloc) {
+            m_inline[m_inlineSize++] = value;
+            return;
+        }
+        spill(std::max(m_capacityHint, Prealloc * 2));
+    }
+    m_list.emplaceBack(value);
+}
+
+template<typename T, qsizetype Prealloc>
+inline void RegionStorage<T, Prealloc>::append(const T &value)
+{
+    emplaceBack(value);
+}
+
+template<typename T, qsizetype Prealloc>
+inline void RegionStorage<T, Prealloc>::remove(qsizetype index, qsizetype count)
+{
+    if (m_spilled) {
+        m_list.remove(index, count);
+    } else {
+        std::copy(m_inline + index + count, m_inline + m_inlineSize, m_inline + index);
+        m_inlineSize -= count;
+    }
+}
+
+template<typename T, qsizetype Prealloc>
+inline bool RegionStorage<T, Prealloc>::operator==(const RegionStorage &other) const
+{
+    return std::equal(begin(), end(), other.begin(), other.end());
+}
+
+template<typename T, qsizetype Prealloc>
+inline RegionStorage<T, Prealloc> &RegionStorage<T, Prealloc>::operator=(RegionStorage &&other)
+{
+    std::copy(other.m_inline, other.m_inline + other.m_inlineSize, m_inline);
+    m_inlineSize = std::exchange(other.m_inlineSize, 0);
+    m_capacityHint = std::exchange(other.m_capacityHint, 0);
+    m_list = std::exchange(other.m_list, {});
+    m_spilled = std::exchange(other.m_spilled, false);
+    return *this;
+}
+
 /*!
  * \class KWin::Region
  * \inmodule KWin
@@ -512,7 +729,7 @@ private:
     BandRef coalesceBands(const BandRef &previous, const BandRef &current);
     void appendRects(QSpan<const Rect> rects);
 
-    QList<Rect> m_rects;
+    RegionStorage<Rect, 4> m_rects;
     Rect m_bounds;
 };
 
@@ -1032,7 +1249,7 @@ private:
     BandRef coalesceBands(const BandRef &previous, const BandRef &current);
     void appendRects(QSpan<const RectF> rects);
 
-    QList<RectF> m_rects;
+    RegionStorage<RectF, 4> m_rects;
     RectF m_bounds;
 
     friend class Region;
@@ -0,0 +1,51 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QtGlobal>
+
+namespace KWin
+{
+
+/*!
+ * \internal
+ *
+ * The instruction set used by the Region and RegionF band kernels. The best instruction set
+ * supported by the CPU is picked at runtime.
+ */
+enum class RegionIsa {
+    Scalar,
+    Sse41,
+    Avx2,
+};
+
+/*!
+ * \internal
+ *
+ * Returns the best instruction set supported by the CPU for the region band kernels.
+ */
+KWIN_EXPORT RegionIsa bestRegionIsa();
+
+/*!
+ * \internal
+ *
+ * Returns the instruction set currently used by the region band kernels.
+ */
+KWIN_EXPORT RegionIsa regionIsa();
+
+/*!
+ * \internal
+ *
+ * Forces the region band kernels to use the specified \a isa. If the CPU does not support
+ * the given instruction set, the best supported one will be used instead. This is intended
+ * to be used only by tests and benchmarks.
+ */
+KWIN_EXPORT void setRegionIsa(RegionIsa isa);
+
+} // namespace KWin
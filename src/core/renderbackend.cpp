@@ -55,7 +55,7 @@ OutputFrame::~OutputFrame()
 {
     Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
     if (!m_presented && m_loop) {
-        RenderLoopPrivate::get(m_loop)->notifyFrameDropped();
+        RenderLoopPrivate::get(m_loop)->notifyFrameDropped(this);
     }
 }
 
@@ -138,6 +138,30 @@ std::chrono::nanoseconds OutputFrame::predictedRenderTime() const
     return m_predictedRenderTime;
 }
 
+void OutputFrame::setPrepareTime(const RenderTimeSpan &span)
+{
+    m_prepareTime = span;
+}
+
+std::optional<RenderTimeSpan> OutputFrame::prepareTime() const
+{
+    return m_prepareTime;
+}
+
+void OutputFrame::setCommitTime(std::chrono::steady_clock::time_point time)
+{
+    m_commitTime.store(time.time_since_epoch().count(), std::memory_order_relaxed);
+}
+
+std::optional<std::chrono::steady_clock::time_point> OutputFrame::commitTime() const
+{
+    const int64_t time = m_commitTime.load(std::memory_order_relaxed);
+    if (!time) {
+        return std::nullopt;
+    }
+    return std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(time));
+}
+
 std::optional<double> OutputFrame::brightness() const
 {
     return m_brightness;
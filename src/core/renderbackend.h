@@ -13,6 +13,7 @@
 
 #include <QObject>
 #include <QPointer>
+#include <atomic>
 #include <memory>
 #include <sys/types.h>
 
@@ -92,6 +93,19 @@ public:
     std::chrono::nanoseconds refreshDuration() const;
     std::chrono::nanoseconds predictedRenderTime() const;
 
+    /**
+     * Sets the time span during which the compositor prepared the scene for this frame.
+     */
+    void setPrepareTime(const RenderTimeSpan &span);
+    std::optional<RenderTimeSpan> prepareTime() const;
+
+    /**
+     * Sets the time when the frame has been committed to the display. Unlike the other
+     * setters, this function can be called from any thread.
+     */
+    void setCommitTime(std::chrono::steady_clock::time_point time);
+    std::optional<std::chrono::steady_clock::time_point> commitTime() const;
+
     std::optional<double> brightness() const;
     void setBrightness(double brightness);
 
@@ -113,6 +127,8 @@ private:
     PresentationMode m_presentationMode = PresentationMode::VSync;
     std::vector<std::unique_ptr<RenderTimeQuery>> m_renderTimeQueries;
     bool m_presented = false;
+    std::optional<RenderTimeSpan> m_prepareTime;
+    std::atomic<int64_t> m_commitTime = 0;
     std::optional<double> m_brightness;
     std::optional<double> m_dimmingFactor;
     std::optional<double> m_artificialHdrHeadroom;
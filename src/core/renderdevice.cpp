@@ -265,14 +265,19 @@ static std::unique_ptr<VulkanDevice> openVulkanDevice(const vk::raii::Instance &
             });
         }
 
-        const auto featuresChain = physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceHostQueryResetFeatures>();
+        const auto featuresChain = physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceHostQueryResetFeatures, vk::PhysicalDeviceDynamicRenderingFeatures>();
         if (!featuresChain.get<vk::PhysicalDeviceHostQueryResetFeatures>().hostQueryReset) {
             qCWarning(KWIN_VULKAN, "Physical device %s doesn't support host query resets", deviceName);
             continue;
         }
+        // only needed for compositing with Vulkan, copies between GPUs work without it
+        const bool dynamicRendering = featuresChain.get<vk::PhysicalDeviceDynamicRenderingFeatures>().dynamicRendering;
 
+        vk::PhysicalDeviceDynamicRenderingFeatures dynamicRenderingFeatures;
+        dynamicRenderingFeatures.dynamicRendering = dynamicRendering;
         vk::PhysicalDeviceHostQueryResetFeatures hostQueryReset;
         hostQueryReset.hostQueryReset = true;
+        hostQueryReset.pNext = &dynamicRenderingFeatures;
         vk::PhysicalDeviceSynchronization2Features syncFeatures;
         syncFeatures.synchronization2 = true;
         syncFeatures.pNext = &hostQueryReset;
@@ -302,7 +307,10 @@ static std::unique_ptr<VulkanDevice> openVulkanDevice(const vk::raii::Instance &
             physicalDevice,
             std::move(logicalDevice),
             queueProperties | std::ranges::to<std::vector<VkQueueFamilyProperties>>(),
-            basicProperties.properties.deviceType);
+            basicProperties.properties.deviceType,
+            dynamicRendering,
+            // Sampling from udmabufs results in black on Nvidia and i915, like with EGL
+            !drm || !(drm->isNvidia() || drm->isI915()));
         if (ret->transferFormats().isEmpty()) {
             continue;
         }
@@ -14,8 +14,28 @@ using namespace std::chrono_literals;
 namespace KWin
 {
 
-RenderJournal::RenderJournal()
+static constexpr std::chrono::nanoseconds s_bucketWidth = 100us;
+static constexpr size_t s_bucketCount = 500;
+static constexpr std::chrono::nanoseconds s_maxSampleAge = 2s;
+
+RenderJournal::RenderJournal(Predictor predictor, double percentile, int windowSize)
+    : m_predictor(predictor)
+    , m_percentile(std::clamp(percentile, 0.0, 1.0))
+    , m_windowSize(std::max(windowSize, 1))
 {
+    if (m_predictor == Predictor::Percentile) {
+        m_histogram.resize(s_bucketCount + 1);
+    }
+}
+
+RenderJournal::Predictor RenderJournal::predictor() const
+{
+    return m_predictor;
+}
+
+double RenderJournal::percentile() const
+{
+    return m_percentile;
 }
 
 static std::chrono::nanoseconds mix(std::chrono::nanoseconds duration1, std::chrono::nanoseconds duration2, double ratio)
@@ -24,6 +44,18 @@ static std::chrono::nanoseconds mix(std::chrono::nanoseconds duration1, std::chr
 }
 
 void RenderJournal::add(std::chrono::nanoseconds renderTime, std::chrono::nanoseconds presentationTimestamp)
+{
+    switch (m_predictor) {
+    case Predictor::Smoothed:
+        addSmoothed(renderTime, presentationTimestamp);
+        break;
+    case Predictor::Percentile:
+        addPercentile(renderTime, presentationTimestamp);
+        break;
+    }
+}
+
+void RenderJournal::addSmoothed(std::chrono::nanoseconds renderTime, std::chrono::nanoseconds presentationTimestamp)
 {
     const auto timeDifference = m_lastAdd ? presentationTimestamp - *m_lastAdd : 10s;
     m_lastAdd = presentationTimestamp;
@@ -38,8 +70,51 @@ void RenderJournal::add(std::chrono::nanoseconds renderTime, std::chrono::nanose
     m_result = mix(renderTime, m_result, ratio);
 }
 
+static size_t bucketIndex(std::chrono::nanoseconds renderTime)
+{
+    return std::min<size_t>(std::max(renderTime, 0ns) / s_bucketWidth, s_bucketCount);
+}
+
+void RenderJournal::addPercentile(std::chrono::nanoseconds renderTime, std::chrono::nanoseconds presentationTimestamp)
+{
+    while (!m_window.empty() && (m_window.size() >= m_windowSize || presentationTimestamp - m_window.front().presentationTimestamp > s_maxSampleAge)) {
+        m_histogram[bucketIndex(m_window.front().renderTime)]--;
+        m_window.pop_front();
+    }
+    m_window.push_back(Sample{
+        .renderTime = renderTime,
+        .presentationTimestamp = presentationTimestamp,
+    });
+    m_histogram[bucketIndex(renderTime)]++;
+
+    // The smallest render time that at least the given share of the frames in the window fit in.
+    const size_t rank = std::max<size_t>(std::ceil(m_percentile * m_window.size()), 1);
+    size_t count = 0;
+    for (size_t bucket = 0; bucket < s_bucketCount; ++bucket) {
+        count += m_histogram[bucket];
+        if (count >= rank) {
+            m_result = s_bucketWidth * (bucket + 1);
+            return;
+        }
+    }
+
+    // The percentile is in the overflow bucket, which is rare enough to scan the window.
+    std::vector<std::chrono::nanoseconds> overflow;
+    for (const Sample &sample : m_window) {
+        if (bucketIndex(sample.renderTime) == s_bucketCount) {
+            overflow.push_back(sample.renderTime);
+        }
+    }
+    const size_t overflowRank = rank - count - 1;
+    std::nth_element(overflow.begin(), overflow.begin() + overflowRank, overflow.end());
+    m_result = overflow[overflowRank];
+}
+
 std::chrono::nanoseconds RenderJournal::result() const
 {
+    if (m_predictor == Predictor::Percentile) {
+        return m_result;
+    }
     return m_result + m_variance * 2;
 }
 
@@ -8,7 +8,9 @@
 #include "kwin_export.h"
 
 #include <chrono>
+#include <deque>
 #include <optional>
+#include <vector>
 
 namespace KWin
 {
@@ -20,16 +22,57 @@ namespace KWin
 class KWIN_EXPORT RenderJournal
 {
 public:
-    explicit RenderJournal();
+    enum class Predictor {
+        /**
+         * The render time is estimated as the exponentially smoothed render time plus twice
+         * the smoothed overshoot. It reacts quickly to changes, but bimodal workloads either
+         * cause missed deadlines or inflate the estimate for all frames.
+         */
+        Smoothed,
+        /**
+         * The render time is estimated as a percentile of the render times in a sliding
+         * window of the most recent frames. Frames older than two seconds drop out of the
+         * window even if it isn't full, so the prediction follows workload changes and
+         * doesn't hold on to frames from before an idle period.
+         */
+        Percentile,
+    };
+
+    explicit RenderJournal(Predictor predictor = Predictor::Smoothed, double percentile = 0.95, int windowSize = 120);
+
+    Predictor predictor() const;
+    double percentile() const;
 
     void add(std::chrono::nanoseconds renderTime, std::chrono::nanoseconds presentationTimestamp);
 
     std::chrono::nanoseconds result() const;
 
 private:
+    void addSmoothed(std::chrono::nanoseconds renderTime, std::chrono::nanoseconds presentationTimestamp);
+    void addPercentile(std::chrono::nanoseconds renderTime, std::chrono::nanoseconds presentationTimestamp);
+
+    const Predictor m_predictor;
     std::chrono::nanoseconds m_result{0};
     std::chrono::nanoseconds m_variance{0};
     std::optional<std::chrono::nanoseconds> m_lastAdd;
+
+    struct Sample
+    {
+        std::chrono::nanoseconds renderTime;
+        std::chrono::nanoseconds presentationTimestamp;
+    };
+
+    const double m_percentile;
+    /**
+     * The render times of the last frames, from the oldest to the newest one.
+     */
+    std::deque<Sample> m_window;
+    size_t m_windowSize;
+    /**
+     * Number of render times in the window per bucket. The last bucket collects all render
+     * times that don't fit in the other buckets.
+     */
+    std::vector<uint32_t> m_histogram;
 };
 
 } // namespace KWin
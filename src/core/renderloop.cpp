@@ -24,9 +24,20 @@ RenderLoopPrivate *RenderLoopPrivate::get(RenderLoop *loop)
 
 static const bool s_printDebugInfo = qEnvironmentVariableIntValue("KWIN_LOG_PERFORMANCE_DATA") != 0;
 
+static RenderJournal createRenderJournal()
+{
+    if (qgetenv("KWIN_RENDER_TIME_PREDICTOR") != QByteArrayLiteral("percentile")) {
+        return RenderJournal(RenderJournal::Predictor::Smoothed);
+    }
+    bool ok = false;
+    const int percentile = qEnvironmentVariableIntValue("KWIN_RENDER_TIME_PERCENTILE", &ok);
+    return RenderJournal(RenderJournal::Predictor::Percentile, ok ? std::clamp(percentile, 1, 100) / 100.0 : 0.95);
+}
+
 RenderLoopPrivate::RenderLoopPrivate(RenderLoop *q, BackendOutput *output)
     : q(q)
     , output(output)
+    , renderJournal(createRenderJournal())
 {
     QObject::connect(&compositeTimer, &PreciseTimer::timeout, q, [this] {
         dispatch();
@@ -117,11 +128,13 @@ void RenderLoopPrivate::delayScheduleRepaint()
     pendingReschedule = true;
 }
 
-void RenderLoopPrivate::notifyFrameDropped()
+void RenderLoopPrivate::notifyFrameDropped(OutputFrame *frame)
 {
     Q_ASSERT(pendingFrameCount > 0);
     pendingFrameCount--;
 
+    recordFrameStatistics(FrameStatistics::Status::Dropped, frame, std::nullopt, frame->presentationMode(), std::chrono::nanoseconds::zero());
+
     if (!inhibitCount && pendingReschedule) {
         scheduleNextRepaint();
     }
@@ -144,6 +157,8 @@ void RenderLoopPrivate::notifyFrameCompleted(std::chrono::nanoseconds timestamp,
     Q_ASSERT(pendingFrameCount > 0);
     pendingFrameCount--;
 
+    recordFrameStatistics(FrameStatistics::Status::Presented, frame, renderTime, mode, timestamp);
+
     notifyVblank(timestamp);
 
     if (renderTime) {
@@ -160,6 +175,27 @@ void RenderLoopPrivate::notifyFrameCompleted(std::chrono::nanoseconds timestamp,
     Q_EMIT q->framePresented(q, timestamp, mode);
 }
 
+void RenderLoopPrivate::recordFrameStatistics(FrameStatistics::Status status, OutputFrame *frame, std::optional<RenderTimeSpan> renderTime, PresentationMode mode, std::chrono::nanoseconds timestamp)
+{
+    const auto prepareTime = frame->prepareTime().value_or(RenderTimeSpan{});
+    const auto renderSpan = renderTime.value_or(RenderTimeSpan{});
+    const auto commitTime = frame->commitTime().value_or(std::chrono::steady_clock::time_point{});
+
+    frameStatistics.add(FrameStatistics{
+        .status = status,
+        .presentationMode = mode,
+        .refreshDuration = frame->refreshDuration(),
+        .predictedRenderTime = frame->predictedRenderTime(),
+        .targetPresentationTimestamp = frame->targetPageflipTime().time_since_epoch(),
+        .prepareStart = prepareTime.start.time_since_epoch(),
+        .prepareEnd = prepareTime.end.time_since_epoch(),
+        .renderStart = renderSpan.start.time_since_epoch(),
+        .renderEnd = renderSpan.end.time_since_epoch(),
+        .commitTimestamp = commitTime.time_since_epoch(),
+        .presentationTimestamp = timestamp,
+    });
+}
+
 void RenderLoopPrivate::notifyVblank(std::chrono::nanoseconds timestamp)
 {
     if (lastPresentationTimestamp <= timestamp) {
@@ -318,6 +354,11 @@ std::chrono::nanoseconds RenderLoop::predictedRenderTime() const
     return d->renderJournal.result();
 }
 
+const FrameStatisticsRing *RenderLoop::frameStatistics() const
+{
+    return &d->frameStatistics;
+}
+
 } // namespace KWin
 
 #include "moc_renderloop.cpp"
@@ -17,6 +17,7 @@ class RenderLoopPrivate;
 class SurfaceItem;
 class Item;
 class BackendOutput;
+class FrameStatisticsRing;
 class OutputLayer;
 
 /**
@@ -100,6 +101,12 @@ public:
      */
     std::chrono::nanoseconds predictedRenderTime() const;
 
+    /**
+     * Returns the statistics of the most recently presented and dropped frames. The
+     * statistics can be read from any thread.
+     */
+    const FrameStatisticsRing *frameStatistics() const;
+
     // TODO integrate cursor updates into the render loop / frame scheduling somehow?
     // and then remove this again
     bool activeWindowControlsVrrRefreshRate() const;
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "framestatistics.h"
 #include "renderbackend.h"
 #include "renderjournal.h"
 #include "renderloop.h"
@@ -34,8 +35,9 @@ public:
     void scheduleNextRepaint();
     void scheduleRepaint(std::chrono::nanoseconds lastTargetTimestamp);
 
-    void notifyFrameDropped();
+    void notifyFrameDropped(OutputFrame *frame);
     void notifyFrameCompleted(std::chrono::nanoseconds timestamp, std::optional<RenderTimeSpan> renderTime, PresentationMode mode, OutputFrame *frame);
+    void recordFrameStatistics(FrameStatistics::Status status, OutputFrame *frame, std::optional<RenderTimeSpan> renderTime, PresentationMode mode, std::chrono::nanoseconds timestamp);
     void notifyVblank(std::chrono::nanoseconds timestamp);
 
     RenderLoop *const q;
@@ -47,6 +49,7 @@ public:
     int doubleBufferingCounter = 0;
     PreciseTimer compositeTimer;
     RenderJournal renderJournal;
+    FrameStatisticsRing frameStatistics;
     int refreshRate = 60000;
     int pendingFrameCount = 0;
     bool preparingNewFrame = false;
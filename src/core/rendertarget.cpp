@@ -6,6 +6,7 @@
 
 #include "core/rendertarget.h"
 #include "opengl/glutils.h"
+#include "vulkan/vulkan_texture.h"
 
 namespace KWin
 {
@@ -23,6 +24,13 @@ RenderTarget::RenderTarget(QImage *image, const std::shared_ptr<ColorDescription
 {
 }
 
+RenderTarget::RenderTarget(VulkanTexture *texture, const std::shared_ptr<SyncReleasePoint> &releasePoint, const std::shared_ptr<ColorDescription> &colorDescription)
+    : m_vulkanTexture(texture)
+    , m_releasePoint(releasePoint)
+    , m_colorDescription(colorDescription)
+{
+}
+
 QSize RenderTarget::transformedSize() const
 {
     return m_transform.map(size());
@@ -39,6 +47,8 @@ QSize RenderTarget::size() const
         return m_framebuffer->size();
     } else if (m_image) {
         return m_image->size();
+    } else if (m_vulkanTexture) {
+        return m_vulkanTexture->size();
     } else {
         Q_UNREACHABLE();
     }
@@ -59,6 +69,16 @@ GLTexture *RenderTarget::texture() const
     return m_framebuffer->colorAttachment();
 }
 
+VulkanTexture *RenderTarget::vulkanTexture() const
+{
+    return m_vulkanTexture;
+}
+
+const std::shared_ptr<SyncReleasePoint> &RenderTarget::releasePoint() const
+{
+    return m_releasePoint;
+}
+
 QImage *RenderTarget::image() const
 {
     return m_image;
@@ -16,12 +16,19 @@ namespace KWin
 
 class GLFramebuffer;
 class GLTexture;
+class SyncReleasePoint;
+class VulkanTexture;
 
 class KWIN_EXPORT RenderTarget
 {
 public:
     explicit RenderTarget(GLFramebuffer *fbo, const std::shared_ptr<ColorDescription> &colorDescription = ColorDescription::sRGB);
     explicit RenderTarget(QImage *image, const std::shared_ptr<ColorDescription> &colorDescription = ColorDescription::sRGB);
+    /**
+     * The renderer adds the fence that signals the completion of rendering to the
+     * @a releasePoint, the texture can't be read or presented before that.
+     */
+    explicit RenderTarget(VulkanTexture *texture, const std::shared_ptr<SyncReleasePoint> &releasePoint, const std::shared_ptr<ColorDescription> &colorDescription = ColorDescription::sRGB);
 
     QSize transformedSize() const;
     Rect transformedRect() const;
@@ -33,9 +40,13 @@ public:
     QImage *image() const;
     GLFramebuffer *framebuffer() const;
     GLTexture *texture() const;
+    VulkanTexture *vulkanTexture() const;
+    const std::shared_ptr<SyncReleasePoint> &releasePoint() const;
 
 private:
     QImage *m_image = nullptr;
+    VulkanTexture *m_vulkanTexture = nullptr;
+    std::shared_ptr<SyncReleasePoint> m_releasePoint;
     GLFramebuffer *m_framebuffer = nullptr;
     const OutputTransform m_transform;
     const std::shared_ptr<ColorDescription> m_colorDescription;
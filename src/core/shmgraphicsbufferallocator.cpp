@@ -77,6 +77,67 @@ const ShmAttributes *ShmGraphicsBuffer::shmAttributes() const
     return &m_attributes;
 }
 
+static qsizetype alignUp(qsizetype value, qsizetype alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+QList<ShmPlaneLayout> ShmGraphicsBufferAllocator::planeLayout(uint32_t format, const QSize &size)
+{
+    switch (format) {
+    case DRM_FORMAT_ARGB8888:
+    case DRM_FORMAT_XRGB8888:
+        return {
+            ShmPlaneLayout{
+                .offset = 0,
+                .stride = size.width() * 4,
+                .size = size,
+            },
+        };
+    case DRM_FORMAT_NV12: {
+        const qsizetype stride = alignUp(size.width(), 4);
+        const QSize chromaSize((size.width() + 1) / 2, (size.height() + 1) / 2);
+        return {
+            ShmPlaneLayout{
+                .offset = 0,
+                .stride = stride,
+                .size = size,
+            },
+            ShmPlaneLayout{
+                .offset = stride * alignUp(size.height(), 2),
+                .stride = stride,
+                .size = chromaSize,
+            },
+        };
+    }
+    case DRM_FORMAT_YUV420: {
+        const qsizetype stride = alignUp(size.width(), 4);
+        const QSize chromaSize((size.width() + 1) / 2, (size.height() + 1) / 2);
+        const qsizetype chromaStride = alignUp(chromaSize.width(), 4);
+        const qsizetype chromaOffset = stride * alignUp(size.height(), 2);
+        return {
+            ShmPlaneLayout{
+                .offset = 0,
+                .stride = stride,
+                .size = size,
+            },
+            ShmPlaneLayout{
+                .offset = chromaOffset,
+                .stride = chromaStride,
+                .size = chromaSize,
+            },
+            ShmPlaneLayout{
+                .offset = chromaOffset + chromaStride * chromaSize.height(),
+                .stride = chromaStride,
+                .size = chromaSize,
+            },
+        };
+    }
+    default:
+        return {};
+    }
+}
+
 GraphicsBuffer *ShmGraphicsBufferAllocator::allocate(const GraphicsBufferOptions &options)
 {
     if (!options.software) {
@@ -86,16 +147,13 @@ GraphicsBuffer *ShmGraphicsBufferAllocator::allocate(const GraphicsBufferOptions
         return nullptr;
     }
 
-    switch (options.format) {
-    case DRM_FORMAT_ARGB8888:
-    case DRM_FORMAT_XRGB8888:
-        break;
-    default:
+    const QList<ShmPlaneLayout> planes = planeLayout(options.format, options.size);
+    if (planes.isEmpty()) {
         return nullptr;
     }
 
-    const int stride = options.size.width() * 4;
-    const int bufferSize = options.size.height() * stride;
+    const int stride = planes.first().stride;
+    const int bufferSize = planes.last().offset + planes.last().stride * planes.last().size.height();
 
 #if HAVE_MEMFD
     FileDescriptor fd = FileDescriptor(memfd_create("shm", MFD_CLOEXEC | MFD_ALLOW_SEALING));
@@ -134,7 +192,7 @@ GraphicsBuffer *ShmGraphicsBufferAllocator::allocate(const GraphicsBufferOptions
         .format = options.format,
     };
 
-    MemoryMap memoryMap(attributes.stride * attributes.size.height(), PROT_READ | PROT_WRITE, MAP_SHARED, attributes.fd.get(), attributes.offset);
+    MemoryMap memoryMap(bufferSize, PROT_READ | PROT_WRITE, MAP_SHARED, attributes.fd.get(), attributes.offset);
     if (!memoryMap.isValid()) {
         return nullptr;
     }
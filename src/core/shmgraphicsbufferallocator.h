@@ -11,10 +11,24 @@
 namespace KWin
 {
 
+struct ShmPlaneLayout
+{
+    qsizetype offset;
+    qsizetype stride;
+    QSize size;
+};
+
 class KWIN_EXPORT ShmGraphicsBufferAllocator : public GraphicsBufferAllocator
 {
 public:
     GraphicsBuffer *allocate(const GraphicsBufferOptions &options) override;
+
+    /**
+     * Returns the layout of the planes of a buffer with the specified @p format and @p size, or
+     * an empty list if the format is not supported. The planes of multi-planar formats follow
+     * each other in the same buffer, the same way GStreamer lays out raw video frames by default.
+     */
+    static QList<ShmPlaneLayout> planeLayout(uint32_t format, const QSize &size);
 };
 
 } // namespace KWin
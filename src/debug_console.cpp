@@ -17,6 +17,7 @@
 #include "opengl/eglbackend.h"
 #include "opengl/glplatform.h"
 #include "opengl/glutils.h"
+#include "scene/itemrenderer_opengl.h"
 #include "scene/workspacescene.h"
 #include "tiles/customtile.h"
 #include "tiles/tile.h"
@@ -55,6 +56,7 @@
 #include <QPushButton>
 #include <QScopeGuard>
 #include <QSortFilterProxyModel>
+#include <QTimer>
 #include <QWindow>
 #include <QtConcurrentRun>
 
@@ -781,6 +783,21 @@ void DebugConsole::initGLTab()
     const EglBackend *backend = static_cast<EglBackend *>(Compositor::self()->backend());
     m_ui->platformExtensionsLabel->setText(extensionsString(backend->eglDisplayObject()->extensions()));
     m_ui->openGLExtensionsLabel->setText(extensionsString(backend->openglContext()->openglExtensions()));
+
+    auto updateDrawCalls = [this]() {
+        const auto renderer = dynamic_cast<ItemRendererOpenGL *>(kwinApp()->scene()->renderer());
+        if (!renderer) {
+            return;
+        }
+        const ItemRendererOpenGL::DrawStatistics statistics = renderer->drawStatistics();
+        m_ui->glDrawCallsLabel->setText(i18nc("Draw calls of the last frame", "%1 draw calls, %2 batches for %3 render nodes",
+                                              statistics.drawCalls, statistics.batches, statistics.renderNodes));
+    };
+    updateDrawCalls();
+
+    auto timer = new QTimer(this);
+    connect(timer, &QTimer::timeout, this, updateDrawCalls);
+    timer->start(std::chrono::seconds(1));
 }
 
 template<typename T>
@@ -0,0 +1,232 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "framestatisticsdbusinterface.h"
+#include "core/backendoutput.h"
+#include "core/outputbackend.h"
+#include "core/renderloop.h"
+#include "main.h"
+#include "utils/common.h"
+
+#include <QDBusConnection>
+#include <QDBusMetaType>
+
+using namespace std::chrono_literals;
+
+namespace KWin
+{
+
+static QList<BackendOutput *> statisticsOutputs()
+{
+    if (!kwinApp()->outputBackend()) {
+        return {};
+    }
+    QList<BackendOutput *> outputs;
+    for (BackendOutput *output : kwinApp()->outputBackend()->outputs()) {
+        if (output->renderLoop()) {
+            outputs.append(output);
+        }
+    }
+    return outputs;
+}
+
+FrameStatisticsDBusInterface::FrameStatisticsDBusInterface(QObject *parent)
+    : QObject(parent)
+{
+    qDBusRegisterMetaType<KWin::FrameStatistics>();
+    qDBusRegisterMetaType<QList<KWin::FrameStatistics>>();
+
+    m_serviceWatcher.setConnection(QDBusConnection::sessionBus());
+    m_serviceWatcher.setWatchMode(QDBusServiceWatcher::WatchForUnregistration);
+    connect(&m_serviceWatcher, &QDBusServiceWatcher::serviceUnregistered, this, [this](const QString &service) {
+        m_serviceWatcher.removeWatchedService(service);
+        m_subscribers.remove(service);
+        if (m_subscribers.isEmpty()) {
+            m_flushTimer.stop();
+        }
+    });
+
+    // The statistics are sent in batches to keep the bus traffic low, see updateFlushInterval().
+    connect(&m_flushTimer, &QTimer::timeout, this, &FrameStatisticsDBusInterface::flush);
+
+    QDBusConnection::sessionBus().registerObject(QStringLiteral("/FrameStatistics"), this, QDBusConnection::ExportScriptableContents);
+}
+
+FrameStatisticsDBusInterface::~FrameStatisticsDBusInterface()
+{
+    QDBusConnection::sessionBus().unregisterObject(QStringLiteral("/FrameStatistics"));
+}
+
+QStringList FrameStatisticsDBusInterface::outputs() const
+{
+    QStringList names;
+    for (BackendOutput *output : statisticsOutputs()) {
+        names.append(output->name());
+    }
+    return names;
+}
+
+QList<FrameStatistics> FrameStatisticsDBusInterface::snapshot(const QString &output, quint64 since) const
+{
+    for (BackendOutput *candidate : statisticsOutputs()) {
+        if (candidate->name() == output) {
+            return candidate->renderLoop()->frameStatistics()->snapshot(since);
+        }
+    }
+    sendErrorReply(QDBusError::InvalidArgs, QStringLiteral("No output with name %1").arg(output));
+    return {};
+}
+
+void FrameStatisticsDBusInterface::subscribe()
+{
+    const QString service = message().service();
+    if (m_subscribers.contains(service)) {
+        return;
+    }
+
+    m_subscribers.insert(service);
+    m_serviceWatcher.addWatchedService(service);
+
+    if (!m_flushTimer.isActive()) {
+        // Only the frames recorded after the subscription are streamed.
+        m_lastFlushedSequence.clear();
+        for (BackendOutput *output : statisticsOutputs()) {
+            m_lastFlushedSequence[output->renderLoop()] = output->renderLoop()->frameStatistics()->lastSequence();
+        }
+        updateFlushInterval();
+        m_flushTimer.start();
+    }
+}
+
+void FrameStatisticsDBusInterface::unsubscribe()
+{
+    const QString service = message().service();
+    if (!m_subscribers.remove(service)) {
+        return;
+    }
+
+    m_serviceWatcher.removeWatchedService(service);
+    if (m_subscribers.isEmpty()) {
+        m_flushTimer.stop();
+    }
+}
+
+void FrameStatisticsDBusInterface::flush()
+{
+    QHash<RenderLoop *, quint64> lastFlushedSequence;
+    for (BackendOutput *output : statisticsOutputs()) {
+        RenderLoop *renderLoop = output->renderLoop();
+        const FrameStatisticsRing *statistics = renderLoop->frameStatistics();
+
+        const quint64 since = m_lastFlushedSequence.value(renderLoop, 0);
+        const QList<FrameStatistics> frames = statistics->snapshot(since);
+        lastFlushedSequence[renderLoop] = frames.isEmpty() ? since : frames.constLast().sequence;
+
+        // The frames between the last flush and the oldest frame in the ring have been overwritten.
+        if (!frames.isEmpty() && m_lastFlushedSequence.contains(renderLoop) && frames.constFirst().sequence > since + 1) {
+            const quint64 lost = frames.constFirst().sequence - since - 1;
+            qCWarning(KWIN_CORE) << "Lost the statistics of" << lost << "frames of" << output->name();
+            m_lostFrames += lost;
+        }
+
+        if (!frames.isEmpty()) {
+            Q_EMIT framesRecorded(output->name(), frames);
+        }
+    }
+
+    // Also forget the outputs that have been removed.
+    m_lastFlushedSequence = lastFlushedSequence;
+    updateFlushInterval();
+}
+
+void FrameStatisticsDBusInterface::updateFlushInterval()
+{
+    // Flush at the latest when the ring of the output with the highest refresh rate is half full,
+    // but not more often than necessary on common refresh rates.
+    std::chrono::milliseconds interval = 1s;
+    for (BackendOutput *output : statisticsOutputs()) {
+        RenderLoop *renderLoop = output->renderLoop();
+        if (renderLoop->refreshRate() <= 0) {
+            continue;
+        }
+        const int halfCapacity = renderLoop->frameStatistics()->capacity() / 2;
+        interval = std::min(interval, std::chrono::milliseconds(qint64(halfCapacity) * 1'000'000 / renderLoop->refreshRate()));
+    }
+    m_flushTimer.setInterval(std::max(interval, 16ms));
+}
+
+quint64 FrameStatisticsDBusInterface::lostFrames() const
+{
+    return m_lostFrames;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &arg, FrameStatistics &statistics)
+{
+    quint32 status;
+    quint32 presentationMode;
+    qint64 refreshDuration;
+    qint64 predictedRenderTime;
+    qint64 targetPresentationTimestamp;
+    qint64 prepareStart;
+    qint64 prepareEnd;
+    qint64 renderStart;
+    qint64 renderEnd;
+    qint64 commitTimestamp;
+    qint64 presentationTimestamp;
+
+    arg.beginStructure();
+    arg >> statistics.sequence;
+    arg >> status;
+    arg >> presentationMode;
+    arg >> refreshDuration;
+    arg >> predictedRenderTime;
+    arg >> targetPresentationTimestamp;
+    arg >> prepareStart;
+    arg >> prepareEnd;
+    arg >> renderStart;
+    arg >> renderEnd;
+    arg >> commitTimestamp;
+    arg >> presentationTimestamp;
+    arg.endStructure();
+
+    statistics.status = FrameStatistics::Status(status);
+    statistics.presentationMode = PresentationMode(presentationMode);
+    statistics.refreshDuration = std::chrono::nanoseconds(refreshDuration);
+    statistics.predictedRenderTime = std::chrono::nanoseconds(predictedRenderTime);
+    statistics.targetPresentationTimestamp = std::chrono::nanoseconds(targetPresentationTimestamp);
+    statistics.prepareStart = std::chrono::nanoseconds(prepareStart);
+    statistics.prepareEnd = std::chrono::nanoseconds(prepareEnd);
+    statistics.renderStart = std::chrono::nanoseconds(renderStart);
+    statistics.renderEnd = std::chrono::nanoseconds(renderEnd);
+    statistics.commitTimestamp = std::chrono::nanoseconds(commitTimestamp);
+    statistics.presentationTimestamp = std::chrono::nanoseconds(presentationTimestamp);
+
+    return arg;
+}
+
+const QDBusArgument &operator<<(QDBusArgument &arg, const FrameStatistics &statistics)
+{
+    arg.beginStructure();
+    arg << statistics.sequence;
+    arg << quint32(statistics.status);
+    arg << quint32(statistics.presentationMode);
+    arg << qint64(statistics.refreshDuration.count());
+    arg << qint64(statistics.predictedRenderTime.count());
+    arg << qint64(statistics.targetPresentationTimestamp.count());
+    arg << qint64(statistics.prepareStart.count());
+    arg << qint64(statistics.prepareEnd.count());
+    arg << qint64(statistics.renderStart.count());
+    arg << qint64(statistics.renderEnd.count());
+    arg << qint64(statistics.commitTimestamp.count());
+    arg << qint64(statistics.presentationTimestamp.count());
+    arg.endStructure();
+
+    return arg;
+}
+
+} // namespace KWin
+
+#include "moc_framestatisticsdbusinterface.cpp"
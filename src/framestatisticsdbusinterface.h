@@ -0,0 +1,105 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "core/framestatistics.h"
+
+#include <QDBusArgument>
+#include <QDBusContext>
+#include <QDBusServiceWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QTimer>
+
+namespace KWin
+{
+
+class RenderLoop;
+
+/**
+ * The FrameStatisticsDBusInterface class exports the per-output frame statistics on the
+ * session bus as object /FrameStatistics, so frame pacing can be monitored without effects.
+ *
+ * Clients can either poll the statistics with snapshot(), or call subscribe() to receive
+ * the new frames in batches with the framesRecorded() signal. Every frame is a struct of
+ * the following values:
+ * @li @c t sequence number
+ * @li @c u status, 0 if the frame has been presented, 1 if it has been dropped
+ * @li @c u presentation mode
+ * @li @c x refresh duration
+ * @li @c x predicted render time
+ * @li @c x target presentation timestamp
+ * @li @c x prepare start timestamp
+ * @li @c x prepare end timestamp
+ * @li @c x render start timestamp
+ * @li @c x render end timestamp
+ * @li @c x commit timestamp
+ * @li @c x presentation timestamp
+ *
+ * Durations and timestamps are in nanoseconds, the timestamps are sourced from the
+ * monotonic clock. A zero timestamp means that the value is unknown.
+ *
+ * The frames are flushed often enough that the ring of an output is at most half full between
+ * two flushes. Frames that are overwritten nevertheless, e.g. because the event loop has been
+ * blocked, are counted by lostFrames().
+ */
+class FrameStatisticsDBusInterface : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.kde.KWin.FrameStatistics")
+
+public:
+    explicit FrameStatisticsDBusInterface(QObject *parent = nullptr);
+    ~FrameStatisticsDBusInterface() override;
+
+    /**
+     * Returns the names of the outputs that have frame statistics.
+     */
+    Q_SCRIPTABLE QStringList outputs() const;
+
+    /**
+     * Returns the recorded frames of the specified @a output with a sequence number greater
+     * than @a since.
+     */
+    Q_SCRIPTABLE QList<KWin::FrameStatistics> snapshot(const QString &output, quint64 since) const;
+
+    /**
+     * Starts emitting the framesRecorded() signal until unsubscribe() is called or the
+     * calling client disconnects from the bus.
+     */
+    Q_SCRIPTABLE void subscribe();
+    Q_SCRIPTABLE void unsubscribe();
+
+    /**
+     * Returns the number of frames that have been overwritten in the ring before they could be
+     * sent to the subscribers.
+     */
+    Q_SCRIPTABLE quint64 lostFrames() const;
+
+Q_SIGNALS:
+    /**
+     * This signal is emitted periodically with the frames of the @a output that have been
+     * recorded since the last emission.
+     */
+    Q_SCRIPTABLE void framesRecorded(const QString &output, const QList<KWin::FrameStatistics> &frames);
+
+private:
+    void flush();
+    void updateFlushInterval();
+
+    QSet<QString> m_subscribers;
+    QDBusServiceWatcher m_serviceWatcher;
+    QTimer m_flushTimer;
+    QHash<RenderLoop *, quint64> m_lastFlushedSequence;
+    quint64 m_lostFrames = 0;
+};
+
+const QDBusArgument &operator>>(const QDBusArgument &arg, FrameStatistics &statistics);
+const QDBusArgument &operator<<(QDBusArgument &arg, const FrameStatistics &statistics);
+
+} // namespace KWin
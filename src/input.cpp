@@ -30,6 +30,7 @@
 #include "touch_input.h"
 #include "wayland/abstract_data_source.h"
 #include "wayland/xdgtopleveldrag_v1.h"
+#include "windowhittestindex.h"
 #if KWIN_BUILD_X11
 #include "x11window.h"
 #endif
@@ -2984,6 +2985,8 @@ void InputRedirection::setupWorkspace()
 {
     connect(workspace(), &Workspace::outputsChanged, this, &InputRedirection::updateScreens);
 
+    m_hitTestIndex = std::make_unique<WindowHitTestIndex>(workspace());
+
     m_keyboard->init();
     m_pointer->init();
     m_touch->init();
@@ -3453,7 +3456,7 @@ void InputRedirection::removeIdleInhibitor(Window *inhibitor)
 
 Window *InputRedirection::findToplevel(const QPointF &pos)
 {
-    if (!Workspace::self()) {
+    if (!Workspace::self() || !m_hitTestIndex) {
         return nullptr;
     }
     const bool isScreenLocked = waylandServer() && waylandServer()->isScreenLocked();
@@ -3463,34 +3466,24 @@ Window *InputRedirection::findToplevel(const QPointF &pos)
             return nullptr;
         }
     }
-    const QList<Window *> &stacking = Workspace::self()->stackingOrder();
-    if (stacking.isEmpty()) {
-        return nullptr;
-    }
-    auto it = stacking.end();
-    do {
-        --it;
-        Window *window = (*it);
+    return m_hitTestIndex->topmostAt(pos, [&pos, isScreenLocked](Window *window) {
         if (window->isDeleted()) {
             // a deleted window doesn't get mouse events
-            continue;
+            return false;
         }
         if (!window->isOnCurrentActivity() || !window->isOnCurrentDesktop() || window->isMinimized() || window->isHidden() || window->isHiddenByShowDesktop()) {
-            continue;
+            return false;
         }
         if (!window->readyForPainting()) {
-            continue;
+            return false;
         }
         if (isScreenLocked) {
             if (!window->isLockScreen() && !window->isInputMethod() && !window->isLockScreenOverlay()) {
-                continue;
+                return false;
             }
         }
-        if (window->hitTest(pos)) {
-            return window;
-        }
-    } while (it != stacking.begin());
-    return nullptr;
+        return window->hitTest(pos);
+    });
 }
 
 Qt::KeyboardModifiers InputRedirection::keyboardModifiers() const
@@ -42,6 +42,7 @@ class PointerInputRedirection;
 class SeatInterface;
 class TabletInputRedirection;
 class TouchInputRedirection;
+class WindowHitTestIndex;
 class WindowSelectorFilter;
 struct SwitchEvent;
 struct TabletToolTipEvent;
@@ -302,6 +303,7 @@ private:
     QList<IdleDetector *> m_idleDetectors;
     QList<Window *> m_idleInhibitors;
     std::unique_ptr<WindowSelectorFilter> m_windowSelector;
+    std::unique_ptr<WindowHitTestIndex> m_hitTestIndex;
 
     QList<InputEventFilter *> m_filters;
     QList<InputEventSpy *> m_spies;
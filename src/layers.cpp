@@ -102,6 +102,9 @@ void Workspace::updateStackingOrder(bool propagate_new_windows)
     QList<Window *> new_stacking_order = constrainedStackingOrder();
     bool changed = (force_restacking || new_stacking_order != stacking_order);
     force_restacking = false;
+    if (new_stacking_order != stacking_order) {
+        ++m_stackingOrderGeneration;
+    }
     stacking_order = new_stacking_order;
     if (changed || propagate_new_windows) {
 #if KWIN_BUILD_X11
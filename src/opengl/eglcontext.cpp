@@ -15,6 +15,7 @@
 #include "glplatform.h"
 #include "glshader.h"
 #include "glshadermanager.h"
+#include "gluploadbuffer_p.h"
 #include "glvertexbuffer.h"
 #include "glvertexbuffer_p.h"
 #include "opengl/egl_context_attribute_builder.h"
@@ -109,6 +110,10 @@ EglContext::EglContext(EglDisplay *display, EGLConfig config, ::EGLContext conte
         if (qgetenv("KWIN_PERSISTENT_VBO") != QByteArrayLiteral("0")) {
             m_streamingBuffer->setPersistent();
         }
+        // pixel unpack buffers are core in OpenGL ES 3.0 and OpenGL 2.1
+        if (hasVersion(Version(3, 0)) && qgetenv("KWIN_PBO_UPLOADS") != QByteArrayLiteral("0")) {
+            m_uploadBuffer = std::make_unique<GLUploadBuffer>();
+        }
     }
 }
 
@@ -118,6 +123,7 @@ EglContext::~EglContext()
     m_shaderManager.reset();
     m_streamingBuffer.reset();
     m_indexBuffer.reset();
+    m_uploadBuffer.reset();
     doneCurrent();
     eglDestroyContext(m_display->handle(), m_handle);
 }
@@ -375,6 +381,11 @@ IndexBuffer *EglContext::indexBuffer() const
     return m_indexBuffer.get();
 }
 
+GLUploadBuffer *EglContext::uploadBuffer() const
+{
+    return m_uploadBuffer.get();
+}
+
 GLPlatform *EglContext::glPlatform() const
 {
     return m_glPlatform.get();
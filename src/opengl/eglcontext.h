@@ -23,6 +23,7 @@ namespace KWin
 class EglDisplay;
 class ShaderManager;
 class IndexBuffer;
+class GLUploadBuffer;
 class GLPlatform;
 class GLFramebuffer;
 struct DmaBufAttributes;
@@ -75,6 +76,11 @@ public:
     ShaderManager *shaderManager() const;
     GLVertexBuffer *streamingVbo() const;
     IndexBuffer *indexBuffer() const;
+    /**
+     * @returns the ring of pixel unpack buffers used for texture uploads,
+     *          or @c nullptr if the context doesn't support persistently mapped buffers
+     */
+    GLUploadBuffer *uploadBuffer() const;
     GLPlatform *glPlatform() const;
     QSet<QByteArray> openglExtensions() const;
 
@@ -159,6 +165,7 @@ private:
     std::unique_ptr<ShaderManager> m_shaderManager;
     std::unique_ptr<GLVertexBuffer> m_streamingBuffer;
     std::unique_ptr<IndexBuffer> m_indexBuffer;
+    std::unique_ptr<GLUploadBuffer> m_uploadBuffer;
     QStack<GLFramebuffer *> m_fbos;
     uint32_t m_vao = 0;
     bool m_failed = false;
@@ -36,6 +36,9 @@ GLShader::~GLShader()
         qCCritical(KWIN_OPENGL, "Attempted to delete a shader in the wrong context!");
         return;
     }
+    for (GLuint shader : std::as_const(m_deferredShaders)) {
+        glDeleteShader(shader);
+    }
     if (m_program) {
         glDeleteProgram(m_program);
     }
@@ -44,7 +47,50 @@ GLShader::~GLShader()
 bool GLShader::link()
 {
     glLinkProgram(m_program);
+    return checkLinkStatus();
+}
+
+void GLShader::linkDeferred()
+{
+    glLinkProgram(m_program);
+}
+
+bool GLShader::isLinkFinished() const
+{
+    GLint finished = GL_FALSE;
+    glGetProgramiv(m_program, GL_COMPLETION_STATUS_KHR, &finished);
+    return finished != GL_FALSE;
+}
+
+bool GLShader::finishLink()
+{
+    bool compiled = true;
+    for (GLuint shader : std::as_const(m_deferredShaders)) {
+        int status;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+        if (status == 0) {
+            int shaderType, maxLength;
+            glGetShaderiv(shader, GL_SHADER_TYPE, &shaderType);
+            glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &maxLength);
+
+            QByteArray log(maxLength, 0);
+            glGetShaderInfoLog(shader, maxLength, nullptr, log.data());
+
+            const char *typeName = (shaderType == GL_VERTEX_SHADER ? "vertex" : "fragment");
+            qCCritical(KWIN_OPENGL) << "Failed to compile" << typeName << "shader:"
+                                    << "\n"
+                                    << log.data();
+            compiled = false;
+        }
+        glDeleteShader(shader);
+    }
+    m_deferredShaders.clear();
 
+    return compiled && checkLinkStatus();
+}
+
+bool GLShader::checkLinkStatus() const
+{
     // Get the program info log
     int maxLength, length;
     glGetProgramiv(m_program, GL_INFO_LOG_LENGTH, &maxLength);
@@ -190,6 +236,35 @@ bool GLShader::compile(GLuint program, GLenum shaderType, const QByteArray &sour
     return status != 0;
 }
 
+bool GLShader::loadDeferred(const QByteArray &vertexSource, const QByteArray &fragmentSource)
+{
+    const std::pair<GLenum, const QByteArray &> stages[] = {
+        {GL_VERTEX_SHADER, vertexSource},
+        {GL_FRAGMENT_SHADER, fragmentSource},
+    };
+
+    for (const auto &[shaderType, source] : stages) {
+        if (source.isEmpty()) {
+            continue;
+        }
+
+        const auto preparedSource = preprocess(source, shaderType);
+        if (!preparedSource.has_value()) {
+            return false;
+        }
+
+        // The compile status is checked in finishLink(), querying it now would wait for the compiler.
+        GLuint shader = glCreateShader(shaderType);
+        const char *src = preparedSource->constData();
+        glShaderSource(shader, 1, &src, nullptr);
+        glCompileShader(shader);
+        glAttachShader(m_program, shader);
+        m_deferredShaders.append(shader);
+    }
+
+    return true;
+}
+
 bool GLShader::load(const QByteArray &vertexSource, const QByteArray &fragmentSource)
 {
     // Compile the vertex shader
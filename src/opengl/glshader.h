@@ -150,6 +150,18 @@ protected:
     bool load(const QByteArray &vertexSource, const QByteArray &fragmentSource);
     std::optional<QByteArray> preprocess(const QByteArray &src, GLenum shaderType, int recursionDepth = 0) const;
     bool compile(GLuint program, GLenum shaderType, const QByteArray &sourceCode) const;
+    bool checkLinkStatus() const;
+
+    /**
+     * Like load() and link(), but doesn't wait for the driver to finish compiling the program.
+     * With GL_KHR_parallel_shader_compile, isLinkFinished() can be used to check whether the
+     * program is ready without blocking. finishLink() must be called before the shader is used.
+     */
+    bool loadDeferred(const QByteArray &vertexSource, const QByteArray &fragmentSource);
+    void linkDeferred();
+    bool isLinkFinished() const;
+    bool finishLink();
+
     void bind();
     void unbind();
     void resolveLocations();
@@ -157,6 +169,7 @@ protected:
 private:
     EglContext *const m_context;
     unsigned int m_program;
+    QList<GLuint> m_deferredShaders;
     bool m_locationsResolved : 1;
     QHash<Mat3Uniform, int> m_matrix3Locations;
     QHash<Mat4Uniform, int> m_matrix4Locations;
@@ -167,6 +180,7 @@ private:
     QHash<IntUniform, int> m_intLocations;
     QHash<ColorUniform, int> m_colorLocations;
 
+    friend class GLShaderCache;
     friend class ShaderManager;
 };
 
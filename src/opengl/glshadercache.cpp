@@ -0,0 +1,239 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "glshadercache.h"
+#include "config-kwin.h"
+#include "eglcontext.h"
+#include "glshader.h"
+#include "utils/common.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+using namespace std::chrono_literals;
+
+namespace KWin
+{
+
+static constexpr quint32 s_magic = 0x4b575342; // KWSB
+static constexpr quint32 s_formatVersion = 1;
+
+// Cache directories of drivers or compositor versions that have not been used for this long are removed.
+static constexpr int s_staleDirectoryDays = 30;
+
+static QList<GLint> programBinaryFormats(EglContext *context)
+{
+    if (!context->hasVersion(Version(3, 0)) && !context->hasOpenglExtension(QByteArrayLiteral("GL_OES_get_program_binary"))) {
+        return {};
+    }
+
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &count);
+    if (count <= 0) {
+        return {};
+    }
+
+    QList<GLint> formats(count);
+    glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data());
+    return formats;
+}
+
+static void removeStaleDirectories(const QString &parentDirectory, const QString &currentDirectory)
+{
+    const QDateTime threshold = QDateTime::currentDateTime().addDays(-s_staleDirectoryDays);
+
+    const QFileInfoList entries = QDir(parentDirectory).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QFileInfo &entry : entries) {
+        if (entry.absoluteFilePath() != currentDirectory && entry.lastModified() < threshold) {
+            QDir(entry.absoluteFilePath()).removeRecursively();
+        }
+    }
+}
+
+std::unique_ptr<GLShaderCache> GLShaderCache::create(EglContext *context)
+{
+    if (qgetenv("KWIN_GL_SHADER_CACHE") == QByteArrayLiteral("0")) {
+        return nullptr;
+    }
+
+    const QList<GLint> formats = programBinaryFormats(context);
+    if (formats.isEmpty()) {
+        qCDebug(KWIN_OPENGL) << "Program binaries are not supported, the shader cache is disabled";
+        return nullptr;
+    }
+
+    const QString cacheLocation = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+    if (cacheLocation.isEmpty()) {
+        return nullptr;
+    }
+
+    // The program binaries can be used only with the driver that produced them.
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArrayView(KWIN_VERSION_STRING.data(), KWIN_VERSION_STRING.size()));
+    hash.addData(context->vendor());
+    hash.addData(context->renderer());
+    hash.addData(context->openglVersionString());
+    hash.addData(context->glslVersionString());
+
+    const QString parentDirectory = cacheLocation + QLatin1StringView("/kwin/shaders");
+    const QString directory = parentDirectory + QLatin1Char('/') + QString::fromLatin1(hash.result().toHex());
+    if (!QDir().mkpath(directory)) {
+        qCWarning(KWIN_OPENGL) << "Failed to create the shader cache directory" << directory;
+        return nullptr;
+    }
+
+    removeStaleDirectories(parentDirectory, directory);
+
+    auto cache = std::make_unique<GLShaderCache>(context, directory);
+    cache->m_binaryFormats = formats;
+    return cache;
+}
+
+GLShaderCache::GLShaderCache(EglContext *context, const QString &directory)
+    : m_context(context)
+    , m_directory(directory)
+{
+}
+
+QString GLShaderCache::filePath(const QByteArray &key) const
+{
+    return m_directory + QLatin1Char('/') + QString::fromLatin1(key);
+}
+
+QByteArray GLShaderCache::key(const GLShader *shader, const QByteArray &vertexSource, const QByteArray &fragmentSource, const QByteArray &attributes) const
+{
+    // Hash the preprocessed sources so changes in the included files invalidate the entries too.
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    const auto addSource = [&](const QByteArray &source, GLenum shaderType) {
+        if (source.isEmpty()) {
+            hash.addData(QByteArrayView("0\n"));
+            return true;
+        }
+        const std::optional<QByteArray> processed = shader->preprocess(source, shaderType);
+        if (!processed) {
+            return false;
+        }
+        hash.addData(QByteArray::number(processed->size()) + '\n');
+        hash.addData(*processed);
+        return true;
+    };
+
+    if (!addSource(vertexSource, GL_VERTEX_SHADER) || !addSource(fragmentSource, GL_FRAGMENT_SHADER)) {
+        return QByteArray();
+    }
+    hash.addData(attributes);
+
+    return hash.result().toHex();
+}
+
+bool GLShaderCache::load(GLShader *shader, const QByteArray &key)
+{
+    QFile file(filePath(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        ++m_missCount;
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 format = 0;
+    qint64 compileTime = 0;
+    QByteArray checksum;
+    QByteArray binary;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream >> magic >> version >> format >> compileTime >> checksum >> binary;
+
+    if (stream.status() != QDataStream::Ok || magic != s_magic || version != s_formatVersion
+        || !m_binaryFormats.contains(GLint(format)) || QCryptographicHash::hash(binary, QCryptographicHash::Md5) != checksum) {
+        qCWarning(KWIN_OPENGL) << "Discarding invalid shader cache entry" << file.fileName();
+        file.remove();
+        ++m_missCount;
+        return false;
+    }
+
+    glProgramBinary(shader->m_program, format, binary.constData(), binary.size());
+
+    GLint status = GL_FALSE;
+    glGetProgramiv(shader->m_program, GL_LINK_STATUS, &status);
+    if (status == GL_FALSE) {
+        // This can happen if the driver has been updated without changing its version string.
+        qCDebug(KWIN_OPENGL) << "The driver rejected shader cache entry" << file.fileName();
+        file.remove();
+        ++m_missCount;
+        return false;
+    }
+
+    const std::chrono::nanoseconds loadTime(timer.nsecsElapsed());
+    m_savedTime += std::max(std::chrono::nanoseconds(compileTime) - loadTime, 0ns);
+    ++m_hitCount;
+
+    qCDebug(KWIN_OPENGL).nospace() << "Loaded shader " << key << " from the cache in "
+                                   << std::chrono::duration_cast<std::chrono::microseconds>(loadTime).count() << "us, compiling it took "
+                                   << std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::nanoseconds(compileTime)).count() << "us ("
+                                   << m_hitCount << " hits, " << m_missCount << " misses, "
+                                   << std::chrono::duration_cast<std::chrono::milliseconds>(m_savedTime).count() << "ms saved in total)";
+    return true;
+}
+
+void GLShaderCache::prepare(GLShader *shader) const
+{
+    // Program binaries are always retrievable with GL_OES_get_program_binary.
+    if (m_context->hasVersion(Version(3, 0))) {
+        glProgramParameteri(shader->m_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+}
+
+void GLShaderCache::store(GLShader *shader, const QByteArray &key, std::chrono::nanoseconds compileTime)
+{
+    GLint length = 0;
+    glGetProgramiv(shader->m_program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    QByteArray binary(length, Qt::Uninitialized);
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(shader->m_program, length, &written, &format, binary.data());
+    if (written <= 0) {
+        return;
+    }
+    binary.truncate(written);
+
+    QSaveFile file(filePath(key));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(KWIN_OPENGL) << "Failed to write shader cache entry" << file.fileName() << file.errorString();
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << s_magic << s_formatVersion << quint32(format) << qint64(compileTime.count())
+           << QCryptographicHash::hash(binary, QCryptographicHash::Md5) << binary;
+
+    if (!file.commit()) {
+        qCWarning(KWIN_OPENGL) << "Failed to write shader cache entry" << file.fileName() << file.errorString();
+        return;
+    }
+
+    qCDebug(KWIN_OPENGL).nospace() << "Compiled shader " << key << " in "
+                                   << std::chrono::duration_cast<std::chrono::microseconds>(compileTime).count() << "us and stored it in the cache";
+}
+
+} // namespace KWin
@@ -0,0 +1,83 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <epoxy/gl.h>
+
+#include <chrono>
+#include <memory>
+
+namespace KWin
+{
+
+class EglContext;
+class GLShader;
+
+/**
+ * The GLShaderCache class stores linked shader programs on disk so they don't need to be compiled
+ * again the next time they are needed, e.g. after restarting the compositor.
+ *
+ * The program binaries are only valid for the driver that produced them. The cache directory is
+ * therefore specific to the vendor, renderer and version strings of the context, and the binaries
+ * are keyed on the preprocessed shader sources. If the driver rejects a cached binary, the entry
+ * is removed and the caller is expected to compile the shader from source.
+ */
+class KWIN_EXPORT GLShaderCache
+{
+public:
+    /**
+     * Creates a shader cache for the given @a context. Returns @c nullptr if the context cannot
+     * retrieve program binaries or if the cache has been disabled with KWIN_GL_SHADER_CACHE=0.
+     */
+    static std::unique_ptr<GLShaderCache> create(EglContext *context);
+
+    explicit GLShaderCache(EglContext *context, const QString &directory);
+
+    /**
+     * Returns the cache key for a program with the specified sources, or an empty byte array if
+     * the sources cannot be preprocessed. The @a attributes must describe the attribute bindings
+     * of the program as they are baked into the binary.
+     */
+    QByteArray key(const GLShader *shader, const QByteArray &vertexSource, const QByteArray &fragmentSource, const QByteArray &attributes) const;
+
+    /**
+     * Loads the program binary with the given @a key into the @a shader. Returns @c true if the
+     * program has been loaded and linked successfully; otherwise returns @c false.
+     */
+    bool load(GLShader *shader, const QByteArray &key);
+
+    /**
+     * Must be called before the @a shader is linked so that its binary can be retrieved later.
+     */
+    void prepare(GLShader *shader) const;
+
+    /**
+     * Stores the binary of the linked @a shader with the given @a key. The @a compileTime is the
+     * time it took to compile and link the program, it's used to report how much time the cache
+     * saves.
+     */
+    void store(GLShader *shader, const QByteArray &key, std::chrono::nanoseconds compileTime);
+
+private:
+    QString filePath(const QByteArray &key) const;
+
+    EglContext *m_context;
+    QString m_directory;
+    QList<GLint> m_binaryFormats;
+    int m_hitCount = 0;
+    int m_missCount = 0;
+    std::chrono::nanoseconds m_savedTime = std::chrono::nanoseconds::zero();
+};
+
+} // namespace KWin
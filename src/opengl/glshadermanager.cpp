@@ -12,12 +12,16 @@
 #include "eglcontext.h"
 #include "glplatform.h"
 #include "glshader.h"
+#include "glshadercache.h"
 #include "glvertexbuffer.h"
 #include "utils/common.h"
 
+#include <QElapsedTimer>
 #include <QFile>
 #include <QTextStream>
 
+#include <algorithm>
+
 namespace KWin
 {
 
@@ -26,8 +30,28 @@ ShaderManager *ShaderManager::instance()
     return EglContext::currentContext()->shaderManager();
 }
 
+// Without GL_KHR_parallel_shader_compile, pre-warmed shaders are compiled one per interval.
+static constexpr std::chrono::milliseconds s_prewarmInterval(50);
+
+static const QByteArray s_builtinAttributes = QByteArrayLiteral("position=0;texcoord=1");
+
+static void bindBuiltinAttributeLocations(GLShader *shader)
+{
+    shader->bindAttributeLocation("position", VA_Position);
+    shader->bindAttributeLocation("texcoord", VA_TexCoord);
+}
+
 ShaderManager::ShaderManager()
+    : m_context(EglContext::currentContext())
 {
+    if (m_context) {
+        m_shaderCache = GLShaderCache::create(m_context);
+        m_parallelCompile = m_context->hasOpenglExtension(QByteArrayLiteral("GL_KHR_parallel_shader_compile"));
+        if (m_parallelCompile) {
+            // Let the driver pick the number of compiler threads.
+            glMaxShaderCompilerThreadsKHR(0xffffffff);
+        }
+    }
 }
 
 ShaderManager::~ShaderManager()
@@ -35,6 +59,8 @@ ShaderManager::~ShaderManager()
     while (!m_boundShaders.isEmpty()) {
         popShader();
     }
+    m_prewarmTimer.reset();
+    m_pendingShaders.clear();
 }
 
 static QByteArray listDefines(ShaderTraits traits)
@@ -84,21 +110,181 @@ std::unique_ptr<GLShader> ShaderManager::generateCustomShader(ShaderTraits trait
     const auto vertex = defines + (vertexSource.isEmpty() ? generateVertexSource(traits) : vertexSource);
     const auto fragment = defines + (fragmentSource.isEmpty() ? generateFragmentSource(traits) : fragmentSource);
 
+    QByteArray cacheKey;
+    if (auto shader = loadCachedShader(vertex, fragment, &cacheKey)) {
+        return shader;
+    }
+
+    QElapsedTimer compileTimer;
+    compileTimer.start();
+
     auto shader = std::make_unique<GLShader>();
     if (!shader->load(vertex, fragment)) {
         return nullptr;
     }
 
-    shader->bindAttributeLocation("position", VA_Position);
-    shader->bindAttributeLocation("texcoord", VA_TexCoord);
+    bindBuiltinAttributeLocations(shader.get());
+
+    if (!cacheKey.isEmpty()) {
+        m_shaderCache->prepare(shader.get());
+    }
 
     if (!shader->link()) {
         return nullptr;
     }
 
+    if (!cacheKey.isEmpty()) {
+        m_shaderCache->store(shader.get(), cacheKey, std::chrono::nanoseconds(compileTimer.nsecsElapsed()));
+    }
+
     return shader;
 }
 
+std::unique_ptr<GLShader> ShaderManager::loadCachedShader(const QByteArray &vertexSource, const QByteArray &fragmentSource, QByteArray *cacheKey)
+{
+    if (!m_shaderCache) {
+        return nullptr;
+    }
+
+    auto shader = std::make_unique<GLShader>();
+    *cacheKey = m_shaderCache->key(shader.get(), vertexSource, fragmentSource, s_builtinAttributes);
+    if (cacheKey->isEmpty() || !m_shaderCache->load(shader.get(), *cacheKey)) {
+        return nullptr;
+    }
+
+    return shader;
+}
+
+void ShaderManager::prewarm(const QList<ShaderTraits> &traits)
+{
+    for (const ShaderTraits &shaderTraits : traits) {
+        if (m_shaderHash.contains(shaderTraits) || m_prewarmQueue.contains(shaderTraits)) {
+            continue;
+        }
+        if (std::ranges::find(m_pendingShaders, shaderTraits, &PendingShader::traits) == m_pendingShaders.end()) {
+            m_prewarmQueue.append(shaderTraits);
+        }
+    }
+
+    if (m_prewarmQueue.isEmpty()) {
+        return;
+    }
+    if (!m_prewarmElapsed.isValid()) {
+        m_prewarmElapsed.start();
+    }
+
+    if (m_parallelCompile) {
+        // Handing the shaders over to the driver is cheap, checkPendingShaders() picks them up
+        // once they are compiled.
+        while (!m_prewarmQueue.isEmpty()) {
+            startPendingShader(m_prewarmQueue.takeFirst());
+        }
+        finishPrewarm();
+        return;
+    }
+
+    // Without parallel compilation, the shaders are compiled one at a time, far enough apart
+    // that frames can still be rendered in between.
+    if (!m_prewarmTimer) {
+        m_prewarmTimer = std::make_unique<QTimer>();
+        m_prewarmTimer->setInterval(s_prewarmInterval);
+        QObject::connect(m_prewarmTimer.get(), &QTimer::timeout, m_prewarmTimer.get(), [this]() {
+            compileNextPrewarmShader();
+        });
+    }
+    m_prewarmTimer->start();
+}
+
+void ShaderManager::checkPendingShaders()
+{
+    Q_ASSERT(EglContext::currentContext() == m_context);
+    for (auto it = m_pendingShaders.begin(); it != m_pendingShaders.end();) {
+        if (it->shader->isLinkFinished()) {
+            m_shaderHash[it->traits] = finishPendingShader(*it);
+            it = m_pendingShaders.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    finishPrewarm();
+}
+
+void ShaderManager::compileNextPrewarmShader()
+{
+    if (m_prewarmQueue.isEmpty()) {
+        finishPrewarm();
+        return;
+    }
+
+    EglContext *previousContext = EglContext::currentContext();
+    if (!m_context->makeCurrent()) {
+        return;
+    }
+
+    const ShaderTraits traits = m_prewarmQueue.takeFirst();
+    m_shaderHash[traits] = generateShader(traits);
+    finishPrewarm();
+
+    if (previousContext && previousContext != m_context) {
+        (void)previousContext->makeCurrent();
+    }
+}
+
+void ShaderManager::finishPrewarm()
+{
+    if (!m_prewarmQueue.isEmpty() || !m_pendingShaders.empty() || !m_prewarmElapsed.isValid()) {
+        return;
+    }
+    if (m_prewarmTimer) {
+        m_prewarmTimer->stop();
+    }
+    qCDebug(KWIN_OPENGL) << "Shader pre-warming finished in" << m_prewarmElapsed.elapsed() << "ms";
+    m_prewarmElapsed.invalidate();
+}
+
+void ShaderManager::startPendingShader(ShaderTraits traits)
+{
+    const auto defines = listDefines(traits);
+    const auto vertex = defines + generateVertexSource(traits);
+    const auto fragment = defines + generateFragmentSource(traits);
+
+    PendingShader pending{
+        .traits = traits,
+    };
+    if (auto shader = loadCachedShader(vertex, fragment, &pending.cacheKey)) {
+        m_shaderHash[traits] = std::move(shader);
+        return;
+    }
+
+    pending.compileTimer.start();
+    pending.shader = std::make_unique<GLShader>();
+    if (!pending.shader->loadDeferred(vertex, fragment)) {
+        m_shaderHash[traits] = nullptr;
+        return;
+    }
+
+    bindBuiltinAttributeLocations(pending.shader.get());
+    if (!pending.cacheKey.isEmpty()) {
+        m_shaderCache->prepare(pending.shader.get());
+    }
+    pending.shader->linkDeferred();
+
+    m_pendingShaders.push_back(std::move(pending));
+}
+
+std::unique_ptr<GLShader> ShaderManager::finishPendingShader(PendingShader &pending)
+{
+    if (!pending.shader->finishLink()) {
+        return nullptr;
+    }
+
+    if (!pending.cacheKey.isEmpty()) {
+        m_shaderCache->store(pending.shader.get(), pending.cacheKey, std::chrono::nanoseconds(pending.compileTimer.nsecsElapsed()));
+    }
+
+    return std::move(pending.shader);
+}
+
 std::unique_ptr<GLShader> ShaderManager::generateShaderFromFile(ShaderTraits traits, const QString &vertexFile, const QString &fragmentFile)
 {
     auto loadShaderFile = [](const QString &filePath) {
@@ -128,6 +314,17 @@ std::unique_ptr<GLShader> ShaderManager::generateShaderFromFile(ShaderTraits tra
 
 GLShader *ShaderManager::shader(ShaderTraits traits)
 {
+    // The shader is needed right now, stop waiting for it in the background.
+    if (!m_prewarmQueue.isEmpty() || !m_pendingShaders.empty()) {
+        m_prewarmQueue.removeOne(traits);
+        const auto pending = std::ranges::find(m_pendingShaders, traits, &PendingShader::traits);
+        if (pending != m_pendingShaders.end()) {
+            m_shaderHash[traits] = finishPendingShader(*pending);
+            m_pendingShaders.erase(pending);
+        }
+        finishPrewarm();
+    }
+
     std::unique_ptr<GLShader> &shader = m_shaderHash[traits];
     if (!shader) {
         shader = generateShader(traits);
@@ -12,15 +12,21 @@
 #include "kwin_export.h"
 
 #include <QByteArray>
+#include <QElapsedTimer>
 #include <QFlags>
+#include <QList>
 #include <QStack>
+#include <QTimer>
 #include <map>
 #include <memory>
+#include <vector>
 
 namespace KWin
 {
 
+class EglContext;
 class GLShader;
+class GLShaderCache;
 
 enum class ShaderTrait {
     MapTexture = (1 << 0),
@@ -142,12 +148,45 @@ public:
      */
     std::unique_ptr<GLShader> generateShaderFromFile(ShaderTraits traits, const QString &vertexFile = QString(), const QString &fragmentFile = QString());
 
+    /**
+     * Compiles the shaders with the given @p traits in the background, so they are ready by the
+     * time they are needed for the first time.
+     *
+     * If the driver supports GL_KHR_parallel_shader_compile, all shaders are handed over to the
+     * driver at once and compiled in its threads, and checkPendingShaders() picks them up when
+     * they are ready. Otherwise, the shaders are compiled one by one on a timer. A shader that is
+     * requested with shader() or pushShader() before it is ready is finished immediately.
+     *
+     * The context of the shader manager must be current.
+     */
+    void prewarm(const QList<ShaderTraits> &traits);
+
+    /**
+     * Finishes the pre-warmed shaders that the driver has compiled in the background. This is
+     * meant to be called while painting, when the context of the shader manager is current.
+     */
+    void checkPendingShaders();
+
     /**
      * @return a pointer to the ShaderManager instance
      */
     static ShaderManager *instance();
 
 private:
+    struct PendingShader
+    {
+        ShaderTraits traits;
+        std::unique_ptr<GLShader> shader;
+        QByteArray cacheKey;
+        QElapsedTimer compileTimer;
+    };
+
+    std::unique_ptr<GLShader> loadCachedShader(const QByteArray &vertexSource, const QByteArray &fragmentSource, QByteArray *cacheKey);
+    void compileNextPrewarmShader();
+    void finishPrewarm();
+    void startPendingShader(ShaderTraits traits);
+    std::unique_ptr<GLShader> finishPendingShader(PendingShader &pending);
+
     void bindAttributeLocations(GLShader *shader) const;
 
     QByteArray generateVertexSource(ShaderTraits traits) const;
@@ -156,6 +195,13 @@ private:
 
     QStack<GLShader *> m_boundShaders;
     std::map<ShaderTraits, std::unique_ptr<GLShader>> m_shaderHash;
+    std::unique_ptr<GLShaderCache> m_shaderCache;
+    EglContext *m_context;
+    bool m_parallelCompile = false;
+    QList<ShaderTraits> m_prewarmQueue;
+    std::vector<PendingShader> m_pendingShaders;
+    std::unique_ptr<QTimer> m_prewarmTimer;
+    QElapsedTimer m_prewarmElapsed;
 };
 
 /**
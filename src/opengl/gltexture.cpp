@@ -12,6 +12,7 @@
 #include "gltexture_p.h"
 #include "opengl/glframebuffer.h"
 #include "opengl/glplatform.h"
+#include "opengl/gluploadbuffer_p.h"
 #include "opengl/glutils.h"
 #include "utils/common.h"
 
@@ -140,6 +141,13 @@ void GLTexture::update(const QImage &image, const Region &region, const QPoint &
 
     bind();
 
+    if (GLUploadBuffer *uploadBuffer = context->uploadBuffer()) {
+        if (uploadBuffer->upload(d->m_target, im, region, offset, glFormat, type)) {
+            unbind();
+            return;
+        }
+    }
+
     for (const Rect &rect : region.rects()) {
         Q_ASSERT(im.depth() % 8 == 0);
         glPixelStorei(GL_UNPACK_ROW_LENGTH, im.bytesPerLine() / (im.depth() / 8));
@@ -0,0 +1,281 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "gluploadbuffer_p.h"
+#include "eglcontext.h"
+#include "utils/common.h"
+
+#include <QImage>
+#include <QThread>
+#include <QtConcurrentMap>
+
+namespace KWin
+{
+
+using namespace std::chrono_literals;
+
+// The ring starts this big and doubles when it runs out of space, up to the maximum size.
+static constexpr size_t s_minRingSize = 4 * 1024 * 1024;
+static constexpr size_t s_maxRingSize = 64 * 1024 * 1024;
+// Bigger uploads are rare and would pin a lot of memory, the ring must fit at least two.
+static constexpr size_t s_maxUploadSize = s_maxRingSize / 2;
+// The ring is released after there haven't been any uploads for that long.
+static constexpr std::chrono::seconds s_idleTimeout = 5s;
+// Below this, handing the copy over to the thread pool costs more than it saves.
+static constexpr size_t s_minParallelCopySize = 1024 * 1024;
+
+static size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+GLUploadBuffer::GLUploadBuffer()
+    : m_context(EglContext::currentContext())
+{
+    // The copy is memory bound, more threads than that don't help.
+    m_threadPool.setMaxThreadCount(std::clamp(QThread::idealThreadCount(), 1, 4));
+    m_threadPool.setObjectName(QStringLiteral("KWinTextureUpload"));
+}
+
+GLUploadBuffer::~GLUploadBuffer()
+{
+    m_threadPool.waitForDone();
+
+    if (!EglContext::currentContext()) {
+        qCWarning(KWIN_OPENGL, "Could not delete texture upload buffers because no context is current");
+        return;
+    }
+    Q_ASSERT(m_context->isCompatibleWith(EglContext::currentContext()));
+    if (!m_context->isCompatibleWith(EglContext::currentContext())) {
+        qCCritical(KWIN_OPENGL, "Attempted to delete texture upload buffers in the wrong context!");
+        return;
+    }
+    release();
+}
+
+void GLUploadBuffer::release()
+{
+    for (const Fence &fence : m_fences) {
+        glDeleteSync(fence.sync);
+    }
+    m_fences.clear();
+    if (m_buffer) {
+        // This also unmaps the buffer, the GPU keeps the storage alive as long as it's used
+        glDeleteBuffers(1, &m_buffer);
+    }
+    m_buffer = 0;
+    m_size = 0;
+    m_map = nullptr;
+    m_head = 0;
+    m_tail = 0;
+}
+
+void GLUploadBuffer::retireSignaledFences()
+{
+    while (!m_fences.empty()) {
+        const Fence &fence = m_fences.front();
+        GLint status;
+        glGetSynciv(fence.sync, GL_SYNC_STATUS, 1, nullptr, &status);
+        if (status != GL_SIGNALED) {
+            break;
+        }
+        m_tail = fence.end;
+        glDeleteSync(fence.sync);
+        m_fences.pop_front();
+    }
+    if (m_fences.empty()) {
+        // nothing is in flight, start at the beginning of the buffer again
+        m_head = 0;
+        m_tail = 0;
+    }
+}
+
+bool GLUploadBuffer::awaitFence()
+{
+    const Fence &fence = m_fences.front();
+    qCDebug(KWIN_OPENGL) << "Stalling on texture upload buffer fence";
+    const GLenum ret = glClientWaitSync(fence.sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+    if (ret == GL_TIMEOUT_EXPIRED || ret == GL_WAIT_FAILED) {
+        qCCritical(KWIN_OPENGL) << "Wait failed";
+        return false;
+    }
+    m_tail = fence.end;
+    glDeleteSync(fence.sync);
+    m_fences.pop_front();
+    return true;
+}
+
+bool GLUploadBuffer::reallocate(size_t size)
+{
+    release();
+
+    const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffer);
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, access);
+    m_map = static_cast<uint8_t *>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, access));
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (!m_map) {
+        qCWarning(KWIN_OPENGL) << "Failed to map a texture upload buffer of size" << size;
+        release();
+        return false;
+    }
+
+    m_size = size;
+    return true;
+}
+
+std::optional<size_t> GLUploadBuffer::allocate(size_t size)
+{
+    retireSignaledFences();
+
+    // A range can't wrap around, skip the end of the buffer if it's too small
+    const auto startOf = [this, size]() {
+        const size_t position = m_head % m_size;
+        return position + size > m_size ? m_head + (m_size - position) : m_head;
+    };
+
+    uint64_t start = m_buffer ? startOf() : 0;
+    if (!m_buffer || start + size - m_tail > m_size) {
+        if (m_size < s_maxRingSize) {
+            // The GPU hasn't consumed the uploads yet, possibly of the current frame. Growing
+            // the ring is cheaper than waiting for them.
+            const size_t ringSize = std::min(s_maxRingSize, std::max({m_size * 2, s_minRingSize, alignUp(size * 2, 1024 * 1024)}));
+            if (!reallocate(ringSize)) {
+                return std::nullopt;
+            }
+            start = 0;
+        } else {
+            while (start + size - m_tail > m_size) {
+                if (m_fences.empty() || !awaitFence()) {
+                    return std::nullopt;
+                }
+                if (m_fences.empty()) {
+                    m_head = 0;
+                    m_tail = 0;
+                }
+                start = startOf();
+            }
+        }
+    }
+
+    m_head = start + size;
+    return start % m_size;
+}
+
+void GLUploadBuffer::beginFrame()
+{
+    if (!m_buffer) {
+        return;
+    }
+    retireSignaledFences();
+    if (m_fences.empty() && std::chrono::steady_clock::now() - m_lastUpload > s_idleTimeout) {
+        release();
+    }
+}
+
+void GLUploadBuffer::copy(uint8_t *destination, const QImage &image, const QList<Rect> &rects, const QList<size_t> &offsets)
+{
+    struct Band
+    {
+        const uchar *source;
+        uint8_t *destination;
+        size_t rowSize;
+        int rowCount;
+    };
+
+    const uchar *bits = image.constBits();
+    const qsizetype stride = image.bytesPerLine();
+    const size_t totalSize = offsets.back();
+    const int threadCount = m_threadPool.maxThreadCount();
+
+    // Make a few bands per thread so the threads don't idle if the rects have different sizes.
+    QList<Band> bands;
+    for (qsizetype i = 0; i < rects.size(); ++i) {
+        const Rect &rect = rects[i];
+        const size_t rowSize = size_t(rect.width()) * 4;
+        const int bandHeight = totalSize < s_minParallelCopySize ? rect.height() : std::max(16, rect.height() / (threadCount * 4));
+        for (int y = 0; y < rect.height(); y += bandHeight) {
+            bands.append(Band{
+                .source = bits + (rect.y() + y) * stride + rect.x() * 4,
+                .destination = destination + offsets[i] + y * rowSize,
+                .rowSize = rowSize,
+                .rowCount = std::min(bandHeight, rect.height() - y),
+            });
+        }
+    }
+
+    const auto copyBand = [stride](const Band &band) {
+        for (int row = 0; row < band.rowCount; ++row) {
+            memcpy(band.destination + row * band.rowSize, band.source + row * stride, band.rowSize);
+        }
+    };
+
+    if (threadCount == 1 || bands.size() == 1) {
+        for (const Band &band : std::as_const(bands)) {
+            copyBand(band);
+        }
+    } else {
+        QtConcurrent::blockingMap(&m_threadPool, bands, copyBand);
+    }
+}
+
+bool GLUploadBuffer::upload(GLenum target, const QImage &image, const Region &region, const QPoint &offset, GLenum format, GLenum type)
+{
+    Q_ASSERT(image.depth() == 32);
+
+    const auto regionRects = region.rects();
+    if (regionRects.empty()) {
+        return true;
+    }
+
+    // The rects are packed tightly, one after another. The last offset is the total size.
+    const QList<Rect> rects(regionRects.begin(), regionRects.end());
+    QList<size_t> offsets;
+    offsets.reserve(rects.size() + 1);
+    size_t size = 0;
+    for (const Rect &rect : rects) {
+        offsets.append(size);
+        size = alignUp(size + size_t(rect.width()) * rect.height() * 4, 16);
+    }
+    offsets.append(size);
+    if (size > s_maxUploadSize) {
+        return false;
+    }
+
+    const std::optional<size_t> bufferOffset = allocate(size);
+    if (!bufferOffset) {
+        return false;
+    }
+    m_lastUpload = std::chrono::steady_clock::now();
+
+    copy(m_map + *bufferOffset, image, rects, offsets);
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffer);
+    for (qsizetype i = 0; i < rects.size(); ++i) {
+        const Rect &rect = rects[i];
+        glTexSubImage2D(target, 0, offset.x() + rect.x(), offset.y() + rect.y(), rect.width(), rect.height(), format, type, reinterpret_cast<const GLvoid *>(*bufferOffset + offsets[i]));
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (GLsync sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)) {
+        m_fences.push_back(Fence{
+            .sync = sync,
+            .end = m_head,
+        });
+    } else {
+        // without a fence, the range can't be reused safely
+        qCWarning(KWIN_OPENGL) << "Failed to create a texture upload buffer fence";
+        release();
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,84 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "core/region.h"
+
+#include <QThreadPool>
+#include <chrono>
+#include <deque>
+#include <epoxy/gl.h>
+#include <optional>
+
+class QImage;
+
+namespace KWin
+{
+
+class EglContext;
+
+/**
+ * The GLUploadBuffer class streams texture uploads through a persistently mapped pixel unpack
+ * buffer that is used as a ring.
+ *
+ * With client memory, glTexSubImage2D() has to copy the pixels before it returns. With a
+ * pixel unpack buffer, the pixels are copied into memory that the GPU can read directly and
+ * the transfer into the texture happens asynchronously, overlapping with the rendering.
+ *
+ * Every upload takes a range of the ring that is guarded by a fence, so the range is only
+ * reused once the GPU is done with it. If the ring is full, it grows rather than waiting for
+ * uploads of the same frame, up to a limit. The ring is released if there haven't been any
+ * uploads for a while, so a burst of big uploads doesn't keep memory pinned.
+ */
+class GLUploadBuffer
+{
+public:
+    explicit GLUploadBuffer();
+    ~GLUploadBuffer();
+
+    /**
+     * Uploads the @p region of the @p image to the texture bound to @p target. The image must
+     * have 4 bytes per pixel. Returns @c false if the upload couldn't be done this way, e.g.
+     * because the region is too big, in which case nothing has been uploaded.
+     */
+    bool upload(GLenum target, const QImage &image, const Region &region, const QPoint &offset, GLenum format, GLenum type);
+
+    /**
+     * Recycles the ranges that the GPU is done with, and releases the ring if it has been idle.
+     */
+    void beginFrame();
+
+private:
+    struct Fence
+    {
+        GLsync sync;
+        uint64_t end;
+    };
+
+    std::optional<size_t> allocate(size_t size);
+    bool reallocate(size_t size);
+    void release();
+    void retireSignaledFences();
+    bool awaitFence();
+    void copy(uint8_t *destination, const QImage &image, const QList<Rect> &rects, const QList<size_t> &offsets);
+
+    EglContext *const m_context;
+    GLuint m_buffer = 0;
+    size_t m_size = 0;
+    uint8_t *m_map = nullptr;
+    // Positions in the ring grow monotonically, the offset in the buffer is the position
+    // modulo the size. The GPU may still read the range between the tail and the head.
+    uint64_t m_head = 0;
+    uint64_t m_tail = 0;
+    std::deque<Fence> m_fences;
+    std::chrono::steady_clock::time_point m_lastUpload;
+    QThreadPool m_threadPool;
+};
+
+}
@@ -697,6 +697,13 @@ void Options::loadConfig()
     QString compositingBackend = config.readEntry("Backend", "OpenGL");
     if (compositingBackend == "QPainter") {
         compositingMode = QPainterCompositing;
+    } else if (compositingBackend == "Vulkan") {
+#if KWIN_BUILD_VULKAN
+        compositingMode = VulkanCompositing;
+#else
+        qCWarning(KWIN_CORE) << "KWin has been built without Vulkan compositing support, using OpenGL";
+        compositingMode = OpenGLCompositing;
+#endif
     } else {
         compositingMode = OpenGLCompositing;
     }
@@ -711,6 +718,14 @@ void Options::loadConfig()
             qCDebug(KWIN_CORE) << "Compositing forced to QPainter mode by environment variable";
             compositingMode = QPainterCompositing;
             break;
+        case 'V':
+#if KWIN_BUILD_VULKAN
+            qCDebug(KWIN_CORE) << "Compositing forced to Vulkan mode by environment variable";
+            compositingMode = VulkanCompositing;
+#else
+            qCWarning(KWIN_CORE) << "KWin has been built without Vulkan compositing support, ignoring KWIN_COMPOSE=V";
+#endif
+            break;
         default:
             qCDebug(KWIN_CORE) << "Unknown KWIN_COMPOSE mode set, ignoring";
             break;
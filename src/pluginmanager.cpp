@@ -77,6 +77,12 @@ QStringList PluginManager::availablePlugins() const
     return ret;
 }
 
+Plugin *PluginManager::plugin(const QString &pluginId) const
+{
+    const auto it = m_plugins.find(pluginId);
+    return it != m_plugins.end() ? it->second.get() : nullptr;
+}
+
 bool PluginManager::loadPlugin(const QString &pluginId)
 {
     if (m_plugins.find(pluginId) != m_plugins.end()) {
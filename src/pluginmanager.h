@@ -31,6 +31,10 @@ public:
 
     QStringList loadedPlugins() const;
     QStringList availablePlugins() const;
+    /**
+     * Returns the loaded plugin with the given @p pluginId, or @c nullptr if it's not loaded.
+     */
+    Plugin *plugin(const QString &pluginId) const;
 
 public Q_SLOTS:
     bool loadPlugin(const QString &pluginId);
@@ -0,0 +1,262 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "outputscreencastrenderer.h"
+#include "filteredsceneview.h"
+#include "screencastlayer.h"
+
+#include "compositor.h"
+#include "core/output.h"
+#include "opengl/eglbackend.h"
+#include "opengl/eglcontext.h"
+#include "opengl/egldisplay.h"
+#include "opengl/glframebuffer.h"
+#include "opengl/glshader.h"
+#include "opengl/glshadermanager.h"
+#include "opengl/gltexture.h"
+#include "scene/item.h"
+#include "scene/workspacescene.h"
+
+#include <bit>
+
+namespace KWin
+{
+
+OutputScreenCastRenderer::OutputScreenCastRenderer(LogicalOutput *output, std::optional<pid_t> pidToHide, bool renderCursor)
+    : m_output(output)
+    , m_pidToHide(pidToHide)
+    , m_renderCursor(renderCursor)
+{
+    // Streams can lag behind by a few frames, e.g. if the consumer is slow to return buffers
+    m_damageJournal.setCapacity(32);
+
+    m_layer = std::make_unique<ScreencastLayer>(m_output, static_cast<EglBackend *>(Compositor::self()->backend())->openglContext()->displayObject()->nonExternalOnlySupportedDrmFormats());
+
+    m_sceneView = std::make_unique<FilteredSceneView>(kwinApp()->scene(), m_output, m_layer.get(), m_pidToHide);
+    m_sceneView->setViewport(m_output->geometryF());
+    m_sceneView->setScale(m_output->scale());
+    m_sceneView->setRefreshRate(m_output->refreshRate());
+    connect(m_output, &LogicalOutput::changed, m_sceneView.get(), [this]() {
+        m_sceneView->setViewport(m_output->geometryF());
+        m_sceneView->setScale(m_output->scale());
+        m_sceneView->setRefreshRate(m_output->refreshRate());
+    });
+
+    m_cursorView = std::make_unique<ItemTreeView>(m_sceneView.get(), kwinApp()->scene()->cursorItem(), m_output, nullptr, nullptr);
+    m_cursorView->setExclusive(!m_renderCursor);
+
+    connect(m_layer.get(), &OutputLayer::itemRepaintScheduled, this, [this](Item *item) {
+        m_pendingDamage += item->deviceRepaints(m_sceneView.get());
+    });
+    connect(m_layer.get(), &OutputLayer::repaintScheduled, this, [this]() {
+        m_dirty = true;
+        Q_EMIT frame();
+    });
+}
+
+OutputScreenCastRenderer::~OutputScreenCastRenderer()
+{
+    if (m_target.texture) {
+        if (EglBackend *backend = qobject_cast<EglBackend *>(Compositor::self()->backend()); backend && backend->openglContext()->makeCurrent()) {
+            m_target = {};
+        }
+    }
+
+    m_cursorView.reset();
+    m_sceneView.reset();
+    m_layer.reset();
+}
+
+LogicalOutput *OutputScreenCastRenderer::output() const
+{
+    return m_output;
+}
+
+std::optional<pid_t> OutputScreenCastRenderer::pidToHide() const
+{
+    return m_pidToHide;
+}
+
+bool OutputScreenCastRenderer::renderCursor() const
+{
+    return m_renderCursor;
+}
+
+void OutputScreenCastRenderer::attach()
+{
+    ++m_attachedStreams;
+}
+
+void OutputScreenCastRenderer::detach()
+{
+    Q_ASSERT(m_attachedStreams > 0);
+    --m_attachedStreams;
+}
+
+uint64_t OutputScreenCastRenderer::paintCount() const
+{
+    return m_frame;
+}
+
+Region OutputScreenCastRenderer::render(GLFramebuffer *target, const Region &targetRepair, uint64_t *frame)
+{
+    const Rect targetRect(QPoint(), target->size());
+    const bool shared = m_attachedStreams > 1;
+
+    if (!shared) {
+        // The target may have missed frames that have been rendered for other streams
+        const Region missed = damageSince(*frame);
+        const Region damage = paint(target, targetRepair | missed);
+        *frame = m_frame;
+
+        // The texture has missed this frame, it will be repainted fully if it's needed again
+        if (m_target.texture) {
+            m_target = {};
+        }
+        return (damage | missed) & targetRect;
+    }
+
+    Region textureRepair;
+    if (!ensureTexture(&textureRepair)) {
+        return Region{};
+    }
+    if (m_dirty || !textureRepair.isEmpty()) {
+        paint(m_target.framebuffer.get(), textureRepair);
+        m_mipmapsDirty = true;
+    }
+
+    const Region changed = damageSince(*frame);
+    Region damage;
+    GLFramebuffer::pushFramebuffer(m_target.framebuffer.get());
+    if (target->size() == m_target.texture->size()) {
+        damage = changed & targetRect;
+        for (const Rect &rect : ((damage | targetRepair) & targetRect).rects()) {
+            target->blitFromFramebuffer(rect, rect, GL_NEAREST);
+        }
+    } else {
+        // The frame is scaled as a whole
+        if (!changed.isEmpty() || !targetRepair.isEmpty()) {
+            downscale(target);
+        }
+        if (!changed.isEmpty()) {
+            damage = targetRect;
+        }
+    }
+    GLFramebuffer::popFramebuffer();
+
+    *frame = m_frame;
+    return damage;
+}
+
+void OutputScreenCastRenderer::downscale(GLFramebuffer *target)
+{
+    GLTexture *texture = m_target.texture.get();
+
+    // Without mipmaps, shrinking the frame by more than a half would skip pixels
+    if (m_mipmapsDirty) {
+        texture->bind();
+        texture->generateMipmaps();
+        texture->unbind();
+        m_mipmapsDirty = false;
+    }
+
+    GLFramebuffer::pushFramebuffer(target);
+
+    QMatrix4x4 projection;
+    projection.ortho(QRectF(QPointF(), target->size()));
+
+    ShaderBinder binder(ShaderTrait::MapTexture);
+    binder.shader()->setUniform(GLShader::Mat4Uniform::ModelViewProjectionMatrix, projection);
+
+    // The aspect ratio of the output is preserved, the stream may have unused space
+    const QSize targetSize = target->size();
+    const qreal scale = std::min(qreal(targetSize.width()) / texture->width(), qreal(targetSize.height()) / texture->height());
+
+    texture->setFilter(GL_LINEAR_MIPMAP_LINEAR);
+    texture->render(QSizeF(texture->size()) * scale);
+
+    GLFramebuffer::popFramebuffer();
+}
+
+Region OutputScreenCastRenderer::paint(GLFramebuffer *target, const Region &repair)
+{
+    m_dirty = false;
+
+    // Streams smaller than the output are rendered at their size right away rather than
+    // rendered at the size of the output and scaled down afterwards
+    const QSize outputSize = m_output->pixelSize();
+    const qreal scale = std::min({1.0, qreal(target->size().width()) / outputSize.width(), qreal(target->size().height()) / outputSize.height()});
+    m_sceneView->setScale(m_output->scale() * scale);
+
+    m_layer->setFramebuffer(target, repair & Rect(QPoint(), target->size()));
+    if (!m_layer->preparePresentationTest()) {
+        return Region{};
+    }
+    const auto beginInfo = m_layer->beginFrame();
+    if (!beginInfo) {
+        return Region{};
+    }
+    m_sceneView->prePaint();
+    const auto bufferDamage = (m_layer->deviceRepaints() | m_sceneView->collectDamage()) & Rect(QPoint(), target->size());
+    const auto repaints = beginInfo->repaint | bufferDamage;
+    m_layer->resetRepaints();
+    m_pendingDamage = Region{};
+    m_sceneView->paint(beginInfo->renderTarget, QPoint(), repaints);
+    m_sceneView->postPaint();
+    if (!m_layer->endFrame(repaints, bufferDamage, nullptr)) {
+        return Region{};
+    }
+
+    ++m_frame;
+    m_damageJournal.add(bufferDamage);
+    return bufferDamage;
+}
+
+Region OutputScreenCastRenderer::pendingDamage() const
+{
+    // The damage is in the device coordinates of the view, which may be scaled to fit a stream buffer
+    return (m_pendingDamage | m_layer->deviceRepaints()).scaledAndRoundedOut(m_output->scale() / m_sceneView->scale());
+}
+
+Region OutputScreenCastRenderer::damageSince(uint64_t frame) const
+{
+    if (frame == 0 || m_frame - frame >= uint64_t(m_damageJournal.capacity())) {
+        return Region::infinite();
+    }
+    return m_damageJournal.accumulate(m_frame - frame + 1, Region::infinite());
+}
+
+bool OutputScreenCastRenderer::ensureTexture(Region *repair)
+{
+    const QSize size = m_output->pixelSize();
+    if (m_target.texture && m_target.texture->size() == size) {
+        return true;
+    }
+
+    m_target = {};
+    // Mipmaps are only generated if a stream needs them, NPOT textures can have them since GL 3.0
+    const int levels = EglContext::currentContext()->hasVersion(Version(3, 0)) ? std::bit_width(uint(std::max(size.width(), size.height()))) : 1;
+    std::shared_ptr<GLTexture> texture = GLTexture::allocate(GL_RGBA8, size, levels);
+    if (!texture) {
+        return false;
+    }
+    auto framebuffer = std::make_unique<GLFramebuffer>(texture.get());
+    if (!framebuffer->valid()) {
+        return false;
+    }
+
+    m_target = ScreenCastRenderTarget{
+        .texture = std::move(texture),
+        .framebuffer = std::move(framebuffer),
+    };
+    *repair = Region::infinite();
+    m_mipmapsDirty = true;
+    return true;
+}
+
+} // namespace KWin
+
+#include "moc_outputscreencastrenderer.cpp"
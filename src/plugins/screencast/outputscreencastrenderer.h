@@ -0,0 +1,98 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "screencastbuffer.h"
+#include "utils/damagejournal.h"
+
+#include <QObject>
+#include <QPointer>
+
+#include <memory>
+#include <optional>
+
+namespace KWin
+{
+
+class FilteredSceneView;
+class GLFramebuffer;
+class ItemTreeView;
+class LogicalOutput;
+class ScreencastLayer;
+
+/**
+ * The OutputScreenCastRenderer class renders an output for screencasting.
+ *
+ * Streams of the same output with the same filter configuration share a renderer, see
+ * ScreencastManager::outputRenderer(). If there is only one attached stream, the output is rendered
+ * directly into the buffers of the stream, at the size of the stream. Otherwise, the output is
+ * rendered once per frame into a texture, and the damaged parts of the texture are copied into
+ * the buffers of every stream. Streams that are smaller than the output get a mipmapped copy.
+ */
+class OutputScreenCastRenderer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit OutputScreenCastRenderer(LogicalOutput *output, std::optional<pid_t> pidToHide, bool renderCursor);
+    ~OutputScreenCastRenderer() override;
+
+    LogicalOutput *output() const;
+    std::optional<pid_t> pidToHide() const;
+    bool renderCursor() const;
+
+    /**
+     * Registers a stream that renders the output with this renderer. Every attach() has to be
+     * balanced with a detach() once the stream doesn't render the output anymore.
+     */
+    void attach();
+    void detach();
+
+    /**
+     * Returns the number of times the output has been painted by this renderer.
+     */
+    uint64_t paintCount() const;
+
+    /**
+     * Brings the @p target up to date and returns the parts of it that have changed. The
+     * @p targetRepair specifies the parts of the target that have to be repainted regardless
+     * of the damage. The @p frame is the frame that the target has been last updated to, or
+     * @c 0 if it hasn't been updated by this renderer yet; it's advanced to the current frame.
+     */
+    Region render(GLFramebuffer *target, const Region &targetRepair, uint64_t *frame);
+    /**
+     * Returns the parts of the output that have been damaged since it was last rendered, in
+     * device coordinates of the output.
+     */
+    Region pendingDamage() const;
+
+Q_SIGNALS:
+    void frame();
+
+private:
+    Region paint(GLFramebuffer *target, const Region &repair);
+    void downscale(GLFramebuffer *target);
+    Region damageSince(uint64_t frame) const;
+    bool ensureTexture(Region *repair);
+
+    QPointer<LogicalOutput> m_output;
+    std::optional<pid_t> m_pidToHide;
+    bool m_renderCursor;
+    std::unique_ptr<ScreencastLayer> m_layer;
+    std::unique_ptr<FilteredSceneView> m_sceneView;
+    std::unique_ptr<ItemTreeView> m_cursorView;
+
+    ScreenCastRenderTarget m_target;
+    DamageJournal m_damageJournal;
+    Region m_pendingDamage;
+    uint64_t m_frame = 0;
+    int m_attachedStreams = 0;
+    bool m_dirty = true;
+    bool m_mipmapsDirty = true;
+};
+
+} // namespace KWin
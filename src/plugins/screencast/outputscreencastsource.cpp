@@ -5,18 +5,12 @@
 */
 
 #include "outputscreencastsource.h"
-#include "filteredsceneview.h"
-#include "screencastlayer.h"
-#include "screencastutils.h"
+#include "outputscreencastrenderer.h"
+#include "screencastmanager.h"
 
-#include "compositor.h"
 #include "core/output.h"
+#include "core/region.h"
 #include "cursor.h"
-#include "opengl/eglbackend.h"
-#include "opengl/egldisplay.h"
-#include "opengl/glframebuffer.h"
-#include "opengl/gltexture.h"
-#include "scene/workspacescene.h"
 #include "workspace.h"
 
 #include <drm_fourcc.h>
@@ -24,8 +18,9 @@
 namespace KWin
 {
 
-OutputScreenCastSource::OutputScreenCastSource(LogicalOutput *output, std::optional<pid_t> pidToHide)
+OutputScreenCastSource::OutputScreenCastSource(ScreencastManager *manager, LogicalOutput *output, std::optional<pid_t> pidToHide)
     : ScreenCastSource()
+    , m_manager(manager)
     , m_output(output)
     , m_pidToHide(pidToHide)
 {
@@ -58,44 +53,43 @@ qreal OutputScreenCastSource::devicePixelRatio() const
 
 void OutputScreenCastSource::setRenderCursor(bool enable)
 {
+    if (m_renderCursor == enable) {
+        return;
+    }
     m_renderCursor = enable;
-    if (m_cursorView) {
-        m_cursorView->setExclusive(!enable);
+    if (m_active) {
+        // Streams with and without the cursor can't share the rendered frames
+        releaseRenderer();
+        acquireRenderer();
     }
 }
 
-Region OutputScreenCastSource::render(QImage *target, const Region &bufferRepair)
+Region OutputScreenCastSource::render(GLFramebuffer *target, const Region &bufferRepair)
 {
-    auto texture = GLTexture::allocate(GL_RGBA8, target->size());
-    if (!texture) {
-        return Region{};
-    }
-    GLFramebuffer buffer(texture.get());
-    const Region ret = render(&buffer, Region::infinite());
-    grabTexture(texture.get(), target);
-    return ret;
+    return m_renderer->render(target, bufferRepair, &m_rendererFrame);
 }
 
-Region OutputScreenCastSource::render(GLFramebuffer *target, const Region &bufferRepair)
+Region OutputScreenCastSource::pendingDamage() const
 {
-    m_layer->setFramebuffer(target, bufferRepair & Rect(QPoint(), target->size()));
-    if (!m_layer->preparePresentationTest()) {
-        return Region{};
-    }
-    const auto beginInfo = m_layer->beginFrame();
-    if (!beginInfo) {
-        return Region{};
-    }
-    m_sceneView->prePaint();
-    const auto bufferDamage = (m_layer->deviceRepaints() | m_sceneView->collectDamage()) & Rect(QPoint(), target->size());
-    const auto repaints = beginInfo->repaint | bufferDamage;
-    m_layer->resetRepaints();
-    m_sceneView->paint(beginInfo->renderTarget, QPoint(), repaints);
-    m_sceneView->postPaint();
-    if (!m_layer->endFrame(repaints, bufferDamage, nullptr)) {
+    if (!m_renderer) {
         return Region{};
     }
-    return bufferDamage;
+    return m_renderer->pendingDamage();
+}
+
+void OutputScreenCastSource::acquireRenderer()
+{
+    m_renderer = m_manager->outputRenderer(m_output, m_pidToHide, m_renderCursor);
+    m_renderer->attach();
+    m_rendererFrame = 0;
+    connect(m_renderer.get(), &OutputScreenCastRenderer::frame, this, &OutputScreenCastSource::frame);
+}
+
+void OutputScreenCastSource::releaseRenderer()
+{
+    disconnect(m_renderer.get(), &OutputScreenCastRenderer::frame, this, &OutputScreenCastSource::frame);
+    m_renderer->detach();
+    m_renderer.reset();
 }
 
 uint OutputScreenCastSource::refreshRate() const
@@ -109,22 +103,7 @@ void OutputScreenCastSource::resume()
         return;
     }
 
-    m_layer = std::make_unique<ScreencastLayer>(m_output, static_cast<EglBackend *>(Compositor::self()->backend())->openglContext()->displayObject()->nonExternalOnlySupportedDrmFormats());
-
-    m_sceneView = std::make_unique<FilteredSceneView>(kwinApp()->scene(), m_output, m_layer.get(), m_pidToHide);
-    m_sceneView->setViewport(m_output->geometryF());
-    m_sceneView->setScale(m_output->scale());
-    m_sceneView->setRefreshRate(m_output->refreshRate());
-    connect(m_output, &LogicalOutput::changed, m_sceneView.get(), [this]() {
-        m_sceneView->setViewport(m_output->geometryF());
-        m_sceneView->setScale(m_output->scale());
-        m_sceneView->setRefreshRate(m_output->refreshRate());
-    });
-
-    m_cursorView = std::make_unique<ItemTreeView>(m_sceneView.get(), kwinApp()->scene()->cursorItem(), m_output, nullptr, nullptr);
-    m_cursorView->setExclusive(!m_renderCursor);
-
-    connect(m_layer.get(), &OutputLayer::repaintScheduled, this, &OutputScreenCastSource::frame);
+    acquireRenderer();
     Q_EMIT frame();
 
     m_active = true;
@@ -136,11 +115,7 @@ void OutputScreenCastSource::pause()
         return;
     }
 
-    disconnect(m_layer.get(), &OutputLayer::repaintScheduled, this, &OutputScreenCastSource::frame);
-
-    m_cursorView.reset();
-    m_sceneView.reset();
-    m_layer.reset();
+    releaseRenderer();
 
     m_active = false;
 }
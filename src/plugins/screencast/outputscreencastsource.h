@@ -10,20 +10,21 @@
 
 #include <QPointer>
 
+#include <memory>
+
 namespace KWin
 {
 
-class FilteredSceneView;
-class ItemTreeView;
 class LogicalOutput;
-class ScreencastLayer;
+class OutputScreenCastRenderer;
+class ScreencastManager;
 
 class OutputScreenCastSource : public ScreenCastSource
 {
     Q_OBJECT
 
 public:
-    explicit OutputScreenCastSource(LogicalOutput *output, std::optional<pid_t> pidToHide);
+    explicit OutputScreenCastSource(ScreencastManager *manager, LogicalOutput *output, std::optional<pid_t> pidToHide);
     ~OutputScreenCastSource() override;
 
     uint refreshRate() const override;
@@ -33,7 +34,7 @@ public:
 
     void setRenderCursor(bool enable) override;
     Region render(GLFramebuffer *target, const Region &bufferRepair) override;
-    Region render(QImage *target, const Region &bufferRepair) override;
+    Region pendingDamage() const override;
 
     void resume() override;
     void pause() override;
@@ -46,11 +47,14 @@ public:
     void resize(const QSize &size) override;
 
 private:
+    void acquireRenderer();
+    void releaseRenderer();
+
+    ScreencastManager *const m_manager;
     QPointer<LogicalOutput> m_output;
     std::optional<pid_t> m_pidToHide;
-    std::unique_ptr<ScreencastLayer> m_layer;
-    std::unique_ptr<FilteredSceneView> m_sceneView;
-    std::unique_ptr<ItemTreeView> m_cursorView;
+    std::shared_ptr<OutputScreenCastRenderer> m_renderer;
+    uint64_t m_rendererFrame = 0;
     bool m_active = false;
     bool m_renderCursor = false;
 };
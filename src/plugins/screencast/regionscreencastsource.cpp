@@ -7,7 +7,6 @@
 #include "regionscreencastsource.h"
 #include "filteredsceneview.h"
 #include "screencastlayer.h"
-#include "screencastutils.h"
 
 #include "compositor.h"
 #include "core/output.h"
@@ -15,6 +14,7 @@
 #include "opengl/eglbackend.h"
 #include "opengl/glframebuffer.h"
 #include "opengl/gltexture.h"
+#include "scene/item.h"
 #include "scene/workspacescene.h"
 #include "workspace.h"
 
@@ -73,6 +73,7 @@ void RegionScreenCastSource::setRenderCursor(bool enable)
 
 Region RegionScreenCastSource::render(GLFramebuffer *target, const Region &bufferRepair)
 {
+    m_sceneView->setScale(m_scale * scaleForSize(target->size()));
     m_layer->setFramebuffer(target, bufferRepair & Rect(QPoint(), target->size()));
     if (!m_layer->preparePresentationTest()) {
         return Region{};
@@ -85,6 +86,7 @@ Region RegionScreenCastSource::render(GLFramebuffer *target, const Region &buffe
     const auto bufferDamage = (m_layer->deviceRepaints() | m_sceneView->collectDamage()) & Rect(QPoint(), target->size());
     const auto repaints = beginInfo->repaint | bufferDamage;
     m_layer->resetRepaints();
+    m_pendingDamage = Region{};
     m_sceneView->paint(beginInfo->renderTarget, QPoint(), repaints);
     m_sceneView->postPaint();
     if (!m_layer->endFrame(repaints, bufferDamage, nullptr)) {
@@ -93,16 +95,13 @@ Region RegionScreenCastSource::render(GLFramebuffer *target, const Region &buffe
     return bufferDamage;
 }
 
-Region RegionScreenCastSource::render(QImage *target, const Region &bufferRepair)
+Region RegionScreenCastSource::pendingDamage() const
 {
-    auto texture = GLTexture::allocate(GL_RGBA8, target->size());
-    if (!texture) {
+    if (!m_active) {
         return Region{};
     }
-    GLFramebuffer buffer(texture.get());
-    const Region ret = render(&buffer, Region::infinite());
-    grabTexture(texture.get(), target);
-    return ret;
+    // The damage is in the device coordinates of the view, which is scaled to fit the last stream buffer
+    return (m_pendingDamage | m_layer->deviceRepaints()).scaledAndRoundedOut(m_scale / m_sceneView->scale());
 }
 
 uint RegionScreenCastSource::refreshRate() const
@@ -134,6 +133,7 @@ void RegionScreenCastSource::pause()
     m_active = false;
     disconnect(m_layer.get(), &OutputLayer::repaintScheduled, this, &RegionScreenCastSource::frame);
 
+    m_pendingDamage = Region{};
     m_cursorView.reset();
     m_sceneView.reset();
     m_layer.reset();
@@ -156,6 +156,9 @@ void RegionScreenCastSource::resume()
     m_cursorView->setExclusive(!m_renderCursor);
 
     m_active = true;
+    connect(m_layer.get(), &OutputLayer::itemRepaintScheduled, this, [this](Item *item) {
+        m_pendingDamage += item->deviceRepaints(m_sceneView.get());
+    });
     connect(m_layer.get(), &OutputLayer::repaintScheduled, this, &RegionScreenCastSource::frame);
     Q_EMIT frame();
 }
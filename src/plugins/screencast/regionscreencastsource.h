@@ -32,7 +32,7 @@ public:
 
     void setRenderCursor(bool enable) override;
     Region render(GLFramebuffer *target, const Region &bufferRepair) override;
-    Region render(QImage *target, const Region &bufferRepair) override;
+    Region pendingDamage() const override;
 
     void close();
     void pause() override;
@@ -54,6 +54,7 @@ private:
     std::unique_ptr<ScreencastLayer> m_layer;
     std::unique_ptr<FilteredSceneView> m_sceneView;
     std::unique_ptr<ItemTreeView> m_cursorView;
+    Region m_pendingDamage;
 };
 
 } // namespace KWin
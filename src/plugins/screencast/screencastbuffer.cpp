@@ -10,7 +10,10 @@
 #include "core/renderdevice.h"
 #include "core/shmgraphicsbufferallocator.h"
 #include "opengl/eglbackend.h"
+#include "opengl/egldisplay.h"
+#include "opengl/eglimagetexture.h"
 #include "opengl/glframebuffer.h"
+#include "screencastyuvconverter.h"
 
 namespace KWin
 {
@@ -25,14 +28,59 @@ ScreenCastBuffer::~ScreenCastBuffer()
     m_buffer->drop();
 }
 
-DmaBufScreenCastBuffer::DmaBufScreenCastBuffer(GraphicsBuffer *buffer, std::shared_ptr<GLTexture> &&texture, std::unique_ptr<GLFramebuffer> &&framebuffer, std::unique_ptr<SyncTimeline> &&synctimeline)
+DmaBufScreenCastBuffer::DmaBufScreenCastBuffer(GraphicsBuffer *buffer, std::vector<ScreenCastRenderTarget> &&planes, std::unique_ptr<SyncTimeline> &&synctimeline)
     : ScreenCastBuffer(buffer)
-    , texture(std::move(texture))
-    , framebuffer(std::move(framebuffer))
+    , planes(std::move(planes))
     , synctimeline(std::move(synctimeline))
 {
 }
 
+std::vector<ScreenCastRenderTarget> DmaBufScreenCastBuffer::importRenderTargets(EglBackend *backend, const DmaBufAttributes &attributes)
+{
+    const QList<ScreenCastYuvConverter::Plane> yuvPlanes = ScreenCastYuvConverter::planes(attributes.format);
+    if (yuvPlanes.isEmpty()) {
+        auto texture = backend->importDmaBufAsTexture(attributes);
+        if (!texture) {
+            return {};
+        }
+        auto framebuffer = std::make_unique<GLFramebuffer>(texture.get());
+        if (!framebuffer->valid()) {
+            return {};
+        }
+        std::vector<ScreenCastRenderTarget> ret;
+        ret.push_back(ScreenCastRenderTarget{
+            .texture = std::move(texture),
+            .framebuffer = std::move(framebuffer),
+        });
+        return ret;
+    }
+
+    // YUV buffers need to be imported plane for plane
+    if (attributes.planeCount != yuvPlanes.size()) {
+        return {};
+    }
+
+    EglDisplay *display = backend->eglDisplayObject();
+    std::vector<ScreenCastRenderTarget> ret;
+    for (int i = 0; i < yuvPlanes.size(); ++i) {
+        const QSize size = yuvPlanes[i].size(QSize(attributes.width, attributes.height));
+        EGLImageKHR image = display->importDmaBufAsImage(attributes, i, yuvPlanes[i].drmFormat, size);
+        auto texture = EGLImageTexture::create(display, image, yuvPlanes[i].internalFormat, size, false);
+        if (!texture) {
+            return {};
+        }
+        auto framebuffer = std::make_unique<GLFramebuffer>(texture.get());
+        if (!framebuffer->valid()) {
+            return {};
+        }
+        ret.push_back(ScreenCastRenderTarget{
+            .texture = std::move(texture),
+            .framebuffer = std::move(framebuffer),
+        });
+    }
+    return ret;
+}
+
 DmaBufScreenCastBuffer *DmaBufScreenCastBuffer::create(pw_buffer *pwBuffer, const GraphicsBufferOptions &options)
 {
     EglBackend *backend = dynamic_cast<EglBackend *>(Compositor::self()->backend());
@@ -62,14 +110,8 @@ DmaBufScreenCastBuffer *DmaBufScreenCastBuffer::create(pw_buffer *pwBuffer, cons
         return nullptr;
     }
 
-    auto texture = backend->importDmaBufAsTexture(*attrs);
-    if (!texture) {
-        buffer->drop();
-        return nullptr;
-    }
-
-    auto framebuffer = std::make_unique<GLFramebuffer>(texture.get());
-    if (!framebuffer->valid()) {
+    auto planes = importRenderTargets(backend, *attrs);
+    if (planes.empty()) {
         buffer->drop();
         return nullptr;
     }
@@ -111,13 +153,19 @@ DmaBufScreenCastBuffer *DmaBufScreenCastBuffer::create(pw_buffer *pwBuffer, cons
         releaseData.fd = syncobjfd.get();
     }
 
-    return new DmaBufScreenCastBuffer(buffer, std::move(texture), std::move(framebuffer), std::move(synctimeline));
+    return new DmaBufScreenCastBuffer(buffer, std::move(planes), std::move(synctimeline));
 }
 
-MemFdScreenCastBuffer::MemFdScreenCastBuffer(GraphicsBuffer *buffer, GraphicsBufferView &&view)
+MemFdScreenCastBuffer::MemFdScreenCastBuffer(GraphicsBuffer *buffer, uint8_t *data, QList<ShmPlaneLayout> &&planes)
     : ScreenCastBuffer(buffer)
-    , view(std::move(view))
+    , data(data)
+    , planes(std::move(planes))
+{
+}
+
+MemFdScreenCastBuffer::~MemFdScreenCastBuffer()
 {
+    m_buffer->unmap();
 }
 
 MemFdScreenCastBuffer *MemFdScreenCastBuffer::create(pw_buffer *pwBuffer, const GraphicsBufferOptions &options)
@@ -127,19 +175,21 @@ MemFdScreenCastBuffer *MemFdScreenCastBuffer::create(pw_buffer *pwBuffer, const
         return nullptr;
     }
 
-    GraphicsBufferView view(buffer, GraphicsBuffer::Read | GraphicsBuffer::Write);
-    if (view.isNull()) {
+    const auto map = buffer->map(GraphicsBuffer::Read | GraphicsBuffer::Write);
+    if (!map.data) {
         buffer->drop();
         return nullptr;
     }
 
     const ShmAttributes *attributes = buffer->shmAttributes();
+    QList<ShmPlaneLayout> planes = ShmGraphicsBufferAllocator::planeLayout(attributes->format, attributes->size);
+    const ShmPlaneLayout &lastPlane = planes.last();
 
     struct spa_data *spaData = pwBuffer->buffer->datas;
     spaData->type = SPA_DATA_MemFd;
     spaData->flags = SPA_DATA_FLAG_READWRITE;
     spaData->mapoffset = 0;
-    spaData->maxsize = attributes->stride * attributes->size.height();
+    spaData->maxsize = lastPlane.offset + lastPlane.stride * lastPlane.size.height();
     spaData->fd = attributes->fd.get();
     spaData->data = nullptr;
     spaData->chunk->offset = 0;
@@ -147,7 +197,7 @@ MemFdScreenCastBuffer *MemFdScreenCastBuffer::create(pw_buffer *pwBuffer, const
     spaData->chunk->stride = attributes->stride;
     spaData->chunk->flags = SPA_CHUNK_FLAG_NONE;
 
-    return new MemFdScreenCastBuffer(buffer, std::move(view));
+    return new MemFdScreenCastBuffer(buffer, static_cast<uint8_t *>(map.data), std::move(planes));
 }
 
 } // namespace KWin
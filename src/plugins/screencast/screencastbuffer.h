@@ -6,7 +6,7 @@
 
 #pragma once
 
-#include "core/graphicsbufferview.h"
+#include "core/shmgraphicsbufferallocator.h"
 #include "core/syncobjtimeline.h"
 
 #include <pipewire/pipewire.h>
@@ -14,11 +14,19 @@
 namespace KWin
 {
 
+class EglBackend;
 class GLFramebuffer;
 class GLTexture;
 class GraphicsBuffer;
+struct DmaBufAttributes;
 struct GraphicsBufferOptions;
 
+struct ScreenCastRenderTarget
+{
+    std::shared_ptr<GLTexture> texture;
+    std::unique_ptr<GLFramebuffer> framebuffer;
+};
+
 class ScreenCastBuffer
 {
 public:
@@ -27,7 +35,7 @@ public:
 
     int m_age = 0;
 
-private:
+protected:
     GraphicsBuffer *m_buffer;
 };
 
@@ -36,23 +44,31 @@ class DmaBufScreenCastBuffer : public ScreenCastBuffer
 public:
     static DmaBufScreenCastBuffer *create(pw_buffer *pwBuffer, const GraphicsBufferOptions &options);
 
-    std::shared_ptr<GLTexture> texture;
-    std::unique_ptr<GLFramebuffer> framebuffer;
+    /**
+     * Imports the dmabuf as render targets. YUV buffers are imported plane by plane, other
+     * buffers as a single render target. Returns an empty list on failure.
+     */
+    static std::vector<ScreenCastRenderTarget> importRenderTargets(EglBackend *backend, const DmaBufAttributes &attributes);
+
+    std::vector<ScreenCastRenderTarget> planes;
     std::unique_ptr<SyncTimeline> synctimeline;
 
 private:
-    DmaBufScreenCastBuffer(GraphicsBuffer *buffer, std::shared_ptr<GLTexture> &&texture, std::unique_ptr<GLFramebuffer> &&framebuffer, std::unique_ptr<SyncTimeline> &&synctimeline);
+    DmaBufScreenCastBuffer(GraphicsBuffer *buffer, std::vector<ScreenCastRenderTarget> &&planes, std::unique_ptr<SyncTimeline> &&synctimeline);
 };
 
 class MemFdScreenCastBuffer : public ScreenCastBuffer
 {
 public:
+    ~MemFdScreenCastBuffer() override;
+
     static MemFdScreenCastBuffer *create(pw_buffer *pwBuffer, const GraphicsBufferOptions &options);
 
-    GraphicsBufferView view;
+    uint8_t *data;
+    QList<ShmPlaneLayout> planes;
 
 private:
-    MemFdScreenCastBuffer(GraphicsBuffer *buffer, GraphicsBufferView &&view);
+    MemFdScreenCastBuffer(GraphicsBuffer *buffer, uint8_t *data, QList<ShmPlaneLayout> &&planes);
 };
 
 } // namespace KWin
@@ -12,6 +12,7 @@
 #include "core/output.h"
 #include "core/outputbackend.h"
 #include "core/renderbackend.h"
+#include "outputscreencastrenderer.h"
 #include "outputscreencastsource.h"
 #include "pipewirecore.h"
 #include "regionscreencastsource.h"
@@ -110,7 +111,7 @@ void ScreencastManager::streamOutput(ScreencastStreamV1Interface *waylandStream,
         return;
     }
 
-    auto stream = new ScreenCastStream(new OutputScreenCastSource(streamOutput, waylandStream->connection()->processId()), getPipewireConnection(), this);
+    auto stream = new ScreenCastStream(new OutputScreenCastSource(this, streamOutput, waylandStream->connection()->processId()), getPipewireConnection(), this);
     stream->setObjectName(streamOutput->name());
     stream->setCursorMode(mode);
 
@@ -177,6 +178,36 @@ void ScreencastManager::integrateStreams(ScreencastStreamV1Interface *waylandStr
     }
 }
 
+std::shared_ptr<OutputScreenCastRenderer> ScreencastManager::outputRenderer(LogicalOutput *output, std::optional<pid_t> pidToHide, bool renderCursor)
+{
+    for (auto it = m_outputRenderers.begin(); it != m_outputRenderers.end();) {
+        std::shared_ptr<OutputScreenCastRenderer> renderer = it->lock();
+        if (!renderer) {
+            it = m_outputRenderers.erase(it);
+            continue;
+        }
+        if (renderer->output() == output && renderer->pidToHide() == pidToHide && renderer->renderCursor() == renderCursor) {
+            return renderer;
+        }
+        ++it;
+    }
+
+    auto renderer = std::make_shared<OutputScreenCastRenderer>(output, pidToHide, renderCursor);
+    m_outputRenderers.append(renderer);
+    return renderer;
+}
+
+quint64 ScreencastManager::debugOutputPaintCount(const QString &outputName) const
+{
+    quint64 count = 0;
+    for (const std::weak_ptr<OutputScreenCastRenderer> &weakRenderer : m_outputRenderers) {
+        if (const auto renderer = weakRenderer.lock(); renderer && renderer->output() && renderer->output()->name() == outputName) {
+            count += renderer->paintCount();
+        }
+    }
+    return count;
+}
+
 std::shared_ptr<PipeWireCore> ScreencastManager::getPipewireConnection()
 {
     if (m_pipewireConnectionCache && m_pipewireConnectionCache->isValid()) {
@@ -12,10 +12,14 @@
 
 #include "wayland/screencast_v1.h"
 
+#include <memory>
+#include <optional>
+
 namespace KWin
 {
 
 class LogicalOutput;
+class OutputScreenCastRenderer;
 class ScreenCastStream;
 class PipeWireCore;
 
@@ -26,6 +30,19 @@ class ScreencastManager : public Plugin
 public:
     explicit ScreencastManager();
 
+    /**
+     * Returns the renderer for streams of the given @p output with the given filter
+     * configuration. Streams that share the configuration share the renderer, so the output
+     * is rendered only once per frame no matter how many streams there are.
+     */
+    std::shared_ptr<OutputScreenCastRenderer> outputRenderer(LogicalOutput *output, std::optional<pid_t> pidToHide, bool renderCursor);
+
+    /**
+     * Returns how many times the output with the given @p outputName has been painted by the
+     * renderers that are alive. It's meant for tests, which can't link to the plugin.
+     */
+    Q_INVOKABLE quint64 debugOutputPaintCount(const QString &outputName) const;
+
 private:
     void streamWindow(ScreencastStreamV1Interface *stream,
                       const QString &winid,
@@ -52,6 +69,7 @@ private:
 
     ScreencastV1Interface *m_screencast;
     std::shared_ptr<PipeWireCore> m_pipewireConnectionCache;
+    QList<std::weak_ptr<OutputScreenCastRenderer>> m_outputRenderers;
 };
 
 } // namespace KWin
@@ -0,0 +1,237 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "screencastreadback.h"
+#include "kwinscreencast_logging.h"
+#include "opengl/eglcontext.h"
+#include "opengl/egldisplay.h"
+#include "opengl/glframebuffer.h"
+
+namespace KWin
+{
+
+static size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static int bytesPerPixel(GLenum format)
+{
+    switch (format) {
+    case GL_RED:
+        return 1;
+    case GL_RG:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+ScreenCastReadback::ScreenCastReadback(EglContext *context)
+    : m_context(context)
+{
+}
+
+ScreenCastReadback::~ScreenCastReadback()
+{
+    if (!m_context->makeCurrent()) {
+        qCWarning(KWIN_SCREENCAST) << "Could not delete screencast pixel buffers because the context could not be made current";
+        return;
+    }
+    for (Pending &pending : m_pending) {
+        glDeleteBuffers(1, &pending.pixelBuffer.buffer);
+    }
+    for (const PixelBuffer &pixelBuffer : std::as_const(m_freePixelBuffers)) {
+        glDeleteBuffers(1, &pixelBuffer.buffer);
+    }
+}
+
+void ScreenCastReadback::read(const void *target, const QList<Plane> &planes, std::function<void()> &&done)
+{
+    Pending pending{
+        .target = target,
+        .done = std::move(done),
+    };
+
+    // The rects are packed tightly, one after another.
+    for (const Plane &plane : planes) {
+        const int bpp = bytesPerPixel(plane.format);
+        const Region region = plane.region & Rect(QPoint(), plane.source->size());
+        for (const Rect &rect : region.rects()) {
+            pending.copies.append(Copy{
+                .destination = plane.data + rect.y() * plane.stride + rect.x() * bpp,
+                .stride = plane.stride,
+                .rowSize = size_t(rect.width()) * bpp,
+                .rowCount = rect.height(),
+                .offset = pending.size,
+            });
+            pending.size = alignUp(pending.size + size_t(rect.width()) * rect.height() * bpp, 16);
+        }
+    }
+
+    if (pending.copies.isEmpty()) {
+        if (m_pending.empty()) {
+            pending.done();
+        } else {
+            // Nothing to read, but the buffer must not overtake the ones that are still pending.
+            m_pending.push_back(std::move(pending));
+        }
+        return;
+    }
+
+    // Pixel pack buffers need GL 3.0 or GLES 3.0 with glMapBufferRange(). Without a native fence,
+    // they're still used but mapped right away, which waits for the rendering to finish.
+    if (!m_context->hasVersion(Version(3, 0)) || !m_context->hasMapBufferRange()) {
+        for (const Plane &plane : planes) {
+            readSynchronously(plane);
+        }
+        pending.done();
+        return;
+    }
+
+    pending.pixelBuffer = acquirePixelBuffer(pending.size);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pending.pixelBuffer.buffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    qsizetype copyIndex = 0;
+    for (const Plane &plane : planes) {
+        GLFramebuffer::pushFramebuffer(plane.source);
+        const Region region = plane.region & Rect(QPoint(), plane.source->size());
+        for (const Rect &rect : region.rects()) {
+            const Copy &copy = pending.copies[copyIndex++];
+            glReadPixels(rect.x(), rect.y(), rect.width(), rect.height(), plane.format, GL_UNSIGNED_BYTE, reinterpret_cast<GLvoid *>(copy.offset));
+        }
+        GLFramebuffer::popFramebuffer();
+    }
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    auto fence = std::make_unique<EGLNativeFence>(m_context->displayObject());
+    if (fence->isValid() && fence->fileDescriptor().isValid()) {
+        pending.notifier = std::make_unique<QSocketNotifier>(fence->fileDescriptor().get(), QSocketNotifier::Read);
+        connect(pending.notifier.get(), &QSocketNotifier::activated, this, &ScreenCastReadback::processPending);
+        pending.fence = std::move(fence);
+        m_pending.push_back(std::move(pending));
+        return;
+    }
+
+    // The pixel buffers are mapped in order, so the previous readbacks have to complete first.
+    m_pending.push_back(std::move(pending));
+    while (!m_pending.empty()) {
+        Pending front = std::move(m_pending.front());
+        m_pending.pop_front();
+        finish(front);
+    }
+}
+
+void ScreenCastReadback::cancel(const void *target)
+{
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        if (it->target == target) {
+            if (it->pixelBuffer.buffer) {
+                releasePixelBuffer(it->pixelBuffer);
+            }
+            it = m_pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ScreenCastReadback::readSynchronously(const Plane &plane)
+{
+    const QSize size = plane.source->size();
+    const int bpp = bytesPerPixel(plane.format);
+    // Padded planes are only used with YUV formats, which need GL 3.0 anyway.
+    Q_ASSERT(plane.stride == size.width() * bpp || m_context->hasVersion(Version(3, 0)));
+
+    GLFramebuffer::pushFramebuffer(plane.source);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    if (plane.stride != size.width() * bpp) {
+        glPixelStorei(GL_PACK_ROW_LENGTH, plane.stride / bpp);
+    }
+    m_context->glReadnPixels(0, 0, size.width(), size.height(), plane.format, GL_UNSIGNED_BYTE, plane.stride * size.height(), plane.data);
+    if (plane.stride != size.width() * bpp) {
+        glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+    }
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    GLFramebuffer::popFramebuffer();
+}
+
+ScreenCastReadback::PixelBuffer ScreenCastReadback::acquirePixelBuffer(size_t size)
+{
+    for (qsizetype i = 0; i < m_freePixelBuffers.size(); ++i) {
+        if (m_freePixelBuffers[i].size >= size) {
+            return m_freePixelBuffers.takeAt(i);
+        }
+    }
+
+    // Only a few readbacks are in flight at a time, drop the buffers that have become too small.
+    for (const PixelBuffer &pixelBuffer : std::as_const(m_freePixelBuffers)) {
+        glDeleteBuffers(1, &pixelBuffer.buffer);
+    }
+    m_freePixelBuffers.clear();
+
+    // Round the size up to 1 MiB so that slightly growing damage doesn't reallocate every frame
+    PixelBuffer pixelBuffer{
+        .size = alignUp(size, 1024 * 1024),
+    };
+    glGenBuffers(1, &pixelBuffer.buffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer.buffer);
+    glBufferData(GL_PIXEL_PACK_BUFFER, pixelBuffer.size, nullptr, GL_STREAM_READ);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return pixelBuffer;
+}
+
+void ScreenCastReadback::releasePixelBuffer(const PixelBuffer &pixelBuffer)
+{
+    m_freePixelBuffers.append(pixelBuffer);
+}
+
+void ScreenCastReadback::processPending()
+{
+    while (!m_pending.empty()) {
+        Pending &front = m_pending.front();
+        if (front.fence && !front.fence->fileDescriptor().isReadable()) {
+            break;
+        }
+        Pending pending = std::move(front);
+        m_pending.pop_front();
+        finish(pending);
+    }
+}
+
+void ScreenCastReadback::finish(Pending &pending)
+{
+    pending.notifier.reset();
+    pending.fence.reset();
+
+    if (pending.pixelBuffer.buffer) {
+        if (!m_context->makeCurrent()) {
+            qCWarning(KWIN_SCREENCAST) << "Failed to make the context current, the recording may be corrupted";
+        } else {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, pending.pixelBuffer.buffer);
+            const auto map = static_cast<const uint8_t *>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, pending.size, GL_MAP_READ_BIT));
+            if (map) {
+                for (const Copy &copy : std::as_const(pending.copies)) {
+                    const uint8_t *source = map + copy.offset;
+                    for (int y = 0; y < copy.rowCount; ++y) {
+                        memcpy(copy.destination + y * copy.stride, source + y * copy.rowSize, copy.rowSize);
+                    }
+                }
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            } else {
+                qCWarning(KWIN_SCREENCAST) << "Failed to map a screencast pixel buffer, the recording may be corrupted";
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        }
+        releasePixelBuffer(pending.pixelBuffer);
+    }
+
+    pending.done();
+}
+
+} // namespace KWin
@@ -0,0 +1,105 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "core/region.h"
+#include "opengl/eglnativefence.h"
+
+#include <QObject>
+#include <QSocketNotifier>
+
+#include <deque>
+#include <epoxy/gl.h>
+#include <functional>
+#include <memory>
+
+namespace KWin
+{
+
+class EglContext;
+class GLFramebuffer;
+
+/**
+ * The ScreenCastReadback class copies rendered frames into memfd buffers.
+ *
+ * Only the requested rects are read. If the driver supports native fences, they are read into
+ * pixel pack buffers and copied into the target memory once the GPU is done, so the compositor
+ * doesn't have to wait for the rendering of the frame to finish. Readbacks complete in the
+ * order they were started.
+ */
+class ScreenCastReadback : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Plane
+    {
+        GLFramebuffer *source = nullptr;
+        uint8_t *data = nullptr;
+        qsizetype stride = 0;
+        /**
+         * GL_BGRA, GL_RG or GL_RED, with one byte per channel.
+         */
+        GLenum format = GL_BGRA;
+        Region region;
+    };
+
+    explicit ScreenCastReadback(EglContext *context);
+    ~ScreenCastReadback() override;
+
+    /**
+     * Reads the regions of the @p planes into the target memory and calls @p done once the
+     * pixels are there. @p done may be called before this function returns. The @p target
+     * identifies the buffer the planes belong to.
+     */
+    void read(const void *target, const QList<Plane> &planes, std::function<void()> &&done);
+
+    /**
+     * Drops all readbacks into @p target without calling their callbacks, e.g. because the
+     * target buffer is about to be destroyed.
+     */
+    void cancel(const void *target);
+
+private:
+    struct PixelBuffer
+    {
+        GLuint buffer = 0;
+        size_t size = 0;
+    };
+
+    struct Copy
+    {
+        uint8_t *destination;
+        qsizetype stride;
+        size_t rowSize;
+        int rowCount;
+        size_t offset;
+    };
+
+    struct Pending
+    {
+        const void *target = nullptr;
+        QList<Copy> copies;
+        size_t size = 0;
+        PixelBuffer pixelBuffer;
+        std::unique_ptr<EGLNativeFence> fence;
+        std::unique_ptr<QSocketNotifier> notifier;
+        std::function<void()> done;
+    };
+
+    void readSynchronously(const Plane &plane);
+    PixelBuffer acquirePixelBuffer(size_t size);
+    void releasePixelBuffer(const PixelBuffer &pixelBuffer);
+    void processPending();
+    void finish(Pending &pending);
+
+    EglContext *const m_context;
+    std::deque<Pending> m_pending;
+    QList<PixelBuffer> m_freePixelBuffers;
+};
+
+} // namespace KWin
@@ -5,6 +5,7 @@
 */
 
 #include "screencastsource.h"
+#include "core/region.h"
 
 namespace KWin
 {
@@ -23,6 +24,17 @@ void ScreenCastSource::resize(const QSize &)
     Q_ASSERT(false);
 }
 
+Region ScreenCastSource::pendingDamage() const
+{
+    return Region{};
+}
+
+qreal ScreenCastSource::scaleForSize(const QSize &size) const
+{
+    const QSize contentsSize = textureSize();
+    return std::min({1.0, qreal(size.width()) / contentsSize.width(), qreal(size.height()) / contentsSize.height()});
+}
+
 } // namespace KWin
 
 #include "moc_screencastsource.cpp"
@@ -8,8 +8,6 @@
 
 #include <QObject>
 
-class QImage;
-
 namespace KWin
 {
 
@@ -32,8 +30,17 @@ public:
     virtual qreal devicePixelRatio() const = 0;
 
     virtual void setRenderCursor(bool enable) = 0;
+    /**
+     * Renders the contents into the @p target and returns the damaged parts of it. If the
+     * target is smaller than textureSize(), the contents are scaled down to fit into it.
+     */
     virtual Region render(GLFramebuffer *target, const Region &bufferRepair) = 0;
-    virtual Region render(QImage *target, const Region &bufferRepair) = 0;
+    /**
+     * Returns the parts of the contents that have been damaged since they were last rendered,
+     * in the coordinate space of textureSize(). If the source can't tell the damage before it
+     * renders the contents, an empty region is returned.
+     */
+    virtual Region pendingDamage() const;
 
     virtual void resume() = 0;
     virtual void pause() = 0;
@@ -45,6 +52,12 @@ public:
     virtual bool followsStreamSize();
     virtual void resize(const QSize &size);
 
+    /**
+     * Returns the factor by which the contents are scaled down when they are rendered into a
+     * buffer of the given @p size. The contents are never scaled up.
+     */
+    qreal scaleForSize(const QSize &size) const;
+
 Q_SIGNALS:
     void frame();
     void closed();
@@ -17,6 +17,7 @@
 #include "kwinscreencast_logging.h"
 #include "main.h"
 #include "opengl/eglbackend.h"
+#include "opengl/egldisplay.h"
 #include "opengl/eglnativefence.h"
 #include "opengl/glframebuffer.h"
 #include "opengl/glplatform.h"
@@ -24,7 +25,9 @@
 #include "pipewirecore.h"
 #include "scene/workspacescene.h"
 #include "screencastbuffer.h"
+#include "screencastreadback.h"
 #include "screencastsource.h"
+#include "screencastyuvconverter.h"
 
 #include <KLocalizedString>
 
@@ -80,6 +83,10 @@ static const struct
         .drmFormat = DRM_FORMAT_NV12,
         .spaFormat = SPA_VIDEO_FORMAT_NV12,
     },
+    {
+        .drmFormat = DRM_FORMAT_YUV420,
+        .spaFormat = SPA_VIDEO_FORMAT_I420,
+    },
     {
         .drmFormat = DRM_FORMAT_RGB888,
         .spaFormat = SPA_VIDEO_FORMAT_BGR,
@@ -132,10 +139,15 @@ void ScreenCastStream::onStreamStateChanged(pw_stream_state old, pw_stream_state
         }
         m_pendingFrame.stop();
         m_pendingContents = Contents();
+        m_keepAliveTimer.stop();
+        m_keepAliveDue = false;
         m_source->pause();
+        qCDebug(KWIN_SCREENCAST) << objectName() << "produced" << m_statistics.producedFrames << "frames, skipped" << m_statistics.skippedFrames
+                                 << "unchanged frames, coalesced" << m_statistics.coalescedRequests << "requests, sent" << m_statistics.keepAliveFrames << "keep-alive frames";
         break;
     case PW_STREAM_STATE_STREAMING:
         m_nextDue.reset();
+        m_coalesceUntil.reset();
         m_source->resume();
         break;
     case PW_STREAM_STATE_CONNECTING:
@@ -150,12 +162,29 @@ void ScreenCastStream::onStreamStateChanged(pw_stream_state old, pw_stream_state
 #define CURSOR_META_SIZE(w, h) (sizeof(struct spa_meta_cursor) + sizeof(struct spa_meta_bitmap) + w * h * CURSOR_BPP)
 static const int videoDamageRegionCount = 16;
 
+// Damage that covers at least this part of the frame is considered motion, e.g. scrolling or video
+static constexpr qreal s_motionDamageRatio = 0.02;
+// Small changes, e.g. a blinking text cursor or a ticking clock, are sent at most this often
+static constexpr std::chrono::milliseconds s_coalesceInterval(100);
+// Frames are sent at least this often, even if nothing changes, so consumers know the stream is alive
+static constexpr std::chrono::seconds s_keepAliveInterval(1);
+
 void ScreenCastStream::newStreamParams()
 {
     qCDebug(KWIN_SCREENCAST) << objectName() << "announcing stream params. with dmabuf:" << m_dmabufParams.has_value();
     const int buffertypes = m_dmabufParams ? (1 << SPA_DATA_DmaBuf) : (1 << SPA_DATA_MemFd);
     const int bpp = m_videoFormat.format == SPA_VIDEO_FORMAT_RGB || m_videoFormat.format == SPA_VIDEO_FORMAT_BGR ? 3 : 4;
-    const int stride = SPA_ROUND_UP_N(m_resolution.width() * bpp, 4);
+    int stride = SPA_ROUND_UP_N(m_resolution.width() * bpp, 4);
+    int size = stride * m_resolution.height();
+
+    // The planes of YUV formats are packed in a single memfd block
+    const QList<ShmPlaneLayout> yuvLayout = ScreenCastYuvConverter::planes(spaVideoFormatToDrmFormat(m_videoFormat.format)).isEmpty()
+        ? QList<ShmPlaneLayout>()
+        : ShmGraphicsBufferAllocator::planeLayout(spaVideoFormatToDrmFormat(m_videoFormat.format), m_resolution);
+    if (!yuvLayout.isEmpty()) {
+        stride = yuvLayout.first().stride;
+        size = yuvLayout.last().offset + yuvLayout.last().stride * yuvLayout.last().size.height();
+    }
 
     struct spa_pod_dynamic_builder pod_builder;
     struct spa_pod_frame f;
@@ -187,7 +216,7 @@ void ScreenCastStream::newStreamParams()
     if (!m_dmabufParams) {
         spa_pod_builder_add(&pod_builder.b,
                             SPA_PARAM_BUFFERS_blocks, SPA_POD_Int(1),
-                            SPA_PARAM_BUFFERS_size, SPA_POD_Int(stride * m_resolution.height()),
+                            SPA_PARAM_BUFFERS_size, SPA_POD_Int(size),
                             SPA_PARAM_BUFFERS_stride, SPA_POD_Int(stride),
                             SPA_PARAM_BUFFERS_align, SPA_POD_Int(16), 0);
     } else {
@@ -239,6 +268,8 @@ void ScreenCastStream::onStreamParamChanged(uint32_t id, const struct spa_pod *f
 
     qCDebug(KWIN_SCREENCAST) << objectName() << "negotiated stream size to" << negotiatedSize;
     m_resolution = negotiatedSize;
+    // The cursor bitmap is scaled along with the stream
+    m_cursor.invalid = true;
 
     if (m_source && m_source->followsStreamSize()) {
         m_source->resize(negotiatedSize);
@@ -256,25 +287,29 @@ void ScreenCastStream::onStreamParamChanged(uint32_t id, const struct spa_pod *f
             receivedModifiers.insert(values[i]);
         }
 
-        if (!m_dmabufParams || m_dmabufParams->width != m_resolution.width() || m_dmabufParams->height != m_resolution.height() || !receivedModifiers.contains(m_dmabufParams->modifier)) {
+        const bool yuv = !ScreenCastYuvConverter::planes(spaVideoFormatToDrmFormat(m_videoFormat.format)).isEmpty();
+        const uint32_t drmFormat = yuv ? DRM_FORMAT_NV12 : m_drmFormat;
+        ModifierList &modifiers = yuv ? m_yuvModifiers : m_modifiers;
+
+        if (!m_dmabufParams || m_dmabufParams->format != drmFormat || m_dmabufParams->width != m_resolution.width() || m_dmabufParams->height != m_resolution.height() || !receivedModifiers.contains(m_dmabufParams->modifier)) {
             // DRM_MOD_INVALID should be used as a last option. Do not just remove it it's the only
             // item on the list
             if (receivedModifiers.size() > 1) {
                 receivedModifiers.erase(DRM_FORMAT_MOD_INVALID);
             }
-            m_dmabufParams = testCreateDmaBuf(m_resolution, m_drmFormat, receivedModifiers);
+            m_dmabufParams = testCreateDmaBuf(m_resolution, drmFormat, receivedModifiers);
 
             // In case we fail to use any modifier from the list of offered ones, remove these
             // from our all future offerings, otherwise there will be no indication that it cannot
             // be used and clients can go for it over and over
             if (!m_dmabufParams.has_value()) {
                 for (uint64_t modifier : receivedModifiers) {
-                    m_modifiers.erase(modifier);
+                    modifiers.erase(modifier);
                 }
             }
 
             qCDebug(KWIN_SCREENCAST) << objectName() << "Stream dmabuf modifiers received, offering our best suited modifier" << m_dmabufParams.has_value();
-            char buffer[2048];
+            char buffer[4096];
             auto params = buildFormats(m_dmabufParams.has_value(), buffer);
             pw_stream_update_params(m_pwStream, params.data(), params.count());
             return;
@@ -324,6 +359,9 @@ void ScreenCastStream::onStreamAddBuffer(pw_buffer *pwBuffer)
 void ScreenCastStream::onStreamRemoveBuffer(pw_buffer *pwBuffer)
 {
     if (ScreenCastBuffer *buffer = static_cast<ScreenCastBuffer *>(pwBuffer->user_data)) {
+        if (m_readback) {
+            m_readback->cancel(buffer);
+        }
         delete buffer;
         pwBuffer->user_data = nullptr;
         m_allBuffers.removeOne(buffer);
@@ -337,6 +375,7 @@ ScreenCastStream::ScreenCastStream(ScreenCastSource *source, std::shared_ptr<Pip
     , m_pwCore(pwCore)
     , m_source(source)
     , m_resolution(source->textureSize())
+    , m_sourceSize(source->textureSize())
 {
     connect(source, &ScreenCastSource::frame, this, [this]() {
         scheduleRecord(Content::Video);
@@ -366,6 +405,13 @@ ScreenCastStream::ScreenCastStream(ScreenCastSource *source, std::shared_ptr<Pip
         record(m_pendingContents);
         m_pendingContents = Contents();
     });
+
+    m_keepAliveTimer.setSingleShot(true);
+    m_keepAliveTimer.setInterval(s_keepAliveInterval);
+    connect(&m_keepAliveTimer, &QTimer::timeout, this, [this] {
+        m_keepAliveDue = true;
+        scheduleRecord(Content::Video);
+    });
 }
 
 ScreenCastStream::~ScreenCastStream()
@@ -375,6 +421,15 @@ ScreenCastStream::~ScreenCastStream()
     if (m_pwStream) {
         pw_stream_destroy(m_pwStream);
     }
+
+    if (m_offscreenTarget.texture || m_supersampleTarget.texture || m_yuvConverter) {
+        if (EglBackend *backend = qobject_cast<EglBackend *>(Compositor::self()->backend()); backend && backend->openglContext()->makeCurrent()) {
+            m_offscreenTarget = {};
+            m_supersampleTarget = {};
+            m_offscreenPlanes.clear();
+            m_yuvConverter.reset();
+        }
+    }
 }
 
 bool ScreenCastStream::init()
@@ -453,7 +508,19 @@ bool ScreenCastStream::createStream()
     }
     m_hasDmaBuf = testCreateDmaBuf(m_resolution, m_drmFormat, m_modifiers).has_value();
 
-    char buffer[2048];
+    // The conversion to YUV renders into R8 and RG8 textures, which need GL 3.0 or GLES 3.0.
+    // NV12 is usually external only for sampling, but the planes can still be rendered to.
+    EglBackend *backend = static_cast<EglBackend *>(Compositor::self()->backend());
+    m_hasYuv = backend->openglContext()->hasVersion(Version(3, 0));
+    if (m_hasYuv) {
+        const auto &allFormats = backend->eglDisplayObject()->allSupportedDrmFormats();
+        if (auto it = allFormats.constFind(DRM_FORMAT_NV12); it != allFormats.constEnd()) {
+            m_yuvModifiers = *it;
+            m_hasYuvDmaBuf = testCreateDmaBuf(m_resolution, DRM_FORMAT_NV12, m_yuvModifiers).has_value();
+        }
+    }
+
+    char buffer[4096];
     QList<const spa_pod *> params = buildFormats(false, buffer);
 
     pw_stream_add_listener(m_pwStream, &m_streamListener, &m_pwStreamEvents, this);
@@ -495,6 +562,7 @@ void ScreenCastStream::close()
 
     m_closed = true;
     m_pendingFrame.stop();
+    m_keepAliveTimer.stop();
 
     disconnect(m_cursor.changedConnection);
     m_cursor.changedConnection = {};
@@ -527,19 +595,48 @@ void ScreenCastStream::scheduleRecord(Contents contents)
 
     m_pendingContents |= contents;
 
-    if (m_pendingFrame.isActive()) {
-        return;
+    // Motion that starts while small changes are being coalesced is not held back until the end
+    // of the coalescing interval, the pending frame is rescheduled at the max frame rate instead
+    if ((contents & Content::Video) && m_coalesceUntil.has_value() && isMotion(m_source->pendingDamage(), m_source->textureSize())) {
+        m_coalesceUntil.reset();
+    } else if (m_pendingFrame.isActive()) {
+        ++m_statistics.coalescedRequests;
+        // Cursor updates are not held back by coalescing, only by the max frame rate
+        if (!(contents & Content::Cursor) || !m_coalesceUntil.has_value()) {
+            return;
+        }
+    }
+
+    std::optional<std::chrono::steady_clock::time_point> due;
+    if (frameInterval() != std::chrono::nanoseconds::zero()) {
+        due = m_nextDue;
+    }
+    if (!(m_pendingContents & Content::Cursor) && m_coalesceUntil.has_value()) {
+        due = due.has_value() ? std::max(*due, *m_coalesceUntil) : m_coalesceUntil;
     }
+
     std::chrono::milliseconds waitInterval{0};
-    if (frameInterval() != std::chrono::nanoseconds::zero() && m_nextDue.has_value()) {
+    if (due.has_value()) {
         const auto now = std::chrono::steady_clock::now();
-        if (m_nextDue.value() > now) {
-            waitInterval = std::chrono::ceil<std::chrono::milliseconds>(m_nextDue.value() - now);
+        if (due.value() > now) {
+            waitInterval = std::chrono::ceil<std::chrono::milliseconds>(due.value() - now);
         }
     }
     m_pendingFrame.start(waitInterval);
 }
 
+bool ScreenCastStream::isMotion(const Region &damage, const QSize &size)
+{
+    if (damage.isEmpty()) {
+        return false;
+    }
+    qint64 damagedArea = 0;
+    for (const Rect &rect : damage.rects()) {
+        damagedArea += qint64(rect.width()) * rect.height();
+    }
+    return damagedArea >= qint64(size.width()) * size.height() * s_motionDamageRatio;
+}
+
 pw_buffer *ScreenCastStream::dequeueBuffer()
 {
     const auto isBufferUsable = [](pw_buffer *pwBuffer) {
@@ -638,11 +735,46 @@ void ScreenCastStream::record(Contents contents)
     // rendering, readback and buffer synchronization add latency.
     const auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
         std::chrono::steady_clock::now().time_since_epoch());
+    const uint32_t drmFormat = spaVideoFormatToDrmFormat(m_videoFormat.format);
+    const QList<ScreenCastYuvConverter::Plane> yuvPlanes = ScreenCastYuvConverter::planes(drmFormat);
+
     Region damage;
+    QList<ScreenCastReadback::Plane> readbackPlanes;
     if (effectiveContents & Content::Video) {
         if (auto memfd = dynamic_cast<MemFdScreenCastBuffer *>(buffer)) {
-            damage = m_source->render(memfd->view.image(), m_damageJournal.accumulate(memfd->m_age, Region::infinite()));
-            bumpBufferAge(memfd);
+            // The frame is rendered into a texture that is kept across frames, so only the damaged
+            // parts have to be repainted. Only the parts that have changed since the memfd buffer
+            // was last used are read back.
+            const QSize size = memfd->planes.first().size;
+            Region textureRepair;
+            if (ensureRenderTarget(m_offscreenTarget, size, &textureRepair)) {
+                damage = renderSource(m_offscreenTarget.framebuffer.get(), textureRepair);
+                const Region readbackRegion = (damage | textureRepair | m_damageJournal.accumulate(memfd->m_age, Region::infinite())) & Rect(QPoint(), size);
+                if (yuvPlanes.isEmpty()) {
+                    readbackPlanes.append(ScreenCastReadback::Plane{
+                        .source = m_offscreenTarget.framebuffer.get(),
+                        .data = memfd->data + memfd->planes[0].offset,
+                        .stride = memfd->planes[0].stride,
+                        .format = GL_BGRA,
+                        .region = readbackRegion,
+                    });
+                } else if (ensureOffscreenPlanes(drmFormat, size) && ensureYuvConverter()) {
+                    QList<GLFramebuffer *> framebuffers;
+                    for (const ScreenCastRenderTarget &plane : m_offscreenPlanes) {
+                        framebuffers.append(plane.framebuffer.get());
+                    }
+                    m_yuvConverter->convert(m_offscreenTarget.texture.get(), drmFormat, framebuffers);
+                    for (qsizetype i = 0; i < yuvPlanes.size(); ++i) {
+                        readbackPlanes.append(ScreenCastReadback::Plane{
+                            .source = framebuffers[i],
+                            .data = memfd->data + memfd->planes[i].offset,
+                            .stride = memfd->planes[i].stride,
+                            .format = yuvPlanes[i].readFormat,
+                            .region = readbackRegion.scaledAndRoundedOut(1.0 / yuvPlanes[i].subsampling),
+                        });
+                    }
+                }
+            }
         } else if (auto dmabuf = dynamic_cast<DmaBufScreenCastBuffer *>(buffer)) {
             if (dmabuf->synctimeline) {
                 synctmeta = static_cast<spa_meta_sync_timeline *>(spa_buffer_find_meta_data(spa_buffer,
@@ -655,9 +787,32 @@ void ScreenCastStream::record(Contents contents)
                 }
             }
 
-            damage = m_source->render(dmabuf->framebuffer.get(), m_damageJournal.accumulate(dmabuf->m_age, Region::infinite()));
-            bumpBufferAge(dmabuf);
+            if (yuvPlanes.isEmpty()) {
+                damage = renderSource(dmabuf->planes.front().framebuffer.get(), m_damageJournal.accumulate(dmabuf->m_age, Region::infinite()));
+            } else {
+                // The source renders RGB, the frame is converted into the planes of the buffer afterwards
+                Region textureRepair;
+                if (ensureRenderTarget(m_offscreenTarget, dmabuf->planes.front().texture->size(), &textureRepair) && ensureYuvConverter()) {
+                    damage = renderSource(m_offscreenTarget.framebuffer.get(), textureRepair);
+                    QList<GLFramebuffer *> framebuffers;
+                    for (const ScreenCastRenderTarget &plane : dmabuf->planes) {
+                        framebuffers.append(plane.framebuffer.get());
+                    }
+                    m_yuvConverter->convert(m_offscreenTarget.texture.get(), drmFormat, framebuffers);
+                }
+            }
+        }
+
+        if (damage.isEmpty() && !(contents & Content::Cursor) && !m_keepAliveDue) {
+            // Nothing has changed, so there's no need to send a frame. The buffer has not been read
+            // back or has only had its stale parts repainted, so it's given back with its age intact
+            // and will be repaired again the next time it's used.
+            ++m_statistics.skippedFrames;
+            pw_stream_return_buffer(m_pwStream, pwBuffer);
+            return;
         }
+
+        bumpBufferAge(buffer);
         m_damageJournal.add(damage);
     }
 
@@ -690,7 +845,25 @@ void ScreenCastStream::record(Contents contents)
         spa_data->chunk->flags = SPA_CHUNK_FLAG_CORRUPTED;
     }
 
-    pw_stream_queue_buffer(m_pwStream, pwBuffer);
+    if (auto memfd = dynamic_cast<MemFdScreenCastBuffer *>(buffer)) {
+        if (!m_readback) {
+            m_readback = std::make_unique<ScreenCastReadback>(context);
+        }
+        // The buffer is handed over to the consumer once its pixels have been read back. It goes
+        // through the readback even if there's nothing to read so it doesn't overtake earlier frames.
+        m_readback->read(memfd, readbackPlanes, [this, pwBuffer]() {
+            pw_stream_queue_buffer(m_pwStream, pwBuffer);
+        });
+    } else {
+        pw_stream_queue_buffer(m_pwStream, pwBuffer);
+    }
+
+    ++m_statistics.producedFrames;
+    if (m_keepAliveDue) {
+        ++m_statistics.keepAliveFrames;
+        m_keepAliveDue = false;
+    }
+    m_keepAliveTimer.start();
 
     const auto now = std::chrono::steady_clock::now();
     const auto interval = frameInterval();
@@ -700,11 +873,147 @@ void ScreenCastStream::record(Contents contents)
         m_nextDue.value() += interval;
     }
 
+    // Motion is streamed at the max frame rate, small changes are coalesced into one frame per
+    // coalescing interval. After a while without changes, the first change is sent right away.
+    if (effectiveContents & Content::Video) {
+        if (!damage.isEmpty() && !isMotion(damage, m_resolution)) {
+            m_coalesceUntil = now + s_coalesceInterval;
+        } else {
+            m_coalesceUntil.reset();
+        }
+    }
+
     if (!m_source->followsStreamSize()) {
         updateStreamSize(m_source->textureSize());
     }
 }
 
+bool ScreenCastStream::ensureRenderTarget(ScreenCastRenderTarget &target, const QSize &size, Region *repair)
+{
+    if (target.texture && target.texture->size() == size) {
+        return true;
+    }
+
+    target = {};
+    std::shared_ptr<GLTexture> texture = GLTexture::allocate(GL_RGBA8, size);
+    if (!texture) {
+        return false;
+    }
+    auto framebuffer = std::make_unique<GLFramebuffer>(texture.get());
+    if (!framebuffer->valid()) {
+        return false;
+    }
+
+    target = ScreenCastRenderTarget{
+        .texture = std::move(texture),
+        .framebuffer = std::move(framebuffer),
+    };
+    *repair = Region::infinite();
+    return true;
+}
+
+Region ScreenCastStream::renderSource(GLFramebuffer *target, const Region &targetRepair)
+{
+    const Region damage = renderScaledSource(target, targetRepair);
+    return damage | clearLetterbox(target, targetRepair);
+}
+
+Region ScreenCastStream::renderScaledSource(GLFramebuffer *target, const Region &targetRepair)
+{
+    // Streams that are much smaller than the source are rendered at twice their size and then
+    // scaled down by half, which averages every 2x2 block of pixels. Rendering them at their
+    // size right away would make thin lines and text shimmer.
+    const QSize sourceSize = m_source->textureSize();
+    const QSize targetSize = target->size();
+    if (sourceSize.width() < targetSize.width() * 2 || sourceSize.height() < targetSize.height() * 2) {
+        // The supersampled frame would go stale
+        m_supersampleTarget = {};
+        return m_source->render(target, targetRepair);
+    }
+
+    Region supersampleRepair;
+    if (!ensureRenderTarget(m_supersampleTarget, targetSize * 2, &supersampleRepair)) {
+        return m_source->render(target, targetRepair);
+    }
+
+    const Rect targetRect(QPoint(), targetSize);
+    const Region damage = m_source->render(m_supersampleTarget.framebuffer.get(), supersampleRepair).scaledAndRoundedOut(0.5) & targetRect;
+
+    GLFramebuffer::pushFramebuffer(m_supersampleTarget.framebuffer.get());
+    for (const Rect &rect : ((damage | targetRepair) & targetRect).rects()) {
+        target->blitFromFramebuffer(Rect(rect.x() * 2, rect.y() * 2, rect.width() * 2, rect.height() * 2), rect, GL_LINEAR);
+    }
+    GLFramebuffer::popFramebuffer();
+
+    return damage;
+}
+
+Region ScreenCastStream::clearLetterbox(GLFramebuffer *target, const Region &targetRepair)
+{
+    // The contents are scaled down with the aspect ratio of the source preserved, so the stream
+    // can have unused space on the right or at the bottom. It never changes, so it only needs to
+    // be cleared when the buffer is repaired.
+    const QSize targetSize = target->size();
+    const qreal scale = m_source->scaleForSize(targetSize);
+    const QSize sourceSize = m_source->textureSize();
+    const Rect contentsRect(0, 0, int(std::ceil(sourceSize.width() * scale)), int(std::ceil(sourceSize.height() * scale)));
+    const Region letterbox = (Region(Rect(QPoint(), targetSize)) - contentsRect) & targetRepair;
+    if (letterbox.isEmpty()) {
+        return Region{};
+    }
+
+    GLFramebuffer::pushFramebuffer(target);
+    glEnable(GL_SCISSOR_TEST);
+    glClearColor(0.0, 0.0, 0.0, 0.0);
+    for (const Rect &rect : letterbox.rects()) {
+        glScissor(rect.x(), targetSize.height() - (rect.y() + rect.height()), rect.width(), rect.height());
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+    glDisable(GL_SCISSOR_TEST);
+    GLFramebuffer::popFramebuffer();
+
+    return letterbox;
+}
+
+bool ScreenCastStream::ensureOffscreenPlanes(uint32_t drmFormat, const QSize &size)
+{
+    if (m_offscreenPlanesFormat == drmFormat && !m_offscreenPlanes.empty() && m_offscreenPlanes.front().texture->size() == size) {
+        return true;
+    }
+
+    m_offscreenPlanes.clear();
+    m_offscreenPlanesFormat = DRM_FORMAT_INVALID;
+
+    const QList<ScreenCastYuvConverter::Plane> planes = ScreenCastYuvConverter::planes(drmFormat);
+    for (const ScreenCastYuvConverter::Plane &plane : planes) {
+        std::shared_ptr<GLTexture> texture = GLTexture::allocate(plane.internalFormat, plane.size(size));
+        if (!texture) {
+            m_offscreenPlanes.clear();
+            return false;
+        }
+        auto framebuffer = std::make_unique<GLFramebuffer>(texture.get());
+        if (!framebuffer->valid()) {
+            m_offscreenPlanes.clear();
+            return false;
+        }
+        m_offscreenPlanes.push_back(ScreenCastRenderTarget{
+            .texture = std::move(texture),
+            .framebuffer = std::move(framebuffer),
+        });
+    }
+
+    m_offscreenPlanesFormat = drmFormat;
+    return true;
+}
+
+bool ScreenCastStream::ensureYuvConverter()
+{
+    if (!m_yuvConverter) {
+        m_yuvConverter = std::make_unique<ScreenCastYuvConverter>();
+    }
+    return m_yuvConverter->isValid();
+}
+
 void ScreenCastStream::bumpBufferAge(ScreenCastBuffer *renderedBuffer)
 {
     for (ScreenCastBuffer *buffer : std::as_const(m_allBuffers)) {
@@ -718,12 +1027,12 @@ void ScreenCastStream::bumpBufferAge(ScreenCastBuffer *renderedBuffer)
 
 void ScreenCastStream::updateStreamSize(const QSize &resolution)
 {
-    if (m_resolution == resolution) {
+    if (m_sourceSize == resolution) {
         return;
     }
-    m_resolution = resolution;
+    m_sourceSize = resolution;
 
-    char buffer[2048];
+    char buffer[4096];
     auto params = buildFormats(false, buffer);
     pw_stream_update_params(m_pwStream, params.data(), params.count());
 }
@@ -779,12 +1088,12 @@ void ScreenCastStream::invalidateCursor()
     m_cursor.invalid = true;
 }
 
-QList<const spa_pod *> ScreenCastStream::buildFormats(bool fixate, char buffer[2048])
+QList<const spa_pod *> ScreenCastStream::buildFormats(bool fixate, char buffer[4096])
 {
     const auto dmabufFormat = drmFormatToSpaVideoFormat(m_drmFormat);
     const auto shmFormat = drmFormatToSpaVideoFormat(DRM_FORMAT_ARGB8888);
 
-    spa_pod_builder podBuilder = SPA_POD_BUILDER_INIT(buffer, 2048);
+    spa_pod_builder podBuilder = SPA_POD_BUILDER_INIT(buffer, 4096);
     spa_fraction defFramerate = SPA_FRACTION(0, 1);
     spa_fraction minFramerate = SPA_FRACTION(0, 1);
     spa_fraction maxFramerate = SPA_FRACTION(m_source->refreshRate(), 1000);
@@ -792,18 +1101,32 @@ QList<const spa_pod *> ScreenCastStream::buildFormats(bool fixate, char buffer[2
     constexpr spa_rectangle streamMinSize = SPA_RECTANGLE(200, 200);
     constexpr spa_rectangle streamMaxSize = SPA_RECTANGLE(10000, 10000);
 
-    spa_rectangle defaultSize = SPA_RECTANGLE(uint32_t(m_resolution.width()), uint32_t(m_resolution.height()));
-    spa_rectangle minSize = m_source->followsStreamSize() ? streamMinSize : defaultSize;
+    // Sources that can't be resized are offered at their size by default, but consumers can ask
+    // for a smaller stream, which is then rendered at that size. The contents keep the aspect
+    // ratio of the source, the rest of the stream is left blank.
+    const QSize size = m_source->followsStreamSize() ? m_resolution : m_sourceSize;
+    spa_rectangle defaultSize = SPA_RECTANGLE(uint32_t(size.width()), uint32_t(size.height()));
+    spa_rectangle minSize = m_source->followsStreamSize() ? streamMinSize : SPA_RECTANGLE(std::min(streamMinSize.width, defaultSize.width), std::min(streamMinSize.height, defaultSize.height));
     spa_rectangle maxSize = m_source->followsStreamSize() ? streamMaxSize : defaultSize;
 
+    // YUV formats are offered after the RGB ones, consumers that want to skip the conversion on
+    // the CPU can ask for them explicitly.
     QList<const spa_pod *> params;
+    if (fixate) {
+        spa_rectangle fixatedSize = SPA_RECTANGLE(uint32_t(m_dmabufParams->width), uint32_t(m_dmabufParams->height));
+        params.append(buildFormat(&podBuilder, drmFormatToSpaVideoFormat(m_dmabufParams->format), fixatedSize, minSize, maxSize, &defFramerate, &minFramerate, &maxFramerate, {m_dmabufParams->modifier}, SPA_POD_PROP_FLAG_MANDATORY));
+    }
     if (m_hasDmaBuf) {
-        if (fixate) {
-            params.append(buildFormat(&podBuilder, dmabufFormat, defaultSize, minSize, maxSize, &defFramerate, &minFramerate, &maxFramerate, {m_dmabufParams->modifier}, SPA_POD_PROP_FLAG_MANDATORY));
-        }
         params.append(buildFormat(&podBuilder, dmabufFormat, defaultSize, minSize, maxSize, &defFramerate, &minFramerate, &maxFramerate, m_modifiers, SPA_POD_PROP_FLAG_MANDATORY | SPA_POD_PROP_FLAG_DONT_FIXATE));
     }
+    if (m_hasYuvDmaBuf) {
+        params.append(buildFormat(&podBuilder, SPA_VIDEO_FORMAT_NV12, defaultSize, minSize, maxSize, &defFramerate, &minFramerate, &maxFramerate, m_yuvModifiers, SPA_POD_PROP_FLAG_MANDATORY | SPA_POD_PROP_FLAG_DONT_FIXATE));
+    }
     params.append(buildFormat(&podBuilder, shmFormat, defaultSize, minSize, maxSize, &defFramerate, &minFramerate, &maxFramerate, {}, 0));
+    if (m_hasYuv) {
+        params.append(buildFormat(&podBuilder, SPA_VIDEO_FORMAT_NV12, defaultSize, minSize, maxSize, &defFramerate, &minFramerate, &maxFramerate, {}, 0));
+        params.append(buildFormat(&podBuilder, SPA_VIDEO_FORMAT_I420, defaultSize, minSize, maxSize, &defFramerate, &minFramerate, &maxFramerate, {}, 0));
+    }
     return params;
 }
 
@@ -837,6 +1160,12 @@ spa_pod *ScreenCastStream::buildFormat(struct spa_pod_builder *b, enum spa_video
         spa_pod_builder_add(b, SPA_FORMAT_VIDEO_format, SPA_POD_Id(format), 0);
     }
 
+    if (format == SPA_VIDEO_FORMAT_NV12 || format == SPA_VIDEO_FORMAT_I420) {
+        // Matches the conversion done by ScreenCastYuvConverter
+        spa_pod_builder_add(b, SPA_FORMAT_VIDEO_colorMatrix, SPA_POD_Id(SPA_VIDEO_COLOR_MATRIX_BT709), 0);
+        spa_pod_builder_add(b, SPA_FORMAT_VIDEO_colorRange, SPA_POD_Id(SPA_VIDEO_COLOR_RANGE_16_235), 0);
+    }
+
     if (!modifiers.empty()) {
         spa_pod_builder_prop(b, SPA_FORMAT_VIDEO_modifier, modifiersFlags);
         spa_pod_builder_push_choice(b, &f[1], SPA_CHOICE_Enum, 0);
@@ -871,7 +1200,7 @@ void ScreenCastStream::addCursorMetadata(spa_buffer *spaBuffer, Cursor *cursor)
     }
     m_cursor.visible = true;
 
-    const qreal scale = m_source->devicePixelRatio();
+    const qreal scale = m_source->devicePixelRatio() * m_source->scaleForSize(m_resolution);
     const auto position = m_source->mapFromGlobal(cursor->pos()) * scale;
 
     spaMetaCursor->id = 1;
@@ -919,6 +1248,21 @@ void ScreenCastStream::setCursorMode(ScreencastV1Interface::CursorMode mode)
     m_cursor.mode = mode;
 }
 
+ScreenCastStream::Statistics ScreenCastStream::statistics() const
+{
+    return m_statistics;
+}
+
+QVariantMap ScreenCastStream::debugStatistics() const
+{
+    return QVariantMap{
+        {QStringLiteral("producedFrames"), m_statistics.producedFrames},
+        {QStringLiteral("skippedFrames"), m_statistics.skippedFrames},
+        {QStringLiteral("coalescedRequests"), m_statistics.coalescedRequests},
+        {QStringLiteral("keepAliveFrames"), m_statistics.keepAliveFrames},
+    };
+}
+
 std::optional<ScreenCastDmaBufTextureParams> ScreenCastStream::testCreateDmaBuf(const QSize &size, quint32 format, const ModifierList &modifiers)
 {
     EglBackend *backend = qobject_cast<EglBackend *>(Compositor::self()->backend());
@@ -951,12 +1295,7 @@ std::optional<ScreenCastDmaBufTextureParams> ScreenCastStream::testCreateDmaBuf(
         return std::nullopt;
     }
 
-    auto texture = backend->importDmaBufAsTexture(*attrs);
-    if (!texture) {
-        return std::nullopt;
-    }
-    auto framebuffer = std::make_unique<GLFramebuffer>(texture.get());
-    if (!framebuffer->valid()) {
+    if (DmaBufScreenCastBuffer::importRenderTargets(backend, *attrs).empty()) {
         return std::nullopt;
     }
 
@@ -9,12 +9,14 @@
 #pragma once
 
 #include "core/drm_formats.h"
+#include "screencastbuffer.h"
 #include "utils/damagejournal.h"
 #include "wayland/screencast_v1.h"
 
 #include <QHash>
 #include <QObject>
 #include <QTimer>
+#include <QVariantMap>
 #include <chrono>
 #include <memory>
 #include <optional>
@@ -28,10 +30,12 @@ namespace KWin
 {
 
 class Cursor;
+class GLFramebuffer;
 class PipeWireCore;
 class Region;
-class ScreenCastBuffer;
+class ScreenCastReadback;
 class ScreenCastSource;
+class ScreenCastYuvConverter;
 
 struct ScreenCastDmaBufTextureParams
 {
@@ -46,6 +50,7 @@ struct ScreenCastDmaBufTextureParams
 class KWIN_EXPORT ScreenCastStream : public QObject
 {
     Q_OBJECT
+    Q_PROPERTY(QVariantMap debugStatistics READ debugStatistics)
 
 public:
     explicit ScreenCastStream(ScreenCastSource *source, std::shared_ptr<PipeWireCore> pwCore, QObject *parent);
@@ -59,6 +64,30 @@ public:
     Q_FLAG(Content)
     Q_DECLARE_FLAGS(Contents, Content)
 
+    /**
+     * The Statistics struct describes how the frames of the stream have been paced, it is
+     * logged when the stream gets paused.
+     */
+    struct Statistics
+    {
+        /**
+         * The number of frames that have been sent to the consumer.
+         */
+        quint64 producedFrames = 0;
+        /**
+         * The number of frames that have been rendered but not sent because nothing had changed.
+         */
+        quint64 skippedFrames = 0;
+        /**
+         * The number of frame requests that have been merged into an already scheduled frame.
+         */
+        quint64 coalescedRequests = 0;
+        /**
+         * The number of frames that have been sent only to keep the stream alive.
+         */
+        quint64 keepAliveFrames = 0;
+    };
+
     bool init();
     uint framerate();
     uint nodeId();
@@ -74,6 +103,12 @@ public:
 
     void setCursorMode(ScreencastV1Interface::CursorMode mode);
 
+    Statistics statistics() const;
+    /**
+     * Returns the statistics() as a map, so they can be inspected without linking to the plugin.
+     */
+    QVariantMap debugStatistics() const;
+
 public Q_SLOTS:
     void invalidateCursor();
 
@@ -88,7 +123,7 @@ private:
     void onStreamRemoveBuffer(pw_buffer *buffer);
 
     bool createStream();
-    QList<const spa_pod *> buildFormats(bool fixate, char buffer[2048]);
+    QList<const spa_pod *> buildFormats(bool fixate, char buffer[4096]);
     void updateParams();
     void updateStreamSize(const QSize &resolution);
     void coreFailed(const QString &errorMessage);
@@ -104,7 +139,14 @@ private:
     pw_buffer *dequeueBuffer();
     void record(Contents contents);
     void bumpBufferAge(ScreenCastBuffer *renderedBuffer);
+    Region renderSource(GLFramebuffer *target, const Region &targetRepair);
+    Region renderScaledSource(GLFramebuffer *target, const Region &targetRepair);
+    Region clearLetterbox(GLFramebuffer *target, const Region &targetRepair);
+    bool ensureRenderTarget(ScreenCastRenderTarget &target, const QSize &size, Region *repair);
+    bool ensureOffscreenPlanes(uint32_t drmFormat, const QSize &size);
+    bool ensureYuvConverter();
     std::chrono::nanoseconds frameInterval() const;
+    static bool isMotion(const Region &damage, const QSize &size);
 
     std::optional<ScreenCastDmaBufTextureParams> testCreateDmaBuf(const QSize &size, quint32 format, const ModifierList &modifiers);
 
@@ -117,6 +159,7 @@ private:
     uint32_t m_pwNodeId = 0;
 
     QSize m_resolution;
+    QSize m_sourceSize;
     bool m_closed = false;
 
     spa_video_info_raw m_videoFormat;
@@ -137,14 +180,28 @@ private:
     quint64 m_sequential = 0;
     bool m_hasDmaBuf = false;
     quint32 m_drmFormat = 0;
+    bool m_hasYuv = false;
+    bool m_hasYuvDmaBuf = false;
+    ModifierList m_yuvModifiers;
 
     std::optional<std::chrono::steady_clock::time_point> m_nextDue;
+    std::optional<std::chrono::steady_clock::time_point> m_coalesceUntil;
     QTimer m_pendingFrame;
     Contents m_pendingContents = Content::None;
+    QTimer m_keepAliveTimer;
+    bool m_keepAliveDue = false;
+    Statistics m_statistics;
     QList<pw_buffer *> m_dequeuedBuffers;
 
     QList<ScreenCastBuffer *> m_allBuffers;
     DamageJournal m_damageJournal;
+
+    ScreenCastRenderTarget m_offscreenTarget;
+    ScreenCastRenderTarget m_supersampleTarget;
+    std::vector<ScreenCastRenderTarget> m_offscreenPlanes;
+    uint32_t m_offscreenPlanesFormat = 0;
+    std::unique_ptr<ScreenCastYuvConverter> m_yuvConverter;
+    std::unique_ptr<ScreenCastReadback> m_readback;
 };
 
 } // namespace KWin
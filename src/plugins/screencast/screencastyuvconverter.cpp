@@ -0,0 +1,148 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "screencastyuvconverter.h"
+#include "core/colorspace.h"
+#include "kwinscreencast_logging.h"
+#include "opengl/glframebuffer.h"
+#include "opengl/glshader.h"
+#include "opengl/glshadermanager.h"
+#include "opengl/gltexture.h"
+#include "opengl/glvertexbuffer.h"
+
+#include <drm_fourcc.h>
+
+namespace KWin
+{
+
+QSize ScreenCastYuvConverter::Plane::size(const QSize &frameSize) const
+{
+    return QSize((frameSize.width() + subsampling - 1) / subsampling, (frameSize.height() + subsampling - 1) / subsampling);
+}
+
+ScreenCastYuvConverter::ScreenCastYuvConverter()
+    : m_rgbToYuv(ColorDescription::sRGB->withYuvCoefficients(YUVMatrixCoefficients::BT709, EncodingRange::Limited)->yuvMatrix().inverted())
+{
+    m_shader = ShaderManager::instance()->generateShaderFromFile(ShaderTrait::MapTexture,
+                                                                 QStringLiteral(":/plugins/screencast/shaders/yuv.vert"),
+                                                                 QStringLiteral(":/plugins/screencast/shaders/yuv.frag"));
+    if (!m_shader) {
+        qCWarning(KWIN_SCREENCAST) << "Failed to load the yuv conversion shader";
+        return;
+    }
+    m_planeMatrixLocation = m_shader->uniformLocation("planeMatrix");
+}
+
+ScreenCastYuvConverter::~ScreenCastYuvConverter()
+{
+}
+
+bool ScreenCastYuvConverter::isValid() const
+{
+    return m_shader != nullptr;
+}
+
+QList<ScreenCastYuvConverter::Plane> ScreenCastYuvConverter::planes(uint32_t drmFormat)
+{
+    switch (drmFormat) {
+    case DRM_FORMAT_NV12:
+        return {
+            Plane{
+                .drmFormat = DRM_FORMAT_R8,
+                .internalFormat = GL_R8,
+                .readFormat = GL_RED,
+                .subsampling = 1,
+                .components = {0},
+            },
+            Plane{
+                .drmFormat = DRM_FORMAT_GR88,
+                .internalFormat = GL_RG8,
+                .readFormat = GL_RG,
+                .subsampling = 2,
+                .components = {1, 2},
+            },
+        };
+    case DRM_FORMAT_YUV420:
+        return {
+            Plane{
+                .drmFormat = DRM_FORMAT_R8,
+                .internalFormat = GL_R8,
+                .readFormat = GL_RED,
+                .subsampling = 1,
+                .components = {0},
+            },
+            Plane{
+                .drmFormat = DRM_FORMAT_R8,
+                .internalFormat = GL_R8,
+                .readFormat = GL_RED,
+                .subsampling = 2,
+                .components = {1},
+            },
+            Plane{
+                .drmFormat = DRM_FORMAT_R8,
+                .internalFormat = GL_R8,
+                .readFormat = GL_RED,
+                .subsampling = 2,
+                .components = {2},
+            },
+        };
+    default:
+        return {};
+    }
+}
+
+void ScreenCastYuvConverter::convert(GLTexture *source, uint32_t drmFormat, const QList<GLFramebuffer *> &planes)
+{
+    const QList<Plane> formatPlanes = ScreenCastYuvConverter::planes(drmFormat);
+    Q_ASSERT(formatPlanes.size() == planes.size());
+
+    // The planes cover the whole source texture, the texture coordinates match the framebuffer
+    // coordinates so the rows stay in the same order as in the source.
+    GLVertexBuffer *vbo = GLVertexBuffer::streamingBuffer();
+    vbo->reset();
+    vbo->setAttribLayout(std::span(GLVertexBuffer::GLVertex2DLayout), sizeof(GLVertex2D));
+    if (auto result = vbo->map<GLVertex2D>(6)) {
+        auto map = *result;
+        map[0] = GLVertex2D{.position = QVector2D(-1, -1), .texcoord = QVector2D(0, 0)};
+        map[1] = GLVertex2D{.position = QVector2D(1, -1), .texcoord = QVector2D(1, 0)};
+        map[2] = GLVertex2D{.position = QVector2D(1, 1), .texcoord = QVector2D(1, 1)};
+        map[3] = GLVertex2D{.position = QVector2D(-1, -1), .texcoord = QVector2D(0, 0)};
+        map[4] = GLVertex2D{.position = QVector2D(1, 1), .texcoord = QVector2D(1, 1)};
+        map[5] = GLVertex2D{.position = QVector2D(-1, 1), .texcoord = QVector2D(0, 1)};
+        vbo->unmap();
+    } else {
+        qCWarning(KWIN_SCREENCAST) << "Failed to map vertex buffer";
+        return;
+    }
+
+    vbo->bindArrays();
+    ShaderManager::instance()->pushShader(m_shader.get());
+
+    // Sampling in the middle of 2x2 blocks averages them when the chroma is subsampled.
+    source->setFilter(GL_LINEAR);
+    source->setWrapMode(GL_CLAMP_TO_EDGE);
+    source->bind();
+
+    for (qsizetype i = 0; i < planes.size(); ++i) {
+        QMatrix4x4 planeMatrix;
+        planeMatrix.fill(0);
+        for (qsizetype channel = 0; channel < formatPlanes[i].components.size(); ++channel) {
+            planeMatrix.setRow(channel, m_rgbToYuv.row(formatPlanes[i].components[channel]));
+        }
+        planeMatrix(3, 3) = 1;
+        m_shader->setUniform(m_planeMatrixLocation, planeMatrix);
+
+        GLFramebuffer::pushFramebuffer(planes[i]);
+        vbo->draw(GL_TRIANGLES, 0, 6);
+        GLFramebuffer::popFramebuffer();
+    }
+
+    source->unbind();
+    ShaderManager::instance()->popShader();
+    vbo->unbindArrays();
+}
+
+} // namespace KWin
@@ -0,0 +1,69 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QList>
+#include <QMatrix4x4>
+#include <QSize>
+
+#include <epoxy/gl.h>
+#include <memory>
+
+namespace KWin
+{
+
+class GLFramebuffer;
+class GLShader;
+class GLTexture;
+
+/**
+ * The ScreenCastYuvConverter class converts rendered frames to multi-planar YUV formats on the
+ * GPU, so that video encoders can consume the frames without converting them on the CPU.
+ *
+ * The frames are encoded with the BT.709 matrix in limited range, chroma is subsampled by
+ * averaging 2x2 blocks.
+ */
+class ScreenCastYuvConverter
+{
+public:
+    struct Plane
+    {
+        /**
+         * DRM_FORMAT_R8 or DRM_FORMAT_GR88.
+         */
+        uint32_t drmFormat;
+        GLenum internalFormat;
+        GLenum readFormat;
+        int subsampling;
+        QList<int> components;
+
+        QSize size(const QSize &frameSize) const;
+    };
+
+    explicit ScreenCastYuvConverter();
+    ~ScreenCastYuvConverter();
+
+    bool isValid() const;
+
+    /**
+     * Returns the planes of the specified YUV @p drmFormat, or an empty list if the format is
+     * not supported.
+     */
+    static QList<Plane> planes(uint32_t drmFormat);
+
+    /**
+     * Converts the @p source texture to @p drmFormat and writes the result in the @p planes.
+     */
+    void convert(GLTexture *source, uint32_t drmFormat, const QList<GLFramebuffer *> &planes);
+
+private:
+    std::unique_ptr<GLShader> m_shader;
+    int m_planeMatrixLocation = -1;
+    QMatrix4x4 m_rgbToYuv;
+};
+
+} // namespace KWin
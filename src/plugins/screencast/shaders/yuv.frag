@@ -0,0 +1,12 @@
+#version 140
+uniform sampler2D texUnit;
+uniform mat4 planeMatrix;
+
+in vec2 uv;
+
+out vec4 fragColor;
+
+void main(void)
+{
+    fragColor = planeMatrix * vec4(texture2D(texUnit, uv).rgb, 1.0);
+}
@@ -6,7 +6,6 @@
 */
 
 #include "windowscreencastsource.h"
-#include "screencastutils.h"
 
 #include "compositor.h"
 #include "core/rendertarget.h"
@@ -104,24 +103,10 @@ void WindowScreenCastSource::setRenderCursor(bool enable)
     m_renderCursor = enable;
 }
 
-Region WindowScreenCastSource::render(QImage *target, const Region &bufferDamage)
-{
-    const auto offscreenTexture = GLTexture::allocate(GL_RGBA8, target->size());
-    if (!offscreenTexture) {
-        return Region{};
-    }
-    offscreenTexture->setContentTransform(OutputTransform::FlipY);
-
-    GLFramebuffer offscreenTarget(offscreenTexture.get());
-    render(&offscreenTarget, Region::infinite());
-    grabTexture(offscreenTexture.get(), target);
-    return Rect(QPoint(), target->size());
-}
-
 Region WindowScreenCastSource::render(GLFramebuffer *target, const Region &bufferDamage)
 {
     RenderTarget renderTarget(target);
-    RenderViewport viewport(boundingRect(), devicePixelRatio(), renderTarget, QPoint());
+    RenderViewport viewport(boundingRect(), devicePixelRatio() * scaleForSize(target->size()), renderTarget, QPoint());
 
     WorkspaceScene *scene = kwinApp()->scene();
 
@@ -0,0 +1,23 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "qpainter/qpainterbackend.h"
+
+namespace KWin
+{
+
+QPainterBackend::QPainterBackend()
+{
+}
+
+CompositingType QPainterBackend::compositingType() const
+{
+    return QPainterCompositing;
+}
+
+} // namespace KWin
+
+#include "moc_qpainterbackend.cpp"
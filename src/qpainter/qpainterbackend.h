@@ -0,0 +1,28 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "core/renderbackend.h"
+
+namespace KWin
+{
+
+/**
+ * The QPainterBackend class is the base class for the rendering backends that composite on
+ * the CPU. The output layers provide render targets that wrap QImages.
+ */
+class KWIN_EXPORT QPainterBackend : public RenderBackend
+{
+    Q_OBJECT
+
+public:
+    QPainterBackend();
+
+    CompositingType compositingType() const override final;
+};
+
+} // namespace KWin
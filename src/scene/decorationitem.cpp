@@ -196,6 +196,8 @@ DecorationItem::DecorationItem(KDecoration3::Decoration *decoration, Window *win
             this, &DecorationItem::handleDecorationGeometryChanged);
     connect(decoration, &KDecoration3::Decoration::borderOutlineChanged,
             this, &DecorationItem::updateOutline);
+    connect(decoration, &KDecoration3::Decoration::opaqueChanged,
+            this, &DecorationItem::invalidateOcclusion);
 
     connect(m_renderer.get(), &DecorationRenderer::damaged,
             this, qOverload<const RegionF &>(&Item::scheduleRepaint));
@@ -66,6 +66,7 @@ void Item::setOpacity(qreal opacity)
 {
     if (m_opacity != opacity) {
         m_opacity = opacity;
+        invalidateOcclusion();
         scheduleRepaint(boundingRect());
     }
 }
@@ -116,6 +117,7 @@ void Item::addChild(Item *item)
 
     m_childItems.append(item);
     markSortedChildItemsDirty();
+    invalidateOcclusion();
 
     updateBoundingRect();
     scheduleRepaint(item->transform().mapRect(item->boundingRect()).translated(item->position()));
@@ -130,6 +132,7 @@ void Item::removeChild(Item *item)
 
     m_childItems.removeOne(item);
     markSortedChildItemsDirty();
+    invalidateOcclusion();
 
     updateBoundingRect();
 
@@ -178,6 +181,8 @@ void Item::setPosition(const QPointF &point)
     if (m_position != point) {
         scheduleMoveRepaint(this);
         m_position = point;
+        ++m_transformGeneration;
+        invalidateOcclusion();
         updateItemToSceneTransform();
         if (m_parentItem) {
             m_parentItem->updateBoundingRect();
@@ -257,6 +262,8 @@ void Item::setTransform(const QTransform &transform)
     }
     scheduleRepaint(boundingRect());
     m_transform = transform;
+    ++m_transformGeneration;
+    invalidateOcclusion();
     updateItemToSceneTransform();
     if (m_parentItem) {
         m_parentItem->updateBoundingRect();
@@ -545,6 +552,30 @@ WindowQuadList Item::buildQuads() const
 void Item::discardQuads()
 {
     m_quads.reset();
+    ++m_quadsGeneration;
+    invalidateOcclusion();
+}
+
+quint64 Item::quadsGeneration() const
+{
+    return m_quadsGeneration;
+}
+
+quint64 Item::transformGeneration() const
+{
+    return m_transformGeneration;
+}
+
+quint64 Item::occlusionGeneration() const
+{
+    return m_occlusionGeneration;
+}
+
+void Item::invalidateOcclusion()
+{
+    for (Item *item = this; item; item = item->m_parentItem) {
+        ++item->m_occlusionGeneration;
+    }
 }
 
 WindowQuadList Item::quads() const
@@ -561,6 +592,11 @@ bool Item::hasRepaints(RenderView *view) const
     return it != m_deviceRepaints.end() && !it->isEmpty();
 }
 
+Region Item::deviceRepaints(RenderView *view) const
+{
+    return m_deviceRepaints.value(view);
+}
+
 Region Item::takeDeviceRepaints(RenderView *view)
 {
     auto &repaints = m_deviceRepaints[view];
@@ -593,6 +629,7 @@ void Item::setVisible(bool visible)
 {
     if (m_explicitVisible != visible) {
         m_explicitVisible = visible;
+        invalidateOcclusion();
         updateEffectiveVisibility();
     }
 }
@@ -606,6 +643,7 @@ void Item::setBorderRadius(const BorderRadius &radius)
 {
     if (m_borderRadius != radius) {
         m_borderRadius = radius;
+        invalidateOcclusion();
         scheduleRepaint(rect());
     }
 }
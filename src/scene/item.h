@@ -161,10 +161,27 @@ public:
     void scheduleRepaint(RenderView *delegate, const RegionF &region);
     void scheduleFrame();
     bool hasRepaints(RenderView *view) const;
+    Region deviceRepaints(RenderView *view) const;
     Region takeDeviceRepaints(RenderView *delegate);
     void resetRepaints(RenderView *delegate);
 
     WindowQuadList quads() const;
+    /**
+     * Returns a counter that is incremented every time the quads of this item are discarded.
+     * It can be used to find out whether geometry built from quads() is still up to date.
+     */
+    quint64 quadsGeneration() const;
+    /**
+     * Returns a counter that is incremented every time the position or the transform of this
+     * item changes.
+     */
+    quint64 transformGeneration() const;
+    /**
+     * Returns a counter that is incremented every time the opaque region of this item or any
+     * of its descendants may have changed, e.g. because an item has been moved, resized or
+     * became translucent.
+     */
+    quint64 occlusionGeneration() const;
     virtual void preprocess();
     const std::shared_ptr<ColorDescription> &colorDescription() const;
     RenderingIntent renderingIntent() const;
@@ -207,6 +224,7 @@ protected:
     virtual void handleFramePainted(LogicalOutput *output, OutputFrame *frame, std::chrono::milliseconds timestamp);
     virtual void releaseResources();
     void discardQuads();
+    void invalidateOcclusion();
     void setColorDescription(const std::shared_ptr<ColorDescription> &description);
     void setRenderingIntent(RenderingIntent intent);
     void setPresentationHint(PresentationModeHint hint);
@@ -244,6 +262,9 @@ private:
     bool m_effectiveVisible = true;
     QMap<RenderView *, Region> m_deviceRepaints;
     mutable std::optional<WindowQuadList> m_quads;
+    quint64 m_quadsGeneration = 0;
+    quint64 m_transformGeneration = 0;
+    quint64 m_occlusionGeneration = 0;
     mutable std::optional<QList<Item *>> m_sortedChildItems;
     std::shared_ptr<ColorDescription> m_colorDescription = ColorDescription::sRGB;
     RenderingIntent m_renderingIntent = RenderingIntent::Perceptual;
@@ -219,6 +219,17 @@ void RenderGeometry::copy(std::span<GLVertex2D> destination)
     std::copy(cbegin(), cend(), destination.begin());
 }
 
+void RenderGeometry::copy(std::span<GLVertex2D> destination, const QVector2D &offset)
+{
+    Q_ASSERT(int(destination.size()) >= size());
+    std::transform(cbegin(), cend(), destination.begin(), [&offset](const GLVertex2D &vertex) {
+        return GLVertex2D{
+            .position = vertex.position + offset,
+            .texcoord = vertex.texcoord,
+        };
+    });
+}
+
 void RenderGeometry::appendWindowVertex(const WindowVertex &windowVertex, qreal deviceScale)
 {
     GLVertex2D glVertex;
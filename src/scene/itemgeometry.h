@@ -146,6 +146,17 @@ public:
      *                    enough to contain all elements.
      */
     void copy(std::span<GLVertex2D> destination);
+    /**
+     * Copy geometry data into another buffer, translating the vertex positions.
+     *
+     * This allows baking a translation into the vertices so geometry with
+     * different positions can be drawn with the same transform.
+     *
+     * @param destination The destination buffer. This needs to be at least large
+     *                    enough to contain all elements.
+     * @param offset The translation to add to the vertex positions.
+     */
+    void copy(std::span<GLVertex2D> destination, const QVector2D &offset);
     /**
      * Append a WindowVertex as a geometry vertex.
      *
@@ -11,7 +11,9 @@
 #include "core/renderviewport.h"
 #include "core/syncobjtimeline.h"
 #include "effect/effect.h"
+#include "opengl/eglcontext.h"
 #include "opengl/eglnativefence.h"
+#include "opengl/gluploadbuffer_p.h"
 #include "scene/decorationitem.h"
 #include "scene/imageitem.h"
 #include "scene/opengl/atlas.h"
@@ -36,6 +38,46 @@ ItemRendererOpenGL::ItemRendererOpenGL(EglDisplay *eglDisplay)
     }
 }
 
+QList<ShaderTraits> ItemRendererOpenGL::commonShaderTraits(bool transformColorspace)
+{
+    QList<ShaderTraits> traits;
+    const auto add = [&traits](ShaderTraits shaderTraits) {
+        if (!traits.contains(shaderTraits)) {
+            traits.append(shaderTraits);
+        }
+    };
+
+    const ShaderTraits colorspace = transformColorspace ? ShaderTraits(ShaderTrait::TransformColorspace) : ShaderTraits();
+    const ShaderTraits sources[] = {
+        ShaderTrait::MapTexture,
+        ShaderTrait::MapExternalTexture,
+        ShaderTrait::MapMultiPlaneTexture | ShaderTrait::YuvConversion,
+    };
+    const ShaderTraits corners[] = {
+        ShaderTraits(),
+        ShaderTrait::RoundedCorners,
+    };
+
+    for (const ShaderTraits source : sources) {
+        for (const ShaderTraits corner : corners) {
+            add(source | corner | colorspace);
+            add(source | corner | colorspace | ShaderTrait::Modulate);
+            // Brightness and saturation adjustments, e.g. in the overview, are always applied in linear space.
+            add(source | corner | ShaderTrait::Modulate | ShaderTrait::AdjustSaturation | ShaderTrait::TransformColorspace);
+        }
+    }
+
+    // Holes for surfaces that are shown on overlay or underlay planes.
+    for (const ShaderTraits corner : corners) {
+        add(corner | ShaderTrait::UniformColor);
+    }
+
+    add(ShaderTrait::Border | colorspace);
+    add(ShaderTrait::Border | colorspace | ShaderTrait::Modulate);
+
+    return traits;
+}
+
 std::unique_ptr<Texture> ItemRendererOpenGL::createTexture(GraphicsBuffer *buffer, const std::shared_ptr<SyncReleasePoint> &releasePoint)
 {
     return BufferTextureOpenGL::create(buffer, releasePoint);
@@ -70,16 +112,27 @@ std::unique_ptr<Atlas> ItemRendererOpenGL::createAtlas(const QList<QImage> &spri
 
 void ItemRendererOpenGL::beginFrame(const RenderTarget &renderTarget, const RenderViewport &viewport)
 {
+    ++m_frameCounter;
+    m_drawStatistics = DrawStatistics{};
+    if (m_frameCounter % 64 == 0) {
+        pruneRenderNodeCache();
+    }
+
     GLFramebuffer *fbo = renderTarget.framebuffer();
     GLFramebuffer::pushFramebuffer(fbo);
 
     GLVertexBuffer::streamingBuffer()->beginFrame();
+    if (GLUploadBuffer *uploadBuffer = EglContext::currentContext()->uploadBuffer()) {
+        uploadBuffer->beginFrame();
+    }
+    ShaderManager::instance()->checkPendingShaders();
 }
 
 void ItemRendererOpenGL::endFrame()
 {
     GLVertexBuffer::streamingBuffer()->endOfFrame();
     GLFramebuffer::popFramebuffer();
+    m_lastDrawStatistics = m_drawStatistics;
 
     if (m_eglDisplay) {
         EGLNativeFence fence(m_eglDisplay);
@@ -111,21 +164,30 @@ void ItemRendererOpenGL::setBlendEnabled(bool enabled)
     m_blendingEnabled = enabled;
 }
 
-static RenderGeometry clipQuads(const Item *item, const ItemRendererOpenGL::RenderContext *context)
+static bool isSoftwareClipping(const ItemRendererOpenGL::RenderContext *context)
 {
-    const WindowQuadList quads = item->quads();
+    return context->deviceClip != Region::infinite() && !context->hardwareClipping;
+}
 
-    const qreal scale = context->renderTargetScale;
-    const QPointF itemToDeviceTranslation = context->transformStack.top().map(QPointF(0., 0.))
+static QPointF itemToDeviceTranslation(const ItemRendererOpenGL::RenderContext *context)
+{
+    return context->transformStack.top().map(QPointF(0., 0.))
         - context->viewportOrigin
         + context->renderOffset;
+}
+
+static RenderGeometry clipQuads(const Item *item, const ItemRendererOpenGL::RenderContext *context, bool softwareClipping, const QPointF &itemToDeviceTranslation)
+{
+    const WindowQuadList quads = item->quads();
+
+    const qreal scale = context->renderTargetScale;
 
     RenderGeometry geometry;
     geometry.reserve(quads.count() * 6);
 
     // split all quads in bounding rect with the actual rects in the region
     for (const WindowQuad &quad : std::as_const(quads)) {
-        if (context->deviceClip != Region::infinite() && !context->hardwareClipping) {
+        if (softwareClipping) {
             // Scale to device coordinates, rounding as needed.
             const RectF deviceBounds = quad.bounds().scaled(scale).rounded();
 
@@ -150,6 +212,96 @@ static RenderGeometry clipQuads(const Item *item, const ItemRendererOpenGL::Rend
     return geometry;
 }
 
+ItemRendererOpenGL::RenderNodeCacheEntry *ItemRendererOpenGL::renderNodeCacheEntry(Item *item, const RenderContext *context)
+{
+    RenderNodeCacheEntry &entry = m_renderNodeCache[RenderNodeCacheKey{
+        .item = item,
+        .viewportOrigin = context->viewportOrigin,
+    }];
+
+    // The item may have been destroyed and another one allocated at the same address.
+    if (entry.item != item) {
+        entry = RenderNodeCacheEntry{
+            .item = item,
+        };
+    }
+
+    entry.lastUsedFrame = m_frameCounter;
+    return &entry;
+}
+
+QMatrix4x4 ItemRendererOpenGL::cachedItemTransform(RenderNodeCacheEntry *entry, Item *item, const RenderContext *context)
+{
+    const qreal scale = context->renderTargetScale;
+    if (entry->transform && entry->transformGeneration == item->transformGeneration() && entry->transformScale == scale) {
+        return *entry->transform;
+    }
+
+    const auto logicalPosition = QVector2D(item->position().x(), item->position().y());
+
+    QMatrix4x4 matrix;
+    matrix.translate(roundVector(logicalPosition * scale).toVector3D());
+    if (!item->transform().isIdentity()) {
+        matrix.scale(scale, scale);
+        matrix *= item->transform();
+        matrix.scale(1 / scale, 1 / scale);
+    }
+
+    entry->transform = matrix;
+    entry->transformGeneration = item->transformGeneration();
+    entry->transformScale = scale;
+
+    return matrix;
+}
+
+RenderGeometry ItemRendererOpenGL::cachedGeometry(RenderNodeCacheEntry *entry, Item *item, const RenderContext *context)
+{
+    const bool softwareClipping = isSoftwareClipping(context);
+    const QPointF translation = softwareClipping ? itemToDeviceTranslation(context) : QPointF();
+
+    if (entry->geometry
+        && entry->quadsGeneration == item->quadsGeneration()
+        && entry->geometryScale == context->renderTargetScale
+        && entry->softwareClipping == softwareClipping
+        && (!softwareClipping || (entry->deviceTranslation == translation && entry->deviceClip == context->deviceClip))) {
+        return *entry->geometry;
+    }
+
+    entry->geometry = clipQuads(item, context, softwareClipping, translation);
+    entry->quadsGeneration = item->quadsGeneration();
+    entry->geometryScale = context->renderTargetScale;
+    entry->softwareClipping = softwareClipping;
+    entry->deviceClip = softwareClipping ? context->deviceClip : Region();
+    entry->deviceTranslation = translation;
+    entry->mappedGeometry.reset();
+
+    return *entry->geometry;
+}
+
+RenderGeometry ItemRendererOpenGL::cachedMappedGeometry(RenderNodeCacheEntry *entry, const QMatrix4x4 &textureMatrix)
+{
+    if (!entry->mappedGeometry || entry->textureMatrix != textureMatrix) {
+        RenderGeometry geometry = *entry->geometry;
+        geometry.postProcessTextureCoordinates(textureMatrix);
+        entry->mappedGeometry = geometry;
+        entry->textureMatrix = textureMatrix;
+    }
+    return *entry->mappedGeometry;
+}
+
+void ItemRendererOpenGL::pruneRenderNodeCache()
+{
+    // Drop the entries for items that have been destroyed or haven't been painted for a while.
+    static constexpr quint64 maxUnusedFrames = 120;
+    for (auto it = m_renderNodeCache.begin(); it != m_renderNodeCache.end();) {
+        if (!it->item || m_frameCounter - it->lastUsedFrame > maxUnusedFrames) {
+            it = m_renderNodeCache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 bool ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context, const std::function<bool(Item *)> &filter, const std::function<bool(Item *)> &holeFilter)
 {
     bool hole = false;
@@ -161,18 +313,20 @@ bool ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context, co
     }
     const QList<Item *> sortedChildItems = item->sortedChildItems();
 
-    const auto logicalPosition = QVector2D(item->position().x(), item->position().y());
-    const auto scale = context->renderTargetScale;
-
     QMatrix4x4 matrix;
-    matrix.translate(roundVector(logicalPosition * scale).toVector3D());
     if (context->transformStack.size() == 1) {
+        const auto logicalPosition = QVector2D(item->position().x(), item->position().y());
+        const auto scale = context->renderTargetScale;
+
+        matrix.translate(roundVector(logicalPosition * scale).toVector3D());
         matrix *= context->rootTransform;
-    }
-    if (!item->transform().isIdentity()) {
-        matrix.scale(scale, scale);
-        matrix *= item->transform();
-        matrix.scale(1 / scale, 1 / scale);
+        if (!item->transform().isIdentity()) {
+            matrix.scale(scale, scale);
+            matrix *= item->transform();
+            matrix.scale(1 / scale, 1 / scale);
+        }
+    } else {
+        matrix = cachedItemTransform(renderNodeCacheEntry(item, context), item, context);
     }
     context->transformStack.push(context->transformStack.top() * matrix);
 
@@ -211,16 +365,19 @@ bool ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context, co
         return false;
     }
 
-    RenderGeometry geometry = clipQuads(item, context);
+    // Look up the cache entry only after the child items stacked below this one have been
+    // processed, adding cache entries for them may invalidate the returned pointer.
+    RenderNodeCacheEntry *cacheEntry = renderNodeCacheEntry(item, context);
+    const RenderGeometry geometry = cachedGeometry(cacheEntry, item, context);
 
     if (auto shadowItem = qobject_cast<ShadowItem *>(item)) {
         if (!geometry.isEmpty()) {
             const auto ninePatch = static_cast<NinePatchOpenGL *>(shadowItem->ninePatch());
             if (ninePatch->texture()) {
-                RenderNode &renderNode = context->renderNodes.emplace_back(RenderNode{
+                context->renderNodes.emplace_back(RenderNode{
                     .traits = ShaderTrait::MapTexture,
                     .textures = {ninePatch->texture()},
-                    .geometry = geometry,
+                    .geometry = cachedMappedGeometry(cacheEntry, ninePatch->texture()->matrix(UnnormalizedCoordinates)),
                     .transformMatrix = context->transformStack.top(),
                     .opacity = context->opacityStack.top(),
                     .hasAlpha = true,
@@ -229,17 +386,16 @@ bool ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context, co
                     .bufferReleasePoint = nullptr,
                     .paintHole = hole,
                 });
-                renderNode.geometry.postProcessTextureCoordinates(ninePatch->texture()->matrix(UnnormalizedCoordinates));
             }
         }
     } else if (auto decorationItem = qobject_cast<DecorationItem *>(item)) {
         if (!geometry.isEmpty()) {
             auto atlas = static_cast<const AtlasOpenGL *>(decorationItem->atlas());
             if (atlas && atlas->texture()) {
-                RenderNode &renderNode = context->renderNodes.emplace_back(RenderNode{
+                context->renderNodes.emplace_back(RenderNode{
                     .traits = ShaderTrait::MapTexture,
                     .textures = {atlas->texture()},
-                    .geometry = geometry,
+                    .geometry = cachedMappedGeometry(cacheEntry, atlas->texture()->matrix(UnnormalizedCoordinates)),
                     .transformMatrix = context->transformStack.top(),
                     .opacity = context->opacityStack.top(),
                     .hasAlpha = true,
@@ -248,7 +404,6 @@ bool ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context, co
                     .bufferReleasePoint = nullptr,
                     .paintHole = hole,
                 });
-                renderNode.geometry.postProcessTextureCoordinates(atlas->texture()->matrix(UnnormalizedCoordinates));
             }
         }
     } else if (auto surfaceItem = qobject_cast<SurfaceItem *>(item)) {
@@ -257,7 +412,7 @@ bool ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context, co
             if (!geometry.isEmpty()) {
                 RenderNode &renderNode = context->renderNodes.emplace_back(RenderNode{
                     .textures = texture->planes(),
-                    .geometry = geometry,
+                    .geometry = cachedMappedGeometry(cacheEntry, texture->planes().at(0)->matrix(UnnormalizedCoordinates)),
                     .transformMatrix = context->transformStack.top(),
                     .opacity = context->opacityStack.top(),
                     .hasAlpha = surfaceItem->hasAlphaChannel(),
@@ -277,7 +432,6 @@ bool ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context, co
                     renderNode.traits = ShaderTrait::MapTexture;
                 }
 
-                renderNode.geometry.postProcessTextureCoordinates(texture->planes().at(0)->matrix(UnnormalizedCoordinates));
                 if (surfaceItem->colorDescription()->yuvCoefficients() != YUVMatrixCoefficients::Identity) {
                     renderNode.traits |= ShaderTrait::YuvConversion;
                 }
@@ -299,10 +453,10 @@ bool ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context, co
         if (!geometry.isEmpty()) {
             auto texture = static_cast<TextureOpenGL *>(imageItem->texture());
             if (texture && !texture->planes().isEmpty()) {
-                RenderNode &renderNode = context->renderNodes.emplace_back(RenderNode{
+                context->renderNodes.emplace_back(RenderNode{
                     .traits = ShaderTrait::MapTexture,
                     .textures = texture->planes(),
-                    .geometry = geometry,
+                    .geometry = cachedMappedGeometry(cacheEntry, texture->planes()[0]->matrix(UnnormalizedCoordinates)),
                     .transformMatrix = context->transformStack.top(),
                     .opacity = context->opacityStack.top(),
                     .hasAlpha = imageItem->image().hasAlphaChannel(),
@@ -311,7 +465,6 @@ bool ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context, co
                     .bufferReleasePoint = texture->releasePoint(),
                     .paintHole = hole,
                 });
-                renderNode.geometry.postProcessTextureCoordinates(texture->planes()[0]->matrix(UnnormalizedCoordinates));
             }
         }
     } else if (auto borderItem = qobject_cast<OutlinedBorderItem *>(item)) {
@@ -380,6 +533,85 @@ void ItemRendererOpenGL::renderBackground(const RenderTarget &renderTarget, cons
     }
 }
 
+static std::optional<QVector2D> translationOffset(const QMatrix4x4 &matrix)
+{
+    QMatrix4x4 translation;
+    translation.translate(matrix(0, 3), matrix(1, 3));
+    if (translation != matrix) {
+        return std::nullopt;
+    }
+    return QVector2D(matrix(0, 3), matrix(1, 3));
+}
+
+static bool sameColorDescription(const std::shared_ptr<ColorDescription> &one, const std::shared_ptr<ColorDescription> &other)
+{
+    return one.get() == other.get() || (one && other && *one == *other);
+}
+
+ShaderTraits ItemRendererOpenGL::shaderTraits(const RenderNode &renderNode, const RenderTarget &renderTarget, const WindowPaintData &data) const
+{
+    ShaderTraits traits = renderNode.traits;
+    if (renderNode.opacity != 1.0 || data.brightness() != 1.0) {
+        traits |= ShaderTrait::Modulate;
+    }
+    if (data.saturation() != 1.0) {
+        traits |= ShaderTrait::AdjustSaturation;
+    }
+    if (data.brightness() != 1.0 || data.saturation() != 1.0) {
+        // make sure that brightness and saturation adjustments are always applied in linear space
+        traits |= ShaderTrait::TransformColorspace;
+    } else {
+        const auto colorTransformation = ColorPipeline::create(renderNode.colorDescription, renderTarget.colorDescription(), renderNode.renderingIntent,
+                                                               renderNode.hasFloatingPointColor ? ColorPipeline::InputType::FloatingPoint : ColorPipeline::InputType::FixedPoint);
+        if (!colorTransformation.isIdentity()) {
+            traits |= ShaderTrait::TransformColorspace;
+        }
+    }
+
+    if (renderNode.paintHole) {
+        traits = (traits & ShaderTrait::RoundedCorners) | ShaderTrait::UniformColor;
+    }
+    return traits;
+}
+
+bool ItemRendererOpenGL::canBatch(const RenderNode &first, ShaderTraits firstTraits, const RenderNode &next, ShaderTraits nextTraits)
+{
+    if (firstTraits != nextTraits || first.paintHole != next.paintHole) {
+        return false;
+    }
+    if (first.layerDebugBox || next.layerDebugBox) {
+        return false;
+    }
+    if ((first.hasAlpha || first.opacity < 1.0) != (next.hasAlpha || next.opacity < 1.0)) {
+        return false;
+    }
+    if (first.transformMatrix != next.transformMatrix) {
+        return false;
+    }
+    if (!first.paintHole && first.textures != next.textures) {
+        return false;
+    }
+    if ((firstTraits & ShaderTrait::Modulate) && first.opacity != next.opacity) {
+        return false;
+    }
+    if (firstTraits & (ShaderTrait::TransformColorspace | ShaderTrait::YuvConversion)) {
+        if (!sameColorDescription(first.colorDescription, next.colorDescription) || first.renderingIntent != next.renderingIntent) {
+            return false;
+        }
+    }
+    if (firstTraits & (ShaderTrait::RoundedCorners | ShaderTrait::Border)) {
+        if (first.box != next.box || first.borderRadius != next.borderRadius) {
+            return false;
+        }
+    }
+    if (firstTraits & ShaderTrait::Border) {
+        if (first.borderThickness != next.borderThickness || first.borderColor != next.borderColor) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool ItemRendererOpenGL::renderItem(const RenderTarget &renderTarget, const RenderViewport &viewport, Item *item, int mask, const Region &deviceRegion, const WindowPaintData &data, const std::function<bool(Item *)> &filter, const std::function<bool(Item *)> &holeFilter)
 {
     if (deviceRegion.isEmpty()) {
@@ -425,7 +657,15 @@ bool ItemRendererOpenGL::renderItem(const RenderTarget &renderTarget, const Rend
         RenderNode &renderNode = renderContext.renderNodes[i];
         renderNode.firstVertex = v;
         renderNode.vertexCount = renderNode.geometry.count();
-        renderNode.geometry.copy(map->subspan(v));
+        // Bake plain translations into the vertices so that items at different positions
+        // share the same transform and can be drawn in a single batch.
+        if (const auto offset = translationOffset(renderNode.transformMatrix); offset && !renderNode.layerDebugBox) {
+            renderNode.geometry.copy(map->subspan(v), *offset);
+            renderNode.transformMatrix = QMatrix4x4();
+            renderNode.box += QVector4D(offset->x(), offset->y(), 0, 0);
+        } else {
+            renderNode.geometry.copy(map->subspan(v));
+        }
         v += renderNode.geometry.count();
     }
 
@@ -436,47 +676,49 @@ bool ItemRendererOpenGL::renderItem(const RenderTarget &renderTarget, const Rend
         glEnable(GL_SCISSOR_TEST);
     }
 
-    // Make sure the blend function is set up correctly in case we will be doing blending
-    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
-
     // The scissor region must be in the render target local coordinate system.
     const QSize bufferOffset = renderTarget.transform().map(QSize(viewport.renderOffset().x(), viewport.renderOffset().y()));
     Region scissorRegion = Rect(QPoint(bufferOffset.width(), bufferOffset.height()), renderTarget.size() - 2 * bufferOffset);
     if (renderContext.hardwareClipping) {
         scissorRegion &= viewport.transform().map(deviceRegion & renderTarget.transformedRect(), renderTarget.transformedSize());
     }
+    const int drawCallsPerBatch = renderContext.hardwareClipping ? scissorRegion.rects().size() : 1;
+
+    QVarLengthArray<ShaderTraits> nodeTraits;
+    nodeTraits.reserve(renderContext.renderNodes.count());
+    for (const RenderNode &renderNode : std::as_const(renderContext.renderNodes)) {
+        nodeTraits.append(shaderTraits(renderNode, renderTarget, data));
+    }
+
+    // Make sure the blend function is set up correctly in case we will be doing blending
+    bool holeBlending = false;
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 
     ShaderTraits lastTraits;
     GLShader *shader = nullptr;
-    for (int i = 0; i < renderContext.renderNodes.count(); i++) {
+    QVarLengthArray<GLTexture *, 4> boundTextures;
+    for (int i = 0; i < renderContext.renderNodes.count();) {
         const RenderNode &renderNode = renderContext.renderNodes[i];
-
-        ShaderTraits traits = renderNode.traits;
-        if (renderNode.opacity != 1.0 || data.brightness() != 1.0) {
-            traits |= ShaderTrait::Modulate;
-        }
-        if (data.saturation() != 1.0) {
-            traits |= ShaderTrait::AdjustSaturation;
-        }
-        if (data.brightness() != 1.0 || data.saturation() != 1.0) {
-            // make sure that brightness and saturation adjustments are always applied in linear space
-            traits |= ShaderTrait::TransformColorspace;
-        } else {
-            const auto colorTransformation = ColorPipeline::create(renderNode.colorDescription, renderTarget.colorDescription(), renderNode.renderingIntent,
-                                                                   renderNode.hasFloatingPointColor ? ColorPipeline::InputType::FloatingPoint : ColorPipeline::InputType::FixedPoint);
-            if (!colorTransformation.isIdentity()) {
-                traits |= ShaderTrait::TransformColorspace;
-            }
+        const ShaderTraits traits = nodeTraits[i];
+
+        // Consecutive nodes that would be drawn with the same state are merged into one draw,
+        // their vertices are adjacent in the vertex buffer.
+        int batchEnd = i + 1;
+        int vertexCount = renderNode.vertexCount;
+        while (batchEnd < renderContext.renderNodes.count() && canBatch(renderNode, traits, renderContext.renderNodes[batchEnd], nodeTraits[batchEnd])) {
+            vertexCount += renderContext.renderNodes[batchEnd].vertexCount;
+            batchEnd++;
         }
 
-        if (renderNode.paintHole) {
-            traits = (traits & ShaderTrait::RoundedCorners) | ShaderTrait::UniformColor;
-            glBlendFunc(GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            setBlendEnabled(true);
-        } else {
-            glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
-            setBlendEnabled(renderNode.hasAlpha || renderNode.opacity < 1.0);
+        if (renderNode.paintHole != holeBlending) {
+            holeBlending = renderNode.paintHole;
+            if (holeBlending) {
+                glBlendFunc(GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            } else {
+                glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            }
         }
+        setBlendEnabled(renderNode.paintHole || renderNode.hasAlpha || renderNode.opacity < 1.0);
 
         if (!shader || traits != lastTraits) {
             lastTraits = traits;
@@ -485,6 +727,7 @@ bool ItemRendererOpenGL::renderItem(const RenderTarget &renderTarget, const Rend
             }
             shader = ShaderManager::instance()->pushShader(traits);
             if (!shader) {
+                i = batchEnd;
                 continue;
             }
             if (traits & ShaderTrait::AdjustSaturation) {
@@ -524,25 +767,35 @@ bool ItemRendererOpenGL::renderItem(const RenderTarget &renderTarget, const Rend
             shader->setUniform(GLShader::ColorUniform::Color, QColor(0, 0, 0, 255));
         }
 
-        for (int i = 0; i < renderNode.textures.count() && !renderNode.paintHole; ++i) {
-            glActiveTexture(GL_TEXTURE0 + i);
-            renderNode.textures[i]->bind();
+        // Textures stay bound until a node needs other ones.
+        if (!renderNode.paintHole && renderNode.textures != boundTextures) {
+            for (int unit = renderNode.textures.count(); unit < boundTextures.count(); ++unit) {
+                glActiveTexture(GL_TEXTURE0 + unit);
+                boundTextures[unit]->unbind();
+            }
+            for (int unit = 0; unit < renderNode.textures.count(); ++unit) {
+                glActiveTexture(GL_TEXTURE0 + unit);
+                renderNode.textures[unit]->bind();
+            }
+            boundTextures = renderNode.textures;
         }
 
-        vbo->draw(scissorRegion, GL_TRIANGLES, renderNode.firstVertex,
-                  renderNode.vertexCount, renderContext.hardwareClipping);
+        vbo->draw(scissorRegion, GL_TRIANGLES, renderNode.firstVertex, vertexCount, renderContext.hardwareClipping);
+        m_drawStatistics.batches++;
+        m_drawStatistics.drawCalls += drawCallsPerBatch;
 
-        for (int i = 0; i < renderNode.textures.count() && !renderNode.paintHole; ++i) {
-            glActiveTexture(GL_TEXTURE0 + i);
-            renderNode.textures[i]->unbind();
-        }
-
-        if (renderNode.bufferReleasePoint) {
-            m_releasePoints.insert(renderNode.bufferReleasePoint);
+        for (int j = i; j < batchEnd; ++j) {
+            if (const auto &releasePoint = renderContext.renderNodes[j].bufferReleasePoint) {
+                m_releasePoints.insert(releasePoint);
+            }
         }
+        m_drawStatistics.renderNodes += batchEnd - i;
 
         if (renderNode.layerDebugBox.has_value()) {
-            glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            if (holeBlending) {
+                holeBlending = false;
+                glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            }
             setBlendEnabled(true);
             if (shader) {
                 ShaderManager::instance()->popShader();
@@ -562,7 +815,17 @@ bool ItemRendererOpenGL::renderItem(const RenderTarget &renderTarget, const Rend
             }
             vbo->draw(scissorRegion, GL_TRIANGLES, renderNode.firstVertex,
                       renderNode.vertexCount, renderContext.hardwareClipping);
+            m_drawStatistics.drawCalls += drawCallsPerBatch;
         }
+
+        i = batchEnd;
+    }
+    for (int unit = 0; unit < boundTextures.count(); ++unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        boundTextures[unit]->unbind();
+    }
+    if (holeBlending) {
+        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
     }
     if (shader) {
         // some other code assumes texture 0 is active
@@ -623,6 +886,11 @@ void ItemRendererOpenGL::visualizeFractional(const RenderViewport &viewport, con
     }
 }
 
+ItemRendererOpenGL::DrawStatistics ItemRendererOpenGL::drawStatistics() const
+{
+    return m_lastDrawStatistics;
+}
+
 void ItemRendererOpenGL::setLayerDebugging(bool enable)
 {
     m_debug.layerEnabled = enable;
@@ -10,6 +10,10 @@
 #include "scene/itemrenderer.h"
 #include "scene/surfaceitem.h"
 
+#include <QHash>
+#include <QPointer>
+
+#include <optional>
 #include <unordered_set>
 
 namespace KWin
@@ -48,6 +52,38 @@ public:
         BorderRadius radius;
     };
 
+    /**
+     * The RenderNodeCacheEntry type holds the data that is computed for an item while building
+     * render nodes and that can be reused across frames as long as the item has not changed.
+     */
+    struct RenderNodeCacheEntry
+    {
+        QPointer<Item> item;
+        quint64 lastUsedFrame = 0;
+
+        std::optional<QMatrix4x4> transform;
+        quint64 transformGeneration = 0;
+        qreal transformScale = 0;
+
+        std::optional<RenderGeometry> geometry;
+        quint64 quadsGeneration = 0;
+        qreal geometryScale = 0;
+        bool softwareClipping = false;
+        Region deviceClip;
+        QPointF deviceTranslation;
+
+        std::optional<RenderGeometry> mappedGeometry;
+        QMatrix4x4 textureMatrix;
+    };
+
+    struct RenderNodeCacheKey
+    {
+        const Item *item;
+        QPointF viewportOrigin;
+
+        bool operator==(const RenderNodeCacheKey &other) const = default;
+    };
+
     struct RenderContext
     {
         QList<RenderNode> renderNodes;
@@ -63,8 +99,27 @@ public:
         const QPoint renderOffset;
     };
 
+    /**
+     * The DrawStatistics type describes how the render nodes of a frame were drawn. Consecutive
+     * render nodes that need the same state are merged into a single batch, and every batch is
+     * drawn once per scissor rect.
+     */
+    struct DrawStatistics
+    {
+        int renderNodes = 0;
+        int batches = 0;
+        int drawCalls = 0;
+    };
+
     ItemRendererOpenGL(EglDisplay *eglDisplay);
 
+    /**
+     * Returns the shader traits that are commonly needed to render the scene. If @a transformColorspace
+     * is @c true, the scene is blended in a color space other than sRGB and most surfaces need to be
+     * converted to it.
+     */
+    static QList<ShaderTraits> commonShaderTraits(bool transformColorspace);
+
     std::unique_ptr<Texture> createTexture(GraphicsBuffer *buffer, const std::shared_ptr<SyncReleasePoint> &releasePoint) override;
     std::unique_ptr<Texture> createTexture(const QImage &image) override;
 
@@ -88,15 +143,31 @@ public:
 
     void setLayerDebugging(bool enable) override;
 
+    /**
+     * Returns the draw statistics of the last rendered frame.
+     */
+    DrawStatistics drawStatistics() const;
+
 private:
     QVector4D modulate(float opacity, float brightness) const;
     void setBlendEnabled(bool enabled);
     bool createRenderNode(Item *item, RenderContext *context, const std::function<bool(Item *)> &filter, const std::function<bool(Item *)> &holeFilter);
+    ShaderTraits shaderTraits(const RenderNode &renderNode, const RenderTarget &renderTarget, const WindowPaintData &data) const;
+    static bool canBatch(const RenderNode &first, ShaderTraits firstTraits, const RenderNode &next, ShaderTraits nextTraits);
     void visualizeFractional(const RenderViewport &viewport, const Region &logicalRegion, const RenderContext &renderContext);
+    RenderNodeCacheEntry *renderNodeCacheEntry(Item *item, const RenderContext *context);
+    QMatrix4x4 cachedItemTransform(RenderNodeCacheEntry *entry, Item *item, const RenderContext *context);
+    RenderGeometry cachedGeometry(RenderNodeCacheEntry *entry, Item *item, const RenderContext *context);
+    RenderGeometry cachedMappedGeometry(RenderNodeCacheEntry *entry, const QMatrix4x4 &textureMatrix);
+    void pruneRenderNodeCache();
 
     bool m_blendingEnabled = false;
     EglDisplay *const m_eglDisplay;
     std::unordered_set<std::shared_ptr<SyncReleasePoint>> m_releasePoints;
+    QHash<RenderNodeCacheKey, RenderNodeCacheEntry> m_renderNodeCache;
+    quint64 m_frameCounter = 0;
+    DrawStatistics m_drawStatistics;
+    DrawStatistics m_lastDrawStatistics;
 
     struct
     {
@@ -106,4 +177,9 @@ private:
     } m_debug;
 };
 
+inline size_t qHash(const ItemRendererOpenGL::RenderNodeCacheKey &key, size_t seed = 0)
+{
+    return qHashMulti(seed, key.item, key.viewportOrigin.x(), key.viewportOrigin.y());
+}
+
 } // namespace KWin
@@ -0,0 +1,524 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "scene/itemrenderer_software.h"
+#include "core/rendertarget.h"
+#include "core/renderviewport.h"
+#include "effect/effect.h"
+#include "scene/decorationitem.h"
+#include "scene/imageitem.h"
+#include "scene/itemgeometry.h"
+#include "scene/outlinedborderitem.h"
+#include "scene/shadowitem.h"
+#include "scene/software/atlas.h"
+#include "scene/software/ninepatch.h"
+#include "scene/software/texture.h"
+#include "scene/surfaceitem.h"
+
+#include <QThread>
+#include <QtConcurrentMap>
+
+#include <cmath>
+#include <limits>
+
+namespace KWin
+{
+
+static int renderThreadCount()
+{
+    if (const int count = qEnvironmentVariableIntValue("KWIN_SOFTWARE_RENDER_THREADS"); count > 0) {
+        return count;
+    }
+    // The rasterization is memory bound, more threads than that don't help.
+    return std::clamp(QThread::idealThreadCount(), 1, 8);
+}
+
+ItemRendererSoftware::ItemRendererSoftware()
+{
+    m_threadPool.setMaxThreadCount(renderThreadCount());
+    m_threadPool.setObjectName(QStringLiteral("KWinSoftwareRenderer"));
+}
+
+ItemRendererSoftware::~ItemRendererSoftware()
+{
+    m_threadPool.waitForDone();
+}
+
+std::unique_ptr<Texture> ItemRendererSoftware::createTexture(GraphicsBuffer *buffer, const std::shared_ptr<SyncReleasePoint> &releasePoint)
+{
+    return BufferTextureSoftware::create(buffer);
+}
+
+std::unique_ptr<Texture> ItemRendererSoftware::createTexture(const QImage &image)
+{
+    return ImageTextureSoftware::create(image);
+}
+
+std::unique_ptr<NinePatch> ItemRendererSoftware::createNinePatch(const QImage &image)
+{
+    return NinePatchSoftware::create(image);
+}
+
+std::unique_ptr<NinePatch> ItemRendererSoftware::createNinePatch(const QImage &topLeftPatch,
+                                                                 const QImage &topPatch,
+                                                                 const QImage &topRightPatch,
+                                                                 const QImage &rightPatch,
+                                                                 const QImage &bottomRightPatch,
+                                                                 const QImage &bottomPatch,
+                                                                 const QImage &bottomLeftPatch,
+                                                                 const QImage &leftPatch)
+{
+    return NinePatchSoftware::create(topLeftPatch, topPatch, topRightPatch, rightPatch, bottomRightPatch, bottomPatch, bottomLeftPatch, leftPatch);
+}
+
+std::unique_ptr<Atlas> ItemRendererSoftware::createAtlas(const QList<QImage> &sprites)
+{
+    return AtlasSoftware::create(sprites);
+}
+
+void ItemRendererSoftware::beginFrame(const RenderTarget &renderTarget, const RenderViewport &viewport)
+{
+    m_image = renderTarget.image();
+    m_renderNodes.clear();
+}
+
+void ItemRendererSoftware::endFrame()
+{
+    if (!m_image || m_renderNodes.isEmpty()) {
+        m_image = nullptr;
+        m_renderNodes.clear();
+        return;
+    }
+
+    Rect area;
+    for (const RenderNode &node : std::as_const(m_renderNodes)) {
+        area |= node.clip.boundingRect();
+    }
+    area &= Rect(m_image->rect());
+
+    if (!area.isEmpty()) {
+        // Detaching is not thread safe, so the pixels must be accessed before the workers start.
+        uchar *bits = m_image->bits();
+        const qsizetype stride = m_image->bytesPerLine();
+
+        // Make a few bands per thread so the threads don't idle if the damage is uneven.
+        const int threadCount = m_threadPool.maxThreadCount();
+        const int bandHeight = std::max(16, area.height() / (threadCount * 4));
+
+        QList<Rect> bands;
+        for (int y = area.top(); y < area.bottom(); y += bandHeight) {
+            bands.append(Rect(QPoint(area.left(), y), QPoint(area.right(), std::min(y + bandHeight, area.bottom()))));
+        }
+
+        if (threadCount == 1 || bands.size() == 1) {
+            for (const Rect &band : std::as_const(bands)) {
+                rasterize(bits, stride, band);
+            }
+        } else {
+            QtConcurrent::blockingMap(&m_threadPool, bands, [this, bits, stride](const Rect &band) {
+                rasterize(bits, stride, band);
+            });
+        }
+    }
+
+    m_image = nullptr;
+    m_renderNodes.clear();
+}
+
+void ItemRendererSoftware::renderBackground(const RenderTarget &renderTarget, const RenderViewport &viewport, const Region &deviceRegion)
+{
+    if (!m_image) {
+        return;
+    }
+
+    const Region clipped = deviceRegion & renderTarget.transformedRect();
+    if (!clipped.isEmpty()) {
+        m_renderNodes.append(RenderNode{
+            .type = RenderNode::Type::Clear,
+            .clip = viewport.transform().map(clipped, renderTarget.transformedSize()),
+        });
+    }
+}
+
+bool ItemRendererSoftware::renderItem(const RenderTarget &renderTarget, const RenderViewport &viewport, Item *item, int mask, const Region &deviceRegion, const WindowPaintData &data, const std::function<bool(Item *)> &filter, const std::function<bool(Item *)> &holeFilter)
+{
+    if (!m_image || deviceRegion.isEmpty()) {
+        return true;
+    }
+
+    RenderContext renderContext{
+        .rootTransform = data.toMatrix(viewport.scale()),
+        .bufferClip = viewport.transform().map(deviceRegion & renderTarget.transformedRect(), renderTarget.transformedSize()),
+        .renderTargetScale = viewport.scale(),
+        .viewportOrigin = viewport.scaledRenderRect().topLeft(),
+        .renderOffset = viewport.renderOffset(),
+        .bufferTransform = viewport.transform(),
+        .transformedSize = renderTarget.transformedSize(),
+        .brightness = data.brightness(),
+    };
+
+    renderContext.transformStack.push(QMatrix4x4());
+    renderContext.opacityStack.push(data.opacity());
+
+    createRenderNode(item, &renderContext, filter, holeFilter);
+    return true;
+}
+
+static std::optional<ItemRendererSoftware::RenderQuad> mapQuad(const WindowQuad &quad, const ItemRendererSoftware::RenderContext *context, const QImage &image)
+{
+    const qreal scale = context->renderTargetScale;
+    const QMatrix4x4 &transform = context->transformStack.top();
+    const QSizeF bounds(context->transformedSize);
+
+    const auto toBuffer = [&](const WindowVertex &vertex) {
+        const QPointF position(std::round(vertex.x() * scale), std::round(vertex.y() * scale));
+        const QPointF device = transform.map(position) - context->viewportOrigin + context->renderOffset;
+        return context->bufferTransform.map(device, bounds);
+    };
+
+    const QPointF topLeft = toBuffer(quad[0]);
+    const QPointF topRight = toBuffer(quad[1]);
+    const QPointF bottomRight = toBuffer(quad[2]);
+    const QPointF bottomLeft = toBuffer(quad[3]);
+
+    const QPointF horizontal = topRight - topLeft;
+    const QPointF vertical = bottomLeft - topLeft;
+    const double determinant = horizontal.x() * vertical.y() - horizontal.y() * vertical.x();
+    if (std::abs(determinant) < 1e-9) {
+        return std::nullopt;
+    }
+
+    ItemRendererSoftware::RenderQuad renderQuad;
+
+    // Invert the mapping from the quad parameters to the buffer coordinates.
+    renderQuad.sx = vertical.y() / determinant;
+    renderQuad.sy = -vertical.x() / determinant;
+    renderQuad.s0 = -(topLeft.x() * renderQuad.sx + topLeft.y() * renderQuad.sy);
+    renderQuad.tx = -horizontal.y() / determinant;
+    renderQuad.ty = horizontal.x() / determinant;
+    renderQuad.t0 = -(topLeft.x() * renderQuad.tx + topLeft.y() * renderQuad.ty);
+
+    const QPointF texOrigin(quad[0].u(), quad[0].v());
+    const QPointF texHorizontal = QPointF(quad[1].u(), quad[1].v()) - texOrigin;
+    const QPointF texVertical = QPointF(quad[3].u(), quad[3].v()) - texOrigin;
+
+    renderQuad.u0 = texOrigin.x() + renderQuad.s0 * texHorizontal.x() + renderQuad.t0 * texVertical.x();
+    renderQuad.ux = renderQuad.sx * texHorizontal.x() + renderQuad.tx * texVertical.x();
+    renderQuad.uy = renderQuad.sy * texHorizontal.x() + renderQuad.ty * texVertical.x();
+    renderQuad.v0 = texOrigin.y() + renderQuad.s0 * texHorizontal.y() + renderQuad.t0 * texVertical.y();
+    renderQuad.vx = renderQuad.sx * texHorizontal.y() + renderQuad.tx * texVertical.y();
+    renderQuad.vy = renderQuad.sy * texHorizontal.y() + renderQuad.ty * texVertical.y();
+
+    const RectF boundingRect(QPointF(std::min({topLeft.x(), topRight.x(), bottomRight.x(), bottomLeft.x()}),
+                                     std::min({topLeft.y(), topRight.y(), bottomRight.y(), bottomLeft.y()})),
+                             QPointF(std::max({topLeft.x(), topRight.x(), bottomRight.x(), bottomLeft.x()}),
+                                     std::max({topLeft.y(), topRight.y(), bottomRight.y(), bottomLeft.y()})));
+
+    static constexpr double epsilon = 1e-6;
+    renderQuad.axisAligned = (std::abs(horizontal.y()) < epsilon && std::abs(vertical.x()) < epsilon)
+        || (std::abs(horizontal.x()) < epsilon && std::abs(vertical.y()) < epsilon);
+    renderQuad.bounds = (renderQuad.axisAligned ? boundingRect.rounded() : boundingRect.roundedOut()) & context->bufferClip.boundingRect();
+    if (renderQuad.bounds.isEmpty()) {
+        return std::nullopt;
+    }
+
+    if (!image.isNull()) {
+        const RectF texelRect(QPointF(std::min({quad[0].u(), quad[1].u(), quad[2].u(), quad[3].u()}),
+                                      std::min({quad[0].v(), quad[1].v(), quad[2].v(), quad[3].v()})),
+                              QPointF(std::max({quad[0].u(), quad[1].u(), quad[2].u(), quad[3].u()}),
+                                      std::max({quad[0].v(), quad[1].v(), quad[2].v(), quad[3].v()})));
+        renderQuad.texelBounds = texelRect.roundedOut() & Rect(image.rect());
+        if (renderQuad.texelBounds.isEmpty()) {
+            return std::nullopt;
+        }
+
+        // Pixels that map 1:1 onto texels are copied without resampling.
+        if (std::abs(renderQuad.ux - 1) < epsilon && std::abs(renderQuad.uy) < epsilon
+            && std::abs(renderQuad.vx) < epsilon && std::abs(renderQuad.vy - 1) < epsilon) {
+            const QPoint offset(std::round(renderQuad.u0), std::round(renderQuad.v0));
+            if (std::abs(renderQuad.u0 - offset.x()) < 1e-3 && std::abs(renderQuad.v0 - offset.y()) < 1e-3) {
+                renderQuad.copyOffset = offset;
+            }
+        }
+    }
+
+    return renderQuad;
+}
+
+static QList<ItemRendererSoftware::RenderQuad> mapQuads(const WindowQuadList &quads, const ItemRendererSoftware::RenderContext *context, const QImage &image = QImage())
+{
+    QList<ItemRendererSoftware::RenderQuad> renderQuads;
+    renderQuads.reserve(quads.size());
+    for (const WindowQuad &quad : quads) {
+        if (const auto renderQuad = mapQuad(quad, context, image)) {
+            renderQuads.append(*renderQuad);
+        }
+    }
+    return renderQuads;
+}
+
+static quint32 premultipliedColor(const QColor &color, qreal opacity)
+{
+    const qreal alpha = color.alphaF() * opacity;
+    return qRgba(std::round(color.redF() * alpha * 255),
+                 std::round(color.greenF() * alpha * 255),
+                 std::round(color.blueF() * alpha * 255),
+                 std::round(alpha * 255));
+}
+
+void ItemRendererSoftware::createRenderNode(Item *item, RenderContext *context, const std::function<bool(Item *)> &filter, const std::function<bool(Item *)> &holeFilter)
+{
+    bool hole = false;
+    if (filter && filter(item)) {
+        if (!holeFilter || !holeFilter(item)) {
+            return;
+        }
+        hole = true;
+    }
+    const QList<Item *> sortedChildItems = item->sortedChildItems();
+
+    const qreal scale = context->renderTargetScale;
+    const auto logicalPosition = QVector2D(item->position().x(), item->position().y());
+
+    QMatrix4x4 matrix;
+    matrix.translate(roundVector(logicalPosition * scale).toVector3D());
+    if (context->transformStack.size() == 1) {
+        matrix *= context->rootTransform;
+    }
+    if (!item->transform().isIdentity()) {
+        matrix.scale(scale, scale);
+        matrix *= item->transform();
+        matrix.scale(1 / scale, 1 / scale);
+    }
+    context->transformStack.push(context->transformStack.top() * matrix);
+    context->opacityStack.push(context->opacityStack.top() * item->opacity());
+
+    for (Item *childItem : sortedChildItems) {
+        if (childItem->z() >= 0) {
+            break;
+        }
+        if (childItem->explicitVisible()) {
+            createRenderNode(childItem, context, filter, holeFilter);
+        }
+    }
+
+    item->preprocess();
+
+    const QImage *image = nullptr;
+    bool hasAlpha = true;
+    if (auto shadowItem = qobject_cast<ShadowItem *>(item)) {
+        if (auto ninePatch = static_cast<const NinePatchSoftware *>(shadowItem->ninePatch())) {
+            image = &ninePatch->image();
+        }
+    } else if (auto decorationItem = qobject_cast<DecorationItem *>(item)) {
+        if (auto atlas = static_cast<const AtlasSoftware *>(decorationItem->atlas())) {
+            image = &atlas->image();
+        }
+    } else if (auto surfaceItem = qobject_cast<SurfaceItem *>(item)) {
+        if (auto texture = static_cast<const TextureSoftware *>(surfaceItem->texture())) {
+            image = &texture->image();
+            hasAlpha = surfaceItem->hasAlphaChannel();
+        }
+    } else if (auto imageItem = qobject_cast<ImageItem *>(item)) {
+        if (auto texture = static_cast<const TextureSoftware *>(imageItem->texture())) {
+            image = &texture->image();
+            hasAlpha = texture->image().hasAlphaChannel();
+        }
+    } else if (auto borderItem = qobject_cast<OutlinedBorderItem *>(item)) {
+        const BorderOutline outline = borderItem->outline();
+        const quint32 color = premultipliedColor(outline.color(), context->opacityStack.top());
+        if (!hole && qAlpha(color)) {
+            QList<RenderQuad> quads = mapQuads(item->quads(), context);
+            if (!quads.isEmpty()) {
+                // The corner quads also cover a part of the area inside the border.
+                const int thickness = std::round(outline.thickness() * scale);
+                const RectF outerRect = borderItem->rect().scaled(scale).rounded();
+                const RectF innerRect = outerRect.adjusted(thickness, thickness, -thickness, -thickness);
+                const QMatrix4x4 &transform = context->transformStack.top();
+                const RectF deviceInnerRect = transform.mapRect(innerRect).translated(-context->viewportOrigin + context->renderOffset);
+                Region clip = context->bufferClip;
+                if (innerRect.isValid()) {
+                    clip -= context->bufferTransform.map(deviceInnerRect, QSizeF(context->transformedSize)).roundedIn();
+                }
+
+                m_renderNodes.append(RenderNode{
+                    .type = RenderNode::Type::Color,
+                    .color = color,
+                    .clip = clip,
+                    .quads = quads,
+                });
+            }
+        }
+    }
+
+    if (image && !image->isNull()) {
+        const PixelModulation modulation = PixelModulation::fromOpacity(context->opacityStack.top(), context->brightness);
+        if (hole || modulation.alpha > 0) {
+            QList<RenderQuad> quads = mapQuads(item->quads(), context, *image);
+            if (!quads.isEmpty()) {
+                m_renderNodes.append(RenderNode{
+                    .type = hole ? RenderNode::Type::Clear : RenderNode::Type::Texture,
+                    .image = image,
+                    .opaque = !hasAlpha,
+                    .modulation = modulation,
+                    .clip = context->bufferClip,
+                    .quads = quads,
+                });
+            }
+        }
+    }
+
+    for (Item *childItem : sortedChildItems) {
+        if (childItem->z() < 0) {
+            continue;
+        }
+        if (childItem->explicitVisible()) {
+            createRenderNode(childItem, context, filter, holeFilter);
+        }
+    }
+
+    context->transformStack.pop();
+    context->opacityStack.pop();
+}
+
+/**
+ * Narrows the span [@a begin, @a end) of pixel centers in a row so that the quad parameter
+ * @c{c0 + cx * x} is in the range [0, 1).
+ */
+static void clipSpan(double c0, double cx, double &begin, double &end)
+{
+    if (std::abs(cx) < 1e-12) {
+        if (c0 < 0 || c0 >= 1) {
+            end = begin;
+        }
+        return;
+    }
+
+    double from = -c0 / cx;
+    double to = (1 - c0) / cx;
+    if (from > to) {
+        std::swap(from, to);
+    }
+    begin = std::max(begin, from);
+    end = std::min(end, to);
+}
+
+void ItemRendererSoftware::rasterize(uchar *bits, qsizetype stride, const Rect &band) const
+{
+    thread_local QList<quint32> scratch;
+
+    const auto scanLine = [bits, stride](int y) {
+        return reinterpret_cast<quint32 *>(bits + y * stride);
+    };
+
+    for (const RenderNode &node : m_renderNodes) {
+        const Region clip = node.clip & band;
+        if (clip.isEmpty()) {
+            continue;
+        }
+
+        if (node.quads.isEmpty()) {
+            if (node.type == RenderNode::Type::Clear) {
+                for (const Rect &rect : clip.rects()) {
+                    for (int y = rect.top(); y < rect.bottom(); ++y) {
+                        std::fill_n(scanLine(y) + rect.left(), rect.width(), 0);
+                    }
+                }
+            }
+            continue;
+        }
+
+        if (node.type == RenderNode::Type::Color) {
+            scratch.fill(node.color, band.width());
+        } else {
+            scratch.resize(band.width());
+        }
+
+        const QImage *image = node.image;
+        for (const RenderQuad &quad : node.quads) {
+            const Rect quadBounds = quad.bounds & band;
+            if (quadBounds.isEmpty()) {
+                continue;
+            }
+
+            for (const Rect &rect : clip.rects()) {
+                const Rect area = rect & quadBounds;
+                if (area.isEmpty()) {
+                    continue;
+                }
+
+                for (int y = area.top(); y < area.bottom(); ++y) {
+                    const double center = y + 0.5;
+
+                    int begin = area.left();
+                    int end = area.right();
+                    if (!quad.axisAligned) {
+                        double from = begin + 0.5;
+                        double to = end + 0.5;
+                        clipSpan(quad.s0 + quad.sy * center, quad.sx, from, to);
+                        clipSpan(quad.t0 + quad.ty * center, quad.tx, from, to);
+                        begin = std::max<int>(begin, std::ceil(from - 0.5));
+                        end = std::min<int>(end, std::ceil(to - 0.5));
+                    }
+                    if (begin >= end) {
+                        continue;
+                    }
+
+                    quint32 *dst = scanLine(y) + begin;
+                    const int count = end - begin;
+
+                    switch (node.type) {
+                    case RenderNode::Type::Clear:
+                        std::fill_n(dst, count, 0);
+                        break;
+                    case RenderNode::Type::Color:
+                        blendRow(dst, scratch.constData(), count, false, PixelModulation{});
+                        break;
+                    case RenderNode::Type::Texture: {
+                        const Rect &texels = quad.texelBounds;
+                        if (quad.copyOffset) {
+                            const int sourceY = y + quad.copyOffset->y();
+                            const int sourceBegin = std::max(begin + quad.copyOffset->x(), texels.left());
+                            const int sourceEnd = std::min(end + quad.copyOffset->x(), texels.right());
+                            if (sourceY >= texels.top() && sourceY < texels.bottom() && sourceBegin < sourceEnd) {
+                                const auto source = reinterpret_cast<const quint32 *>(image->constScanLine(sourceY)) + sourceBegin;
+                                blendRow(dst + (sourceBegin - begin - quad.copyOffset->x()), source, sourceEnd - sourceBegin, node.opaque, node.modulation);
+                            }
+                        } else if (std::abs(quad.uy) < 1e-9 && std::abs(quad.vx) < 1e-9) {
+                            // Sample at the pixel centers, the texel centers are at half coordinates.
+                            const double v = quad.v0 + quad.vy * center - 0.5;
+                            const double row = std::floor(v);
+                            const int top = std::clamp<int>(row, texels.top(), texels.bottom() - 1);
+                            const int bottom = std::clamp<int>(row + 1, texels.top(), texels.bottom() - 1);
+                            const double u = quad.u0 + quad.ux * (begin + 0.5) - 0.5;
+
+                            scaleRow(scratch.data(), count,
+                                     reinterpret_cast<const quint32 *>(image->constScanLine(top)),
+                                     reinterpret_cast<const quint32 *>(image->constScanLine(bottom)),
+                                     int((v - row) * 256),
+                                     qint32(std::lround(u * 65536)), qint32(std::lround(quad.ux * 65536)),
+                                     texels.left(), texels.right() - 1);
+                            blendRow(dst, scratch.constData(), count, node.opaque, node.modulation);
+                        } else {
+                            for (int i = 0; i < count; ++i) {
+                                const double x = begin + i + 0.5;
+                                scratch[i] = sampleBilinear(image->constBits(), image->bytesPerLine(),
+                                                            quad.u0 + quad.ux * x + quad.uy * center - 0.5,
+                                                            quad.v0 + quad.vx * x + quad.vy * center - 0.5,
+                                                            texels.left(), texels.top(), texels.right() - 1, texels.bottom() - 1);
+                            }
+                            blendRow(dst, scratch.constData(), count, node.opaque, node.modulation);
+                        }
+                        break;
+                    }
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace KWin
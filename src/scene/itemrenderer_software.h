@@ -0,0 +1,118 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "core/output.h"
+#include "scene/itemrenderer.h"
+#include "scene/software/pixelkernels.h"
+
+#include <QImage>
+#include <QList>
+#include <QStack>
+#include <QThreadPool>
+
+#include <optional>
+
+namespace KWin
+{
+
+/**
+ * The ItemRendererSoftware class composites the item tree on the CPU. It's used with the
+ * QPainter compositing backend, i.e. when there is no usable GPU.
+ *
+ * The draw calls are recorded and executed in endFrame(). The damaged region of the render
+ * target is split into horizontal bands that are rasterized in parallel, every band runs all
+ * draw calls in order, so the result doesn't depend on the number of threads.
+ *
+ * Only what the QPainter compositing backend has traditionally supported is implemented, i.e.
+ * there are no rounded corners, saturation adjustments or color management.
+ */
+class KWIN_EXPORT ItemRendererSoftware : public ItemRenderer
+{
+public:
+    /**
+     * The RenderQuad type describes an item quad in the render target buffer coordinates.
+     * The texel coordinates are affine functions of the buffer coordinates, and the quad
+     * parameters s and t are in the range [0, 1) inside the quad.
+     */
+    struct RenderQuad
+    {
+        Rect bounds;
+        bool axisAligned = false;
+        double s0, sx, sy;
+        double t0, tx, ty;
+        double u0, ux, uy;
+        double v0, vx, vy;
+        Rect texelBounds;
+        std::optional<QPoint> copyOffset;
+    };
+
+    struct RenderNode
+    {
+        enum class Type {
+            Clear,
+            Texture,
+            Color,
+        };
+
+        Type type = Type::Texture;
+        const QImage *image = nullptr;
+        quint32 color = 0;
+        bool opaque = false;
+        PixelModulation modulation;
+        Region clip;
+        QList<RenderQuad> quads;
+    };
+
+    struct RenderContext
+    {
+        QStack<QMatrix4x4> transformStack;
+        QStack<qreal> opacityStack;
+        const QMatrix4x4 rootTransform;
+        const Region bufferClip;
+        const qreal renderTargetScale;
+        const QPointF viewportOrigin;
+        const QPoint renderOffset;
+        const OutputTransform bufferTransform;
+        const QSize transformedSize;
+        const qreal brightness;
+    };
+
+    ItemRendererSoftware();
+    ~ItemRendererSoftware() override;
+
+    std::unique_ptr<Texture> createTexture(GraphicsBuffer *buffer, const std::shared_ptr<SyncReleasePoint> &releasePoint) override;
+    std::unique_ptr<Texture> createTexture(const QImage &image) override;
+
+    std::unique_ptr<NinePatch> createNinePatch(const QImage &image) override;
+    std::unique_ptr<NinePatch> createNinePatch(const QImage &topLeftPatch,
+                                               const QImage &topPatch,
+                                               const QImage &topRightPatch,
+                                               const QImage &rightPatch,
+                                               const QImage &bottomRightPatch,
+                                               const QImage &bottomPatch,
+                                               const QImage &bottomLeftPatch,
+                                               const QImage &leftPatch) override;
+
+    std::unique_ptr<Atlas> createAtlas(const QList<QImage> &sprites) override;
+
+    void beginFrame(const RenderTarget &renderTarget, const RenderViewport &viewport) override;
+    void endFrame() override;
+
+    void renderBackground(const RenderTarget &renderTarget, const RenderViewport &viewport, const Region &deviceRegion) override;
+    bool renderItem(const RenderTarget &renderTarget, const RenderViewport &viewport, Item *item, int mask, const Region &deviceRegion, const WindowPaintData &data, const std::function<bool(Item *)> &filter, const std::function<bool(Item *)> &holeFilter) override;
+
+private:
+    void createRenderNode(Item *item, RenderContext *context, const std::function<bool(Item *)> &filter, const std::function<bool(Item *)> &holeFilter);
+    void rasterize(uchar *bits, qsizetype stride, const Rect &band) const;
+
+    QImage *m_image = nullptr;
+    QList<RenderNode> m_renderNodes;
+    QThreadPool m_threadPool;
+};
+
+} // namespace KWin
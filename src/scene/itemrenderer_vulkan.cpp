@@ -0,0 +1,865 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "scene/itemrenderer_vulkan.h"
+#include "core/pixelgrid.h"
+#include "core/rendertarget.h"
+#include "core/renderviewport.h"
+#include "core/syncobjtimeline.h"
+#include "effect/effect.h"
+#include "scene/decorationitem.h"
+#include "scene/imageitem.h"
+#include "scene/outlinedborderitem.h"
+#include "scene/shadowitem.h"
+#include "scene/surfaceitem.h"
+#include "scene/vulkan/atlas.h"
+#include "scene/vulkan/ninepatch.h"
+#include "scene/vulkan/texture.h"
+#include "scene/workspacescene.h"
+#include "vulkan/vulkan_device.h"
+#include "vulkan/vulkan_logging.h"
+#include "vulkan/vulkan_texture.h"
+
+#include <poll.h>
+
+namespace KWin
+{
+
+static const vk::ImageSubresourceRange s_colorSubresourceRange{
+    vk::ImageAspectFlagBits::eColor,
+    0,
+    1,
+    0,
+    1,
+};
+
+ItemRendererVulkan::ItemRendererVulkan(VulkanDevice *device)
+    : m_device(device)
+    , m_pipelineManager(PipelineManagerVulkan::create(device))
+{
+}
+
+ItemRendererVulkan::~ItemRendererVulkan()
+{
+    // The frame resources may still be in use by the GPU.
+    m_device->waitIdle();
+}
+
+std::unique_ptr<Texture> ItemRendererVulkan::createTexture(GraphicsBuffer *buffer, const std::shared_ptr<SyncReleasePoint> &releasePoint)
+{
+    return BufferTextureVulkan::create(m_device, buffer, releasePoint);
+}
+
+std::unique_ptr<Texture> ItemRendererVulkan::createTexture(const QImage &image)
+{
+    return ImageTextureVulkan::create(m_device, image);
+}
+
+std::unique_ptr<NinePatch> ItemRendererVulkan::createNinePatch(const QImage &image)
+{
+    return NinePatchVulkan::create(m_device, image);
+}
+
+std::unique_ptr<NinePatch> ItemRendererVulkan::createNinePatch(const QImage &topLeftPatch,
+                                                               const QImage &topPatch,
+                                                               const QImage &topRightPatch,
+                                                               const QImage &rightPatch,
+                                                               const QImage &bottomRightPatch,
+                                                               const QImage &bottomPatch,
+                                                               const QImage &bottomLeftPatch,
+                                                               const QImage &leftPatch)
+{
+    return NinePatchVulkan::create(m_device, topLeftPatch, topPatch, topRightPatch, rightPatch, bottomRightPatch, bottomPatch, bottomLeftPatch, leftPatch);
+}
+
+std::unique_ptr<Atlas> ItemRendererVulkan::createAtlas(const QList<QImage> &sprites)
+{
+    return AtlasVulkan::create(m_device, sprites);
+}
+
+void ItemRendererVulkan::waitForFrame(FrameResources *frame)
+{
+    if (frame->completionFence.isValid()) {
+        pollfd pfd{
+            .fd = frame->completionFence.get(),
+            .events = POLLIN,
+            .revents = 0,
+        };
+        while (poll(&pfd, 1, -1) < 0 && (errno == EINTR || errno == EAGAIN)) {
+        }
+        frame->completionFence.reset();
+    }
+
+    frame->renderTargetView = vk::raii::ImageView(nullptr);
+    frame->descriptorSets.clear();
+    for (const vk::raii::DescriptorPool &pool : frame->descriptorPools) {
+        pool.reset();
+    }
+    frame->currentDescriptorPool = 0;
+    frame->retiredVertexBuffers.clear();
+    frame->vertexCount = 0;
+    frame->images.clear();
+    frame->buffers.clear();
+}
+
+void ItemRendererVulkan::discardFrame()
+{
+    // The previous frame has not been submitted, e.g. because painting failed.
+    m_commandBuffer = vk::raii::CommandBuffer(nullptr);
+    m_renderTarget = nullptr;
+    m_renderTargetReleasePoint.reset();
+    m_releasePoints.clear();
+    m_externalImages.clear();
+}
+
+void ItemRendererVulkan::beginFrame(const RenderTarget &renderTarget, const RenderViewport &viewport)
+{
+    if (*m_commandBuffer) {
+        discardFrame();
+    }
+
+    VulkanTexture *texture = renderTarget.vulkanTexture();
+    Q_ASSERT(texture);
+
+    m_frameIndex = (m_frameIndex + 1) % m_frames.size();
+    m_frame = &m_frames[m_frameIndex];
+    waitForFrame(m_frame);
+
+    if (m_pipelineManager && m_prewarmedFormat != texture->format()) {
+        m_prewarmedFormat = texture->format();
+        m_pipelineManager->prewarm(PipelineManagerVulkan::commonPipelines(texture->format()));
+    }
+
+    m_frame->renderTargetView = texture->createView();
+    if (!*m_frame->renderTargetView) {
+        return;
+    }
+
+    m_commandBuffer = m_device->graphicsQueue()->createCommandBuffer();
+    if (!*m_commandBuffer) {
+        return;
+    }
+    m_commandBuffer.begin(vk::CommandBufferBeginInfo{vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+
+    m_renderTarget = texture;
+    m_renderTargetReleasePoint = renderTarget.releasePoint();
+
+    // The render target is a dmabuf, it has to be acquired from the external queue family.
+    const vk::ImageMemoryBarrier2 acquireBarrier{
+        vk::PipelineStageFlagBits2::eAllCommands,
+        vk::AccessFlagBits2::eMemoryWrite | vk::AccessFlagBits2::eMemoryRead,
+        vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+        vk::AccessFlagBits2::eColorAttachmentWrite | vk::AccessFlagBits2::eColorAttachmentRead,
+        vk::ImageLayout::eGeneral,
+        vk::ImageLayout::eGeneral,
+        vk::QueueFamilyExternal,
+        m_device->graphicsQueue()->familyIndex(),
+        texture->handle(),
+        s_colorSubresourceRange,
+    };
+    m_commandBuffer.pipelineBarrier2(vk::DependencyInfo{
+        vk::DependencyFlags{},
+        {},
+        {},
+        acquireBarrier,
+    });
+}
+
+void ItemRendererVulkan::endFrame()
+{
+    if (!*m_commandBuffer) {
+        discardFrame();
+        return;
+    }
+
+    const uint32_t familyIndex = m_device->graphicsQueue()->familyIndex();
+    std::vector<vk::ImageMemoryBarrier2> releaseBarriers;
+    releaseBarriers.push_back(vk::ImageMemoryBarrier2{
+        vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+        vk::AccessFlagBits2::eColorAttachmentWrite,
+        vk::PipelineStageFlagBits2::eAllCommands,
+        vk::AccessFlagBits2::eMemoryWrite | vk::AccessFlagBits2::eMemoryRead,
+        vk::ImageLayout::eGeneral,
+        vk::ImageLayout::eGeneral,
+        familyIndex,
+        vk::QueueFamilyExternal,
+        m_renderTarget->handle(),
+        s_colorSubresourceRange,
+    });
+    for (const SampledImageVulkan *image : m_externalImages) {
+        releaseBarriers.push_back(vk::ImageMemoryBarrier2{
+            vk::PipelineStageFlagBits2::eFragmentShader,
+            vk::AccessFlagBits2::eShaderSampledRead,
+            vk::PipelineStageFlagBits2::eAllCommands,
+            vk::AccessFlagBits2::eMemoryWrite | vk::AccessFlagBits2::eMemoryRead,
+            vk::ImageLayout::eGeneral,
+            vk::ImageLayout::eGeneral,
+            familyIndex,
+            vk::QueueFamilyExternal,
+            image->texture->handle(),
+            s_colorSubresourceRange,
+        });
+    }
+    m_commandBuffer.pipelineBarrier2(vk::DependencyInfo{
+        vk::DependencyFlags{},
+        {},
+        {},
+        releaseBarriers,
+    });
+
+    const vk::Result result = m_commandBuffer.end();
+    if (result != vk::Result::eSuccess) {
+        qCWarning(KWIN_VULKAN) << "Failed to record the frame command buffer:" << vk::to_string(result);
+        discardFrame();
+        return;
+    }
+
+    // The queue keeps the sampled client buffers referenced until the frame is done, the
+    // images themselves are kept alive by the frame resources.
+    std::optional<FileDescriptor> completionFence = m_device->graphicsQueue()->submit(std::move(m_commandBuffer), FileDescriptor{}, std::exchange(m_frame->buffers, {}));
+    m_commandBuffer = vk::raii::CommandBuffer(nullptr);
+    if (completionFence) {
+        if (m_renderTargetReleasePoint) {
+            m_renderTargetReleasePoint->addReleaseFence(*completionFence);
+        }
+        for (const auto &releasePoint : m_releasePoints) {
+            releasePoint->addReleaseFence(*completionFence);
+        }
+        m_frame->completionFence = std::move(*completionFence);
+    } else {
+        qCWarning(KWIN_VULKAN) << "Failed to submit the frame command buffer";
+    }
+
+    m_renderTarget = nullptr;
+    m_renderTargetReleasePoint.reset();
+    m_releasePoints.clear();
+    m_externalImages.clear();
+}
+
+GLVertex2D *ItemRendererVulkan::allocateVertices(FrameResources *frame, int count)
+{
+    if (frame->vertexCount + count <= frame->vertexCapacity) {
+        GLVertex2D *vertices = frame->vertices + frame->vertexCount;
+        frame->vertexCount += count;
+        return vertices;
+    }
+
+    // The current buffer may be referenced by the recorded commands, keep it until the frame is done.
+    if (*frame->vertexBuffer) {
+        frame->retiredVertexBuffers.emplace_back(std::move(frame->vertexBuffer), std::move(frame->vertexMemory));
+        frame->vertexBuffer = vk::raii::Buffer(nullptr);
+        frame->vertexMemory = vk::raii::DeviceMemory(nullptr);
+        frame->vertices = nullptr;
+    }
+
+    const vk::DeviceSize capacity = std::max<vk::DeviceSize>({1024, frame->vertexCapacity * 2, vk::DeviceSize(count)});
+    const vk::BufferCreateInfo bufferInfo{
+        vk::BufferCreateFlags(),
+        capacity * sizeof(GLVertex2D),
+        vk::BufferUsageFlagBits::eVertexBuffer,
+    };
+    auto memory = m_device->allocateMemory(bufferInfo, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+    if (!*memory) {
+        frame->vertexCapacity = 0;
+        return nullptr;
+    }
+    auto [result, buffer] = m_device->logicalDevice().createBuffer(bufferInfo);
+    if (result != vk::Result::eSuccess) {
+        qCWarning(KWIN_VULKAN) << "Failed to create a vertex buffer:" << vk::to_string(result);
+        frame->vertexCapacity = 0;
+        return nullptr;
+    }
+    buffer.bindMemory(memory, 0);
+
+    // The buffer stays mapped, it's only ever written by the CPU.
+    auto [mapResult, data] = memory.mapMemory(0, bufferInfo.size);
+    if (mapResult != vk::Result::eSuccess) {
+        qCWarning(KWIN_VULKAN) << "Failed to map a vertex buffer:" << vk::to_string(mapResult);
+        frame->vertexCapacity = 0;
+        return nullptr;
+    }
+
+    frame->vertexBuffer = std::move(buffer);
+    frame->vertexMemory = std::move(memory);
+    frame->vertices = static_cast<GLVertex2D *>(data);
+    frame->vertexCapacity = capacity;
+    frame->vertexCount = count;
+    return frame->vertices;
+}
+
+vk::DescriptorSet ItemRendererVulkan::descriptorSet(FrameResources *frame, const SampledImageVulkan *image)
+{
+    const VkImageView view = *image->view;
+    if (auto it = frame->descriptorSets.constFind(view); it != frame->descriptorSets.constEnd()) {
+        return *it;
+    }
+
+    static constexpr uint32_t setsPerPool = 64;
+    const vk::DescriptorSetLayout layout = *m_pipelineManager->descriptorSetLayout();
+
+    vk::raii::DescriptorSet set(nullptr);
+    while (!*set) {
+        if (frame->currentDescriptorPool == frame->descriptorPools.size()) {
+            const vk::DescriptorPoolSize poolSize{
+                vk::DescriptorType::eCombinedImageSampler,
+                setsPerPool,
+            };
+            auto [result, pool] = m_device->logicalDevice().createDescriptorPool(vk::DescriptorPoolCreateInfo{
+                vk::DescriptorPoolCreateFlags(),
+                setsPerPool,
+                poolSize,
+            });
+            if (result != vk::Result::eSuccess) {
+                qCWarning(KWIN_VULKAN) << "Failed to create a descriptor pool:" << vk::to_string(result);
+                return nullptr;
+            }
+            frame->descriptorPools.push_back(std::move(pool));
+        }
+
+        auto [result, sets] = m_device->logicalDevice().allocateDescriptorSets(vk::DescriptorSetAllocateInfo{
+            *frame->descriptorPools[frame->currentDescriptorPool],
+            layout,
+        });
+        if (result == vk::Result::eErrorOutOfPoolMemory || result == vk::Result::eErrorFragmentedPool) {
+            frame->currentDescriptorPool++;
+        } else if (result != vk::Result::eSuccess) {
+            qCWarning(KWIN_VULKAN) << "Failed to allocate a descriptor set:" << vk::to_string(result);
+            return nullptr;
+        } else {
+            set = std::move(sets.front());
+        }
+    }
+
+    // The sampler is immutable, it's part of the descriptor set layout.
+    const vk::DescriptorImageInfo imageInfo{
+        nullptr,
+        view,
+        vk::ImageLayout::eGeneral,
+    };
+    m_device->logicalDevice().updateDescriptorSets(vk::WriteDescriptorSet{
+                                                       *set,
+                                                       0,
+                                                       0,
+                                                       vk::DescriptorType::eCombinedImageSampler,
+                                                       imageInfo,
+                                                   },
+                                                   {});
+
+    // The descriptor sets are freed all at once when the pool is reset.
+    const vk::DescriptorSet handle = set.release();
+    frame->descriptorSets.insert(view, handle);
+    return handle;
+}
+
+void ItemRendererVulkan::acquireImages(const QList<RenderNode> &renderNodes)
+{
+    const uint32_t familyIndex = m_device->graphicsQueue()->familyIndex();
+
+    std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+    for (const RenderNode &renderNode : renderNodes) {
+        if (!renderNode.image || renderNode.paintHole) {
+            continue;
+        }
+        if (m_frame->images.insert(renderNode.image).second && renderNode.buffer) {
+            m_frame->buffers.emplace_back(renderNode.buffer);
+        }
+        if (!renderNode.image->external || std::ranges::contains(m_externalImages, renderNode.image.get())) {
+            continue;
+        }
+        m_externalImages.push_back(renderNode.image.get());
+        imageBarriers.push_back(vk::ImageMemoryBarrier2{
+            vk::PipelineStageFlagBits2::eAllCommands,
+            vk::AccessFlagBits2::eMemoryWrite | vk::AccessFlagBits2::eMemoryRead,
+            vk::PipelineStageFlagBits2::eFragmentShader,
+            vk::AccessFlagBits2::eShaderSampledRead,
+            vk::ImageLayout::eGeneral,
+            vk::ImageLayout::eGeneral,
+            vk::QueueFamilyExternal,
+            familyIndex,
+            renderNode.image->texture->handle(),
+            s_colorSubresourceRange,
+        });
+    }
+
+    // The previous render pass may still write to the render target.
+    const vk::MemoryBarrier2 attachmentBarrier{
+        vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+        vk::AccessFlagBits2::eColorAttachmentWrite,
+        vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+        vk::AccessFlagBits2::eColorAttachmentWrite | vk::AccessFlagBits2::eColorAttachmentRead,
+    };
+    m_commandBuffer.pipelineBarrier2(vk::DependencyInfo{
+        vk::DependencyFlags{},
+        attachmentBarrier,
+        {},
+        imageBarriers,
+    });
+}
+
+void ItemRendererVulkan::beginRendering(const RenderTarget &renderTarget)
+{
+    const QSize size = renderTarget.size();
+    const vk::RenderingAttachmentInfo colorAttachment{
+        *m_frame->renderTargetView,
+        vk::ImageLayout::eGeneral,
+        vk::ResolveModeFlagBits::eNone,
+        nullptr,
+        vk::ImageLayout::eUndefined,
+        vk::AttachmentLoadOp::eLoad,
+        vk::AttachmentStoreOp::eStore,
+    };
+    m_commandBuffer.beginRendering(vk::RenderingInfo{
+        vk::RenderingFlags(),
+        vk::Rect2D(vk::Offset2D(0, 0), vk::Extent2D(size.width(), size.height())),
+        1,
+        0,
+        colorAttachment,
+    });
+    m_commandBuffer.setViewport(0, vk::Viewport(0, 0, size.width(), size.height(), 0, 1));
+}
+
+static bool isSoftwareClipping(const ItemRendererVulkan::RenderContext *context)
+{
+    return context->deviceClip != Region::infinite() && !context->hardwareClipping;
+}
+
+static RenderGeometry clipQuads(const Item *item, const ItemRendererVulkan::RenderContext *context)
+{
+    const WindowQuadList quads = item->quads();
+
+    // Item to world translation.
+    const QPointF worldTranslation = context->transformStack.top().map(QPointF(0., 0.));
+    const qreal scale = context->renderTargetScale;
+
+    RenderGeometry geometry;
+    geometry.reserve(quads.count() * 6);
+
+    // split all quads in bounding rect with the actual rects in the region
+    for (const WindowQuad &quad : std::as_const(quads)) {
+        if (isSoftwareClipping(context)) {
+            // Scale to device coordinates, rounding as needed.
+            const RectF deviceBounds = quad.bounds().scaled(scale).rounded();
+
+            for (const Rect &deviceClipRect : context->deviceClip.rects()) {
+                const RectF relativeDeviceClipRect = RectF(deviceClipRect).translated(-worldTranslation + context->viewportOrigin - context->renderOffset);
+                const RectF intersected = relativeDeviceClipRect.intersected(deviceBounds);
+                if (intersected.isValid()) {
+                    if (deviceBounds == intersected) {
+                        // case 1: completely contains, include and do not check other rects
+                        geometry.appendWindowQuad(quad, scale);
+                        break;
+                    }
+                    // case 2: intersection
+                    geometry.appendSubQuad(quad, intersected, scale);
+                }
+            }
+        } else {
+            geometry.appendWindowQuad(quad, scale);
+        }
+    }
+
+    return geometry;
+}
+
+static QMatrix4x4 textureMatrix(const SampledImageVulkan *image)
+{
+    // Vulkan images are stored top to bottom, so the texture coordinates only need to be normalized.
+    const QSize size = image->texture->size();
+    QMatrix4x4 matrix;
+    matrix.scale(1.0 / size.width(), 1.0 / size.height());
+    return matrix;
+}
+
+static RenderGeometry mappedGeometry(RenderGeometry geometry, const SampledImageVulkan *image)
+{
+    geometry.postProcessTextureCoordinates(textureMatrix(image));
+    return geometry;
+}
+
+bool ItemRendererVulkan::createRenderNode(Item *item, RenderContext *context, const std::function<bool(Item *)> &filter, const std::function<bool(Item *)> &holeFilter)
+{
+    bool hole = false;
+    if (filter && filter(item)) {
+        if (!holeFilter || !holeFilter(item)) {
+            return true;
+        }
+        hole = true;
+    }
+    const QList<Item *> sortedChildItems = item->sortedChildItems();
+
+    const auto logicalPosition = QVector2D(item->position().x(), item->position().y());
+    const auto scale = context->renderTargetScale;
+
+    QMatrix4x4 matrix;
+    matrix.translate(roundVector(logicalPosition * scale).toVector3D());
+    if (context->transformStack.size() == 1) {
+        matrix *= context->rootTransform;
+    }
+    if (!item->transform().isIdentity()) {
+        matrix.scale(scale, scale);
+        matrix *= item->transform();
+        matrix.scale(1 / scale, 1 / scale);
+    }
+    context->transformStack.push(context->transformStack.top() * matrix);
+
+    context->opacityStack.push(context->opacityStack.top() * item->opacity());
+
+    for (Item *childItem : sortedChildItems) {
+        if (childItem->z() >= 0) {
+            break;
+        }
+        if (childItem->explicitVisible()) {
+            if (!createRenderNode(childItem, context, filter, holeFilter)) {
+                return false;
+            }
+        }
+    }
+
+    if (const BorderRadius radius = item->borderRadius(); !radius.isNull()) {
+        const RectF nativeRect = item->rect().scaled(context->renderTargetScale).rounded();
+        const BorderRadius nativeRadius = radius.scaled(context->renderTargetScale).rounded();
+        context->cornerStack.push({
+            .box = nativeRect,
+            .radius = nativeRadius,
+        });
+    } else if (!context->cornerStack.isEmpty()) {
+        const auto &top = std::as_const(context->cornerStack).top();
+        context->cornerStack.push({
+            .box = matrix.inverted().mapRect(top.box),
+            .radius = top.radius,
+        });
+    }
+
+    item->preprocess();
+
+    const RenderGeometry geometry = clipQuads(item, context);
+
+    if (auto shadowItem = qobject_cast<ShadowItem *>(item)) {
+        if (!geometry.isEmpty()) {
+            const auto ninePatch = static_cast<NinePatchVulkan *>(shadowItem->ninePatch());
+            if (ninePatch && ninePatch->texture()) {
+                const auto &image = ninePatch->texture()->image();
+                context->renderNodes.append(RenderNode{
+                    .traits = PipelineTrait::MapTexture,
+                    .image = image,
+                    .geometry = mappedGeometry(geometry, image.get()),
+                    .transformMatrix = context->transformStack.top(),
+                    .opacity = context->opacityStack.top(),
+                    .hasAlpha = true,
+                    .paintHole = hole,
+                });
+            }
+        }
+    } else if (auto decorationItem = qobject_cast<DecorationItem *>(item)) {
+        if (!geometry.isEmpty()) {
+            auto atlas = static_cast<const AtlasVulkan *>(decorationItem->atlas());
+            if (atlas && atlas->texture()) {
+                const auto &image = atlas->texture()->image();
+                context->renderNodes.append(RenderNode{
+                    .traits = PipelineTrait::MapTexture,
+                    .image = image,
+                    .geometry = mappedGeometry(geometry, image.get()),
+                    .transformMatrix = context->transformStack.top(),
+                    .opacity = context->opacityStack.top(),
+                    .hasAlpha = true,
+                    .paintHole = hole,
+                });
+            }
+        }
+    } else if (auto surfaceItem = qobject_cast<SurfaceItem *>(item)) {
+        auto texture = static_cast<TextureVulkan *>(surfaceItem->texture());
+        if (texture && texture->image()) {
+            if (!geometry.isEmpty()) {
+                RenderNode &renderNode = context->renderNodes.emplace_back(RenderNode{
+                    .traits = PipelineTrait::MapTexture,
+                    .image = texture->image(),
+                    .buffer = texture->buffer(),
+                    .geometry = mappedGeometry(geometry, texture->image().get()),
+                    .transformMatrix = context->transformStack.top(),
+                    .opacity = context->opacityStack.top(),
+                    .hasAlpha = surfaceItem->hasAlphaChannel(),
+                    .bufferReleasePoint = texture->releasePoint(),
+                    .paintHole = hole,
+                });
+
+                if (!context->cornerStack.isEmpty()) {
+                    const auto &top = context->cornerStack.top();
+
+                    renderNode.traits |= PipelineTrait::RoundedCorners;
+                    renderNode.hasAlpha = true;
+                    renderNode.box = QVector4D(top.box.x() + top.box.width() * 0.5,
+                                               top.box.y() + top.box.height() * 0.5,
+                                               top.box.width() * 0.5,
+                                               top.box.height() * 0.5);
+                    renderNode.borderRadius = top.radius.toVector();
+                }
+            }
+        }
+    } else if (auto imageItem = qobject_cast<ImageItem *>(item)) {
+        if (!geometry.isEmpty()) {
+            auto texture = static_cast<TextureVulkan *>(imageItem->texture());
+            if (texture && texture->image()) {
+                context->renderNodes.append(RenderNode{
+                    .traits = PipelineTrait::MapTexture,
+                    .image = texture->image(),
+                    .geometry = mappedGeometry(geometry, texture->image().get()),
+                    .transformMatrix = context->transformStack.top(),
+                    .opacity = context->opacityStack.top(),
+                    .hasAlpha = imageItem->image().hasAlphaChannel(),
+                    .bufferReleasePoint = texture->releasePoint(),
+                    .paintHole = hole,
+                });
+            }
+        }
+    } else if (auto borderItem = qobject_cast<OutlinedBorderItem *>(item)) {
+        if (!geometry.isEmpty()) {
+            const BorderOutline outline = borderItem->outline();
+            const int thickness = std::round(outline.thickness() * context->renderTargetScale);
+            const RectF outerRect = borderItem->rect().scaled(context->renderTargetScale).rounded();
+            const RectF innerRect = outerRect.adjusted(thickness, thickness, -thickness, -thickness);
+            if (innerRect.isValid()) {
+                context->renderNodes.append(RenderNode{
+                    .traits = PipelineTrait::Border,
+                    .geometry = geometry,
+                    .transformMatrix = context->transformStack.top(),
+                    .opacity = context->opacityStack.top(),
+                    .hasAlpha = true,
+                    .box = QVector4D(innerRect.x() + innerRect.width() * 0.5,
+                                     innerRect.y() + innerRect.height() * 0.5,
+                                     innerRect.width() * 0.5,
+                                     innerRect.height() * 0.5),
+                    .borderRadius = outline.radius().scaled(context->renderTargetScale).rounded().toVector(),
+                    .borderThickness = thickness,
+                    .borderColor = outline.color(),
+                    .paintHole = hole,
+                });
+            }
+        }
+    }
+
+    for (Item *childItem : sortedChildItems) {
+        if (childItem->z() < 0) {
+            continue;
+        }
+        if (childItem->explicitVisible()) {
+            if (!createRenderNode(childItem, context, filter, holeFilter)) {
+                return false;
+            }
+        }
+    }
+
+    context->transformStack.pop();
+    context->opacityStack.pop();
+    if (!context->cornerStack.isEmpty()) {
+        context->cornerStack.pop();
+    }
+    return true;
+}
+
+void ItemRendererVulkan::renderBackground(const RenderTarget &renderTarget, const RenderViewport &viewport, const Region &deviceRegion)
+{
+    if (!*m_commandBuffer) {
+        return;
+    }
+
+    const auto clipped = deviceRegion & renderTarget.transformedRect();
+    if (clipped.isEmpty()) {
+        return;
+    }
+
+    std::vector<vk::ClearRect> clearRects;
+    for (const Rect &deviceRect : clipped.rects()) {
+        const auto bufferRect = viewport.transform().map(deviceRect, renderTarget.transformedSize());
+        clearRects.push_back(vk::ClearRect{
+            vk::Rect2D(vk::Offset2D(bufferRect.x(), bufferRect.y()), vk::Extent2D(bufferRect.width(), bufferRect.height())),
+            0,
+            1,
+        });
+    }
+
+    acquireImages({});
+    beginRendering(renderTarget);
+    m_commandBuffer.clearAttachments(vk::ClearAttachment{
+                                         vk::ImageAspectFlagBits::eColor,
+                                         0,
+                                         vk::ClearValue(vk::ClearColorValue(0.0f, 0.0f, 0.0f, 0.0f)),
+                                     },
+                                     clearRects);
+    m_commandBuffer.endRendering();
+}
+
+static PipelinePushConstants pushConstants(const QMatrix4x4 &mvp, const QVector4D &modulation, const QVector4D &geometryColor, const QVector4D &box, const QVector4D &cornerRadius)
+{
+    PipelinePushConstants constants;
+    std::copy_n(mvp.constData(), 16, constants.modelViewProjectionMatrix);
+    const QVector4D vectors[] = {modulation, geometryColor, box, cornerRadius};
+    float *destinations[] = {constants.modulation, constants.geometryColor, constants.box, constants.cornerRadius};
+    for (int i = 0; i < 4; ++i) {
+        destinations[i][0] = vectors[i].x();
+        destinations[i][1] = vectors[i].y();
+        destinations[i][2] = vectors[i].z();
+        destinations[i][3] = vectors[i].w();
+    }
+    return constants;
+}
+
+static QVector4D premultipliedColor(const QColor &color)
+{
+    return QVector4D(color.redF() * color.alphaF(), color.greenF() * color.alphaF(), color.blueF() * color.alphaF(), color.alphaF());
+}
+
+bool ItemRendererVulkan::renderItem(const RenderTarget &renderTarget, const RenderViewport &viewport, Item *item, int mask, const Region &deviceRegion, const WindowPaintData &data, const std::function<bool(Item *)> &filter, const std::function<bool(Item *)> &holeFilter)
+{
+    if (deviceRegion.isEmpty()) {
+        return true;
+    }
+    if (!*m_commandBuffer || !m_pipelineManager) {
+        return false;
+    }
+
+    // Unlike OpenGL, the y axis of the Vulkan clip space points down.
+    QMatrix4x4 projectionMatrix;
+    projectionMatrix.scale(1, -1);
+    projectionMatrix *= viewport.projectionMatrix();
+
+    RenderContext renderContext{
+        .projectionMatrix = projectionMatrix,
+        .rootTransform = data.toMatrix(viewport.scale()),
+        .deviceClip = (deviceRegion & renderTarget.transformedRect()),
+        .hardwareClipping = (deviceRegion != Region::infinite() && ((mask & Scene::PAINT_WINDOW_TRANSFORMED) || (mask & Scene::PAINT_SCREEN_TRANSFORMED))) || !viewport.renderOffset().isNull(),
+        .renderTargetScale = viewport.scale(),
+        .viewportOrigin = viewport.scaledRenderRect().topLeft(),
+        .renderOffset = viewport.renderOffset(),
+    };
+
+    renderContext.transformStack.push(QMatrix4x4());
+    renderContext.opacityStack.push(data.opacity());
+
+    if (!createRenderNode(item, &renderContext, filter, holeFilter)) {
+        return false;
+    }
+
+    int totalVertexCount = 0;
+    for (const RenderNode &node : std::as_const(renderContext.renderNodes)) {
+        totalVertexCount += node.geometry.count();
+    }
+    if (totalVertexCount == 0) {
+        return true;
+    }
+
+    GLVertex2D *vertices = allocateVertices(m_frame, totalVertexCount);
+    if (!vertices) {
+        return false;
+    }
+    const int baseVertex = m_frame->vertexCount - totalVertexCount;
+    for (int i = 0, v = 0; i < renderContext.renderNodes.count(); i++) {
+        RenderNode &renderNode = renderContext.renderNodes[i];
+        renderNode.firstVertex = baseVertex + v;
+        renderNode.vertexCount = renderNode.geometry.count();
+        renderNode.geometry.copy(std::span(vertices + v, renderNode.vertexCount));
+        v += renderNode.vertexCount;
+    }
+
+    // The scissor region must be in the render target local coordinate system.
+    const QSize bufferOffset = renderTarget.transform().map(QSize(viewport.renderOffset().x(), viewport.renderOffset().y()));
+    Region scissorRegion = Rect(QPoint(bufferOffset.width(), bufferOffset.height()), renderTarget.size() - 2 * bufferOffset);
+    if (renderContext.hardwareClipping) {
+        scissorRegion &= viewport.transform().map(deviceRegion & renderTarget.transformedRect(), renderTarget.transformedSize());
+    } else {
+        scissorRegion = Rect(QPoint(0, 0), renderTarget.size());
+    }
+    if (scissorRegion.isEmpty()) {
+        return true;
+    }
+
+    std::vector<vk::Rect2D> scissors;
+    for (const Rect &rect : scissorRegion.rects()) {
+        scissors.push_back(vk::Rect2D(vk::Offset2D(rect.x(), rect.y()), vk::Extent2D(rect.width(), rect.height())));
+    }
+
+    acquireImages(renderContext.renderNodes);
+    beginRendering(renderTarget);
+    m_commandBuffer.bindVertexBuffers(0, *m_frame->vertexBuffer, vk::DeviceSize(0));
+
+    const vk::Format format = m_renderTarget->format();
+    vk::Pipeline lastPipeline = nullptr;
+    vk::DescriptorSet lastDescriptorSet = nullptr;
+    for (const RenderNode &renderNode : std::as_const(renderContext.renderNodes)) {
+        PipelineTraits traits = renderNode.traits;
+        if (renderNode.opacity != 1.0 || data.brightness() != 1.0) {
+            traits |= PipelineTrait::Modulate;
+        }
+        if (data.saturation() != 1.0) {
+            traits |= PipelineTrait::AdjustSaturation;
+        }
+
+        PipelineBlendMode blendMode;
+        if (renderNode.paintHole) {
+            traits = (traits & PipelineTrait::RoundedCorners) | PipelineTrait::UniformColor;
+            blendMode = PipelineBlendMode::Hole;
+        } else if (renderNode.hasAlpha || renderNode.opacity < 1.0) {
+            blendMode = PipelineBlendMode::PremultipliedAlpha;
+        } else {
+            blendMode = PipelineBlendMode::None;
+        }
+
+        const vk::Pipeline pipeline = m_pipelineManager->pipeline(PipelineKey{
+            .traits = traits,
+            .blendMode = blendMode,
+            .format = format,
+        });
+        if (!pipeline) {
+            continue;
+        }
+        if (pipeline != lastPipeline) {
+            m_commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+            lastPipeline = pipeline;
+        }
+
+        if (traits & PipelineTrait::MapTexture) {
+            const vk::DescriptorSet set = descriptorSet(m_frame, renderNode.image.get());
+            if (!set) {
+                continue;
+            }
+            if (set != lastDescriptorSet) {
+                m_commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *m_pipelineManager->pipelineLayout(), 0, set, {});
+                lastDescriptorSet = set;
+            }
+        }
+
+        QVector4D geometryColor;
+        if (renderNode.paintHole) {
+            geometryColor = QVector4D(0, 0, 0, 1);
+        } else if (traits & PipelineTrait::Border) {
+            // The blend function expects premultiplied colors.
+            geometryColor = premultipliedColor(renderNode.borderColor);
+        }
+
+        const PipelinePushConstants constants = pushConstants(renderContext.projectionMatrix * renderNode.transformMatrix,
+                                                              QVector4D(renderNode.opacity * data.brightness(), renderNode.opacity, data.saturation(), renderNode.borderThickness),
+                                                              geometryColor,
+                                                              renderNode.box,
+                                                              renderNode.borderRadius);
+        m_commandBuffer.pushConstants<PipelinePushConstants>(*m_pipelineManager->pipelineLayout(),
+                                                             vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment,
+                                                             0,
+                                                             constants);
+
+        for (const vk::Rect2D &scissor : scissors) {
+            m_commandBuffer.setScissor(0, scissor);
+            m_commandBuffer.draw(renderNode.vertexCount, 1, renderNode.firstVertex, 0);
+        }
+
+        if (renderNode.bufferReleasePoint) {
+            m_releasePoints.insert(renderNode.bufferReleasePoint);
+        }
+    }
+
+    m_commandBuffer.endRendering();
+    return true;
+}
+
+} // namespace KWin
@@ -0,0 +1,151 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "core/graphicsbuffer.h"
+#include "scene/borderradius.h"
+#include "scene/itemgeometry.h"
+#include "scene/itemrenderer.h"
+#include "scene/vulkan/pipelinemanager.h"
+#include "utils/filedescriptor.h"
+
+#include <QColor>
+#include <QHash>
+#include <QStack>
+
+#include <array>
+#include <unordered_set>
+
+namespace KWin
+{
+
+class VulkanDevice;
+struct SampledImageVulkan;
+
+/**
+ * The ItemRendererVulkan class renders the item tree with Vulkan. The render target must be a
+ * dmabuf imported with VulkanDevice::importBuffer() and the device must support dynamic
+ * rendering.
+ *
+ * All commands of a frame are recorded in one command buffer that is submitted in endFrame().
+ * The fence that signals the completion of the frame is added to the release point of the
+ * render target, as well as to the release points of the client buffers that were sampled.
+ */
+class KWIN_EXPORT ItemRendererVulkan : public ItemRenderer
+{
+public:
+    struct RenderNode
+    {
+        PipelineTraits traits;
+        std::shared_ptr<SampledImageVulkan> image;
+        GraphicsBuffer *buffer = nullptr;
+        RenderGeometry geometry;
+        QMatrix4x4 transformMatrix;
+        int firstVertex = 0;
+        int vertexCount = 0;
+        qreal opacity = 1;
+        bool hasAlpha = false;
+        std::shared_ptr<SyncReleasePoint> bufferReleasePoint;
+        QVector4D box;
+        QVector4D borderRadius;
+        int borderThickness = 0;
+        QColor borderColor;
+        bool paintHole = false;
+    };
+
+    struct RenderCorner
+    {
+        RectF box;
+        BorderRadius radius;
+    };
+
+    struct RenderContext
+    {
+        QList<RenderNode> renderNodes;
+        QStack<QMatrix4x4> transformStack;
+        QStack<qreal> opacityStack;
+        QStack<RenderCorner> cornerStack;
+        const QMatrix4x4 projectionMatrix;
+        const QMatrix4x4 rootTransform;
+        const Region deviceClip;
+        const bool hardwareClipping;
+        const qreal renderTargetScale;
+        const QPointF viewportOrigin;
+        const QPoint renderOffset;
+    };
+
+    explicit ItemRendererVulkan(VulkanDevice *device);
+    ~ItemRendererVulkan() override;
+
+    std::unique_ptr<Texture> createTexture(GraphicsBuffer *buffer, const std::shared_ptr<SyncReleasePoint> &releasePoint) override;
+    std::unique_ptr<Texture> createTexture(const QImage &image) override;
+
+    std::unique_ptr<NinePatch> createNinePatch(const QImage &image) override;
+    std::unique_ptr<NinePatch> createNinePatch(const QImage &topLeftPatch,
+                                               const QImage &topPatch,
+                                               const QImage &topRightPatch,
+                                               const QImage &rightPatch,
+                                               const QImage &bottomRightPatch,
+                                               const QImage &bottomPatch,
+                                               const QImage &bottomLeftPatch,
+                                               const QImage &leftPatch) override;
+
+    std::unique_ptr<Atlas> createAtlas(const QList<QImage> &sprites) override;
+
+    void beginFrame(const RenderTarget &renderTarget, const RenderViewport &viewport) override;
+    void endFrame() override;
+
+    void renderBackground(const RenderTarget &renderTarget, const RenderViewport &viewport, const Region &deviceRegion) override;
+    bool renderItem(const RenderTarget &renderTarget, const RenderViewport &viewport, Item *item, int mask, const Region &deviceRegion, const WindowPaintData &data, const std::function<bool(Item *)> &filter, const std::function<bool(Item *)> &holeFilter) override;
+
+private:
+    /**
+     * The resources of a frame that must stay alive until the GPU is done with it. There
+     * are a few sets of them, so the CPU can record a frame while the previous ones are
+     * still being rendered.
+     */
+    struct FrameResources
+    {
+        FileDescriptor completionFence;
+        vk::raii::ImageView renderTargetView{nullptr};
+        std::vector<vk::raii::DescriptorPool> descriptorPools;
+        size_t currentDescriptorPool = 0;
+        QHash<VkImageView, vk::DescriptorSet> descriptorSets;
+        vk::raii::Buffer vertexBuffer{nullptr};
+        vk::raii::DeviceMemory vertexMemory{nullptr};
+        GLVertex2D *vertices = nullptr;
+        vk::DeviceSize vertexCapacity = 0;
+        vk::DeviceSize vertexCount = 0;
+        std::vector<std::pair<vk::raii::Buffer, vk::raii::DeviceMemory>> retiredVertexBuffers;
+        std::unordered_set<std::shared_ptr<SampledImageVulkan>> images;
+        std::vector<GraphicsBufferRef> buffers;
+    };
+
+    bool createRenderNode(Item *item, RenderContext *context, const std::function<bool(Item *)> &filter, const std::function<bool(Item *)> &holeFilter);
+    void waitForFrame(FrameResources *frame);
+    GLVertex2D *allocateVertices(FrameResources *frame, int count);
+    vk::DescriptorSet descriptorSet(FrameResources *frame, const SampledImageVulkan *image);
+    void acquireImages(const QList<RenderNode> &renderNodes);
+    void beginRendering(const RenderTarget &renderTarget);
+    void discardFrame();
+
+    VulkanDevice *const m_device;
+    std::unique_ptr<PipelineManagerVulkan> m_pipelineManager;
+    vk::Format m_prewarmedFormat = vk::Format::eUndefined;
+
+    std::array<FrameResources, 3> m_frames;
+    FrameResources *m_frame = nullptr;
+    uint m_frameIndex = 0;
+
+    vk::raii::CommandBuffer m_commandBuffer{nullptr};
+    VulkanTexture *m_renderTarget = nullptr;
+    std::shared_ptr<SyncReleasePoint> m_renderTargetReleasePoint;
+    std::unordered_set<std::shared_ptr<SyncReleasePoint>> m_releasePoints;
+    std::vector<const SampledImageVulkan *> m_externalImages;
+};
+
+} // namespace KWin
@@ -0,0 +1,93 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "scene/software/atlas.h"
+
+#include <QPainter>
+
+namespace KWin
+{
+
+std::unique_ptr<AtlasSoftware> AtlasSoftware::create(const QList<QImage> &images)
+{
+    auto atlas = std::make_unique<AtlasSoftware>();
+    if (atlas->reset(images)) {
+        return atlas;
+    }
+
+    return nullptr;
+}
+
+const QImage &AtlasSoftware::image() const
+{
+    return m_image;
+}
+
+Atlas::Sprite AtlasSoftware::sprite(uint spriteId) const
+{
+    return m_sprites.value(spriteId);
+}
+
+bool AtlasSoftware::update(uint spriteId, const QImage &image, const Rect &damage)
+{
+    Q_ASSERT(!image.isNull());
+    if (spriteId >= m_sprites.size()) {
+        return false;
+    }
+
+    const Sprite &sprite = m_sprites[spriteId];
+    const Rect sourceRect = damage & Rect(image.rect());
+
+    QPainter painter(&m_image);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.drawImage(sprite.geometry.topLeft() + sourceRect.topLeft(), image, sourceRect);
+    return true;
+}
+
+bool AtlasSoftware::reset(const QList<QImage> &images)
+{
+    // Unlike with textures, there is no reason to rotate the sprites or to pad them because the
+    // pixel kernels clamp the texel coordinates to the sampled quads.
+    Rect atlasRect;
+    QList<Sprite> sprites;
+    for (const QImage &image : images) {
+        if (image.isNull()) {
+            sprites.append({
+                .geometry = Rect(),
+                .rotated = false,
+            });
+        } else {
+            const Rect geometry(QPoint(0, atlasRect.bottom()), image.size());
+            sprites.append({
+                .geometry = geometry,
+                .rotated = false,
+            });
+            atlasRect |= geometry;
+        }
+    }
+
+    if (atlasRect.isEmpty()) {
+        m_image = QImage();
+        m_sprites.clear();
+        return false;
+    }
+
+    if (m_image.size() != atlasRect.size()) {
+        m_image = QImage(atlasRect.size(), QImage::Format_ARGB32_Premultiplied);
+    }
+    m_image.fill(Qt::transparent);
+    m_sprites = sprites;
+
+    for (int i = 0; i < images.size(); ++i) {
+        if (!images[i].isNull()) {
+            update(i, images[i], Rect(images[i].rect()));
+        }
+    }
+
+    return true;
+}
+
+} // namespace KWin
@@ -0,0 +1,34 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "scene/atlas.h"
+
+#include <QImage>
+
+#include <memory>
+
+namespace KWin
+{
+
+class AtlasSoftware : public Atlas
+{
+public:
+    static std::unique_ptr<AtlasSoftware> create(const QList<QImage> &images);
+
+    const QImage &image() const;
+
+    Sprite sprite(uint spriteId) const override;
+    bool update(uint spriteId, const QImage &image, const Rect &damage) override;
+    bool reset(const QList<QImage> &images) override;
+
+private:
+    QImage m_image;
+    QList<Sprite> m_sprites;
+};
+
+} // namespace KWin
@@ -0,0 +1,39 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "scene/ninepatch.h"
+
+#include <QImage>
+
+#include <memory>
+
+namespace KWin
+{
+
+class NinePatchSoftware : public NinePatch
+{
+public:
+    static std::unique_ptr<NinePatchSoftware> create(const QImage &image);
+    static std::unique_ptr<NinePatchSoftware> create(const QImage &topLeftPatch,
+                                                     const QImage &topPatch,
+                                                     const QImage &topRightPatch,
+                                                     const QImage &rightPatch,
+                                                     const QImage &bottomRightPatch,
+                                                     const QImage &bottomPatch,
+                                                     const QImage &bottomLeftPatch,
+                                                     const QImage &leftPatch);
+
+    explicit NinePatchSoftware(const QImage &image);
+
+    const QImage &image() const;
+
+private:
+    QImage m_image;
+};
+
+} // namespace KWin
@@ -0,0 +1,301 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "scene/software/pixelkernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define KWIN_PIXEL_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace KWin
+{
+
+PixelModulation PixelModulation::fromOpacity(qreal opacity, qreal brightness)
+{
+    // Brightening premultiplied pixels can produce invalid colors, so the brightness is capped.
+    return PixelModulation{
+        .color = int(std::round(std::clamp(opacity * brightness, 0.0, 1.0) * 256)),
+        .alpha = int(std::round(std::clamp(opacity, 0.0, 1.0) * 256)),
+    };
+}
+
+static inline quint32 modulatePixel(quint32 pixel, PixelModulation modulation)
+{
+    const quint32 b = ((pixel & 0xff) * modulation.color) >> 8;
+    const quint32 g = (((pixel >> 8) & 0xff) * modulation.color) >> 8;
+    const quint32 r = (((pixel >> 16) & 0xff) * modulation.color) >> 8;
+    const quint32 a = ((pixel >> 24) * modulation.alpha) >> 8;
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+static inline quint32 blendPixel(quint32 dst, quint32 src)
+{
+    const quint32 inverseAlpha = 255 - (src >> 24);
+
+    quint32 result = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        const quint32 t = ((dst >> shift) & 0xff) * inverseAlpha + 128;
+        const quint32 channel = std::min<quint32>(((src >> shift) & 0xff) + ((t + (t >> 8)) >> 8), 255);
+        result |= channel << shift;
+    }
+    return result;
+}
+
+static inline quint32 interpolatePixel(quint32 a, quint32 b, int weight)
+{
+    quint32 result = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        const quint32 channel = (((a >> shift) & 0xff) * (256 - weight) + ((b >> shift) & 0xff) * weight) >> 8;
+        result |= channel << shift;
+    }
+    return result;
+}
+
+static void blendRowScalar(quint32 *dst, const quint32 *src, int count, bool opaque, PixelModulation modulation)
+{
+    const quint32 alphaMask = opaque ? 0xff000000 : 0;
+    for (int i = 0; i < count; ++i) {
+        dst[i] = blendPixel(dst[i], modulatePixel(src[i] | alphaMask, modulation));
+    }
+}
+
+static void scaleRowScalar(quint32 *dst, int count, const quint32 *top, const quint32 *bottom, int weight, qint32 u, qint32 du, int minX, int maxX)
+{
+    for (int i = 0; i < count; ++i) {
+        const qint32 x = qint32(quint32(u) + quint32(i) * quint32(du));
+        const int weightX = (x >> 8) & 0xff;
+        const int x0 = std::clamp(x >> 16, minX, maxX);
+        const int x1 = std::clamp((x >> 16) + 1, minX, maxX);
+        dst[i] = interpolatePixel(interpolatePixel(top[x0], top[x1], weightX),
+                                  interpolatePixel(bottom[x0], bottom[x1], weightX),
+                                  weight);
+    }
+}
+
+#if KWIN_PIXEL_SIMD_X86
+/*
+ * The vector kernels operate on pixels unpacked to 16 bit lanes, i.e. {b, g, r, a} per pixel.
+ * The arithmetic is the same as in the scalar kernels, so the results are bit exact.
+ */
+__attribute__((target("sse2"))) static inline __m128i blendPixelsSse2(__m128i src, __m128i dst, __m128i factor)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rounding = _mm_set1_epi16(128);
+    const __m128i full = _mm_set1_epi16(255);
+
+    const __m128i srcLo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(src, zero), factor), 8);
+    const __m128i srcHi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(src, zero), factor), 8);
+
+    const __m128i inverseAlphaLo = _mm_sub_epi16(full, _mm_shufflehi_epi16(_mm_shufflelo_epi16(srcLo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)));
+    const __m128i inverseAlphaHi = _mm_sub_epi16(full, _mm_shufflehi_epi16(_mm_shufflelo_epi16(srcHi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)));
+
+    __m128i dstLo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(dst, zero), inverseAlphaLo), rounding);
+    __m128i dstHi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(dst, zero), inverseAlphaHi), rounding);
+    dstLo = _mm_srli_epi16(_mm_add_epi16(dstLo, _mm_srli_epi16(dstLo, 8)), 8);
+    dstHi = _mm_srli_epi16(_mm_add_epi16(dstHi, _mm_srli_epi16(dstHi, 8)), 8);
+
+    return _mm_packus_epi16(_mm_add_epi16(srcLo, dstLo), _mm_add_epi16(srcHi, dstHi));
+}
+
+__attribute__((target("sse2"))) static void blendRowSse2(quint32 *dst, const quint32 *src, int count, bool opaque, PixelModulation modulation)
+{
+    const __m128i alphaMask = _mm_set1_epi32(opaque ? int(0xff000000) : 0);
+    const __m128i factor = _mm_set_epi16(modulation.alpha, modulation.color, modulation.color, modulation.color,
+                                         modulation.alpha, modulation.color, modulation.color, modulation.color);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i s = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)), alphaMask);
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), blendPixelsSse2(s, d, factor));
+    }
+
+    blendRowScalar(dst + i, src + i, count - i, opaque, modulation);
+}
+
+__attribute__((target("avx2"))) static inline __m256i blendPixelsAvx2(__m256i src, __m256i dst, __m256i factor)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i rounding = _mm256_set1_epi16(128);
+    const __m256i full = _mm256_set1_epi16(255);
+
+    const __m256i srcLo = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(src, zero), factor), 8);
+    const __m256i srcHi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(src, zero), factor), 8);
+
+    const __m256i inverseAlphaLo = _mm256_sub_epi16(full, _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(srcLo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)));
+    const __m256i inverseAlphaHi = _mm256_sub_epi16(full, _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(srcHi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)));
+
+    __m256i dstLo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(dst, zero), inverseAlphaLo), rounding);
+    __m256i dstHi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(dst, zero), inverseAlphaHi), rounding);
+    dstLo = _mm256_srli_epi16(_mm256_add_epi16(dstLo, _mm256_srli_epi16(dstLo, 8)), 8);
+    dstHi = _mm256_srli_epi16(_mm256_add_epi16(dstHi, _mm256_srli_epi16(dstHi, 8)), 8);
+
+    return _mm256_packus_epi16(_mm256_add_epi16(srcLo, dstLo), _mm256_add_epi16(srcHi, dstHi));
+}
+
+__attribute__((target("avx2"))) static void blendRowAvx2(quint32 *dst, const quint32 *src, int count, bool opaque, PixelModulation modulation)
+{
+    const __m256i alphaMask = _mm256_set1_epi32(opaque ? int(0xff000000) : 0);
+    const __m256i factor = _mm256_broadcastsi128_si256(_mm_set_epi16(modulation.alpha, modulation.color, modulation.color, modulation.color,
+                                                                     modulation.alpha, modulation.color, modulation.color, modulation.color));
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i s = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i)), alphaMask);
+        const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), blendPixelsAvx2(s, d, factor));
+    }
+
+    blendRowScalar(dst + i, src + i, count - i, opaque, modulation);
+}
+
+__attribute__((target("avx2"))) static inline __m256i interpolatePixelsAvx2(__m256i a, __m256i b, __m256i weight)
+{
+    const __m256i one = _mm256_set1_epi16(256);
+    return _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(a, _mm256_sub_epi16(one, weight)), _mm256_mullo_epi16(b, weight)), 8);
+}
+
+__attribute__((target("avx2"))) static void scaleRowAvx2(quint32 *dst, int count, const quint32 *top, const quint32 *bottom, int weight, qint32 u, qint32 du, int minX, int maxX)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i lanes = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(du));
+    const __m256i minIndex = _mm256_set1_epi32(minX);
+    const __m256i maxIndex = _mm256_set1_epi32(maxX);
+    const __m256i weightY = _mm256_set1_epi16(weight);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i x = _mm256_add_epi32(_mm256_set1_epi32(qint32(quint32(u) + quint32(i) * quint32(du))), lanes);
+        const __m256i index = _mm256_srai_epi32(x, 16);
+        const __m256i x0 = _mm256_min_epi32(_mm256_max_epi32(index, minIndex), maxIndex);
+        const __m256i x1 = _mm256_min_epi32(_mm256_max_epi32(_mm256_add_epi32(index, _mm256_set1_epi32(1)), minIndex), maxIndex);
+
+        // Replicate the horizontal weight of every pixel to its four channels.
+        const __m256i weightX = _mm256_and_si256(_mm256_srli_epi32(x, 8), _mm256_set1_epi32(0xff));
+        const __m256i weightPairs = _mm256_or_si256(weightX, _mm256_slli_epi32(weightX, 16));
+        const __m256i weightLo = _mm256_unpacklo_epi32(weightPairs, weightPairs);
+        const __m256i weightHi = _mm256_unpackhi_epi32(weightPairs, weightPairs);
+
+        const __m256i topLeft = _mm256_i32gather_epi32(reinterpret_cast<const int *>(top), x0, 4);
+        const __m256i topRight = _mm256_i32gather_epi32(reinterpret_cast<const int *>(top), x1, 4);
+        const __m256i bottomLeft = _mm256_i32gather_epi32(reinterpret_cast<const int *>(bottom), x0, 4);
+        const __m256i bottomRight = _mm256_i32gather_epi32(reinterpret_cast<const int *>(bottom), x1, 4);
+
+        const __m256i topLo = interpolatePixelsAvx2(_mm256_unpacklo_epi8(topLeft, zero), _mm256_unpacklo_epi8(topRight, zero), weightLo);
+        const __m256i topHi = interpolatePixelsAvx2(_mm256_unpackhi_epi8(topLeft, zero), _mm256_unpackhi_epi8(topRight, zero), weightHi);
+        const __m256i bottomLo = interpolatePixelsAvx2(_mm256_unpacklo_epi8(bottomLeft, zero), _mm256_unpacklo_epi8(bottomRight, zero), weightLo);
+        const __m256i bottomHi = interpolatePixelsAvx2(_mm256_unpackhi_epi8(bottomLeft, zero), _mm256_unpackhi_epi8(bottomRight, zero), weightHi);
+
+        const __m256i resultLo = interpolatePixelsAvx2(topLo, bottomLo, weightY);
+        const __m256i resultHi = interpolatePixelsAvx2(topHi, bottomHi, weightY);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_packus_epi16(resultLo, resultHi));
+    }
+
+    scaleRowScalar(dst + i, count - i, top, bottom, weight, qint32(quint32(u) + quint32(i) * quint32(du)), du, minX, maxX);
+}
+#endif
+
+struct PixelKernels
+{
+    PixelKernelIsa isa;
+    void (*blendRow)(quint32 *dst, const quint32 *src, int count, bool opaque, PixelModulation modulation);
+    void (*scaleRow)(quint32 *dst, int count, const quint32 *top, const quint32 *bottom, int weight, qint32 u, qint32 du, int minX, int maxX);
+};
+
+static PixelKernels selectPixelKernels(PixelKernelIsa isa)
+{
+    switch (isa) {
+#if KWIN_PIXEL_SIMD_X86
+    case PixelKernelIsa::Avx2:
+        return PixelKernels{
+            .isa = PixelKernelIsa::Avx2,
+            .blendRow = blendRowAvx2,
+            .scaleRow = scaleRowAvx2,
+        };
+    case PixelKernelIsa::Sse2:
+        // Without gathers, resampling doesn't benefit from SSE2.
+        return PixelKernels{
+            .isa = PixelKernelIsa::Sse2,
+            .blendRow = blendRowSse2,
+            .scaleRow = scaleRowScalar,
+        };
+#endif
+    default:
+        return PixelKernels{
+            .isa = PixelKernelIsa::Scalar,
+            .blendRow = blendRowScalar,
+            .scaleRow = scaleRowScalar,
+        };
+    }
+}
+
+static PixelKernels &pixelKernels()
+{
+    static PixelKernels kernels = selectPixelKernels(bestPixelKernelIsa());
+    return kernels;
+}
+
+PixelKernelIsa bestPixelKernelIsa()
+{
+#if KWIN_PIXEL_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return PixelKernelIsa::Avx2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        return PixelKernelIsa::Sse2;
+    }
+#endif
+    return PixelKernelIsa::Scalar;
+}
+
+PixelKernelIsa pixelKernelIsa()
+{
+    return pixelKernels().isa;
+}
+
+void setPixelKernelIsa(PixelKernelIsa isa)
+{
+    pixelKernels() = selectPixelKernels(std::min(isa, bestPixelKernelIsa()));
+}
+
+void blendRow(quint32 *dst, const quint32 *src, int count, bool opaque, PixelModulation modulation)
+{
+    if (opaque && modulation.isIdentity()) {
+        for (int i = 0; i < count; ++i) {
+            dst[i] = src[i] | 0xff000000;
+        }
+    } else {
+        pixelKernels().blendRow(dst, src, count, opaque, modulation);
+    }
+}
+
+void scaleRow(quint32 *dst, int count, const quint32 *top, const quint32 *bottom, int weight, qint32 u, qint32 du, int minX, int maxX)
+{
+    pixelKernels().scaleRow(dst, count, top, bottom, weight, u, du, minX, maxX);
+}
+
+quint32 sampleBilinear(const uchar *bits, qsizetype stride, float u, float v, int minX, int minY, int maxX, int maxY)
+{
+    const float x = std::floor(u);
+    const float y = std::floor(v);
+    const int weightX = int((u - x) * 256);
+    const int weightY = int((v - y) * 256);
+
+    const int x0 = std::clamp(int(x), minX, maxX);
+    const int x1 = std::clamp(int(x) + 1, minX, maxX);
+    const auto top = reinterpret_cast<const quint32 *>(bits + std::clamp(int(y), minY, maxY) * stride);
+    const auto bottom = reinterpret_cast<const quint32 *>(bits + std::clamp(int(y) + 1, minY, maxY) * stride);
+
+    return interpolatePixel(interpolatePixel(top[x0], top[x1], weightX),
+                            interpolatePixel(bottom[x0], bottom[x1], weightX),
+                            weightY);
+}
+
+} // namespace KWin
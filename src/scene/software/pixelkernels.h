@@ -0,0 +1,83 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QtGlobal>
+
+namespace KWin
+{
+
+/**
+ * The instruction set used by the software renderer pixel kernels. The best instruction set
+ * supported by the CPU is picked at runtime.
+ */
+enum class PixelKernelIsa {
+    Scalar,
+    Sse2,
+    Avx2,
+};
+
+/**
+ * The PixelModulation type describes how the color and the alpha channels of premultiplied
+ * pixels are scaled before blending. The factors are in the range [0, 256], 256 leaves the
+ * channels unchanged.
+ */
+struct PixelModulation
+{
+    int color = 256;
+    int alpha = 256;
+
+    bool isIdentity() const
+    {
+        return color == 256 && alpha == 256;
+    }
+
+    static PixelModulation fromOpacity(qreal opacity, qreal brightness);
+};
+
+/**
+ * Returns the best instruction set supported by the CPU for the pixel kernels.
+ */
+KWIN_EXPORT PixelKernelIsa bestPixelKernelIsa();
+
+/**
+ * Returns the instruction set currently used by the pixel kernels.
+ */
+KWIN_EXPORT PixelKernelIsa pixelKernelIsa();
+
+/**
+ * Forces the pixel kernels to use the specified @a isa. If the CPU does not support the given
+ * instruction set, the best supported one will be used instead. This is intended to be used
+ * only by tests and benchmarks.
+ */
+KWIN_EXPORT void setPixelKernelIsa(PixelKernelIsa isa);
+
+/**
+ * Blends @a count premultiplied ARGB32 pixels from @a src over @a dst using the source over
+ * operator. If @a opaque is @c true, the alpha channel of the source pixels is assumed to be
+ * 255, e.g. for XRGB buffers. The results are identical with every instruction set.
+ */
+KWIN_EXPORT void blendRow(quint32 *dst, const quint32 *src, int count, bool opaque, PixelModulation modulation);
+
+/**
+ * Resamples a row of @a count pixels into @a dst using bilinear filtering. The i-th pixel is
+ * sampled at @c{u + i * du} between the rows @a top and @a bottom, @a weight is the weight of
+ * the @a bottom row in the range [0, 256]. The horizontal coordinates are in the 16.16 fixed
+ * point format, so the results are identical with every instruction set. Texel indices are
+ * clamped to [@a minX, @a maxX].
+ */
+KWIN_EXPORT void scaleRow(quint32 *dst, int count, const quint32 *top, const quint32 *bottom, int weight, qint32 u, qint32 du, int minX, int maxX);
+
+/**
+ * Samples the texel at @a u, @a v in the image with the specified @a bits and @a stride using
+ * bilinear filtering. Texel coordinates are clamped to [@a minX, @a maxX] x [@a minY, @a maxY].
+ */
+KWIN_EXPORT quint32 sampleBilinear(const uchar *bits, qsizetype stride, float u, float v, int minX, int minY, int maxX, int maxY);
+
+} // namespace KWin
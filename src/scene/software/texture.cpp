@@ -0,0 +1,106 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "scene/software/texture.h"
+#include "core/graphicsbuffer.h"
+#include "core/graphicsbufferview.h"
+#include "core/region.h"
+#include "utils/common.h"
+
+#include <QPainter>
+
+namespace KWin
+{
+
+static QImage::Format textureFormat(const QImage &image)
+{
+    return image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32;
+}
+
+static void copyImage(QImage *destination, const QImage &source, const Region &region)
+{
+    QPainter painter(destination);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    for (const Rect &rect : region.rects()) {
+        painter.drawImage(rect.topLeft(), source, rect);
+    }
+}
+
+const QImage &TextureSoftware::image() const
+{
+    return m_image;
+}
+
+std::unique_ptr<ImageTextureSoftware> ImageTextureSoftware::create(const QImage &image)
+{
+    if (image.isNull()) {
+        return nullptr;
+    }
+
+    auto texture = std::make_unique<ImageTextureSoftware>();
+    texture->m_image = image.convertToFormat(textureFormat(image));
+    texture->m_size = image.size();
+    return texture;
+}
+
+void ImageTextureSoftware::attach(GraphicsBuffer *buffer, const Region &region, const std::shared_ptr<SyncReleasePoint> &releasePoint)
+{
+    Q_UNREACHABLE();
+}
+
+void ImageTextureSoftware::upload(const QImage &image, const Rect &region)
+{
+    if (m_image.format() != textureFormat(image)) {
+        m_image = image.convertToFormat(textureFormat(image));
+    } else {
+        copyImage(&m_image, image, region & Rect(image.rect()));
+    }
+}
+
+std::unique_ptr<BufferTextureSoftware> BufferTextureSoftware::create(GraphicsBuffer *buffer)
+{
+    auto texture = std::make_unique<BufferTextureSoftware>();
+    if (texture->copy(buffer, Region::infinite())) {
+        return texture;
+    }
+
+    return nullptr;
+}
+
+void BufferTextureSoftware::attach(GraphicsBuffer *buffer, const Region &region, const std::shared_ptr<SyncReleasePoint> &releasePoint)
+{
+    copy(buffer, region);
+}
+
+void BufferTextureSoftware::upload(const QImage &image, const Rect &region)
+{
+    Q_UNREACHABLE();
+}
+
+bool BufferTextureSoftware::copy(GraphicsBuffer *buffer, const Region &region)
+{
+    // The buffer contents are copied because the client is free to reuse the buffer as soon
+    // as it has been released, the copy is limited to the damaged region though.
+    const GraphicsBufferView view(buffer);
+    if (Q_UNLIKELY(view.isNull())) {
+        qCDebug(KWIN_CORE) << "Failed to map graphics buffer" << buffer << "for software rendering";
+        return false;
+    }
+
+    const QImage *source = view.image();
+    const QImage::Format format = textureFormat(*source);
+    if (m_image.size() != source->size() || m_image.format() != format) {
+        m_image = QImage(source->size(), format);
+        copyImage(&m_image, *source, Region(Rect(source->rect())));
+    } else {
+        copyImage(&m_image, *source, region & Rect(source->rect()));
+    }
+
+    m_size = buffer->size();
+    return true;
+}
+
+} // namespace KWin
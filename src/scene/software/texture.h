@@ -0,0 +1,52 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "scene/texture.h"
+
+#include <QImage>
+
+#include <memory>
+
+namespace KWin
+{
+
+/**
+ * The TextureSoftware class holds the contents of a texture in system memory, either in the
+ * ARGB32_Premultiplied or the RGB32 format, as expected by the software pixel kernels.
+ */
+class TextureSoftware : public Texture
+{
+public:
+    const QImage &image() const;
+
+protected:
+    QImage m_image;
+};
+
+class ImageTextureSoftware : public TextureSoftware
+{
+public:
+    static std::unique_ptr<ImageTextureSoftware> create(const QImage &image);
+
+    void attach(GraphicsBuffer *buffer, const Region &region, const std::shared_ptr<SyncReleasePoint> &releasePoint) override;
+    void upload(const QImage &image, const Rect &region) override;
+};
+
+class BufferTextureSoftware : public TextureSoftware
+{
+public:
+    static std::unique_ptr<BufferTextureSoftware> create(GraphicsBuffer *buffer);
+
+    void attach(GraphicsBuffer *buffer, const Region &region, const std::shared_ptr<SyncReleasePoint> &releasePoint) override;
+    void upload(const QImage &image, const Rect &region) override;
+
+private:
+    bool copy(GraphicsBuffer *buffer, const Region &region);
+};
+
+} // namespace KWin
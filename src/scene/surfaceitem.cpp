@@ -45,6 +45,7 @@ GraphicsBuffer *SurfaceItem::buffer() const
 
 void SurfaceItem::setBuffer(GraphicsBuffer *buffer)
 {
+    const bool hadAlphaChannel = m_hasAlphaChannel;
     if (buffer) {
         m_bufferRef = buffer;
         m_hasAlphaChannel = buffer->hasAlphaChannel();
@@ -54,6 +55,9 @@ void SurfaceItem::setBuffer(GraphicsBuffer *buffer)
         m_hasAlphaChannel = false;
         setBufferSize(QSize(0, 0));
     }
+    if (hadAlphaChannel != m_hasAlphaChannel) {
+        invalidateOcclusion();
+    }
 }
 
 void SurfaceItem::setBufferReleasePoint(const std::shared_ptr<SyncReleasePoint> &releasePoint)
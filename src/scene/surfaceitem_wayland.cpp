@@ -48,6 +48,7 @@ SurfaceItemWayland::SurfaceItemWayland(SurfaceInterface *surface, Item *parent)
             this, &SurfaceItemWayland::handlePresentationModeHintChanged);
     connect(surface, &SurfaceInterface::bufferReleasePointChanged, this, &SurfaceItemWayland::handleReleasePointChanged);
     connect(surface, &SurfaceInterface::alphaMultiplierChanged, this, &SurfaceItemWayland::handleAlphaMultiplierChanged);
+    connect(surface, &SurfaceInterface::opaqueChanged, this, &SurfaceItemWayland::invalidateOcclusion);
 
     connect(surface, &SurfaceInterface::mapped,
             this, &SurfaceItemWayland::handleSurfaceMappedChanged);
@@ -256,6 +257,8 @@ SurfaceItemXwayland::SurfaceItemXwayland(X11Window *window, Item *parent)
     , m_window(window)
 {
     connect(window, &X11Window::shapeChanged, this, &SurfaceItemXwayland::handleShapeChange);
+    connect(window, &X11Window::opaqueRegionChanged, this, &SurfaceItemXwayland::invalidateOcclusion);
+    connect(window, &X11Window::hasAlphaChanged, this, &SurfaceItemXwayland::invalidateOcclusion);
 }
 
 void SurfaceItemXwayland::handleShapeChange()
@@ -0,0 +1,69 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "scene/vulkan/atlas.h"
+#include "scene/vulkan/texture.h"
+
+namespace KWin
+{
+
+std::unique_ptr<AtlasVulkan> AtlasVulkan::create(VulkanDevice *device, const QList<QImage> &images)
+{
+    auto atlas = std::make_unique<AtlasVulkan>(device);
+    if (atlas->reset(images)) {
+        return atlas;
+    }
+
+    return nullptr;
+}
+
+AtlasVulkan::AtlasVulkan(VulkanDevice *device)
+    : m_device(device)
+{
+}
+
+AtlasVulkan::~AtlasVulkan()
+{
+}
+
+ImageTextureVulkan *AtlasVulkan::texture() const
+{
+    return m_texture.get();
+}
+
+Atlas::Sprite AtlasVulkan::sprite(uint spriteId) const
+{
+    return m_layout.sprite(spriteId);
+}
+
+bool AtlasVulkan::update(uint spriteId, const QImage &image, const Rect &damage)
+{
+    if (!m_texture || !m_layout.update(spriteId, image, damage)) {
+        return false;
+    }
+
+    const Sprite sprite = m_layout.sprite(spriteId);
+    const Rect atlasDamage = (damage & Rect(image.rect())).translated(sprite.geometry.topLeft());
+    m_texture->upload(m_layout.image(), atlasDamage);
+    return true;
+}
+
+bool AtlasVulkan::reset(const QList<QImage> &images)
+{
+    if (!m_layout.reset(images)) {
+        m_texture.reset();
+        return false;
+    }
+
+    if (m_texture) {
+        m_texture->upload(m_layout.image(), Rect(m_layout.image().rect()));
+    } else {
+        m_texture = ImageTextureVulkan::create(m_device, m_layout.image());
+    }
+    return m_texture != nullptr;
+}
+
+} // namespace KWin
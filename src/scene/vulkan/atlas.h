@@ -0,0 +1,41 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "scene/software/atlas.h"
+
+namespace KWin
+{
+
+class ImageTextureVulkan;
+class VulkanDevice;
+
+/**
+ * The AtlasVulkan class packs the sprites the same way as the software renderer does. The
+ * packed image is kept in system memory, and only the damaged parts are uploaded on update.
+ */
+class AtlasVulkan : public Atlas
+{
+public:
+    static std::unique_ptr<AtlasVulkan> create(VulkanDevice *device, const QList<QImage> &images);
+
+    explicit AtlasVulkan(VulkanDevice *device);
+    ~AtlasVulkan() override;
+
+    ImageTextureVulkan *texture() const;
+
+    Sprite sprite(uint spriteId) const override;
+    bool update(uint spriteId, const QImage &image, const Rect &damage) override;
+    bool reset(const QList<QImage> &images) override;
+
+private:
+    VulkanDevice *const m_device;
+    AtlasSoftware m_layout;
+    std::unique_ptr<ImageTextureVulkan> m_texture;
+};
+
+} // namespace KWin
@@ -0,0 +1,57 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "scene/vulkan/ninepatch.h"
+#include "scene/software/ninepatch.h"
+#include "scene/vulkan/texture.h"
+
+namespace KWin
+{
+
+std::unique_ptr<NinePatchVulkan> NinePatchVulkan::create(VulkanDevice *device, const QImage &image)
+{
+    auto texture = ImageTextureVulkan::create(device, image);
+    if (!texture) {
+        return nullptr;
+    }
+
+    return std::make_unique<NinePatchVulkan>(std::move(texture));
+}
+
+std::unique_ptr<NinePatchVulkan> NinePatchVulkan::create(VulkanDevice *device,
+                                                         const QImage &topLeftPatch,
+                                                         const QImage &topPatch,
+                                                         const QImage &topRightPatch,
+                                                         const QImage &rightPatch,
+                                                         const QImage &bottomRightPatch,
+                                                         const QImage &bottomPatch,
+                                                         const QImage &bottomLeftPatch,
+                                                         const QImage &leftPatch)
+{
+    // The patches are laid out the same way as for the software renderer.
+    const auto layout = NinePatchSoftware::create(topLeftPatch, topPatch, topRightPatch, rightPatch, bottomRightPatch, bottomPatch, bottomLeftPatch, leftPatch);
+    if (!layout) {
+        return nullptr;
+    }
+
+    return create(device, layout->image());
+}
+
+NinePatchVulkan::NinePatchVulkan(std::unique_ptr<ImageTextureVulkan> &&texture)
+    : m_texture(std::move(texture))
+{
+}
+
+NinePatchVulkan::~NinePatchVulkan()
+{
+}
+
+ImageTextureVulkan *NinePatchVulkan::texture() const
+{
+    return m_texture.get();
+}
+
+} // namespace KWin
@@ -0,0 +1,418 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "scene/vulkan/pipelinemanager.h"
+#include "opengl/glvertexbuffer.h"
+#include "vulkan/vulkan_device.h"
+#include "vulkan/vulkan_logging.h"
+
+#include <QtConcurrentRun>
+
+namespace KWin
+{
+
+static const uint32_t s_itemVertexShader[] = {
+#include "scene/vulkan/shaders/item.vert.spv.h"
+};
+
+static const uint32_t s_itemFragmentShader[] = {
+#include "scene/vulkan/shaders/item.frag.spv.h"
+};
+
+// The order must match the constant_id values in item.frag.
+static const PipelineTrait s_specializedTraits[] = {
+    PipelineTrait::MapTexture,
+    PipelineTrait::UniformColor,
+    PipelineTrait::Modulate,
+    PipelineTrait::AdjustSaturation,
+    PipelineTrait::RoundedCorners,
+    PipelineTrait::Border,
+};
+
+PipelineManagerVulkan::PipelineManagerVulkan(VulkanDevice *device,
+                                             vk::raii::Sampler &&sampler,
+                                             vk::raii::DescriptorSetLayout &&descriptorSetLayout,
+                                             vk::raii::PipelineLayout &&pipelineLayout,
+                                             vk::raii::PipelineCache &&pipelineCache,
+                                             vk::raii::ShaderModule &&vertexShader,
+                                             vk::raii::ShaderModule &&fragmentShader)
+    : m_device(device)
+    , m_sampler(std::move(sampler))
+    , m_descriptorSetLayout(std::move(descriptorSetLayout))
+    , m_pipelineLayout(std::move(pipelineLayout))
+    , m_pipelineCache(std::move(pipelineCache))
+    , m_vertexShader(std::move(vertexShader))
+    , m_fragmentShader(std::move(fragmentShader))
+{
+}
+
+PipelineManagerVulkan::~PipelineManagerVulkan()
+{
+    m_prewarmed.waitForFinished();
+}
+
+const vk::raii::DescriptorSetLayout &PipelineManagerVulkan::descriptorSetLayout() const
+{
+    return m_descriptorSetLayout;
+}
+
+const vk::raii::PipelineLayout &PipelineManagerVulkan::pipelineLayout() const
+{
+    return m_pipelineLayout;
+}
+
+vk::Pipeline PipelineManagerVulkan::pipeline(const PipelineKey &key)
+{
+    if (m_prewarmed.isValid() && m_prewarmed.isFinished()) {
+        collectPrewarmedPipelines();
+    }
+
+    auto it = m_pipelines.find(key);
+    if (it == m_pipelines.end()) {
+        // If the pipeline is still being prewarmed, it's created twice. The pipeline cache
+        // makes that cheap, and it's better than blocking until all prewarmed pipelines are done.
+        auto pipeline = createPipeline(key);
+        if (!*pipeline) {
+            return nullptr;
+        }
+        it = m_pipelines.insert(key, std::make_shared<vk::raii::Pipeline>(std::move(pipeline)));
+    }
+    return **it.value();
+}
+
+void PipelineManagerVulkan::prewarm(const QList<PipelineKey> &keys)
+{
+    if (m_prewarmed.isValid()) {
+        m_prewarmed.waitForFinished();
+        collectPrewarmedPipelines();
+    }
+
+    QList<PipelineKey> pending;
+    for (const PipelineKey &key : keys) {
+        if (!m_pipelines.contains(key) && !pending.contains(key)) {
+            pending.append(key);
+        }
+    }
+    if (pending.isEmpty()) {
+        return;
+    }
+
+    // Creating pipelines is thread safe, the pipeline cache is internally synchronized.
+    m_prewarmed = QtConcurrent::run([this, pending]() {
+        QList<std::pair<PipelineKey, std::shared_ptr<vk::raii::Pipeline>>> pipelines;
+        for (const PipelineKey &key : pending) {
+            auto pipeline = createPipeline(key);
+            if (*pipeline) {
+                pipelines.append(std::make_pair(key, std::make_shared<vk::raii::Pipeline>(std::move(pipeline))));
+            }
+        }
+        return pipelines;
+    });
+}
+
+void PipelineManagerVulkan::collectPrewarmedPipelines()
+{
+    const auto pipelines = m_prewarmed.takeResult();
+    for (const auto &[key, pipeline] : pipelines) {
+        if (!m_pipelines.contains(key)) {
+            m_pipelines.insert(key, pipeline);
+        }
+    }
+    m_prewarmed = {};
+}
+
+QList<PipelineKey> PipelineManagerVulkan::commonPipelines(vk::Format format)
+{
+    QList<PipelineKey> keys;
+    const auto add = [&keys, format](PipelineTraits traits, PipelineBlendMode blendMode) {
+        const PipelineKey key{
+            .traits = traits,
+            .blendMode = blendMode,
+            .format = format,
+        };
+        if (!keys.contains(key)) {
+            keys.append(key);
+        }
+    };
+
+    // Opaque surfaces are not blended, everything else is.
+    add(PipelineTrait::MapTexture, PipelineBlendMode::None);
+    add(PipelineTrait::MapTexture, PipelineBlendMode::PremultipliedAlpha);
+    add(PipelineTrait::MapTexture | PipelineTrait::Modulate, PipelineBlendMode::PremultipliedAlpha);
+    add(PipelineTrait::MapTexture | PipelineTrait::RoundedCorners, PipelineBlendMode::PremultipliedAlpha);
+    add(PipelineTrait::MapTexture | PipelineTrait::RoundedCorners | PipelineTrait::Modulate, PipelineBlendMode::PremultipliedAlpha);
+    add(PipelineTrait::MapTexture | PipelineTrait::Modulate | PipelineTrait::AdjustSaturation, PipelineBlendMode::PremultipliedAlpha);
+
+    // Holes for surfaces that are shown on overlay or underlay planes.
+    add(PipelineTrait::UniformColor, PipelineBlendMode::Hole);
+    add(PipelineTrait::UniformColor | PipelineTrait::RoundedCorners, PipelineBlendMode::Hole);
+
+    add(PipelineTrait::Border, PipelineBlendMode::PremultipliedAlpha);
+    add(PipelineTrait::Border | PipelineTrait::Modulate, PipelineBlendMode::PremultipliedAlpha);
+
+    return keys;
+}
+
+static vk::PipelineColorBlendAttachmentState blendState(PipelineBlendMode blendMode)
+{
+    const auto colorWriteMask = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
+    switch (blendMode) {
+    case PipelineBlendMode::None:
+        return vk::PipelineColorBlendAttachmentState{
+            false,
+            vk::BlendFactor::eOne,
+            vk::BlendFactor::eZero,
+            vk::BlendOp::eAdd,
+            vk::BlendFactor::eOne,
+            vk::BlendFactor::eZero,
+            vk::BlendOp::eAdd,
+            colorWriteMask,
+        };
+    case PipelineBlendMode::PremultipliedAlpha:
+        return vk::PipelineColorBlendAttachmentState{
+            true,
+            vk::BlendFactor::eOne,
+            vk::BlendFactor::eOneMinusSrcAlpha,
+            vk::BlendOp::eAdd,
+            vk::BlendFactor::eOne,
+            vk::BlendFactor::eOneMinusSrcAlpha,
+            vk::BlendOp::eAdd,
+            colorWriteMask,
+        };
+    case PipelineBlendMode::Hole:
+        return vk::PipelineColorBlendAttachmentState{
+            true,
+            vk::BlendFactor::eOneMinusSrcAlpha,
+            vk::BlendFactor::eOneMinusSrcAlpha,
+            vk::BlendOp::eAdd,
+            vk::BlendFactor::eOneMinusSrcAlpha,
+            vk::BlendFactor::eOneMinusSrcAlpha,
+            vk::BlendOp::eAdd,
+            colorWriteMask,
+        };
+    }
+    Q_UNREACHABLE();
+}
+
+vk::raii::Pipeline PipelineManagerVulkan::createPipeline(const PipelineKey &key) const
+{
+    std::array<vk::Bool32, std::size(s_specializedTraits)> specializationData;
+    std::array<vk::SpecializationMapEntry, std::size(s_specializedTraits)> specializationEntries;
+    for (size_t i = 0; i < std::size(s_specializedTraits); ++i) {
+        specializationData[i] = key.traits.testFlag(s_specializedTraits[i]) ? VK_TRUE : VK_FALSE;
+        specializationEntries[i] = vk::SpecializationMapEntry{
+            uint32_t(i),
+            uint32_t(i * sizeof(vk::Bool32)),
+            sizeof(vk::Bool32),
+        };
+    }
+    const vk::SpecializationInfo specializationInfo{
+        uint32_t(specializationEntries.size()),
+        specializationEntries.data(),
+        specializationData.size() * sizeof(vk::Bool32),
+        specializationData.data(),
+    };
+
+    const std::array stages{
+        vk::PipelineShaderStageCreateInfo{
+            vk::PipelineShaderStageCreateFlags(),
+            vk::ShaderStageFlagBits::eVertex,
+            *m_vertexShader,
+            "main",
+        },
+        vk::PipelineShaderStageCreateInfo{
+            vk::PipelineShaderStageCreateFlags(),
+            vk::ShaderStageFlagBits::eFragment,
+            *m_fragmentShader,
+            "main",
+            &specializationInfo,
+        },
+    };
+
+    // The vertices are laid out as in the OpenGL renderer, see GLVertex2D.
+    const vk::VertexInputBindingDescription vertexBinding{
+        0,
+        sizeof(GLVertex2D),
+        vk::VertexInputRate::eVertex,
+    };
+    const std::array vertexAttributes{
+        vk::VertexInputAttributeDescription{0, 0, vk::Format::eR32G32Sfloat, uint32_t(offsetof(GLVertex2D, position))},
+        vk::VertexInputAttributeDescription{1, 0, vk::Format::eR32G32Sfloat, uint32_t(offsetof(GLVertex2D, texcoord))},
+    };
+    const vk::PipelineVertexInputStateCreateInfo vertexInputState{
+        vk::PipelineVertexInputStateCreateFlags(),
+        vertexBinding,
+        vertexAttributes,
+    };
+
+    const vk::PipelineInputAssemblyStateCreateInfo inputAssemblyState{
+        vk::PipelineInputAssemblyStateCreateFlags(),
+        vk::PrimitiveTopology::eTriangleList,
+    };
+
+    // The viewport and the scissor are dynamic, so they are set when the commands are recorded.
+    const vk::PipelineViewportStateCreateInfo viewportState{
+        vk::PipelineViewportStateCreateFlags(),
+        1,
+        nullptr,
+        1,
+        nullptr,
+    };
+    const std::array dynamicStates{
+        vk::DynamicState::eViewport,
+        vk::DynamicState::eScissor,
+    };
+    const vk::PipelineDynamicStateCreateInfo dynamicState{
+        vk::PipelineDynamicStateCreateFlags(),
+        dynamicStates,
+    };
+
+    const vk::PipelineRasterizationStateCreateInfo rasterizationState{
+        vk::PipelineRasterizationStateCreateFlags(),
+        false, // depth clamp
+        false, // rasterizer discard
+        vk::PolygonMode::eFill,
+        vk::CullModeFlagBits::eNone,
+        vk::FrontFace::eCounterClockwise,
+        false, // depth bias
+        0,
+        0,
+        0,
+        1, // line width
+    };
+
+    const vk::PipelineMultisampleStateCreateInfo multisampleState{
+        vk::PipelineMultisampleStateCreateFlags(),
+        vk::SampleCountFlagBits::e1,
+    };
+
+    const vk::PipelineColorBlendAttachmentState blendAttachment = blendState(key.blendMode);
+    const vk::PipelineColorBlendStateCreateInfo colorBlendState{
+        vk::PipelineColorBlendStateCreateFlags(),
+        false,
+        vk::LogicOp::eCopy,
+        blendAttachment,
+    };
+
+    const vk::PipelineRenderingCreateInfo renderingInfo{
+        0, // view mask
+        key.format,
+    };
+
+    const vk::GraphicsPipelineCreateInfo createInfo{
+        vk::PipelineCreateFlags(),
+        stages,
+        &vertexInputState,
+        &inputAssemblyState,
+        nullptr, // tessellation
+        &viewportState,
+        &rasterizationState,
+        &multisampleState,
+        nullptr, // depth stencil
+        &colorBlendState,
+        &dynamicState,
+        *m_pipelineLayout,
+        nullptr, // render pass, dynamic rendering is used instead
+        0,
+        nullptr,
+        -1,
+        &renderingInfo,
+    };
+
+    auto [result, pipeline] = m_device->logicalDevice().createGraphicsPipeline(m_pipelineCache, createInfo);
+    if (result != vk::Result::eSuccess) {
+        qCWarning(KWIN_VULKAN) << "Failed to create a graphics pipeline for traits" << key.traits << vk::to_string(result);
+        return vk::raii::Pipeline(nullptr);
+    }
+    return std::move(pipeline);
+}
+
+static vk::raii::ShaderModule createShaderModule(VulkanDevice *device, std::span<const uint32_t> code)
+{
+    auto [result, module] = device->logicalDevice().createShaderModule(vk::ShaderModuleCreateInfo{
+        vk::ShaderModuleCreateFlags(),
+        code.size_bytes(),
+        code.data(),
+    });
+    if (result != vk::Result::eSuccess) {
+        qCWarning(KWIN_VULKAN) << "Failed to create a shader module" << vk::to_string(result);
+        return vk::raii::ShaderModule(nullptr);
+    }
+    return std::move(module);
+}
+
+std::unique_ptr<PipelineManagerVulkan> PipelineManagerVulkan::create(VulkanDevice *device)
+{
+    auto [samplerResult, sampler] = device->logicalDevice().createSampler(vk::SamplerCreateInfo{
+        vk::SamplerCreateFlags(),
+        vk::Filter::eLinear,
+        vk::Filter::eLinear,
+        vk::SamplerMipmapMode::eNearest,
+        vk::SamplerAddressMode::eClampToEdge,
+        vk::SamplerAddressMode::eClampToEdge,
+        vk::SamplerAddressMode::eClampToEdge,
+    });
+    if (samplerResult != vk::Result::eSuccess) {
+        qCWarning(KWIN_VULKAN) << "Failed to create a sampler" << vk::to_string(samplerResult);
+        return nullptr;
+    }
+
+    // The sampler is immutable, so the descriptor sets only need to reference the image views.
+    const vk::Sampler immutableSampler = *sampler;
+    const vk::DescriptorSetLayoutBinding binding{
+        0,
+        vk::DescriptorType::eCombinedImageSampler,
+        1,
+        vk::ShaderStageFlagBits::eFragment,
+        &immutableSampler,
+    };
+    auto [descriptorSetLayoutResult, descriptorSetLayout] = device->logicalDevice().createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo{
+        vk::DescriptorSetLayoutCreateFlags(),
+        binding,
+    });
+    if (descriptorSetLayoutResult != vk::Result::eSuccess) {
+        qCWarning(KWIN_VULKAN) << "Failed to create a descriptor set layout" << vk::to_string(descriptorSetLayoutResult);
+        return nullptr;
+    }
+
+    const vk::PushConstantRange pushConstantRange{
+        vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment,
+        0,
+        sizeof(PipelinePushConstants),
+    };
+    const vk::DescriptorSetLayout setLayout = *descriptorSetLayout;
+    auto [pipelineLayoutResult, pipelineLayout] = device->logicalDevice().createPipelineLayout(vk::PipelineLayoutCreateInfo{
+        vk::PipelineLayoutCreateFlags(),
+        setLayout,
+        pushConstantRange,
+    });
+    if (pipelineLayoutResult != vk::Result::eSuccess) {
+        qCWarning(KWIN_VULKAN) << "Failed to create a pipeline layout" << vk::to_string(pipelineLayoutResult);
+        return nullptr;
+    }
+
+    auto [pipelineCacheResult, pipelineCache] = device->logicalDevice().createPipelineCache(vk::PipelineCacheCreateInfo{});
+    if (pipelineCacheResult != vk::Result::eSuccess) {
+        qCWarning(KWIN_VULKAN) << "Failed to create a pipeline cache" << vk::to_string(pipelineCacheResult);
+        return nullptr;
+    }
+
+    auto vertexShader = createShaderModule(device, s_itemVertexShader);
+    auto fragmentShader = createShaderModule(device, s_itemFragmentShader);
+    if (!*vertexShader || !*fragmentShader) {
+        return nullptr;
+    }
+
+    return std::make_unique<PipelineManagerVulkan>(device,
+                                                   std::move(sampler),
+                                                   std::move(descriptorSetLayout),
+                                                   std::move(pipelineLayout),
+                                                   std::move(pipelineCache),
+                                                   std::move(vertexShader),
+                                                   std::move(fragmentShader));
+}
+
+} // namespace KWin
@@ -0,0 +1,132 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QFlags>
+#include <QFuture>
+#include <QHash>
+#include <QList>
+
+#include <memory>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace KWin
+{
+
+class VulkanDevice;
+
+/**
+ * The PipelineTrait enum matches the ShaderTrait enum of the OpenGL renderer, but only the
+ * traits that the Vulkan item shaders support are listed.
+ */
+enum class PipelineTrait {
+    MapTexture = (1 << 0),
+    UniformColor = (1 << 1),
+    Modulate = (1 << 2),
+    AdjustSaturation = (1 << 3),
+    RoundedCorners = (1 << 4),
+    Border = (1 << 5),
+};
+
+Q_DECLARE_FLAGS(PipelineTraits, PipelineTrait)
+
+enum class PipelineBlendMode {
+    None,
+    PremultipliedAlpha,
+    Hole,
+};
+
+struct PipelineKey
+{
+    PipelineTraits traits;
+    PipelineBlendMode blendMode = PipelineBlendMode::None;
+    vk::Format format = vk::Format::eUndefined;
+
+    bool operator==(const PipelineKey &other) const = default;
+};
+
+inline size_t qHash(const PipelineKey &key, size_t seed = 0)
+{
+    return qHashMulti(seed, key.traits.toInt(), int(key.blendMode), int(key.format));
+}
+
+/**
+ * The push constants of the item shaders, the layout must match item.vert and item.frag.
+ */
+struct PipelinePushConstants
+{
+    float modelViewProjectionMatrix[16];
+    float modulation[4];
+    float geometryColor[4];
+    float box[4];
+    float cornerRadius[4];
+};
+
+static_assert(sizeof(PipelinePushConstants) == 128, "Vulkan only guarantees 128 bytes of push constants");
+
+/**
+ * The PipelineManagerVulkan class creates the graphics pipelines for the item renderer. There
+ * is one pipeline for every combination of traits, blend mode and render target format. All
+ * variants are specialized from the same shader modules, the traits are passed as
+ * specialization constants.
+ *
+ * Pipelines are created on demand, but the commonly needed ones can be created ahead of time
+ * in a worker thread with prewarm() so the first frames that need them are not late.
+ */
+class KWIN_EXPORT PipelineManagerVulkan
+{
+public:
+    explicit PipelineManagerVulkan(VulkanDevice *device,
+                                   vk::raii::Sampler &&sampler,
+                                   vk::raii::DescriptorSetLayout &&descriptorSetLayout,
+                                   vk::raii::PipelineLayout &&pipelineLayout,
+                                   vk::raii::PipelineCache &&pipelineCache,
+                                   vk::raii::ShaderModule &&vertexShader,
+                                   vk::raii::ShaderModule &&fragmentShader);
+    ~PipelineManagerVulkan();
+
+    const vk::raii::DescriptorSetLayout &descriptorSetLayout() const;
+    const vk::raii::PipelineLayout &pipelineLayout() const;
+
+    /**
+     * Returns the pipeline for the given @a key, or a null handle if it can't be created.
+     */
+    vk::Pipeline pipeline(const PipelineKey &key);
+
+    /**
+     * Creates the pipelines for the given @a keys in the background.
+     */
+    void prewarm(const QList<PipelineKey> &keys);
+
+    /**
+     * Returns the pipelines that are commonly needed to render the scene into a render target
+     * with the given @a format.
+     */
+    static QList<PipelineKey> commonPipelines(vk::Format format);
+
+    static std::unique_ptr<PipelineManagerVulkan> create(VulkanDevice *device);
+
+private:
+    vk::raii::Pipeline createPipeline(const PipelineKey &key) const;
+    void collectPrewarmedPipelines();
+
+    VulkanDevice *const m_device;
+    vk::raii::Sampler m_sampler;
+    vk::raii::DescriptorSetLayout m_descriptorSetLayout;
+    vk::raii::PipelineLayout m_pipelineLayout;
+    vk::raii::PipelineCache m_pipelineCache;
+    vk::raii::ShaderModule m_vertexShader;
+    vk::raii::ShaderModule m_fragmentShader;
+    QHash<PipelineKey, std::shared_ptr<vk::raii::Pipeline>> m_pipelines;
+    QFuture<QList<std::pair<PipelineKey, std::shared_ptr<vk::raii::Pipeline>>>> m_prewarmed;
+};
+
+} // namespace KWin
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(KWin::PipelineTraits)
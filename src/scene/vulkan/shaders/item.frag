@@ -0,0 +1,69 @@
+#version 450
+
+#include "sdf.glsl"
+
+// The traits are specialization constants, so the driver can drop the unused code when
+// the pipeline is created and every variant is still built from the same SPIR-V module.
+layout(constant_id = 0) const bool traitMapTexture = false;
+layout(constant_id = 1) const bool traitUniformColor = false;
+layout(constant_id = 2) const bool traitModulate = false;
+layout(constant_id = 3) const bool traitAdjustSaturation = false;
+layout(constant_id = 4) const bool traitRoundedCorners = false;
+layout(constant_id = 5) const bool traitBorder = false;
+
+layout(set = 0, binding = 0) uniform sampler2D sampler0;
+
+layout(location = 0) in vec2 texcoord0;
+layout(location = 1) in vec2 position0;
+
+layout(location = 0) out vec4 fragColor;
+
+layout(push_constant) uniform PushConstants {
+    mat4 modelViewProjectionMatrix;
+    // x: color factor, y: alpha factor, z: saturation, w: border thickness
+    vec4 modulation;
+    vec4 geometryColor;
+    vec4 box;
+    vec4 cornerRadius;
+};
+
+// The primary brightness of sRGB, color management is not supported yet.
+const vec3 primaryBrightness = vec3(0.2126, 0.7152, 0.0722);
+
+void main()
+{
+    vec4 result = vec4(0.0);
+
+    if (traitMapTexture) {
+        result = texture(sampler0, texcoord0);
+    }
+    if (traitUniformColor) {
+        result = geometryColor;
+    }
+
+    if (traitBorder) {
+        float thickness = modulation.w;
+        float inner = sdfRoundedBox(position0, box.xy, box.zw, cornerRadius);
+        float outer = sdfRoundedBox(position0, box.xy, box.zw + vec2(thickness), cornerRadius + vec4(thickness));
+        float f = sdfSubtract(outer, inner);
+        float df = fwidth(f);
+        result = geometryColor * (1.0 - clamp(0.5 + f / df, 0.0, 1.0));
+    }
+
+    if (traitRoundedCorners) {
+        float f = sdfRoundedBox(position0, box.xy, box.zw, cornerRadius);
+        float df = fwidth(f);
+        result *= 1.0 - clamp(0.5 + f / df, 0.0, 1.0);
+    }
+
+    if (traitAdjustSaturation) {
+        float Y = dot(result.rgb, primaryBrightness);
+        result.rgb = mix(vec3(Y), result.rgb, modulation.z);
+    }
+
+    if (traitModulate) {
+        result *= modulation.xxxy;
+    }
+
+    fragColor = result;
+}
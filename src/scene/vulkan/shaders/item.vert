@@ -0,0 +1,22 @@
+#version 450
+
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec2 texcoord;
+
+layout(location = 0) out vec2 texcoord0;
+layout(location = 1) out vec2 position0;
+
+layout(push_constant) uniform PushConstants {
+    mat4 modelViewProjectionMatrix;
+    vec4 modulation;
+    vec4 geometryColor;
+    vec4 box;
+    vec4 cornerRadius;
+};
+
+void main()
+{
+    texcoord0 = texcoord;
+    position0 = position;
+    gl_Position = modelViewProjectionMatrix * vec4(position, 0.0, 1.0);
+}
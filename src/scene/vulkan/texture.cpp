@@ -0,0 +1,365 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "scene/vulkan/texture.h"
+#include "core/drm_formats.h"
+#include "core/graphicsbuffer.h"
+#include "core/graphicsbufferview.h"
+#include "core/region.h"
+#include "vulkan/vulkan_device.h"
+#include "vulkan/vulkan_logging.h"
+#include "vulkan/vulkan_texture.h"
+
+namespace KWin
+{
+
+static constexpr vk::ImageUsageFlags s_uploadUsage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc;
+
+static QImage::Format textureFormat(const QImage &image)
+{
+    // Other formats are either not widely supported for sampling or need swizzles.
+    switch (image.format()) {
+    case QImage::Format_ARGB32_Premultiplied:
+    case QImage::Format_RGB32:
+    case QImage::Format_RGBA8888_Premultiplied:
+    case QImage::Format_RGBX8888:
+    case QImage::Format_RGBA64_Premultiplied:
+    case QImage::Format_RGBX64:
+    case QImage::Format_RGBA16FPx4_Premultiplied:
+    case QImage::Format_RGBX16FPx4:
+        return image.format();
+    default:
+        return image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32;
+    }
+}
+
+static QImage convertImage(const QImage &image)
+{
+    const QImage::Format format = textureFormat(image);
+    if (image.format() == format) {
+        return image;
+    }
+    return image.convertToFormat(format);
+}
+
+TextureVulkan::TextureVulkan(VulkanDevice *device)
+    : m_device(device)
+{
+}
+
+TextureVulkan::~TextureVulkan()
+{
+}
+
+const std::shared_ptr<SampledImageVulkan> &TextureVulkan::image() const
+{
+    return m_image;
+}
+
+GraphicsBuffer *TextureVulkan::buffer() const
+{
+    return m_buffer;
+}
+
+bool TextureVulkan::setImage(std::shared_ptr<VulkanTexture> &&texture, bool hasAlphaChannel, bool external)
+{
+    // Formats without an alpha channel may have garbage in the padding bits.
+    const vk::ComponentMapping components = hasAlphaChannel
+        ? vk::ComponentMapping()
+        : vk::ComponentMapping(vk::ComponentSwizzle::eIdentity, vk::ComponentSwizzle::eIdentity, vk::ComponentSwizzle::eIdentity, vk::ComponentSwizzle::eOne);
+    auto view = texture->createView(components);
+    if (!*view) {
+        return false;
+    }
+
+    // The previous image may still be in use by the GPU, the renderer keeps it alive as needed.
+    m_image = std::make_shared<SampledImageVulkan>(SampledImageVulkan{
+        .texture = std::move(texture),
+        .view = std::move(view),
+        .external = external,
+    });
+    return true;
+}
+
+std::unique_ptr<ImageTextureVulkan> ImageTextureVulkan::create(VulkanDevice *device, const QImage &image)
+{
+    auto texture = std::make_unique<ImageTextureVulkan>(device);
+    if (texture->upload(image)) {
+        return texture;
+    }
+
+    return nullptr;
+}
+
+void ImageTextureVulkan::attach(GraphicsBuffer *buffer, const Region &region, const std::shared_ptr<SyncReleasePoint> &releasePoint)
+{
+    Q_UNREACHABLE();
+}
+
+bool ImageTextureVulkan::upload(const QImage &image)
+{
+    if (image.isNull()) {
+        return false;
+    }
+
+    std::shared_ptr<VulkanTexture> nativeTexture = VulkanTexture::upload(m_device, convertImage(image), s_uploadUsage);
+    if (!nativeTexture) {
+        return false;
+    }
+
+    if (!setImage(std::move(nativeTexture), image.hasAlphaChannel(), false)) {
+        return false;
+    }
+    m_size = image.size();
+    return true;
+}
+
+void ImageTextureVulkan::upload(const QImage &image, const Rect &region)
+{
+    const QImage converted = convertImage(image);
+    if (converted.size() != m_size || VulkanTexture::qImageToVulkanFormat(converted.format()) != m_image->texture->format()) {
+        upload(image);
+        return;
+    }
+    m_image->texture->update(converted, region & Rect(converted.rect()));
+}
+
+std::unique_ptr<BufferTextureVulkan> BufferTextureVulkan::create(VulkanDevice *device, GraphicsBuffer *buffer, const std::shared_ptr<SyncReleasePoint> &releasePoint)
+{
+    auto texture = std::make_unique<BufferTextureVulkan>(device);
+    if (texture->attach(buffer, releasePoint)) {
+        return texture;
+    }
+
+    return nullptr;
+}
+
+bool BufferTextureVulkan::attach(GraphicsBuffer *buffer, const std::shared_ptr<SyncReleasePoint> &releasePoint)
+{
+    if (buffer->dmabufAttributes()) {
+        return loadDmabufTexture(buffer, releasePoint);
+    } else if (buffer->shmAttributes()) {
+        if (auto texture = m_device->importUdmabuf(buffer, VK_IMAGE_USAGE_SAMPLED_BIT)) {
+            return loadUDmabufTexture(buffer, std::move(texture), releasePoint);
+        } else {
+            return loadShmTexture(buffer);
+        }
+    } else if (buffer->singlePixelAttributes()) {
+        return loadSinglePixelTexture(buffer);
+    } else {
+        qCDebug(KWIN_VULKAN) << "Failed to create a Vulkan surface texture for a buffer of unknown type" << buffer;
+        return false;
+    }
+}
+
+void BufferTextureVulkan::attach(GraphicsBuffer *buffer, const Region &region, const std::shared_ptr<SyncReleasePoint> &releasePoint)
+{
+    if (buffer->dmabufAttributes()) {
+        updateDmabufTexture(buffer, releasePoint);
+    } else if (buffer->shmAttributes()) {
+        if (auto texture = m_device->importUdmabuf(buffer, VK_IMAGE_USAGE_SAMPLED_BIT)) {
+            updateUDmabufTexture(buffer, std::move(texture), releasePoint);
+        } else {
+            updateShmTexture(buffer, region, releasePoint);
+        }
+    } else if (buffer->singlePixelAttributes()) {
+        updateSinglePixelTexture(buffer, releasePoint);
+    } else {
+        qCDebug(KWIN_VULKAN) << "Failed to update a Vulkan surface texture for a buffer of unknown type" << buffer;
+    }
+}
+
+void BufferTextureVulkan::upload(const QImage &image, const Rect &region)
+{
+    Q_UNREACHABLE();
+}
+
+void BufferTextureVulkan::reset()
+{
+    m_image.reset();
+    m_buffer = nullptr;
+    m_bufferType = BufferType::None;
+    m_size = QSize();
+    m_releasePoint.reset();
+}
+
+bool BufferTextureVulkan::loadShmTexture(GraphicsBuffer *buffer)
+{
+    const GraphicsBufferView view(buffer);
+    if (Q_UNLIKELY(view.isNull())) {
+        return false;
+    }
+
+    std::shared_ptr<VulkanTexture> texture = VulkanTexture::upload(m_device, convertImage(*view.image()), s_uploadUsage);
+    if (Q_UNLIKELY(!texture)) {
+        return false;
+    }
+    if (!setImage(std::move(texture), buffer->hasAlphaChannel(), false)) {
+        return false;
+    }
+
+    m_bufferType = BufferType::Shm;
+    m_size = buffer->size();
+    const auto info = FormatInfo::get(buffer->shmAttributes()->format);
+    m_isFloatingPoint = info && info->floatingPoint;
+
+    return true;
+}
+
+static Region simplifyDamage(const Region &damage)
+{
+    if (damage.rects().size() < 3) {
+        return damage;
+    } else {
+        return damage.boundingRect();
+    }
+}
+
+void BufferTextureVulkan::updateShmTexture(GraphicsBuffer *buffer, const Region &region, const std::shared_ptr<SyncReleasePoint> &releasePoint)
+{
+    if (Q_UNLIKELY(m_bufferType != BufferType::Shm) || m_size != buffer->size()) {
+        reset();
+        attach(buffer, releasePoint);
+        return;
+    }
+
+    const GraphicsBufferView view(buffer);
+    if (Q_UNLIKELY(view.isNull())) {
+        return;
+    }
+
+    const QImage image = convertImage(*view.image());
+    if (VulkanTexture::qImageToVulkanFormat(image.format()) != m_image->texture->format()) {
+        reset();
+        attach(buffer, releasePoint);
+        return;
+    }
+
+    // The copy is ordered against the frames that sample the texture on the GPU, see VulkanTexture::update().
+    m_image->texture->update(image, simplifyDamage(region) & Rect(QPoint(0, 0), m_size));
+}
+
+bool BufferTextureVulkan::loadDmabufTexture(GraphicsBuffer *buffer, const std::shared_ptr<SyncReleasePoint> &releasePoint)
+{
+    // Buffers from other GPUs and YUV buffers are rejected by VulkanBackend::testImportBuffer().
+    auto texture = m_device->importBuffer(buffer, VK_IMAGE_USAGE_SAMPLED_BIT);
+    if (!texture) {
+        qCDebug(KWIN_VULKAN) << "Failed to import dmabuf" << buffer;
+        return false;
+    }
+    if (!setImage(std::move(texture), buffer->hasAlphaChannel(), true)) {
+        return false;
+    }
+
+    m_bufferType = BufferType::DmaBuf;
+    m_buffer = buffer;
+    m_size = buffer->size();
+    m_releasePoint = releasePoint;
+    const auto info = FormatInfo::get(buffer->dmabufAttributes()->format);
+    m_isFloatingPoint = info && info->floatingPoint;
+
+    return true;
+}
+
+void BufferTextureVulkan::updateDmabufTexture(GraphicsBuffer *buffer, const std::shared_ptr<SyncReleasePoint> &releasePoint)
+{
+    if (Q_UNLIKELY(m_bufferType != BufferType::DmaBuf)) {
+        reset();
+        attach(buffer, releasePoint);
+        return;
+    }
+
+    // The imported image is cached by the device, so only a new view has to be created if
+    // the client cycles through a set of buffers.
+    if (m_buffer != buffer) {
+        if (!loadDmabufTexture(buffer, releasePoint)) {
+            reset();
+        }
+        return;
+    }
+    m_releasePoint = releasePoint;
+}
+
+bool BufferTextureVulkan::loadUDmabufTexture(GraphicsBuffer *buffer, std::shared_ptr<VulkanTexture> &&texture, const std::shared_ptr<SyncReleasePoint> &releasePoint)
+{
+    if (!setImage(std::move(texture), buffer->hasAlphaChannel(), true)) {
+        return false;
+    }
+
+    // The renderer keeps the buffer referenced and signals the release point once the GPU is
+    // done with it, so the client can't write to the memory while it's being sampled.
+    m_bufferType = BufferType::UDmaBuf;
+    m_buffer = buffer;
+    m_size = buffer->size();
+    m_releasePoint = releasePoint;
+    const auto info = FormatInfo::get(buffer->shmAttributes()->format);
+    m_isFloatingPoint = info && info->floatingPoint;
+
+    return true;
+}
+
+void BufferTextureVulkan::updateUDmabufTexture(GraphicsBuffer *buffer, std::shared_ptr<VulkanTexture> &&texture, const std::shared_ptr<SyncReleasePoint> &releasePoint)
+{
+    if (Q_UNLIKELY(m_bufferType != BufferType::UDmaBuf)) {
+        reset();
+        attach(buffer, releasePoint);
+        return;
+    }
+
+    // The client writes directly into the sampled memory, only a new buffer needs a new view.
+    if (m_buffer != buffer) {
+        if (!loadUDmabufTexture(buffer, std::move(texture), releasePoint)) {
+            reset();
+        }
+        return;
+    }
+    m_releasePoint = releasePoint;
+}
+
+bool BufferTextureVulkan::loadSinglePixelTexture(GraphicsBuffer *buffer)
+{
+    // A 1x1 texture keeps single pixel buffers on the same pipelines as other buffers.
+    const GraphicsBufferView view(buffer);
+    if (Q_UNLIKELY(view.isNull())) {
+        return false;
+    }
+
+    std::shared_ptr<VulkanTexture> texture = VulkanTexture::upload(m_device, convertImage(*view.image()), s_uploadUsage);
+    if (Q_UNLIKELY(!texture)) {
+        return false;
+    }
+    if (!setImage(std::move(texture), true, false)) {
+        return false;
+    }
+
+    m_bufferType = BufferType::SinglePixel;
+    m_size = QSize(1, 1);
+    m_isFloatingPoint = false;
+    return true;
+}
+
+void BufferTextureVulkan::updateSinglePixelTexture(GraphicsBuffer *buffer, const std::shared_ptr<SyncReleasePoint> &releasePoint)
+{
+    if (Q_UNLIKELY(m_bufferType != BufferType::SinglePixel)) {
+        reset();
+        attach(buffer, releasePoint);
+        return;
+    }
+
+    const GraphicsBufferView view(buffer);
+    if (Q_UNLIKELY(view.isNull())) {
+        return;
+    }
+    const QImage image = convertImage(*view.image());
+    if (VulkanTexture::qImageToVulkanFormat(image.format()) != m_image->texture->format()) {
+        reset();
+        attach(buffer, releasePoint);
+        return;
+    }
+    m_image->texture->update(image);
+}
+
+} // namespace KWin
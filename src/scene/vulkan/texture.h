@@ -0,0 +1,106 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "scene/texture.h"
+
+#include <QImage>
+
+#include <memory>
+#include <vulkan/vulkan_raii.hpp>
+
+namespace KWin
+{
+
+class VulkanDevice;
+class VulkanTexture;
+
+/**
+ * The SampledImageVulkan type holds an image and the view that the item shaders sample. It's
+ * reference counted so the renderer can keep it alive until the frames that use it are done.
+ */
+struct SampledImageVulkan
+{
+    std::shared_ptr<VulkanTexture> texture;
+    vk::raii::ImageView view{nullptr};
+    /**
+     * Whether the image is backed by a dmabuf and must be acquired from the external queue
+     * family before it can be sampled.
+     */
+    bool external = false;
+};
+
+class TextureVulkan : public Texture
+{
+public:
+    explicit TextureVulkan(VulkanDevice *device);
+    ~TextureVulkan() override;
+
+    const std::shared_ptr<SampledImageVulkan> &image() const;
+
+    /**
+     * Returns the graphics buffer whose memory is sampled directly, if any.
+     */
+    GraphicsBuffer *buffer() const;
+
+protected:
+    bool setImage(std::shared_ptr<VulkanTexture> &&texture, bool hasAlphaChannel, bool external);
+
+    VulkanDevice *const m_device;
+    std::shared_ptr<SampledImageVulkan> m_image;
+    GraphicsBuffer *m_buffer = nullptr;
+};
+
+class ImageTextureVulkan : public TextureVulkan
+{
+public:
+    static std::unique_ptr<ImageTextureVulkan> create(VulkanDevice *device, const QImage &image);
+
+    using TextureVulkan::TextureVulkan;
+
+    void attach(GraphicsBuffer *buffer, const Region &region, const std::shared_ptr<SyncReleasePoint> &releasePoint) override;
+
+    bool upload(const QImage &image);
+    void upload(const QImage &image, const Rect &region) override;
+};
+
+class BufferTextureVulkan : public TextureVulkan
+{
+public:
+    static std::unique_ptr<BufferTextureVulkan> create(VulkanDevice *device, GraphicsBuffer *buffer, const std::shared_ptr<SyncReleasePoint> &releasePoint);
+
+    using TextureVulkan::TextureVulkan;
+
+    bool attach(GraphicsBuffer *buffer, const std::shared_ptr<SyncReleasePoint> &releasePoint);
+    void attach(GraphicsBuffer *buffer, const Region &region, const std::shared_ptr<SyncReleasePoint> &releasePoint) override;
+
+    void upload(const QImage &image, const Rect &region) override;
+
+private:
+    void reset();
+
+    bool loadShmTexture(GraphicsBuffer *buffer);
+    void updateShmTexture(GraphicsBuffer *buffer, const Region &region, const std::shared_ptr<SyncReleasePoint> &releasePoint);
+    bool loadDmabufTexture(GraphicsBuffer *buffer, const std::shared_ptr<SyncReleasePoint> &releasePoint);
+    void updateDmabufTexture(GraphicsBuffer *buffer, const std::shared_ptr<SyncReleasePoint> &releasePoint);
+    bool loadUDmabufTexture(GraphicsBuffer *buffer, std::shared_ptr<VulkanTexture> &&texture, const std::shared_ptr<SyncReleasePoint> &releasePoint);
+    void updateUDmabufTexture(GraphicsBuffer *buffer, std::shared_ptr<VulkanTexture> &&texture, const std::shared_ptr<SyncReleasePoint> &releasePoint);
+    bool loadSinglePixelTexture(GraphicsBuffer *buffer);
+    void updateSinglePixelTexture(GraphicsBuffer *buffer, const std::shared_ptr<SyncReleasePoint> &releasePoint);
+
+    enum class BufferType {
+        None,
+        Shm,
+        DmaBuf,
+        UDmaBuf,
+        SinglePixel,
+    };
+
+    BufferType m_bufferType = BufferType::None;
+};
+
+} // namespace KWin
@@ -103,6 +103,10 @@ WorkspaceScene::WorkspaceScene()
     connect(waylandServer()->seat(), &SeatInterface::dragStarted, this, &WorkspaceScene::createDndIconItem);
     connect(waylandServer()->seat(), &SeatInterface::dragEnded, this, &WorkspaceScene::destroyDndIconItem);
 
+    connect(this, &Scene::viewRemoved, this, [this](RenderView *view) {
+        m_opaqueRegionCache.remove(view);
+    });
+
     // make sure it's over the dnd icon
     m_cursorItem->setZ(1);
     connect(Cursors::self(), &Cursors::hiddenChanged, this, &WorkspaceScene::updateCursor);
@@ -530,6 +534,7 @@ void WorkspaceScene::prePaint(SceneView *delegate, OutputFrame *frame)
 {
     painted_delegate = delegate;
     painted_screen = painted_delegate->logicalOutput();
+    ++m_frameCounter;
 
     createStackingOrder();
 
@@ -631,6 +636,52 @@ static void addOpaqueRegionRecursive(SceneView *view, Item *item, const std::opt
     }
 }
 
+Region WorkspaceScene::opaqueRegion(SceneView *view, Item *item)
+{
+    // Child items are positioned relative to their parent, so the position of the parent in
+    // the view is enough to tell whether the item tree has been moved.
+    const QPointF origin = item->parentItem() ? item->parentItem()->mapToView(RectF(), view).topLeft() : QPointF();
+
+    OpaqueRegionCacheEntry &entry = m_opaqueRegionCache[view][item];
+    // The item may have been destroyed and another one allocated at the same address.
+    if (entry.item != item
+        || entry.occlusionGeneration != item->occlusionGeneration()
+        || entry.viewport != view->viewport()
+        || entry.scale != view->scale()
+        || entry.renderOffset != view->renderOffset()
+        || entry.origin != origin) {
+        Region deviceOpaque;
+        addOpaqueRegionRecursive(view, item, std::nullopt, deviceOpaque);
+        entry = OpaqueRegionCacheEntry{
+            .item = item,
+            .occlusionGeneration = item->occlusionGeneration(),
+            .viewport = view->viewport(),
+            .scale = view->scale(),
+            .renderOffset = view->renderOffset(),
+            .origin = origin,
+            .deviceOpaque = std::move(deviceOpaque),
+        };
+    }
+
+    entry.lastUsedFrame = m_frameCounter;
+    return entry.deviceOpaque;
+}
+
+void WorkspaceScene::pruneOpaqueRegionCache(RenderView *view)
+{
+    auto cache = m_opaqueRegionCache.find(view);
+    if (cache == m_opaqueRegionCache.end()) {
+        return;
+    }
+    for (auto it = cache->begin(); it != cache->end();) {
+        if (!it->item || it->lastUsedFrame != m_frameCounter) {
+            it = cache->erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 void WorkspaceScene::preparePaintSimpleScreen()
 {
     for (WindowItem *windowItem : std::as_const(stacking_order)) {
@@ -642,7 +693,7 @@ void WorkspaceScene::preparePaintSimpleScreen()
 
         Region opaque;
         if (window->opacity() == 1.0 && !(data.mask & PAINT_WINDOW_TRANSLUCENT)) {
-            addOpaqueRegionRecursive(painted_delegate, windowItem, std::nullopt, opaque);
+            opaque = opaqueRegion(painted_delegate, windowItem);
         }
         m_paintContext.phase2Data.append(Phase2Data{
             .item = windowItem,
@@ -670,8 +721,7 @@ Region WorkspaceScene::collectDamage()
         accumulateRepaints(m_overlayItem.get(), painted_delegate, &m_paintContext.deviceDamage, &accumulatedRepaints, &forceTranslucent);
 
         // Perform an occlusion cull pass, to remove surface damage occluded by opaque windows.
-        Region opaque;
-        addOpaqueRegionRecursive(painted_delegate, m_overlayItem.get(), std::nullopt, opaque);
+        Region opaque = opaqueRegion(painted_delegate, m_overlayItem.get());
         for (auto &paintData : m_paintContext.phase2Data | std::views::reverse) {
             m_paintContext.deviceDamage |= paintData.deviceRegion - opaque;
 
@@ -691,6 +741,10 @@ void WorkspaceScene::postPaint()
 {
     effects->postPaintScreen();
 
+    if (!(m_paintContext.mask & (PAINT_SCREEN_TRANSFORMED | PAINT_SCREEN_WITH_TRANSFORMED_WINDOWS))) {
+        pruneOpaqueRegionCache(painted_delegate);
+    }
+
     painted_delegate = nullptr;
     painted_screen = nullptr;
     clearStackingOrder();
@@ -12,6 +12,8 @@
 #include "core/renderviewport.h"
 #include "scene/scene.h"
 
+#include <QPointer>
+
 namespace KWin
 {
 
@@ -115,6 +117,26 @@ protected:
     QList<WindowItem *> stacking_order;
 
 private:
+    /**
+     * The OpaqueRegionCacheEntry type holds the opaque region of an item and its descendants in
+     * the device coordinates of a view. It stays valid until the occlusion generation of the item
+     * changes or the item is mapped differently to the view.
+     */
+    struct OpaqueRegionCacheEntry
+    {
+        QPointer<Item> item;
+        quint64 occlusionGeneration = 0;
+        quint64 lastUsedFrame = 0;
+        RectF viewport;
+        qreal scale = 0;
+        QPoint renderOffset;
+        QPointF origin;
+        Region deviceOpaque;
+    };
+
+    Region opaqueRegion(SceneView *view, Item *item);
+    void pruneOpaqueRegionCache(RenderView *view);
+
     void createDndIconItem();
     void destroyDndIconItem();
     void updateCursor();
@@ -125,6 +147,8 @@ private:
     std::unique_ptr<DragAndDropIconItem> m_dndIcon;
     std::unique_ptr<CursorItem> m_cursorItem;
     bool m_layerDebugging = false;
+    QHash<RenderView *, QHash<Item *, OpaqueRegionCacheEntry>> m_opaqueRegionCache;
+    quint64 m_frameCounter = 0;
 };
 
 } // namespace
@@ -0,0 +1,123 @@
+/*
+    SPDX-FileCopyrightText: 2022 Vlad Zahorodnii <vlad.zahorodnii@kde.org>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "utils/damagejournal.h"
+
+namespace KWin
+{
+
+// The accumulated damage that hasn't been queried in that many frames is dropped.
+static constexpr int s_trimInterval = 16;
+
+int DamageJournal::capacity() const
+{
+    return m_capacity;
+}
+
+void DamageJournal::setCapacity(int capacity)
+{
+    if (m_capacity == capacity) {
+        return;
+    }
+
+    QList<Region> log;
+    log.reserve(capacity);
+    for (int i = std::min(m_size, capacity) - 1; i >= 0; --i) {
+        log.append(at(i));
+    }
+
+    m_log = log;
+    m_head = log.size() - 1;
+    m_size = log.size();
+    m_capacity = capacity;
+
+    if (m_accumulated.size() > capacity) {
+        m_accumulated.resize(capacity);
+    }
+}
+
+const Region &DamageJournal::at(int index) const
+{
+    // index 0 refers to the most recent damage region
+    const int position = m_head - index;
+    return m_log[position < 0 ? position + m_log.size() : position];
+}
+
+void DamageJournal::add(const Region &region)
+{
+    if (m_capacity <= 0) {
+        return;
+    }
+
+    if (m_log.size() < m_capacity) {
+        m_log.append(region);
+        m_head = m_log.size() - 1;
+    } else {
+        m_head = (m_head + 1) % m_capacity;
+        m_log[m_head] = region;
+    }
+    m_size = std::min(m_size + 1, m_capacity);
+
+    if (++m_framesSinceTrim >= s_trimInterval) {
+        if (m_accumulated.size() > m_queriedDepth) {
+            m_accumulated.resize(m_queriedDepth);
+        }
+        m_queriedDepth = 0;
+        m_framesSinceTrim = 0;
+    }
+
+    for (qsizetype i = m_accumulated.size() - 1; i > 0; --i) {
+        m_accumulated[i] = region | m_accumulated[i - 1];
+    }
+    if (!m_accumulated.isEmpty()) {
+        m_accumulated[0] = region;
+    }
+}
+
+void DamageJournal::clear()
+{
+    m_log.clear();
+    m_head = 0;
+    m_size = 0;
+    m_accumulated.clear();
+    m_queriedDepth = 0;
+    m_framesSinceTrim = 0;
+}
+
+void DamageJournal::rebuildAccumulated(int depth) const
+{
+    m_accumulated.resize(depth);
+    m_accumulated[0] = at(0);
+    for (int i = 1; i < depth; ++i) {
+        m_accumulated[i] = m_accumulated[i - 1] | at(i);
+    }
+}
+
+Region DamageJournal::accumulate(int bufferAge, const Region &fallback) const
+{
+    if (bufferAge <= 0 || bufferAge > m_size) {
+        return fallback;
+    } else if (bufferAge == 1) {
+        return Region();
+    }
+
+    // The accumulated damage for the given buffer age is not tracked yet. Compute it, subsequent
+    // calls to add() will keep it up to date.
+    const int depth = bufferAge - 1;
+    if (depth > m_accumulated.size()) {
+        rebuildAccumulated(depth);
+    }
+    m_queriedDepth = std::max(m_queriedDepth, depth);
+
+    return m_accumulated[depth - 1];
+}
+
+Region DamageJournal::lastDamage() const
+{
+    return at(0);
+}
+
+} // namespace KWin
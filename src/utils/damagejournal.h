@@ -15,6 +15,13 @@ namespace KWin
 
 /**
  * The DamageJournal class is a helper that tracks last N damage regions.
+ *
+ * The damage regions are stored in a ring buffer. Besides the damage regions, the journal also
+ * keeps the accumulated damage for every buffer age that has been queried so far, and updates it
+ * incrementally as new damage is added. So accumulate() doesn't need to unite damage regions in
+ * the steady state, when the buffer age doesn't change from frame to frame. The accumulated damage
+ * for buffer ages that haven't been queried for a while is dropped, so a single query with a big
+ * buffer age doesn't make every following add() more expensive.
  */
 class KWIN_EXPORT DamageJournal
 {
@@ -22,39 +29,24 @@ public:
     /**
      * Returns the maximum number of damage regions that can be stored in the journal.
      */
-    int capacity() const
-    {
-        return m_capacity;
-    }
+    int capacity() const;
 
     /**
      * Sets the maximum number of damage regions that can be stored in the journal
      * to @a capacity.
      */
-    void setCapacity(int capacity)
-    {
-        m_capacity = capacity;
-    }
+    void setCapacity(int capacity);
 
     /**
      * Adds the specified @a region to the journal.
      */
-    void add(const Region &region)
-    {
-        while (m_log.size() >= m_capacity) {
-            m_log.removeLast();
-        }
-        m_log.prepend(region);
-    }
+    void add(const Region &region);
 
     /**
      * Clears the damage journal. Typically, one would want to clear the damage journal
      * if a buffer swap fails for some reason.
      */
-    void clear()
-    {
-        m_log.clear();
-    }
+    void clear();
 
     /**
      * Accumulates the damage regions in the log up to the specified @a bufferAge.
@@ -62,27 +54,28 @@ public:
      * If the specified buffer age value refers to a damage region older than the last
      * one in the journal, @a fallback will be returned.
      */
-    Region accumulate(int bufferAge, const Region &fallback = Region()) const
-    {
-        Region region;
-        if (bufferAge > 0 && bufferAge <= m_log.size()) {
-            for (int i = 0; i < bufferAge - 1; ++i) {
-                region += m_log[i];
-            }
-        } else {
-            region = fallback;
-        }
-        return region;
-    }
+    Region accumulate(int bufferAge, const Region &fallback = Region()) const;
 
-    Region lastDamage() const
-    {
-        return m_log.first();
-    }
+    Region lastDamage() const;
 
 private:
+    const Region &at(int index) const;
+    void rebuildAccumulated(int depth) const;
+
     QList<Region> m_log;
+    int m_head = 0;
+    int m_size = 0;
     int m_capacity = 10;
+
+    /**
+     * m_accumulated[i] is the union of the i + 1 most recent damage regions.
+     */
+    mutable QList<Region> m_accumulated;
+    /**
+     * The deepest accumulated damage queried since m_accumulated has been trimmed last time.
+     */
+    mutable int m_queriedDepth = 0;
+    int m_framesSinceTrim = 0;
 };
 
 } // namespace KWin
@@ -0,0 +1,81 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QList>
+
+#include <algorithm>
+#include <chrono>
+
+namespace KWin
+{
+
+/**
+ * The FailedConfigurationCache class remembers hardware configurations that failed a test,
+ * so that they are not tested again on every frame.
+ *
+ * Failures can be transient, for example because of memory bandwidth used by other outputs,
+ * so a configuration is forgotten after the retry interval. Only the most recent failures are
+ * kept, the oldest one is dropped when the cache is full.
+ */
+template<typename Configuration>
+class FailedConfigurationCache
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::seconds s_retryInterval = std::chrono::seconds(2);
+    static constexpr qsizetype s_capacity = 16;
+
+    /**
+     * Returns @c true if the @a configuration failed and hasn't expired at @a now yet.
+     */
+    bool contains(const Configuration &configuration, Clock::time_point now = Clock::now())
+    {
+        m_entries.removeIf([now](const Entry &entry) {
+            return entry.retry <= now;
+        });
+        return std::ranges::any_of(m_entries, [&configuration](const Entry &entry) {
+            return entry.configuration == configuration;
+        });
+    }
+
+    /**
+     * Remembers that the @a configuration failed at @a now.
+     */
+    void insert(const Configuration &configuration, Clock::time_point now = Clock::now())
+    {
+        if (m_entries.size() >= s_capacity) {
+            m_entries.removeFirst();
+        }
+        m_entries.push_back(Entry{
+            .configuration = configuration,
+            .retry = now + s_retryInterval,
+        });
+    }
+
+    void clear()
+    {
+        m_entries.clear();
+    }
+
+    qsizetype size() const
+    {
+        return m_entries.size();
+    }
+
+private:
+    struct Entry
+    {
+        Configuration configuration;
+        Clock::time_point retry;
+    };
+
+    QList<Entry> m_entries;
+};
+
+} // namespace KWin
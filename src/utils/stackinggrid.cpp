@@ -0,0 +1,128 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "utils/stackinggrid.h"
+
+#include <algorithm>
+
+namespace KWin
+{
+
+/**
+ * The maximum number of cells that an entry can occupy. Bigger entries are checked at every point.
+ */
+static constexpr qint64 s_maxCellsPerEntry = 1024;
+
+StackingGrid::StackingGrid(qreal cellSize)
+    : m_cellSize(cellSize)
+{
+}
+
+int StackingGrid::size() const
+{
+    return m_bounds.size();
+}
+
+std::optional<RectF> StackingGrid::bounds(int index) const
+{
+    return m_bounds[index];
+}
+
+void StackingGrid::reset(const QList<std::optional<RectF>> &bounds)
+{
+    m_bounds = bounds;
+    m_cells.clear();
+    m_unbounded.clear();
+
+    for (int i = 0; i < m_bounds.size(); ++i) {
+        insert(i);
+    }
+}
+
+void StackingGrid::update(int index, const std::optional<RectF> &bounds)
+{
+    if (m_bounds[index] == bounds) {
+        return;
+    }
+
+    remove(index);
+    m_bounds[index] = bounds;
+    insert(index);
+}
+
+quint64 StackingGrid::cellKey(int x, int y)
+{
+    return (quint64(quint32(x)) << 32) | quint32(y);
+}
+
+std::optional<StackingGrid::CellRange> StackingGrid::cellRange(const RectF &rect) const
+{
+    // The right and the bottom edges are exclusive, so is the last cell in each direction.
+    const qreal left = std::floor(rect.left() / m_cellSize);
+    const qreal top = std::floor(rect.top() / m_cellSize);
+    const qreal right = std::ceil(rect.right() / m_cellSize) - 1;
+    const qreal bottom = std::ceil(rect.bottom() / m_cellSize) - 1;
+    if ((right - left + 1) * (bottom - top + 1) > s_maxCellsPerEntry) {
+        return std::nullopt;
+    }
+
+    return CellRange{
+        .left = int(left),
+        .top = int(top),
+        .right = int(right),
+        .bottom = int(bottom),
+    };
+}
+
+void StackingGrid::insert(int index)
+{
+    const std::optional<RectF> &bounds = m_bounds[index];
+    if (bounds && bounds->isEmpty()) {
+        return;
+    }
+
+    const std::optional<CellRange> range = bounds ? cellRange(*bounds) : std::nullopt;
+    if (!range) {
+        m_unbounded.insert(std::lower_bound(m_unbounded.begin(), m_unbounded.end(), index), index);
+        return;
+    }
+
+    for (int y = range->top; y <= range->bottom; ++y) {
+        for (int x = range->left; x <= range->right; ++x) {
+            QList<int> &cell = m_cells[cellKey(x, y)];
+            cell.insert(std::lower_bound(cell.begin(), cell.end(), index), index);
+        }
+    }
+}
+
+void StackingGrid::remove(int index)
+{
+    const std::optional<RectF> &bounds = m_bounds[index];
+    if (bounds && bounds->isEmpty()) {
+        return;
+    }
+
+    const std::optional<CellRange> range = bounds ? cellRange(*bounds) : std::nullopt;
+    if (!range) {
+        m_unbounded.removeOne(index);
+        return;
+    }
+
+    for (int y = range->top; y <= range->bottom; ++y) {
+        for (int x = range->left; x <= range->right; ++x) {
+            auto cell = m_cells.find(cellKey(x, y));
+            if (cell == m_cells.end()) {
+                continue;
+            }
+            cell->removeOne(index);
+            if (cell->isEmpty()) {
+                m_cells.erase(cell);
+            }
+        }
+    }
+}
+
+} // namespace KWin
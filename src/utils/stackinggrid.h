@@ -0,0 +1,117 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "core/rect.h"
+
+#include <QHash>
+#include <QList>
+
+#include <cmath>
+#include <optional>
+
+namespace KWin
+{
+
+/**
+ * The StackingGrid class is a spatial index that answers "what is the topmost entry at the given
+ * point" queries for a stack of rectangles.
+ *
+ * Entries are identified by their position in the stack, the entry with index 0 is at the bottom.
+ * The plane is divided into square cells, and every cell stores the indices of the entries whose
+ * bounds intersect it, sorted in the stacking order. A query only needs to look at the entries in
+ * one cell rather than walk the whole stack.
+ *
+ * An entry can have no bounds, in which case it is considered at every point. Entries that span too
+ * many cells are not added to the cells to keep updates cheap, they are checked at every point too.
+ */
+class KWIN_EXPORT StackingGrid
+{
+public:
+    explicit StackingGrid(qreal cellSize = 256);
+
+    /**
+     * Returns the number of entries in the stack.
+     */
+    int size() const;
+
+    /**
+     * Returns the bounds of the entry with the specified @a index. If the entry can be found at any
+     * point, @c std::nullopt is returned.
+     */
+    std::optional<RectF> bounds(int index) const;
+
+    /**
+     * Replaces all entries. The entry with index @c i gets the bounds @a bounds[i].
+     */
+    void reset(const QList<std::optional<RectF>> &bounds);
+
+    /**
+     * Changes the bounds of the entry with the specified @a index. Only the cells covered by the
+     * old and the new bounds are updated.
+     */
+    void update(int index, const std::optional<RectF> &bounds);
+
+    /**
+     * Returns the index of the topmost entry whose bounds contain the @a point and that is accepted
+     * by the @a accept predicate, or @c -1 if there is no such entry. The entries are passed to
+     * the predicate from top to bottom.
+     */
+    template<typename Predicate>
+    int topmostAt(const QPointF &point, Predicate accept) const;
+
+private:
+    struct CellRange
+    {
+        int left;
+        int top;
+        int right;
+        int bottom;
+    };
+
+    std::optional<CellRange> cellRange(const RectF &rect) const;
+    static quint64 cellKey(int x, int y);
+    void insert(int index);
+    void remove(int index);
+
+    qreal m_cellSize;
+    QList<std::optional<RectF>> m_bounds;
+    QHash<quint64, QList<int>> m_cells;
+    QList<int> m_unbounded;
+};
+
+template<typename Predicate>
+int StackingGrid::topmostAt(const QPointF &point, Predicate accept) const
+{
+    static const QList<int> emptyCell;
+
+    const auto cell = m_cells.constFind(cellKey(std::floor(point.x() / m_cellSize), std::floor(point.y() / m_cellSize)));
+    const QList<int> &cellEntries = cell != m_cells.constEnd() ? *cell : emptyCell;
+
+    // Both lists are sorted in the stacking order, merge them from the top.
+    auto cellIt = cellEntries.crbegin();
+    auto unboundedIt = m_unbounded.crbegin();
+    while (cellIt != cellEntries.crend() || unboundedIt != m_unbounded.crend()) {
+        int index;
+        if (unboundedIt == m_unbounded.crend() || (cellIt != cellEntries.crend() && *cellIt > *unboundedIt)) {
+            index = *cellIt++;
+        } else {
+            index = *unboundedIt++;
+        }
+        const std::optional<RectF> &bounds = m_bounds[index];
+        if (bounds && !bounds->contains(point)) {
+            continue;
+        }
+        if (accept(index)) {
+            return index;
+        }
+    }
+
+    return -1;
+}
+
+} // namespace KWin
@@ -0,0 +1,103 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "vulkan/vulkan_backend.h"
+#include "core/drm_formats.h"
+#include "core/gpumanager.h"
+#include "core/graphicsbuffer.h"
+#include "core/renderdevice.h"
+#include "vulkan/vulkan_device.h"
+#include "vulkan/vulkan_logging.h"
+#include "wayland_server.h"
+
+namespace KWin
+{
+
+VulkanBackend::VulkanBackend(RenderDevice *device)
+    : m_renderDevice(device)
+{
+}
+
+CompositingType VulkanBackend::compositingType() const
+{
+    return VulkanCompositing;
+}
+
+RenderDevice *VulkanBackend::renderDevice() const
+{
+    return m_renderDevice;
+}
+
+VulkanDevice *VulkanBackend::vulkanDevice() const
+{
+    return m_renderDevice->vulkanDevice();
+}
+
+static bool isYuvFormat(uint32_t format)
+{
+    const auto info = FormatInfo::get(format);
+    return info && info->yuvConversion();
+}
+
+/**
+ * The item shaders sample a single RGB image, YUV formats would need a conversion pass.
+ */
+static FormatModifierMap rgbFormats(const FormatModifierMap &formats)
+{
+    FormatModifierMap ret = formats;
+    for (auto it = ret.begin(); it != ret.end();) {
+        if (isYuvFormat(it.key())) {
+            it = ret.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return ret;
+}
+
+bool VulkanBackend::testImportBuffer(GraphicsBuffer *buffer, dev_t targetDevice)
+{
+    // Buffers from other GPUs are rejected, the client will either allocate the buffer
+    // on the render device or fall back to shared memory.
+    if (GpuManager::self()->compatibleRenderDevice(targetDevice) != m_renderDevice) {
+        qCDebug(KWIN_VULKAN) << "Rejecting dmabuf" << buffer << "from another GPU, it's not supported with Vulkan compositing";
+        return false;
+    }
+    const DmaBufAttributes *attributes = buffer->dmabufAttributes();
+    if (isYuvFormat(attributes->format)) {
+        qCDebug(KWIN_VULKAN) << "Rejecting dmabuf" << buffer << "with YUV format" << FormatInfo::drmFormatName(attributes->format) << ", it's not supported with Vulkan compositing";
+        return false;
+    }
+    if (!vulkanDevice()->samplingFormats().containsFormat(attributes->format, attributes->modifier)) {
+        return false;
+    }
+    return vulkanDevice()->importBuffer(buffer, VK_IMAGE_USAGE_SAMPLED_BIT) != nullptr;
+}
+
+FormatModifierMap VulkanBackend::supportedFormats() const
+{
+    return rgbFormats(vulkanDevice()->samplingFormats());
+}
+
+void VulkanBackend::initWayland()
+{
+    // Only the render device is advertised, see testImportBuffer().
+    m_tranches = {
+        LinuxDmaBufV1Feedback::Tranche{
+            .device = m_renderDevice->deviceId(),
+            .flags = LinuxDmaBufV1Feedback::TrancheFlag::Sampling,
+            .formatTable = supportedFormats(),
+        },
+    };
+
+    LinuxDmaBufV1ClientBufferIntegration *dmabuf = waylandServer()->linuxDmabuf();
+    dmabuf->setRenderBackend(this);
+    dmabuf->setSupportedFormatsWithModifiers(m_tranches);
+}
+
+} // namespace KWin
+
+#include "moc_vulkan_backend.cpp"
@@ -0,0 +1,45 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "core/renderbackend.h"
+#include "wayland/linuxdmabufv1clientbuffer.h"
+
+namespace KWin
+{
+
+class VulkanDevice;
+
+/**
+ * The VulkanBackend class is the base class for the render backends that composite with
+ * Vulkan. Unlike with OpenGL, there is no context to manage, the layers render into
+ * dmabufs that are imported into the Vulkan device of the render device.
+ */
+class KWIN_EXPORT VulkanBackend : public RenderBackend
+{
+    Q_OBJECT
+
+public:
+    explicit VulkanBackend(RenderDevice *device);
+
+    virtual bool init() = 0;
+    CompositingType compositingType() const override final;
+
+    RenderDevice *renderDevice() const override;
+    VulkanDevice *vulkanDevice() const;
+
+    bool testImportBuffer(GraphicsBuffer *buffer, dev_t targetDevice) override;
+    FormatModifierMap supportedFormats() const override;
+
+protected:
+    void initWayland();
+
+    RenderDevice *const m_renderDevice;
+    QList<LinuxDmaBufV1Feedback::Tranche> m_tranches;
+};
+
+} // namespace KWin
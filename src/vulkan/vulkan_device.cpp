@@ -9,6 +9,7 @@
 #include "vulkan_device.h"
 #include "core/gpumanager.h"
 #include "core/graphicsbuffer.h"
+#include "utils/envvar.h"
 #include "vulkan_logging.h"
 #include "vulkan_texture.h"
 
@@ -19,14 +20,19 @@ namespace KWin
 {
 
 VulkanDevice::VulkanDevice(vk::raii::PhysicalDevice physicalDevice, vk::raii::Device &&logicalDevice,
-                           std::vector<VkQueueFamilyProperties> &&queueProperties, vk::PhysicalDeviceType type)
+                           std::vector<VkQueueFamilyProperties> &&queueProperties, vk::PhysicalDeviceType type,
+                           bool supportsDynamicRendering, bool supportsUdmabufSampling)
     : m_type(type)
     , m_physical(physicalDevice)
     , m_logical(std::move(logicalDevice))
     , m_transferFormats(queryFormats(VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT))
+    , m_renderFormats(supportsDynamicRendering ? queryFormats(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT) : FormatModifierMap())
+    , m_samplingFormats(supportsDynamicRendering ? queryFormats(VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT) : FormatModifierMap())
     , m_queueProperties(std::move(queueProperties))
     , m_deviceLimits(m_physical.getProperties().limits)
     , m_name(physicalDevice.getProperties().deviceName.data())
+    , m_supportsDynamicRendering(supportsDynamicRendering)
+    , m_supportsUdmabufSampling(supportsUdmabufSampling)
 {
     m_memoryProperties = physicalDevice.getMemoryProperties();
     getQueues();
@@ -81,6 +87,31 @@ std::shared_ptr<VulkanTexture> VulkanDevice::importBuffer(GraphicsBuffer *buffer
     return ret;
 }
 
+static const auto s_disableUdmabuf = environmentVariableBoolValue("KWIN_DISABLE_UDMABUF_IMPORT");
+
+std::shared_ptr<VulkanTexture> VulkanDevice::importUdmabuf(GraphicsBuffer *buffer, VkImageUsageFlags usage)
+{
+    const DmaBufAttributes *attributes = buffer->udmabufAttributes();
+    if (!attributes) {
+        return nullptr;
+    }
+    auto it = m_importedTextures.find(buffer);
+    if (it != m_importedTextures.end()) {
+        return it.value();
+    }
+    std::shared_ptr<VulkanTexture> ret;
+    const bool disabled = s_disableUdmabuf.value_or(!m_supportsUdmabufSampling);
+    if (!disabled && m_samplingFormats.containsFormat(attributes->format, attributes->modifier)) {
+        ret = importDmabuf(attributes, usage);
+    }
+    // remember failures too, the buffer is usually attached many times
+    m_importedTextures[buffer] = ret;
+    connect(buffer, &QObject::destroyed, this, [this, buffer]() {
+        m_importedTextures.remove(buffer);
+    });
+    return ret;
+}
+
 /**
  * A dmabuf can have multiple planes with fds pointing to the same image,
  * so checking the number of planes isn't enough to know if it's disjoint
@@ -326,6 +357,11 @@ bool VulkanDevice::isSoftwareRenderer() const
     return m_type == vk::PhysicalDeviceType::eCpu;
 }
 
+bool VulkanDevice::supportsDynamicRendering() const
+{
+    return m_supportsDynamicRendering;
+}
+
 vk::PhysicalDeviceType VulkanDevice::type() const
 {
     return m_type;
@@ -341,6 +377,16 @@ const FormatModifierMap &VulkanDevice::transferFormats() const
     return m_transferFormats;
 }
 
+const FormatModifierMap &VulkanDevice::renderFormats() const
+{
+    return m_renderFormats;
+}
+
+const FormatModifierMap &VulkanDevice::samplingFormats() const
+{
+    return m_samplingFormats;
+}
+
 const vk::raii::Device &VulkanDevice::logicalDevice() const
 {
     return m_logical;
@@ -32,14 +32,26 @@ class KWIN_EXPORT VulkanDevice : public QObject
 
 public:
     explicit VulkanDevice(vk::raii::PhysicalDevice physicalDevice, vk::raii::Device &&logicalDevice,
-                          std::vector<VkQueueFamilyProperties> &&queueProperties, vk::PhysicalDeviceType type);
+                          std::vector<VkQueueFamilyProperties> &&queueProperties, vk::PhysicalDeviceType type,
+                          bool supportsDynamicRendering = false, bool supportsUdmabufSampling = true);
     VulkanDevice(VulkanDevice &&other) = delete;
     VulkanDevice(const VulkanDevice &) = delete;
     ~VulkanDevice();
 
     std::shared_ptr<VulkanTexture> importBuffer(GraphicsBuffer *buffer, VkImageUsageFlags usage);
+    /**
+     * Imports the udmabuf of a shared memory buffer, so that it can be used without copying
+     * it to an image first. Failed imports are remembered, so this is cheap to call for every
+     * commit of the buffer. Drivers that are known to sample udmabufs incorrectly are skipped
+     * unless KWIN_DISABLE_UDMABUF_IMPORT=0 is set.
+     */
+    std::shared_ptr<VulkanTexture> importUdmabuf(GraphicsBuffer *buffer, VkImageUsageFlags usage);
 
     bool isSoftwareRenderer() const;
+    /**
+     * @returns whether the dynamic rendering feature is enabled, it's required for compositing
+     */
+    bool supportsDynamicRendering() const;
     vk::PhysicalDeviceType type() const;
     QString name() const;
 
@@ -47,6 +59,14 @@ public:
     vk::raii::DeviceMemory allocateMemory(const vk::BufferCreateInfo &bufferInfo, vk::MemoryPropertyFlags memoryProperties);
 
     const FormatModifierMap &transferFormats() const;
+    /**
+     * @returns the formats and modifiers of dmabufs that can be used as color attachments
+     */
+    const FormatModifierMap &renderFormats() const;
+    /**
+     * @returns the formats and modifiers of dmabufs that can be sampled by shaders
+     */
+    const FormatModifierMap &samplingFormats() const;
     const vk::raii::Device &logicalDevice() const;
 
     VulkanQueue *graphicsQueue() const;
@@ -102,10 +122,14 @@ private:
     vk::raii::PhysicalDevice m_physical;
     vk::raii::Device m_logical;
     FormatModifierMap m_transferFormats;
+    FormatModifierMap m_renderFormats;
+    FormatModifierMap m_samplingFormats;
     std::vector<VkQueueFamilyProperties> m_queueProperties;
     vk::PhysicalDeviceMemoryProperties m_memoryProperties;
     vk::PhysicalDeviceLimits m_deviceLimits;
     QString m_name;
+    bool m_supportsDynamicRendering;
+    bool m_supportsUdmabufSampling;
 
     std::unique_ptr<VulkanQueue> m_graphicsQueue;
     std::unique_ptr<VulkanQueue> m_transferQueue;
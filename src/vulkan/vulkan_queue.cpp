@@ -50,7 +50,8 @@ vk::raii::CommandBuffer VulkanQueue::createCommandBuffer()
     return std::move(buffers.front());
 }
 
-std::optional<FileDescriptor> VulkanQueue::submit(vk::raii::CommandBuffer &&buffer, FileDescriptor &&syncFd, std::vector<GraphicsBufferRef> &&graphicsBuffers)
+std::optional<FileDescriptor> VulkanQueue::submit(vk::raii::CommandBuffer &&buffer, FileDescriptor &&syncFd, std::vector<GraphicsBufferRef> &&graphicsBuffers,
+                                                  std::vector<std::shared_ptr<void>> &&resources)
 {
     vk::ExportFenceCreateInfo exportInfo{
         vk::ExternalFenceHandleTypeFlagBits::eSyncFd,
@@ -99,6 +100,7 @@ std::optional<FileDescriptor> VulkanQueue::submit(vk::raii::CommandBuffer &&buff
     command->notifier.setSocket(command->completionSyncFd.get());
     command->notifier.setEnabled(true);
     command->graphicsBuffers = std::move(graphicsBuffers);
+    command->resources = std::move(resources);
 
     QObject::connect(&command->notifier, &QSocketNotifier::activated, &command->notifier, [this, cmd = command.get()]() {
         const auto it = std::ranges::find(m_submittedCommandBuffers, cmd, &std::unique_ptr<SubmittedCommand>::get);
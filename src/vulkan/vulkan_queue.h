@@ -13,6 +13,7 @@
 
 #include <QSocketNotifier>
 #include <deque>
+#include <memory>
 #include <vulkan/vulkan_raii.hpp>
 
 namespace KWin
@@ -30,7 +31,12 @@ public:
     const vk::raii::Queue &handle() const;
 
     vk::raii::CommandBuffer createCommandBuffer();
-    std::optional<FileDescriptor> submit(vk::raii::CommandBuffer &&buffer, FileDescriptor &&syncFd, std::vector<GraphicsBufferRef> &&graphicsBuffers);
+    /**
+     * Submits @a buffer to the queue. The @a graphicsBuffers and @a resources, e.g. staging
+     * buffers that the commands read from, are kept alive until the commands are done.
+     */
+    std::optional<FileDescriptor> submit(vk::raii::CommandBuffer &&buffer, FileDescriptor &&syncFd, std::vector<GraphicsBufferRef> &&graphicsBuffers,
+                                         std::vector<std::shared_ptr<void>> &&resources = {});
 
     /**
      * NOTE avoid using this if at all possible, it's obviously terrible for performance!
@@ -47,6 +53,7 @@ private:
         FileDescriptor completionSyncFd;
         QSocketNotifier notifier{QSocketNotifier::Read};
         std::vector<GraphicsBufferRef> graphicsBuffers;
+        std::vector<std::shared_ptr<void>> resources;
     };
 
     VulkanDevice *const m_device;
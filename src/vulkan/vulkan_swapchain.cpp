@@ -62,10 +62,11 @@ std::shared_ptr<SyncReleasePoint> VulkanSwapchainSlot::releasePoint()
     return m_releasePoint;
 }
 
-VulkanSwapchain::VulkanSwapchain(VulkanDevice *device, GraphicsBufferAllocator *allocator, const GraphicsBufferOptions &options, std::shared_ptr<VulkanSwapchainSlot> &&initialSlot)
+VulkanSwapchain::VulkanSwapchain(VulkanDevice *device, GraphicsBufferAllocator *allocator, const GraphicsBufferOptions &options, VkImageUsageFlags usage, std::shared_ptr<VulkanSwapchainSlot> &&initialSlot)
     : m_device(device)
     , m_allocator(allocator)
     , m_options(options)
+    , m_usage(usage)
     , m_slots({std::move(initialSlot)})
 {
 }
@@ -108,7 +109,7 @@ std::shared_ptr<VulkanSwapchainSlot> VulkanSwapchain::acquire()
         return nullptr;
     }
 
-    auto texture = m_device->importBuffer(buffer, VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+    auto texture = m_device->importBuffer(buffer, m_usage);
     if (!texture) {
         buffer->drop();
         return nullptr;
@@ -137,21 +138,21 @@ void VulkanSwapchain::resetBufferAge()
     }
 }
 
-std::unique_ptr<VulkanSwapchain> VulkanSwapchain::create(VulkanDevice *device, GraphicsBufferAllocator *allocator, GraphicsBufferOptions options)
+std::unique_ptr<VulkanSwapchain> VulkanSwapchain::create(VulkanDevice *device, GraphicsBufferAllocator *allocator, GraphicsBufferOptions options, VkImageUsageFlags usage)
 {
     GraphicsBuffer *buffer = allocator->allocate(options);
     if (!buffer) {
         qCWarning(KWIN_VULKAN) << "Failed to allocate a graphics buffer for a Vulkan swapchain";
         return nullptr;
     }
-    auto texture = device->importBuffer(buffer, VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+    auto texture = device->importBuffer(buffer, usage);
     if (!texture) {
         buffer->drop();
         return nullptr;
     }
     options.modifiers = {buffer->dmabufAttributes()->modifier};
     auto slot = std::make_shared<VulkanSwapchainSlot>(buffer, std::move(texture));
-    return std::make_unique<VulkanSwapchain>(device, allocator, options, std::move(slot));
+    return std::make_unique<VulkanSwapchain>(device, allocator, options, usage, std::move(slot));
 }
 
 }
@@ -50,7 +50,7 @@ private:
 class KWIN_EXPORT VulkanSwapchain
 {
 public:
-    explicit VulkanSwapchain(VulkanDevice *device, GraphicsBufferAllocator *allocator, const GraphicsBufferOptions &options, std::shared_ptr<VulkanSwapchainSlot> &&initialSlot);
+    explicit VulkanSwapchain(VulkanDevice *device, GraphicsBufferAllocator *allocator, const GraphicsBufferOptions &options, VkImageUsageFlags usage, std::shared_ptr<VulkanSwapchainSlot> &&initialSlot);
     ~VulkanSwapchain();
 
     QSize size() const;
@@ -63,12 +63,17 @@ public:
 
     void resetBufferAge();
 
-    static std::unique_ptr<VulkanSwapchain> create(VulkanDevice *device, GraphicsBufferAllocator *allocator, GraphicsBufferOptions options);
+    /**
+     * Creates a swapchain whose images can be used as specified by @a usage, e.g. as a
+     * transfer destination for copies between GPUs or as a color attachment for compositing.
+     */
+    static std::unique_ptr<VulkanSwapchain> create(VulkanDevice *device, GraphicsBufferAllocator *allocator, GraphicsBufferOptions options, VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT);
 
 private:
     VulkanDevice *const m_device;
     GraphicsBufferAllocator *const m_allocator;
     const GraphicsBufferOptions m_options;
+    const VkImageUsageFlags m_usage;
     std::vector<std::shared_ptr<VulkanSwapchainSlot>> m_slots;
 };
 
@@ -36,6 +36,11 @@ std::optional<vk::Format> VulkanTexture::qImageToVulkanFormat(QImage::Format for
     case QImage::Format_RGBX8888:
     case QImage::Format_RGBA8888_Premultiplied:
         return vk::Format::eR8G8B8A8Unorm;
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    case QImage::Format_RGB32:
+    case QImage::Format_ARGB32_Premultiplied:
+        return vk::Format::eB8G8R8A8Unorm;
+#endif
     case QImage::Format_BGR30:
     case QImage::Format_A2BGR30_Premultiplied:
         return vk::Format::eA2B10G10R10UnormPack32;
@@ -82,6 +87,23 @@ vk::Format VulkanTexture::format() const
     return m_format;
 }
 
+vk::raii::ImageView VulkanTexture::createView(const vk::ComponentMapping &components) const
+{
+    auto [result, view] = m_device->logicalDevice().createImageView(vk::ImageViewCreateInfo{
+        vk::ImageViewCreateFlags(),
+        *m_image,
+        vk::ImageViewType::e2D,
+        m_format,
+        components,
+        vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1},
+    });
+    if (result != vk::Result::eSuccess) {
+        qCWarning(KWIN_VULKAN) << "creating an image view failed:" << vk::to_string(result);
+        return vk::raii::ImageView(nullptr);
+    }
+    return std::move(view);
+}
+
 static QImage::Format vulkanToQImageFormat(vk::Format format)
 {
     switch (format) {
@@ -91,6 +113,10 @@ static QImage::Format vulkanToQImageFormat(vk::Format format)
         return QImage::Format_Grayscale16;
     case vk::Format::eR8G8B8A8Unorm:
         return QImage::Format_RGBA8888_Premultiplied;
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    case vk::Format::eB8G8R8A8Unorm:
+        return QImage::Format_ARGB32_Premultiplied;
+#endif
     case vk::Format::eR16G16B16A16Unorm:
         return QImage::Format_RGBA64_Premultiplied;
     case vk::Format::eR16G16B16A16Sfloat:
@@ -170,38 +196,71 @@ QImage VulkanTexture::download() const
     return result;
 }
 
+namespace
+{
+struct StagingBuffer
+{
+    vk::raii::DeviceMemory memory{nullptr};
+    vk::raii::Buffer buffer{nullptr};
+};
+}
+
 bool VulkanTexture::update(const QImage &img, const Region &region, const QPoint &offset)
 {
     if (img.size() != m_size || qImageToVulkanFormat(img.format()) != m_format) {
         return false;
     }
-    // FIXME this is terrible. Instead, pass the command buffer in as
-    // an argument, and leave synchronization up to the caller?
-    m_device->waitIdle();
 
     vk::BufferCreateInfo bufferInfo{
         vk::BufferCreateFlags(),
         vk::DeviceSize(img.sizeInBytes()),
         vk::BufferUsageFlagBits::eTransferSrc,
     };
-    auto stagingMemory = m_device->allocateMemory(bufferInfo, vk::MemoryPropertyFlagBits::eHostVisible);
-    if (!*stagingMemory) {
+    auto staging = std::make_shared<StagingBuffer>();
+    staging->memory = m_device->allocateMemory(bufferInfo, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+    if (!*staging->memory) {
         return false;
     }
     auto [result, stagingBuffer] = m_device->logicalDevice().createBuffer(bufferInfo);
     if (result != vk::Result::eSuccess) {
         return false;
     }
-    stagingBuffer.bindMemory(stagingMemory, 0);
-    auto [mapResult, dataPtr] = stagingMemory.mapMemory(0, vk::DeviceSize(img.sizeInBytes()));
+    staging->buffer = std::move(stagingBuffer);
+    staging->buffer.bindMemory(staging->memory, 0);
+    auto [mapResult, dataPtr] = staging->memory.mapMemory(0, vk::DeviceSize(img.sizeInBytes()));
     if (mapResult != vk::Result::eSuccess) {
         return false;
     }
     std::memcpy(dataPtr, img.constBits(), img.sizeInBytes());
-    stagingMemory.unmapMemory();
+    staging->memory.unmapMemory();
 
     auto commandBuffer = m_device->graphicsQueue()->createCommandBuffer();
+    if (!*commandBuffer) {
+        return false;
+    }
     commandBuffer.begin(vk::CommandBufferBeginInfo{vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+    // Barriers apply to everything earlier or later in submission order on the queue, so
+    // previously submitted frames finish sampling the old contents before the copy starts and
+    // later frames see the new contents, without the CPU having to wait for anything.
+    const vk::ImageSubresourceRange subresourceRange{vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1};
+    const vk::ImageMemoryBarrier2 beforeCopy{
+        vk::PipelineStageFlagBits2::eFragmentShader | vk::PipelineStageFlagBits2::eTransfer,
+        vk::AccessFlagBits2::eShaderSampledRead | vk::AccessFlagBits2::eTransferRead | vk::AccessFlagBits2::eTransferWrite,
+        vk::PipelineStageFlagBits2::eTransfer,
+        vk::AccessFlagBits2::eTransferWrite,
+        vk::ImageLayout::eGeneral,
+        vk::ImageLayout::eGeneral,
+        vk::QueueFamilyIgnored,
+        vk::QueueFamilyIgnored,
+        *m_image,
+        subresourceRange,
+    };
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo{
+        vk::DependencyFlags(),
+        {},
+        {},
+        beforeCopy,
+    });
     const uint32_t bytesPerPixel = img.depth() / 8;
     const auto regions = region.rects() | std::views::transform([&img, &offset, bytesPerPixel](const Rect &rect) {
         return vk::BufferImageCopy2{
@@ -219,16 +278,32 @@ bool VulkanTexture::update(const QImage &img, const Region &region, const QPoint
         };
     }) | std::ranges::to<std::vector>();
     commandBuffer.copyBufferToImage2(vk::CopyBufferToImageInfo2{
-        *stagingBuffer,
+        *staging->buffer,
         *m_image,
         vk::ImageLayout::eGeneral,
         regions,
     });
+    const vk::ImageMemoryBarrier2 afterCopy{
+        vk::PipelineStageFlagBits2::eTransfer,
+        vk::AccessFlagBits2::eTransferWrite,
+        vk::PipelineStageFlagBits2::eFragmentShader | vk::PipelineStageFlagBits2::eTransfer,
+        vk::AccessFlagBits2::eShaderSampledRead | vk::AccessFlagBits2::eTransferRead | vk::AccessFlagBits2::eTransferWrite,
+        vk::ImageLayout::eGeneral,
+        vk::ImageLayout::eGeneral,
+        vk::QueueFamilyIgnored,
+        vk::QueueFamilyIgnored,
+        *m_image,
+        subresourceRange,
+    };
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo{
+        vk::DependencyFlags(),
+        {},
+        {},
+        afterCopy,
+    });
     commandBuffer.end();
-    m_device->graphicsQueue()->submit(std::move(commandBuffer), FileDescriptor{}, {});
-
-    m_device->graphicsQueue()->waitIdle();
-    return true;
+    // The staging buffer is released once the copy is done.
+    return m_device->graphicsQueue()->submit(std::move(commandBuffer), FileDescriptor{}, {}, {std::move(staging)}).has_value();
 }
 
 bool VulkanTexture::update(const QImage &img)
@@ -279,12 +354,9 @@ std::unique_ptr<VulkanTexture> VulkanTexture::allocate(VulkanDevice *device, vk:
     };
     commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eFragmentShader, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, toTransferSrc);
     commandBuffer.end();
+    // The barrier also orders the transition before any later submission to the queue.
     device->graphicsQueue()->submit(std::move(commandBuffer), FileDescriptor{}, {});
 
-    // FIXME this is terrible. Instead, pass the command buffer in as
-    // an argument, and leave synchronization up to the caller.
-    device->graphicsQueue()->waitIdle();
-
     std::vector<vk::raii::DeviceMemory> mem;
     mem.push_back(std::move(memory));
     return std::make_unique<VulkanTexture>(device, format, std::move(image), std::move(mem), size);
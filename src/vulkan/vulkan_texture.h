@@ -34,6 +34,9 @@ public:
 
     /**
      * NOTE the format and size have to match in order for the update to work
+     *
+     * The copy is submitted to the graphics queue without waiting for it. It's ordered after
+     * the work that has already been submitted and before the work that is submitted later.
      */
     bool update(const QImage &img, const Region &region, const QPoint &offset = QPoint());
     /**
@@ -43,6 +46,12 @@ public:
 
     QImage download() const;
 
+    /**
+     * Creates a view of the whole image. The @a components can be used to e.g. ignore the
+     * alpha channel of formats that have padding bits instead of alpha.
+     */
+    vk::raii::ImageView createView(const vk::ComponentMapping &components = vk::ComponentMapping()) const;
+
     const vk::raii::Image &handle() const;
     vk::Format format() const;
     QSize size() const;
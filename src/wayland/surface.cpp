@@ -621,7 +621,6 @@ void SurfaceState::mergeInto(SurfaceState *target)
 void SurfaceInterfacePrivate::applyState(SurfaceState *next)
 {
     const bool bufferChanged = (next->committed & SurfaceState::Field::Buffer) && (current->buffer != next->buffer);
-    const bool opaqueRegionChanged = (next->committed & SurfaceState::Field::Opaque);
     const bool transformChanged = (next->committed & SurfaceState::Field::BufferTransform) && (current->bufferTransform != next->bufferTransform);
     const bool shadowChanged = (next->committed & SurfaceState::Field::Shadow);
     const bool blurChanged = (next->committed & SurfaceState::Field::Blur);
@@ -640,6 +639,7 @@ void SurfaceInterfacePrivate::applyState(SurfaceState *next)
     const QSizeF oldSurfaceSize = surfaceSize;
     const RectF oldBufferSourceBox = bufferSourceBox;
     const RegionF oldInputRegion = inputRegion;
+    const RegionF oldOpaqueRegion = opaqueRegion;
     const std::optional<RegionF> oldEffectivePointerLock = effectivePointerLock;
     const std::optional<RegionF> oldEffectivePointerConfinement = effectivePointerConfinement;
 
@@ -696,6 +696,8 @@ void SurfaceInterfacePrivate::applyState(SurfaceState *next)
     }
 
     const bool inputRegionChanged = oldInputRegion != inputRegion;
+    // The opaque region also depends on whether the buffer has an alpha channel
+    const bool opaqueRegionChanged = oldOpaqueRegion != opaqueRegion;
     if (inputRegionChanged || pointerLockRegionChanged) {
         effectivePointerLock = current->pointerLockRegion.transform([this](const RegionF &region) {
             if (region.isEmpty()) {
@@ -0,0 +1,127 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "windowhittestindex.h"
+#include "wayland/surface.h"
+#include "window.h"
+#include "workspace.h"
+
+#include <KDecoration3/Decoration>
+
+namespace KWin
+{
+
+/**
+ * Returns the area in which Window::hitTest() can succeed for the given @a window, or std::nullopt
+ * if it cannot be tracked.
+ */
+static std::optional<RectF> inputBounds(const Window *window)
+{
+    if (SurfaceInterface *surface = window->surface()) {
+        // Sub-surfaces can be moved or resized without changing the geometry of the window.
+        if (!surface->below().isEmpty() || !surface->above().isEmpty()) {
+            return std::nullopt;
+        }
+    }
+
+    RectF bounds = window->bufferGeometry();
+    if (window->isDecorated()) {
+        // The decoration input region also includes the resize only borders around the frame.
+        bounds = bounds.united(window->frameGeometry().marginsAdded(window->decoration()->resizeOnlyBorders()));
+    }
+
+    // Leave some room for rounding errors in the input region checks.
+    return bounds.adjusted(-1, -1, 1, 1);
+}
+
+WindowHitTestIndex::WindowHitTestIndex(Workspace *workspace)
+    : m_workspace(workspace)
+{
+}
+
+WindowHitTestIndex::~WindowHitTestIndex()
+{
+    unwatchWindows();
+}
+
+bool WindowHitTestIndex::isValid() const
+{
+    // The generation also changes if the stacking order is modified without stackingOrderChanged.
+    return !m_dirty && m_generation == m_workspace->stackingOrderGeneration();
+}
+
+void WindowHitTestIndex::invalidate()
+{
+    m_dirty = true;
+}
+
+void WindowHitTestIndex::rebuild()
+{
+    unwatchWindows();
+
+    m_windows = m_workspace->stackingOrder();
+    m_generation = m_workspace->stackingOrderGeneration();
+    m_indices.clear();
+    m_indices.reserve(m_windows.size());
+
+    QList<std::optional<RectF>> bounds;
+    bounds.reserve(m_windows.size());
+    for (int i = 0; i < m_windows.size(); ++i) {
+        Window *window = m_windows[i];
+        m_indices.insert(window, i);
+        bounds.append(inputBounds(window));
+        watchWindow(window);
+    }
+
+    m_grid.reset(bounds);
+    m_dirty = false;
+}
+
+void WindowHitTestIndex::updateWindow(Window *window)
+{
+    if (m_dirty) {
+        return;
+    }
+    const auto it = m_indices.constFind(window);
+    if (it != m_indices.constEnd()) {
+        m_grid.update(*it, inputBounds(window));
+    }
+}
+
+void WindowHitTestIndex::watchWindow(Window *window)
+{
+    m_connections << connect(window, &Window::frameGeometryChanged, this, [this, window]() {
+        updateWindow(window);
+    });
+    m_connections << connect(window, &Window::bufferGeometryChanged, this, [this, window]() {
+        updateWindow(window);
+    });
+    m_connections << connect(window, &Window::decorationChanged, this, &WindowHitTestIndex::invalidate);
+    m_connections << connect(window, &Window::surfaceChanged, this, &WindowHitTestIndex::invalidate);
+
+    if (KDecoration3::Decoration *decoration = window->decoration()) {
+        m_connections << connect(decoration, &KDecoration3::Decoration::resizeOnlyBordersChanged, this, [this, window]() {
+            updateWindow(window);
+        });
+    }
+    if (SurfaceInterface *surface = window->surface()) {
+        m_connections << connect(surface, &SurfaceInterface::childSubSurfacesChanged, this, [this, window]() {
+            updateWindow(window);
+        });
+    }
+}
+
+void WindowHitTestIndex::unwatchWindows()
+{
+    for (const QMetaObject::Connection &connection : std::as_const(m_connections)) {
+        disconnect(connection);
+    }
+    m_connections.clear();
+}
+
+} // namespace KWin
+
+#include "moc_windowhittestindex.cpp"
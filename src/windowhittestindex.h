@@ -0,0 +1,79 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "utils/stackinggrid.h"
+
+#include <QHash>
+#include <QObject>
+
+namespace KWin
+{
+
+class Window;
+class Workspace;
+
+/**
+ * The WindowHitTestIndex class keeps a StackingGrid of the windows in the stacking order in sync
+ * with the workspace, so the window under the pointer can be found without walking the whole
+ * stacking order.
+ *
+ * The bounds of a window cover every point for which Window::hitTest() may return @c true. The
+ * grid is rebuilt lazily when Workspace::stackingOrderGeneration() changes, geometry changes of
+ * individual windows only update the cells that they touch. Windows whose input area cannot be
+ * tracked, e.g. windows with sub-surfaces, are checked at every point.
+ *
+ * There is one grid for the whole workspace rather than one per output. The grid cells already
+ * partition the global coordinate space, so a query never looks at windows on other outputs, and
+ * windows that span several outputs don't have to be kept in several grids.
+ */
+class WindowHitTestIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit WindowHitTestIndex(Workspace *workspace);
+    ~WindowHitTestIndex() override;
+
+    /**
+     * Returns the topmost window whose bounds contain the specified @a point and that is accepted
+     * by the @a accept predicate, or @c nullptr if there is no such window.
+     */
+    template<typename Predicate>
+    Window *topmostAt(const QPointF &point, Predicate accept);
+
+private:
+    bool isValid() const;
+    void invalidate();
+    void rebuild();
+    void updateWindow(Window *window);
+    void watchWindow(Window *window);
+    void unwatchWindows();
+
+    Workspace *m_workspace;
+    StackingGrid m_grid;
+    QList<Window *> m_windows;
+    QHash<Window *, int> m_indices;
+    QList<QMetaObject::Connection> m_connections;
+    quint64 m_generation = 0;
+    bool m_dirty = true;
+};
+
+template<typename Predicate>
+Window *WindowHitTestIndex::topmostAt(const QPointF &point, Predicate accept)
+{
+    if (!isValid()) {
+        rebuild();
+    }
+
+    const int index = m_grid.topmostAt(point, [this, &accept](int index) {
+        return accept(m_windows[index]);
+    });
+    return index != -1 ? m_windows[index] : nullptr;
+}
+
+} // namespace KWin
@@ -60,6 +60,8 @@
 #include "utils/lightsensor.h"
 #include "utils/orientationsensor.h"
 #include "virtualdesktops.h"
+#include "vulkan/vulkan_backend.h"
+#include "vulkan/vulkan_device.h"
 #include "wayland/externalbrightness_v1.h"
 #include "wayland/surface.h"
 #include "wayland_server.h"
@@ -783,13 +785,16 @@ void Workspace::addToStack(Window *window)
     }
     if (!stacking_order.contains(window)) {
         stacking_order.append(window);
+        ++m_stackingOrderGeneration;
     }
 }
 
 void Workspace::removeFromStack(Window *window)
 {
     unconstrained_stacking_order.removeAll(window);
-    stacking_order.removeAll(window);
+    if (stacking_order.removeAll(window)) {
+        ++m_stackingOrderGeneration;
+    }
 
     for (int i = m_constraints.count() - 1; i >= 0; --i) {
         Constraint *constraint = m_constraints[i];
@@ -1998,6 +2003,15 @@ QString Workspace::supportInformation() const
             support.append(QStringLiteral("OpenGL 2 Shaders are used\n"));
             break;
         }
+        case VulkanCompositing: {
+            const auto backend = static_cast<VulkanBackend *>(Compositor::self()->backend());
+            support.append(QStringLiteral("Compositing Type: Vulkan\n"));
+            support.append(QStringLiteral("Vulkan device: ") + backend->vulkanDevice()->name() + QStringLiteral("\n"));
+            if (auto kernelVersion = linuxKernelVersion(); kernelVersion.isValid()) {
+                support.append(QStringLiteral("Linux kernel version: ") + kernelVersion.toString() + QStringLiteral("\n"));
+            }
+            break;
+        }
         case QPainterCompositing:
         case NoCompositing:
         default:
@@ -265,6 +265,11 @@ public:
      * at the last position
      */
     const QList<Window *> &stackingOrder() const;
+    /**
+     * Returns a number that changes whenever stackingOrder() is modified, including
+     * modifications that are not announced by stackingOrderChanged().
+     */
+    quint64 stackingOrderGeneration() const;
     QList<Window *> unconstrainedStackingOrder() const;
     QList<Window *> ensureStackingOrder(const QList<Window *> &windows) const;
 
@@ -665,6 +670,7 @@ private:
 
     QList<Window *> unconstrained_stacking_order; // Topmost last
     QList<Window *> stacking_order; // Topmost last
+    quint64 m_stackingOrderGeneration = 0;
     QList<Window *> attention_chain;
     bool force_restacking;
 
@@ -810,6 +816,11 @@ inline const QList<Window *> &Workspace::stackingOrder() const
     return stacking_order;
 }
 
+inline quint64 Workspace::stackingOrderGeneration() const
+{
+    return m_stackingOrderGeneration;
+}
+
 inline bool Workspace::wasUserInteraction() const
 {
     return was_user_interaction;
@@ -315,7 +315,7 @@ bool X11Window::track(xcb_window_t w)
     m_frameGeometry = Xcb::fromXNative(geo.rect());
     m_clientGeometry = Xcb::fromXNative(geo.rect());
     checkOutput();
-    bit_depth = geo->depth;
+    setBitDepth(geo->depth);
     info = new NETWinInfo(kwinApp()->x11Connection(), w, kwinApp()->x11RootWindow(),
                           NET::WMWindowType,
                           NET::WM2Opacity | NET::WM2WindowRole | NET::WM2WindowClass | NET::WM2OpaqueRegion);
@@ -357,7 +357,7 @@ bool X11Window::manage(xcb_window_t w, bool isMapped)
     m_client.setBorderWidth(0);
     m_client.selectInput(attr->your_event_mask | XCB_EVENT_MASK_FOCUS_CHANGE | XCB_EVENT_MASK_PROPERTY_CHANGE);
 
-    bit_depth = windowGeometry->depth;
+    setBitDepth(windowGeometry->depth);
 
     // SELI TODO: Order all these things in some sane manner
 
@@ -381,7 +381,7 @@ bool X11Window::manage(xcb_window_t w, bool isMapped)
 
     if (isDesktop() && bit_depth == 32) {
         // force desktop windows to be opaque. It's a desktop after all, there is no window below
-        bit_depth = 24;
+        setBitDepth(24);
     }
 
     // If it's already mapped, ignore hint
@@ -3880,7 +3880,19 @@ void X11Window::getWmOpaqueRegion()
     for (const auto &r : rects) {
         new_opaque_region += Xcb::fromXNative(Rect(r.pos.x, r.pos.y, r.size.width, r.size.height));
     }
-    opaque_region = new_opaque_region;
+    if (opaque_region != new_opaque_region) {
+        opaque_region = new_opaque_region;
+        Q_EMIT opaqueRegionChanged();
+    }
+}
+
+void X11Window::setBitDepth(int depth)
+{
+    const bool hadAlpha = hasAlpha();
+    bit_depth = depth;
+    if (hadAlpha != hasAlpha()) {
+        Q_EMIT hasAlphaChanged();
+    }
 }
 
 RegionF X11Window::shapeRegion() const
@@ -280,6 +280,8 @@ protected:
 
 Q_SIGNALS:
     void shapeChanged();
+    void opaqueRegionChanged();
+    void hasAlphaChanged();
 
 private:
     void exportMappingState(int s); // ICCCM 4.1.3.1, 4.1.4, NETWM 2.5.1
@@ -287,6 +289,7 @@ private:
     void updateAllowedActions(bool force = false);
     Rect fullscreenMonitorsArea(NETFullscreenMonitors topology) const;
     void getResourceClass();
+    void setBitDepth(int depth);
     void getWmNormalHints();
     void getWmClientMachine();
     void getMotifHints();